@@ -0,0 +1,40 @@
+# - Find ODBC
+# Find the ODBC driver manager includes and library (unixODBC, iODBC or the Windows one)
+# This module defines
+#  ODBC_INCLUDE_DIR, where to find sql.h and sqlext.h
+#  ODBC_LIBRARIES, the libraries needed to use ODBC.
+#  ODBC_FOUND, If false, do not try to use ODBC.
+#
+# Redistribution and use is allowed according to the terms of the BSD license.
+# For details see the accompanying COPYING-CMAKE-SCRIPTS file.
+
+
+if (ODBC_INCLUDE_DIR AND ODBC_LIBRARIES)
+  # Already in cache, be silent
+  set(ODBC_FIND_QUIETLY TRUE)
+endif (ODBC_INCLUDE_DIR AND ODBC_LIBRARIES)
+
+
+find_path(ODBC_INCLUDE_DIR sqlext.h
+   ${ODBC_PATH_INCLUDES}/
+   /usr/include/
+   /usr/include/odbc/
+   /usr/local/include/
+   /usr/local/odbc/include/
+   /usr/include/iodbc/
+   /usr/local/include/iodbc/
+)
+
+find_library(ODBC_LIBRARIES NAMES odbc odbc32 iodbc
+    PATHS
+        ${ODBC_PATH_LIB}
+        /usr/lib/
+        /usr/local/lib/
+        /usr/local/odbc/lib/
+)
+
+include(ToraFindPackageHandleStandardArgs)
+find_package_handle_standard_args(ODBC DEFAULT_MSG
+                                  ODBC_INCLUDE_DIR ODBC_LIBRARIES )
+
+mark_as_advanced(ODBC_INCLUDE_DIR ODBC_LIBRARIES)
@@ -35,6 +35,8 @@
 #include "trotl_export.h"
 #include "trotl_conn.h"
 
+#include <new>
+
 #if 0
 #include <sql2oci.h>
 #endif
@@ -74,6 +76,34 @@ void OciConnection::cancel()
 	oci_check_error(__TROTL_HERE__, _env._errh, res);
 }
 
+char* OciConnection::arena_take(size_t &size)
+{
+	if(_arena_block && _arena_size >= size)
+	{
+		char *retval = _arena_block;
+		size = _arena_size;
+		_arena_block = NULL;
+		_arena_size = 0;
+		return retval;
+	}
+	char *retval = (char*) malloc(size);
+	if(!retval)
+		throw std::bad_alloc();
+	return retval;
+}
+
+void OciConnection::arena_give(char *block, size_t size)
+{
+	if(_arena_size >= size)
+	{
+		free(block);
+		return;
+	}
+	free(_arena_block);
+	_arena_block = block;
+	_arena_size = size;
+}
+
 /// reset() is to be called after handling the cancellation in the calling worker thread.
 void OciConnection::reset()
 {
@@ -54,8 +54,18 @@ struct TROTL_EXPORT OracleServer : public OciHandle<OCIServer>
 		_version = 0;
 	}
 
+	// server handle shared by sessions of a session pool
+	OracleServer(OciEnv& env, OCIServer* handle)
+		:	super(env, handle)
+	{
+		_version_string[0] = '\0';
+		_version = 0;
+	}
+
 	~OracleServer()
 	{
+		if (!_handle)
+			return;
 		sword res = OCICALL(OCIServerDetach(_handle, _env._errh, OCI_DEFAULT));
 		oci_check_error(__TROTL_HERE__, _env._errh, res);
 	}
@@ -165,6 +175,73 @@ struct TROTL_EXPORT LoginAndPChangePara : public LoginPara
 	{}
 };
 
+/// OCI session pool (OCISessionPoolCreate), sessions of one user sharing server handles.
+/// Sessions are borrowed by OciLogin(env, pool) and returned when the login disconnects.
+struct TROTL_EXPORT OciSessionPool : public OciHandle<OCISPool>
+{
+	typedef OciHandle<OCISPool> super;
+
+	OciSessionPool(OciEnv& env, const LoginPara& login_para, ub4 sess_max=16, ub4 stmt_cache_size=20)
+		: super(env)
+		, _pool_name(NULL)
+		, _pool_name_len(0)
+		, _created(false)
+	{
+		sword res = OCICALL(OCISessionPoolCreate(_env, _env._errh, _handle,
+		                    &_pool_name, &_pool_name_len,
+		                    (const OraText*)login_para._tnsname.c_str(), (ub4)login_para._tnsname.length(),
+		                    0 /* sessMin */, sess_max, 1 /* sessIncr */,
+		                    (OraText*)login_para._username.c_str(), (ub4)login_para._username.length(),
+		                    (OraText*)login_para._password.c_str(), (ub4)login_para._password.length(),
+		                    OCI_SPC_HOMOGENEOUS | OCI_SPC_STMTCACHE));
+		oci_check_error(__TROTL_HERE__, _env._errh, res);
+		_created = true;
+
+		set_attribute(OCI_ATTR_SPOOL_STMTCACHESIZE, stmt_cache_size);
+	}
+
+	~OciSessionPool()
+	{
+		if (_created)
+		{
+			// sessions still borrowed are terminated too
+			// destructor must not throw, the error is only logged
+			try
+			{
+				sword res = OCICALL(OCISessionPoolDestroy(_handle, _env._errh, OCI_SPD_FORCE));
+				oci_check_error(__TROTL_HERE__, _env._errh, res);
+			}
+			catch (OciException const &e)
+			{
+				std::cerr << __TROTL_HERE__ << e.what() << std::endl;
+			}
+		}
+	}
+
+	OCISvcCtx* get()
+	{
+		OCISvcCtx* svc = NULL;
+		boolean found = FALSE;
+		sword res = OCICALL(OCISessionGet(_env, _env._errh, &svc, NULL,
+		                                  _pool_name, _pool_name_len,
+		                                  NULL, 0, NULL, NULL, &found, OCI_SESSGET_SPOOL));
+		oci_check_error(__TROTL_HERE__, _env._errh, res);
+		return svc;
+	}
+
+	// drop the session instead of returning it into pool, when it is broken
+	void release(OCISvcCtx* svc, bool drop=false)
+	{
+		sword res = OCICALL(OCISessionRelease(svc, _env._errh, NULL, 0, drop ? OCI_SESSRLS_DROPSESS : OCI_DEFAULT));
+		oci_check_error(__TROTL_HERE__, _env._errh, res);
+	}
+
+	OraText* _pool_name;
+	ub4 _pool_name_len;
+protected:
+	bool _created;
+};
+
 /// simple OCI login to database
 struct TROTL_EXPORT OciLogin : public OciHandle<OCISvcCtx>
 {
@@ -177,6 +254,7 @@ struct TROTL_EXPORT OciLogin : public OciHandle<OCISvcCtx>
 		, _serial(0)
 		, _session(env)
 		, _connected(false)
+		, _pool(NULL)
 	{
 		connect(login_para._username, login_para._password, login_para._tnsname, mode);
 		getSidAndSerial();
@@ -186,7 +264,8 @@ struct TROTL_EXPORT OciLogin : public OciHandle<OCISvcCtx>
 		: super(env),
 		  _server(env),
 		  _session(env),
-		  _connected(false)
+		  _connected(false),
+		  _pool(NULL)
 	{
 		connect_and_pchange(login_para._username, login_para._password, login_para._new_password, login_para._tnsname, mode);
 		getSidAndSerial();
@@ -196,12 +275,44 @@ struct TROTL_EXPORT OciLogin : public OciHandle<OCISvcCtx>
 		: super(env),
 		  _server(env),
 		  _session(env),
-		  _connected(false)
+		  _connected(false),
+		  _pool(NULL)
 	{
 		connect(username, password, tnsname, mode);
 		getSidAndSerial();
 	}
 
+	/// session borrowed from a session pool, no authentication round-trip when pool has an idle session
+	OciLogin(OciEnv& env, OciSessionPool& pool, const tstring& tnsname)
+		: super(env, pool.get()),
+		  _server(env, svc_attribute<OCIServer*>(env, OCI_ATTR_SERVER)),
+		  _tnsname(tnsname),
+		  _sid(0),
+		  _serial(0),
+		  _session(env, svc_attribute<OCISession*>(env, OCI_ATTR_SESSION)),
+		  _connected(true),
+		  _pool(&pool)
+	{
+		try
+		{
+			_server.getVersion();
+			getSidAndSerial();
+		}
+		catch (...)
+		{
+			// destructor is not called, hand the session back (it is not trusted any more)
+			try
+			{
+				disconnect(true);
+			}
+			catch (OciException const &e)
+			{
+				std::cerr << __TROTL_HERE__ << e.what() << std::endl;
+			}
+			throw;
+		}
+	}
+
 	void connect(const tstring& username, const tstring& password, const tstring& tnsname, ub4 mode=OCI_DEFAULT)
 	{
 		// set server name
@@ -271,9 +382,20 @@ struct TROTL_EXPORT OciLogin : public OciHandle<OCISvcCtx>
 		disconnect();
 	}
 
-	void disconnect()
+	// for pooled sessions: drop the session instead of returning it into pool
+	void disconnect(bool drop=false)
 	{
-		if (_connected)
+		if (_connected && _pool)
+		{
+			OCISvcCtx* svc = _handle;
+			// handles belong to the pool
+			_handle = 0;
+			_server.forget();
+			_session.forget();
+			_connected = false;
+			_pool->release(svc, drop);
+		}
+		else if (_connected)
 		{
 			/* automatically free server and session handles
 			 * sword res = OCICALL(OCILogoff(_svchp, _env._errh));
@@ -299,6 +421,11 @@ struct TROTL_EXPORT OciLogin : public OciHandle<OCISvcCtx>
 		oci_check_error(__TROTL_HERE__, _env._errh, res);
 	}
 
+	bool pooled() const
+	{
+		return _pool != NULL;
+	}
+
 	unsigned sid()
 	{
 		if (_sid == 0)
@@ -350,6 +477,15 @@ protected:
 #endif
 	OciHandle<OCISession>	_session;
 	bool	_connected;
+	OciSessionPool* _pool;	// set when the session was borrowed from a pool
+
+	template<class RETTYPE> RETTYPE svc_attribute(OciEnv& env, ub4 attrtype)
+	{
+		RETTYPE retval = NULL;
+		sword res = OCICALL(OCIAttrGet(_handle, OCI_HTYPE_SVCCTX, &retval, 0, attrtype, env._errh));
+		oci_check_error(__TROTL_HERE__, env._errh, res);
+		return retval;
+	}
 };
 
 /// wrap OCIEnv and OCISvcCtx together
@@ -362,7 +498,8 @@ struct TROTL_EXPORT OciConnection
 	OciContext	_svc_ctx;
 
 	OciConnection(OCIEnv* envh, OCISvcCtx* svc_ctx)
-		: _env(envh), _svc_ctx(svc_ctx)
+		: _env(envh), _svc_ctx(svc_ctx), _arena_block(NULL), _arena_size(0)
+		, _stmt_cache_size(0), _stmt_cache_known(false)
 	{}
 
 	//OciConnection(OCIEnv* envh) :
@@ -374,7 +511,14 @@ struct TROTL_EXPORT OciConnection
 	//   	but ... - OCI Programmer's Guide should be trusted:)
 	~OciConnection()
 	{
-		rollback();
+		// destructor must not throw, rollback fails on broken connections
+		try
+		{
+			rollback();
+		}
+		catch(...)
+		{}
+		free(_arena_block);
 	}
 
 #if 0
@@ -385,6 +529,12 @@ struct TROTL_EXPORT OciConnection
 	tstring	getNLS_LANG();
 	void	changePassword (tstring userid, tstring password, tstring new_password);
 
+	/* Define buffer blocks (see DefineArena) recycled between statements.
+	 * arena_take returns a block of at least size bytes, arena_give keeps the largest block returned.
+	 */
+	char*	arena_take(size_t &size);
+	void	arena_give(char *block, size_t size);
+
 	void commit(ub4 flags=OCI_DEFAULT)
 	{
 		sword res = OCICALL(OCITransCommit(_svc_ctx, _env._errh, flags));
@@ -426,10 +576,29 @@ struct TROTL_EXPORT OciConnection
 #endif
 	}
 
+	// Statement cache size of the session, sessions from OciSessionPool have statement cache enabled.
+	// It does not change during the session lifetime, so it is queried only once (prepare asks for every statement)
+	ub4 stmt_cache_size()
+	{
+		if (!_stmt_cache_known)
+		{
+			ub4 size = 0;
+			sword res = OCICALL(OCIAttrGet(_svc_ctx, OCI_HTYPE_SVCCTX, &size, 0, OCI_ATTR_STMTCACHESIZE, _env._errh));
+			_stmt_cache_size = (res == OCI_SUCCESS) ? size : 0;
+			_stmt_cache_known = true;
+		}
+		return _stmt_cache_size;
+	}
+
 	//StatementCache	_stmt_cache; TODO
 
 private:
 	OciConnection(const OciConnection&);	// disallow copy constructor calls
+
+	char *_arena_block;
+	size_t _arena_size;
+	ub4 _stmt_cache_size;
+	bool _stmt_cache_known;
 };
 
 };
@@ -54,7 +54,7 @@ Util::RegisterInFactory<BindParDate, DefineParFactTwoParmSing, int> regDefineTim
 
 BindParDate::BindParDate(unsigned int pos, SqlStatement &stmt, DescribeColumn* ct) : BindPar(pos, stmt, ct)
 {
-	valuep = (void**) calloc(_cnt, sizeof(OCIDate));
+	valuep = (void**) define_calloc(_cnt, sizeof(OCIDate));
 
 	dty = SQLT_ODT;
 	value_sz = sizeof(OCIDate);
@@ -49,11 +49,17 @@ namespace trotl
 #if defined(TROTL_MAKE_DLL) || defined(__GNUC__)
 extern int TROTL_EXPORT g_OCIPL_BULK_ROWS;
 extern int TROTL_EXPORT g_OCIPL_MAX_LONG;
+extern bool TROTL_EXPORT g_OCIPL_UTF16_DEFINES;
+extern int TROTL_EXPORT g_OCIPL_FETCH_MEMORY;
+extern int TROTL_EXPORT g_OCIPL_LOB_PREFETCH;
 extern const char TROTL_EXPORT *g_TROTL_DEFAULT_NUM_FTM;
 extern const char TROTL_EXPORT *g_TROTL_DEFAULT_DATE_FTM;
 #else
 int TROTL_EXPORT g_OCIPL_BULK_ROWS;
 int TROTL_EXPORT g_OCIPL_MAX_LONG;
+bool TROTL_EXPORT g_OCIPL_UTF16_DEFINES;
+int TROTL_EXPORT g_OCIPL_FETCH_MEMORY;
+int TROTL_EXPORT g_OCIPL_LOB_PREFETCH;
 const char TROTL_EXPORT *g_TROTL_DEFAULT_NUM_FTM;
 const char TROTL_EXPORT *g_TROTL_DEFAULT_DATE_FTM;
 #endif
@@ -117,6 +117,10 @@ template <> inline ub4 OciHandleID<OCISubscription>::get_type_id()
 {
 	return OCI_HTYPE_SUBSCRIPTION;
 }
+template <> inline ub4 OciHandleID<OCISPool>::get_type_id()
+{
+	return OCI_HTYPE_SPOOL;
+}
 /*
   template <> inline ub4 OciHandleID<***>::get_type_id() {return OCI_HTYPE_DIRPATH_CTX;}
   template <> inline ub4 OciHandleID<***>::get_type_id() {return OCI_HTYPE_DIRPATH_COLUMN_ARRAY;}
@@ -394,6 +398,12 @@ struct OciHandle : public OciHandleID<TYPE>
 		return _handle;
 	}
 
+	// forget the handle without freeing it, used for handles owned by OCI (e.g. sessions from a session pool)
+	void forget()
+	{
+		_handle = 0;
+	}
+
 	OciEnv& _env;
 protected:
 	HandleType*	_handle;
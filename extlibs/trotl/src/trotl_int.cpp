@@ -84,7 +84,7 @@ tstring TROTL_EXPORT BindParNumber::get_string(unsigned int row) const
 TROTL_EXPORT BindParNumber::BindParNumber(unsigned int pos, SqlStatement &stmt, DescribeColumn* ct) : BindPar(pos, stmt, ct)
 {
 	_errh.alloc(stmt._env);
-	valuep = (void**) calloc(_cnt, (size_t)OCI_NUMBER_SIZE );
+	valuep = (void**) define_calloc(_cnt, (size_t)OCI_NUMBER_SIZE );
 
 	dty =  SQLT_VNU; //dty = SQLT_NUM;
 	value_sz = OCI_NUMBER_SIZE;
@@ -134,6 +134,19 @@ void BindParLob::define_hook()
 {
 //	sword res = OCICALL(OCIDefineArrayOfStruct(defnpp , _env._errh, sizeof(OCILobLocator*), 0, 0, 0 ));
 //	oci_check_error(__TROTL_HERE__, _env, res);
+#ifdef OCI_ATTR_LOBPREFETCH_SIZE
+	// LOB prefetch (11g+): length and first bytes of each LOB come with the fetched locator,
+	// so short LOBs can be displayed without any extra round-trip.
+	// Servers without prefetch support reject the attribute, such errors are ignored.
+	if(g_OCIPL_LOB_PREFETCH > 0)
+	{
+		ub4 size = g_OCIPL_LOB_PREFETCH;
+		boolean length = TRUE;
+		sword res = OCICALL(OCIAttrSet(defnpp, OCI_HTYPE_DEFINE, &size, 0, OCI_ATTR_LOBPREFETCH_SIZE, _stmt._errh));
+		if(res == OCI_SUCCESS)
+			OCICALL(OCIAttrSet(defnpp, OCI_HTYPE_DEFINE, &length, 0, OCI_ATTR_LOBPREFETCH_LENGTH, _stmt._errh));
+	}
+#endif
 }
 
 bool BindParLob::isTemporary(unsigned _row) const
@@ -47,6 +47,8 @@
 #include <boost/function.hpp>
 
 #include <algorithm>
+#include <mutex>
+#include <unordered_map>
 
 namespace trotl
 {
@@ -230,5 +232,51 @@ tstring SimplePlsqlParser::colorword(const tstring &i, int color)
 #endif
 };
 
+typedef std::unordered_map<tstring, std::shared_ptr<const ParsedStatement> > ParsedStatementMap;
+
+static std::mutex& parsed_statement_lock()
+{
+	static std::mutex lock;
+	return lock;
+}
+
+static ParsedStatementMap& parsed_statement_map()
+{
+	static ParsedStatementMap map;
+	return map;
+}
+
+std::shared_ptr<const ParsedStatement> ParsedStatementCache::get(const tstring &sql)
+{
+	{
+		std::lock_guard<std::mutex> guard(parsed_statement_lock());
+		ParsedStatementMap::const_iterator it = parsed_statement_map().find(sql);
+		if(it != parsed_statement_map().end())
+			return it->second;
+	}
+
+	// parse outside the lock, two threads may parse the same text, the result is the same
+	SimplePlsqlParser parser;
+	if(!parser.parse(sql))
+		return std::shared_ptr<const ParsedStatement>();
+
+	std::shared_ptr<ParsedStatement> retval(new ParsedStatement);
+	retval->sql = parser.getNonColored();
+	retval->bindvars.swap(parser._bindvars);
+
+	std::lock_guard<std::mutex> guard(parsed_statement_lock());
+	ParsedStatementMap &map = parsed_statement_map();
+	if(map.size() >= MAX_ENTRIES)
+		map.clear();
+	map[sql] = retval;
+	return retval;
+}
+
+void ParsedStatementCache::clear()
+{
+	std::lock_guard<std::mutex> guard(parsed_statement_lock());
+	parsed_statement_map().clear();
+}
+
 };
 
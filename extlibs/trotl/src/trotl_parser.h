@@ -38,6 +38,7 @@
 #include "trotl_common.h"
 
 #include <vector>
+#include <memory>
 
 namespace trotl
 {
@@ -178,6 +179,27 @@ private:
 	BindVarDecl _bindvar;
 };
 
+/* Outcome of SimplePlsqlParser::parse - statement text without bind declarations
+ * and the declarations themselves */
+struct TROTL_EXPORT ParsedStatement
+{
+	tstring sql;
+	std::vector<BindVarDecl> bindvars;
+};
+
+/* Process-wide cache of parsed statements keyed by the original SQL text.
+ * Shared by all connections (thread safe), the cache is dropped when it grows over MAX_ENTRIES.
+ */
+class TROTL_EXPORT ParsedStatementCache
+{
+public:
+	enum { MAX_ENTRIES = 1024 };
+
+	// returns NULL when the statement can not be parsed
+	static std::shared_ptr<const ParsedStatement> get(const tstring &sql);
+	static void clear();
+};
+
 };
 
 #endif
@@ -46,6 +46,7 @@
 
 #include <algorithm>
 #include <cctype>       // std::toupper
+#include <cstring>      // memset
 #include <string>
 //#include <assert.h>
 
@@ -55,6 +56,9 @@ namespace trotl
 
 int TROTL_EXPORT g_OCIPL_BULK_ROWS = 256;
 int TROTL_EXPORT g_OCIPL_MAX_LONG = 0x20000; //128 KB
+bool TROTL_EXPORT g_OCIPL_UTF16_DEFINES = false; // fetch character columns as UTF-16
+int TROTL_EXPORT g_OCIPL_FETCH_MEMORY = 0x100000; // 1 MB of define buffers per statement, used to choose fetch size
+int TROTL_EXPORT g_OCIPL_LOB_PREFETCH = 0x8000; // 32 KB of LOB data (and LOB length) returned together with locator, 0 = disabled
 const char TROTL_EXPORT *g_TROTL_DEFAULT_NUM_FTM = "TM";
 const char TROTL_EXPORT *g_TROTL_DEFAULT_DATE_FTM = "YYYY:MM:DD HH24:MI:SS";
 
@@ -73,21 +77,21 @@ SqlStatement::SqlStatement(OciConnection& conn, const tstring& stmt, ub4 lang, i
 	  _last_fetched_row(-1),
 	  _in_pos(0), _out_pos(0), _iters(0),
 	  _last_buff_row(0), _buff_size(g_OCIPL_BULK_ROWS), _fetch_rows(g_OCIPL_BULK_ROWS),
+	  _fetch_rows_hint(0), _row_width(0),
 	  _all_binds(NULL), _all_defines(NULL),
 	  _in_binds(NULL), _out_binds(NULL),
-	  _bound(false)
+	  _bound(false), _cached(false), _batch_errors(false)
 //	_res(NULL),
 //	_bulk_rows(bulk_rows),
 //	_result_buffers(0),
 {
 	_errh.alloc(_env);
 
-	SimplePlsqlParser parser;
-	bool parse_retval = parser.parse(stmt);
-	if(!parse_retval)
-		throw_oci_exception(OciException(__TROTL_HERE__, "Parsing failed for: \n%s").arg(parser.getNonColored()));
+	std::shared_ptr<const ParsedStatement> parsed = ParsedStatementCache::get(stmt);
+	if(!parsed)
+		throw_oci_exception(OciException(__TROTL_HERE__, "Parsing failed for: \n%s").arg(stmt));
 
-	_parsed_stmt= parser.getNonColored();
+	_parsed_stmt= parsed->sql;
 
 	prepare(_parsed_stmt, lang);
 
@@ -118,7 +122,9 @@ SqlStatement::SqlStatement(OciConnection& conn, const tstring& stmt, ub4 lang, i
 	                get_stmt_type() == STMT_DECLARE )
 	{
 		int ipos=1;
-		for(std::vector<BindVarDecl>::iterator it = parser._bindvars.begin(); it != parser._bindvars.end(); ++it, ++ipos)
+		// BindPar constructors take a non-const declaration, copy the cached one
+		std::vector<BindVarDecl> bindvars(parsed->bindvars);
+		for(std::vector<BindVarDecl>::iterator it = bindvars.begin(); it != bindvars.end(); ++it, ++ipos)
 		{
 			if(it->inout == "in")
 			{
@@ -171,9 +177,10 @@ SqlStatement::SqlStatement(OciConnection& conn, OciHandle<OCIStmt>& handle, ub4
 	  _last_fetched_row(-1),
 	  _in_pos(0), _out_pos(0), _iters(0),
 	  _last_buff_row(0), _buff_size(g_OCIPL_BULK_ROWS), _fetch_rows(g_OCIPL_BULK_ROWS),
+	  _fetch_rows_hint(0), _row_width(0),
 	  _all_binds(NULL), _all_defines(NULL),
 	  _in_binds(NULL), _out_binds(NULL),
-	  _bound(false)
+	  _bound(false), _cached(false), _batch_errors(false)
 //	_res(NULL),
 //	_bulk_rows(bulk_rows),
 //	_result_buffers(0),
@@ -187,8 +194,20 @@ void SqlStatement::prepare(const tstring& sql, ub4 lang)
 	ub4 size = sizeof(stmt_type);
 	sword res;
 
-	res = OCICALL(OCIStmtPrepare(_handle/*stmtp*/, _errh, (text*)sql.c_str(), (ub4)sql.length(), lang, OCI_DEFAULT));
-	check_error(__TROTL_HERE__, res);
+	// Sessions from OciSessionPool have statement cache enabled, take the statement from cache.
+	// Repeated statements (e.g. monitoring queries) are then not re-parsed
+	if (_conn.stmt_cache_size() > 0)
+	{
+		destroy(); // handle allocated by constructor is not needed
+		res = OCICALL(OCIStmtPrepare2(_conn._svc_ctx, &_handle, _errh, (text*)sql.c_str(), (ub4)sql.length(), NULL, 0, lang, OCI_DEFAULT));
+		check_error(__TROTL_HERE__, res);
+		_cached = true;
+	}
+	else
+	{
+		res = OCICALL(OCIStmtPrepare(_handle/*stmtp*/, _errh, (text*)sql.c_str(), (ub4)sql.length(), lang, OCI_DEFAULT));
+		check_error(__TROTL_HERE__, res);
+	}
 
 	/* NOTE this call alse returns other values than mentioned in OCI docs.
 	 * for example "EXPLAIN PLAN FOR ..." returns value 15
@@ -238,16 +257,55 @@ void SqlStatement::execute_describe()
 	_state |= DESCRIBED;
 }
 
-void SqlStatement::define_all()
+void SqlStatement::describe_columns()
 {
-	_columns.resize(get_column_count()+1);	// we do not use zero-th position
-	_all_defines= new std::unique_ptr<BindPar> [get_column_count()+1];
+	if(_columns.size() == get_column_count()+1)
+		return;
 
+	_columns.resize(get_column_count()+1);	// we do not use zero-th position
+	_row_width = 0;
+	bool piecewise = false, rowid = false;
 	for(unsigned dpos = 1; dpos <= get_column_count(); ++dpos)
 	{
 		DescribeColumn *dc = new DescribeColumn(_conn, *this, dpos, "");
 		_columns[dpos] = dc;
 
+		// character data are defined with 4 bytes per character (see BindParVarchar)
+		_row_width += dc->_data_size * 4 + sizeof(OCIInd) + sizeof(ub2);
+		piecewise = piecewise || dc->_data_type == SQLT_LNG;
+		rowid = rowid || dc->_data_type == SQLT_RDD;
+	}
+
+	if(_fetch_rows_hint)
+	{
+		_fetch_rows = _fetch_rows_hint;
+	}
+	else
+	{
+		// fill the memory budget: many rows for narrow results, few rows for wide ones
+		ub4 rows = _row_width ? g_OCIPL_FETCH_MEMORY / _row_width : g_OCIPL_BULK_ROWS;
+		_fetch_rows = max((ub4)10, min(rows, (ub4)4096));
+	}
+
+	// same limits as in define_all, they must be known before the first execution (prefetch)
+	if(piecewise)
+		_fetch_rows = 1;
+	if(rowid)
+		_fetch_rows = min(_fetch_rows, (ub4)2);
+}
+
+void SqlStatement::define_all()
+{
+	describe_columns();
+	// _row_width covers value and indicator arrays of scalar types, add the (ub4) alenp arrays,
+	// terminating characters and alignment slack
+	_arena.reserve(_conn, (size_t)_fetch_rows * (_row_width + get_column_count() * (sizeof(ub4) + 4)) + get_column_count() * 64);
+	_all_defines= new std::unique_ptr<BindPar> [get_column_count()+1];
+
+	for(unsigned dpos = 1; dpos <= get_column_count(); ++dpos)
+	{
+		DescribeColumn *dc = _columns[dpos];
+
 		// Use column datatype for lookup in a hash table
 		// and call appropriate create function from the factory
 		if( _columns[dpos]->_data_type != SQLT_NTY)
@@ -411,15 +469,15 @@ bool SqlStatement::execute_internal(ub4 rows, ub4 mode)
 
 	_state &= ~FETCHED & ~EOF_DATA & ~EOF_QUERY & ~STMT_ERROR; // Clear three flags
 
-	//	TODO replace rows by something else - &FETCHED
-	if (rows==0 && get_stmt_type() == STMT_SELECT)
+	if (get_stmt_type() == STMT_SELECT && (_state & DESCRIBED) && (_state & DEFINED) == 0)
 	{
-		// Optimizing of TCP packets by transfering multiple datasets in one packet
+		// Rows prefetched by OCIStmtExecute come back with the execute call, which saves
+		// one round-trip per query. Prefetch size follows the array fetch size.
 		try
 		{
-			set_attribute(OCI_ATTR_PREFETCH_MEMORY, 1500);
-			//set_attribute(OCI_ATTR_PREFETCH_ROWS, 10);
-			set_attribute(OCI_ATTR_PREFETCH_ROWS, g_OCIPL_BULK_ROWS);
+			describe_columns();
+			set_attribute(OCI_ATTR_PREFETCH_ROWS, _fetch_rows);
+			set_attribute(OCI_ATTR_PREFETCH_MEMORY, (ub4)g_OCIPL_FETCH_MEMORY);
 		}
 		catch(std::exception&)
 		{
@@ -442,12 +500,9 @@ bool SqlStatement::execute_internal(ub4 rows, ub4 mode)
 		break;
 	case STMT_UPDATE:
 	case STMT_MERGE:
-		_iters = 1;
-		break;
 	case STMT_DELETE:
-		_iters = 1;
-		break;
 	case STMT_INSERT:
+		// DML statements are executed once for each element of (array) bind variables
 		_iters = 1;
 		if( _in_cnt == 0 )
 			break;
@@ -493,6 +548,11 @@ bool SqlStatement::execute_internal(ub4 rows, ub4 mode)
 
 	//define_all();
 
+	_batch_error_list.clear();
+	const bool batch = _batch_errors && _iters > 1 && get_stmt_type() != STMT_SELECT;
+	if(batch)
+		mode |= OCI_BATCH_ERRORS;
+
 	// execute and do not fetch
 	sword res = OCICALL(OCIStmtExecute(
 	                            _conn._svc_ctx,
@@ -502,6 +562,14 @@ bool SqlStatement::execute_internal(ub4 rows, ub4 mode)
 	                            0,		// rowoff
 	                            (CONST OCISnapshot*)0, (OCISnapshot*)0, mode));
 
+	if(batch && (res == OCI_SUCCESS_WITH_INFO || res == OCI_ERROR))
+	{
+		// ORA-24381: error(s) in array DML, row errors are collected, the statement itself succeeded
+		collect_batch_errors();
+		if(!_batch_error_list.empty())
+			res = OCI_SUCCESS;
+	}
+
 	//std::cout << std::endl
 	//	<< "_iters:" << _iters << std::endl;
 
@@ -624,6 +692,35 @@ void SqlStatement::fetch(ub4 rows/*=-1*/)
 		_state |= EOF_QUERY | EOF_DATA;
 }
 
+void SqlStatement::collect_batch_errors()
+{
+	ub4 num_errs = 0;
+	sword res = OCICALL(OCIAttrGet(_handle, get_type_id(), &num_errs, 0, OCI_ATTR_NUM_DML_ERRORS, _errh));
+	if(res != OCI_SUCCESS || num_errs == 0)
+		return;
+
+	OciError row_errh;
+	row_errh.alloc(_env);
+	for(ub4 i = 0; i < num_errs; ++i)
+	{
+		OCIError *errhp = row_errh;
+		res = OCICALL(OCIParamGet(_errh, OCI_HTYPE_ERROR, _errh, (dvoid**)&errhp, i));
+		if(res != OCI_SUCCESS)
+			break;
+
+		BatchError err;
+		err.row = 0;
+		err.code = 0;
+		OCICALL(OCIAttrGet(errhp, OCI_HTYPE_ERROR, &err.row, 0, OCI_ATTR_DML_ROW_OFFSET, _errh));
+
+		text buffer[1024];
+		buffer[0] = 0;
+		OCICALL(OCIErrorGet(errhp, 1, NULL, &err.code, buffer, sizeof(buffer), OCI_HTYPE_ERROR));
+		err.message = (const char*)buffer;
+		_batch_error_list.push_back(err);
+	}
+}
+
 ub4 SqlStatement::row_count() const
 {
 	ub4 row_count;
@@ -722,6 +819,42 @@ void SqlStatement::define(BindPar &dp)
 	dp.define_hook();
 }
 
+DefineArena::~DefineArena()
+{
+	free(_block);
+}
+
+void DefineArena::reserve(OciConnection &conn, size_t size)
+{
+	if(_block)
+		return;
+	// a recycled block can be much larger than needed, only the part used is cleared
+	_size = _capacity = size;
+	_block = conn.arena_take(_capacity);
+	_used = 0;
+	memset(_block, 0, _size);
+}
+
+void DefineArena::release(OciConnection &conn)
+{
+	if(!_block)
+		return;
+	conn.arena_give(_block, _capacity);
+	_block = NULL;
+	_size = _capacity = _used = 0;
+}
+
+void* DefineArena::alloc(size_t cnt, size_t size)
+{
+	// keep every array aligned for OCINumber, OCIDate and pointers
+	size_t const len = (cnt * size + 15) & ~(size_t)15;
+	if(!_block || _used + len > _size)
+		return NULL;
+	void *retval = _block + _used;
+	_used += len;
+	return retval;
+}
+
 SqlStatement::~SqlStatement()
 {
 	std::vector<DescribeColumn*>::iterator it = _columns.begin();
@@ -732,6 +865,7 @@ SqlStatement::~SqlStatement()
 	}
 	if( get_stmt_type() == STMT_SELECT )
 		delete [] _all_defines;
+	_arena.release(_conn);
 
 	if ( get_bindpar_count() )
 	{
@@ -739,6 +873,12 @@ SqlStatement::~SqlStatement()
 		delete [] _in_binds;
 		delete [] _out_binds;
 	}
+	if (_cached && _handle)
+	{
+		// return the statement into session's statement cache instead of freeing it
+		OCICALL(OCIStmtRelease(_handle, _errh, NULL, 0, OCI_DEFAULT));
+		forget();
+	}
 	_state |= 0xff;
 };
 
@@ -1102,6 +1242,60 @@ SqlStatement& SqlStatement::operator<< <tstring> (const std::vector<tstring> &va
 	return *this;
 };
 
+template<class wrapped_type>
+SqlStatement& SqlStatement::bind_numbers(const std::vector<wrapped_type> &val, const std::vector<bool> &nulls)
+{
+	BindPar &BP(get_next_in_bindpar());
+	BindParNumber &BP2 = dynamic_cast<BindParNumber&>(BP);
+
+	// Check vector size
+	if(BP._max_cnt < val.size())
+		throw_oci_exception(OciException(__TROTL_HERE__,"Input vector too long(length:%d vs. %d)\n").arg(val.size()).arg(BP._max_cnt));
+	if(nulls.size() != val.size())
+		throw_oci_exception(OciException(__TROTL_HERE__,"NULL indicators do not match values(length:%d vs. %d)\n").arg(nulls.size()).arg(val.size()));
+
+	for(unsigned pos=0; pos<val.size(); ++pos)
+	{
+		if(nulls[pos])
+			BP2.indp[pos] = OCI_IND_NULL;
+		else
+			BP2.set_number<wrapped_type>(pos, val[pos]); // also clears the indicator
+	}
+
+	BP2._cnt = (ub4)val.size();
+
+	// perform real bind operation
+	if(!BP._bound) bind(BP);
+
+	if(_in_pos == _in_cnt)
+		execute_internal(g_OCIPL_BULK_ROWS, OCI_DEFAULT);
+
+	return *this;
+}
+
+SqlStatement& SqlStatement::bind_array(const std::vector<long> &val, const std::vector<bool> &nulls)
+{
+	return bind_numbers<long>(val, nulls);
+}
+
+SqlStatement& SqlStatement::bind_array(const std::vector<double> &val, const std::vector<bool> &nulls)
+{
+	return bind_numbers<double>(val, nulls);
+}
+
+SqlStatement& SqlStatement::bind_array(const std::vector<tstring> &val, const std::vector<bool> &nulls)
+{
+	if(nulls.size() != val.size())
+		throw_oci_exception(OciException(__TROTL_HERE__,"NULL indicators do not match values(length:%d vs. %d)\n").arg(nulls.size()).arg(val.size()));
+
+	// string array bind leaves indicators untouched, they can be set in advance
+	const BindPar &BP(get_curr_in_bindpar());
+	for(unsigned pos=0; pos<val.size() && pos<BP._max_cnt; ++pos)
+		BP.indp[pos] = nulls[pos] ? OCI_IND_NULL : OCI_IND_NOTNULL;
+
+	return *this << val;
+}
+
 SqlStatement& SqlStatement::operator<< (const char *val)
 {
 	BindPar &BP(get_next_in_bindpar());
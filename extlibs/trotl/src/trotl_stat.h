@@ -67,6 +67,31 @@ namespace trotl
 class BindParCursor;
 class SqlCursor;
 
+/* Memory for the define buffers of one select statement.
+ * Indicator, length and value arrays of all columns are carved out of one zeroed block
+ * sized from the describe output. The block lives as long as the statement (re-executions
+ * reuse the defines), then it is handed back to the connection for the next statement.
+ * When the estimate is too small alloc() returns NULL and the caller falls back to calloc.
+ */
+struct TROTL_EXPORT DefineArena
+{
+	DefineArena() : _block(NULL), _size(0), _capacity(0), _used(0) {}
+	~DefineArena();
+
+	void reserve(OciConnection &conn, size_t size);
+	void release(OciConnection &conn);
+	void* alloc(size_t cnt, size_t size);
+	bool owns(const void *p) const
+	{
+		return _block && p >= _block && p < _block + _size;
+	}
+
+	char *_block;
+	size_t _size;     // requested size, the part handed out (and cleared)
+	size_t _capacity; // size of the (possibly recycled) block
+	size_t _used;
+};
+
 class TROTL_EXPORT SqlStatement : public OciHandle<OCIStmt>
 {
 	typedef OciHandle<OCIStmt> super;
@@ -96,6 +121,26 @@ public:
 	ub4 row_count() const;
 	ub4 fetched_rows() const;
 
+	/* Row level error of array DML executed with OCI_BATCH_ERRORS */
+	struct BatchError
+	{
+		ub4 row;	// iteration, i.e. index into bind arrays
+		sb4 code;
+		tstring message;
+	};
+
+	/* When enabled array DML continues past failing rows, these are listed by get_batch_errors()
+	 * after each execution. row_count() then returns the number of successful iterations.
+	 */
+	void set_batch_errors(bool enable)
+	{
+		_batch_errors = enable;
+	}
+	const std::vector<BatchError>& get_batch_errors() const
+	{
+		return _batch_error_list;
+	}
+
 	inline STMT_TYPE get_stmt_type() const
 	{
 		return _stmt_type;
@@ -105,6 +150,19 @@ public:
 		/*return _orig_stmt;*/ return _parsed_stmt;
 	};
 	ub4 get_column_count() const;	//Return number of columns returned from SELECT stmt
+
+	/* Array fetch size (rows per round-trip) for SELECT statements, also used as OCI prefetch size.
+	 * Must be set before the statement is executed for the first time.
+	 * 0 (default) chooses the size from the described row width, see g_OCIPL_FETCH_MEMORY
+	 */
+	void set_fetch_rows(ub4 rows)
+	{
+		_fetch_rows_hint = rows;
+	};
+	ub4 get_fetch_rows() const
+	{
+		return _fetch_rows;
+	};
 	ub4 get_bindpar_count() const;
 	const std::vector<DescribeColumn*>& get_columns()
 	{
@@ -216,6 +274,15 @@ public:
 		return *this;
 	}
 
+	/* Array bind with NULL indicators, rows where nulls[row] is set are bound as NULL.
+	 * operator<<(std::vector) can not be used for NULLs, it marks every number row as NOT NULL
+	 * and executes the statement after the last input bind variable, before indicators could be set.
+	 * Executes the statement after the last input bind variable too.
+	 */
+	SqlStatement& bind_array(const std::vector<long> &val, const std::vector<bool> &nulls);
+	SqlStatement& bind_array(const std::vector<double> &val, const std::vector<bool> &nulls);
+	SqlStatement& bind_array(const std::vector<tstring> &val, const std::vector<bool> &nulls);
+
 	SqlStatement& operator>> (SqlValue &val);
 	SqlStatement& operator>> (SqlCursor &val);
 
@@ -300,14 +367,20 @@ protected:
 	virtual void prepare(const tstring& sql, ub4 lang=OCI_NTV_SYNTAX);
 
 	void execute_describe();
+	void collect_batch_errors();
 
 	void fetch(ub4 rows=-1);
 
 	/* OCIBindByPos - for PL/SQL statements */
 	void bind(BindPar &bp);
+	/* see bind_array */
+	template<class wrapped_type>
+	SqlStatement& bind_numbers(const std::vector<wrapped_type> &val, const std::vector<bool> &nulls);
 	/* OCIDefineByPos - for SELECT statements */
 	void define(BindPar &dp);
 	void define_all();
+	/* create column descriptions and choose fetch size */
+	void describe_columns();
 
 	void check_error(tstring where, sword res) const;
 
@@ -357,6 +430,7 @@ public:	//todo delete me - these fields should not be public
 	ub4 _last_row, _last_fetched_row, _in_pos, _out_pos, _iters;
 
 	ub4 _last_buff_row, _buff_size, _fetch_rows; // used in select statements
+	ub4 _fetch_rows_hint, _row_width; // requested fetch size (0 = automatic), estimated size of fetched row
 
 	std::vector<DescribeColumn*> _columns; // TODO move into some SQL-result class
 
@@ -364,6 +438,10 @@ public:	//todo delete me - these fields should not be public
 	std::unique_ptr<BindPar> *_all_defines;
 	ub4 *_in_binds, *_out_binds;
 	bool _bound;
+	bool _cached; // prepared using OCIStmtPrepare2 from session's statement cache
+	DefineArena _arena; // define buffers, see BindPar::define_calloc
+	bool _batch_errors; // execute array DML with OCI_BATCH_ERRORS
+	std::vector<BatchError> _batch_error_list;
 };
 
 /*
@@ -36,6 +36,7 @@
 #include "trotl_string.h"
 #include "trotl_describe.h"
 #include "trotl_parser.h"
+#include "trotl_stat.h"
 
 namespace trotl
 {
@@ -51,11 +52,57 @@ Util::RegisterInFactory<BindParRaw,     DefineParFactTwoParmSing, int> regDefine
 
 Util::RegisterInFactory<BindParLong,    DefineParFactTwoParmSing, int> regDefineLong(SQLT_LNG);
 
+tstring utf16_to_utf8(const ub2 *str, size_t len)
+{
+	tstring retval;
+	retval.reserve(len);
+	for(size_t i = 0; i < len && str[i]; ++i)
+	{
+		unsigned long c = str[i];
+		// surrogate pair
+		if(c >= 0xD800 && c <= 0xDBFF && i + 1 < len && str[i+1] >= 0xDC00 && str[i+1] <= 0xDFFF)
+			c = 0x10000 + ((c - 0xD800) << 10) + (str[++i] - 0xDC00);
+
+		if(c < 0x80)
+		{
+			retval += (char)c;
+		}
+		else if(c < 0x800)
+		{
+			retval += (char)(0xC0 | (c >> 6));
+			retval += (char)(0x80 | (c & 0x3F));
+		}
+		else if(c < 0x10000)
+		{
+			retval += (char)(0xE0 | (c >> 12));
+			retval += (char)(0x80 | ((c >> 6) & 0x3F));
+			retval += (char)(0x80 | (c & 0x3F));
+		}
+		else
+		{
+			retval += (char)(0xF0 | (c >> 18));
+			retval += (char)(0x80 | ((c >> 12) & 0x3F));
+			retval += (char)(0x80 | ((c >> 6) & 0x3F));
+			retval += (char)(0x80 | (c & 0x3F));
+		}
+	}
+	return retval;
+}
+
+static void set_utf16_define(BindPar &dp)
+{
+	ub2 csid = OCI_UTF16ID;
+	sword res = OCICALL(OCIAttrSet(dp.defnpp, OCI_HTYPE_DEFINE, &csid, 0, OCI_ATTR_CHARSET_ID, dp._stmt._errh));
+	oci_check_error(__TROTL_HERE__, dp._stmt._errh, res);
+}
+
 BindParVarchar::BindParVarchar(unsigned int pos, SqlStatement &stmt, DescribeColumn* ct) : BindPar(pos, stmt, ct)
+	, _utf16(g_OCIPL_UTF16_DEFINES)
 {
+	// NOTE: the buffer is large enough for UTF-16 too, a character never takes more than 2 bytes per database charset byte
 	/* amount of bytes =  (string length +1 )*4 * (array length) */
-	valuep = (void**) calloc(_cnt, (ct->_data_size + 1)*4);
-	alenp = (ub2*) calloc(_cnt, sizeof(ub4));
+	valuep = (void**) define_calloc(_cnt, (ct->_data_size + 1)*4);
+	alenp = (ub2*) define_calloc(_cnt, sizeof(ub4));
 
 	dty = SQLT_STR;
 	//value_sz = ct->_width + 1;
@@ -64,6 +111,7 @@ BindParVarchar::BindParVarchar(unsigned int pos, SqlStatement &stmt, DescribeCol
 }
 
 BindParVarchar::BindParVarchar(unsigned int pos, SqlStatement &stmt, BindVarDecl &decl) : BindPar(pos, stmt, decl)
+	, _utf16(false)
 {
 	// amount of bytes =  (string length +1 )*4 * (array length)
 	valuep = (void**) calloc(decl.bracket[1], (decl.bracket[0] + 1) * 4);
@@ -74,10 +122,17 @@ BindParVarchar::BindParVarchar(unsigned int pos, SqlStatement &stmt, BindVarDecl
 	_type_name = typeid(tstring).name();
 }
 
+void BindParVarchar::define_hook()
+{
+	if(_utf16)
+		set_utf16_define(*this);
+}
+
 BindParChar::BindParChar(unsigned int pos, SqlStatement &stmt, DescribeColumn* ct) : BindPar(pos, stmt, ct)
+	, _utf16(g_OCIPL_UTF16_DEFINES)
 {
-	valuep = (void**) calloc(_cnt, ct->_data_size * 4); // TODO +1 ?? why?
-	alenp = (ub2*) calloc(_cnt, sizeof(ub4));
+	valuep = (void**) define_calloc(_cnt, ct->_data_size * 4); // TODO +1 ?? why?
+	alenp = (ub2*) define_calloc(_cnt, sizeof(ub4));
 
 	dty = SQLT_CHR;
 	value_sz = ct->_data_size * 4;
@@ -85,6 +140,7 @@ BindParChar::BindParChar(unsigned int pos, SqlStatement &stmt, DescribeColumn* c
 }
 
 BindParChar::BindParChar(unsigned int pos, SqlStatement &stmt, BindVarDecl &decl): BindPar(pos, stmt, decl)
+	, _utf16(false)
 {
 	valuep = (void**) calloc(decl.bracket[1], (decl.bracket[0] + 1) * 4);
 	alenp = (ub2*) calloc(_cnt, sizeof(ub2));
@@ -94,11 +150,17 @@ BindParChar::BindParChar(unsigned int pos, SqlStatement &stmt, BindVarDecl &decl
 	_type_name = typeid(tstring).name();
 }
 
+void BindParChar::define_hook()
+{
+	if(_utf16)
+		set_utf16_define(*this);
+}
+
 BindParRaw::BindParRaw(unsigned int pos, SqlStatement &stmt, DescribeColumn* ct) : BindPar(pos, stmt, ct)
 {
 	// amount of bytes =  (string length +1 ) * (array length)
-	valuep = (void**) calloc(_cnt, ct->_data_size + 1);
-	alenp = (ub2*) calloc(_cnt, sizeof(ub4));
+	valuep = (void**) define_calloc(_cnt, ct->_data_size + 1);
+	alenp = (ub2*) define_calloc(_cnt, sizeof(ub4));
 
 	dty = SQLT_BIN;
 	value_sz = ct->_data_size + 1;
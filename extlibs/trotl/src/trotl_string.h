@@ -43,6 +43,10 @@
 namespace trotl
 {
 
+/* Convert at most len UTF-16 code units (stops at the first zero unit) into UTF-8
+ **/
+TROTL_EXPORT tstring utf16_to_utf8(const ub2 *str, size_t len);
+
 /* Another template specialization - wraps null terminated string and maps it to tstring
  **/
 // VARCHAR2
@@ -62,9 +66,19 @@ struct TROTL_EXPORT BindParVarchar: public BindPar
 
 	virtual tstring get_string(unsigned int row) const
 	{
-		return is_null(row) ? "NULL" : tstring(((char*)valuep)+(row * value_sz));
+		if(is_null(row))
+			return "NULL";
+		if(_utf16)
+			return utf16_to_utf8((const ub2*)(((char*)valuep)+(row * value_sz)), value_sz / 2);
+		return tstring(((char*)valuep)+(row * value_sz));
 	}
 
+	/* sets OCI_ATTR_CHARSET_ID for UTF-16 defines */
+	virtual void define_hook();
+
+	/* define buffer holds UTF-16 (see g_OCIPL_UTF16_DEFINES) */
+	bool _utf16;
+
 protected:
 	BindParVarchar(const BindParVarchar &other);
 };
@@ -81,11 +95,19 @@ struct TROTL_EXPORT BindParChar: public BindPar
 
 	virtual tstring get_string(unsigned int row) const
 	{
-		if(!indp[row])
-			return tstring(((char*)valuep)+(row * value_sz), (_bind_type != DEFINE_SELECT ? alenp[row] : value_sz) );
-		return "";
+		if(indp[row])
+			return "";
+		if(_utf16)
+			return utf16_to_utf8((const ub2*)(((char*)valuep)+(row * value_sz)), ((ub2*)rlenp)[row] / 2);
+		return tstring(((char*)valuep)+(row * value_sz), (_bind_type != DEFINE_SELECT ? alenp[row] : value_sz) );
 	}
 
+	/* sets OCI_ATTR_CHARSET_ID for UTF-16 defines */
+	virtual void define_hook();
+
+	/* define buffer holds UTF-16 (see g_OCIPL_UTF16_DEFINES) */
+	bool _utf16;
+
 protected:
 	BindParChar(const BindParChar &other);
 };
@@ -421,16 +421,16 @@ BindPar::BindPar(unsigned int pos, SqlStatement &stmt, DescribeColumn *ct)
 	, _env(stmt._env)
 	, _stmt(stmt)
 	, _pos(pos)
-	, _max_cnt(g_OCIPL_BULK_ROWS)
-	, _cnt(g_OCIPL_BULK_ROWS)
+	, _max_cnt(stmt._fetch_rows)
+	, _cnt(stmt._fetch_rows)
 	, _bound(false)
 	, _type_name("")
 	, _reg_name("")
 	, _bind_name("")
 	, _bind_typename("")
 {
-	indp = (OCIInd*) calloc(_cnt, sizeof(OCIInd));
-	rlenp = calloc(_cnt, sizeof(ub2)); // OciDefineByPos uses ub2* for lenp
+	indp = (OCIInd*) define_calloc(_cnt, sizeof(OCIInd));
+	rlenp = define_calloc(_cnt, sizeof(ub2)); // OciDefineByPos uses ub2* for lenp
 
 	_bind_type = DEFINE_SELECT;
 };
@@ -467,6 +467,31 @@ BindPar::BindPar(unsigned int pos, SqlStatement &stmt, BindVarDecl &decl)
 		_bind_type = BIND_OUT;
 };
 
+BindPar::~BindPar()
+{
+	release(indp);
+	indp = NULL;
+	release(rlenp);
+	rlenp = NULL;
+	// if(rcodep) { delete[] rcodep; rcodep = NULL; }
+	release(alenp);
+	alenp = NULL;
+	release(valuep);
+	valuep = NULL;
+}
+
+void* BindPar::define_calloc(size_t cnt, size_t size)
+{
+	void *retval = _stmt._arena.alloc(cnt, size);
+	return retval ? retval : calloc(cnt, size);
+}
+
+void BindPar::release(void *p)
+{
+	if(p && !_stmt._arena.owns(p))
+		free(p);
+}
+
 };
 
 
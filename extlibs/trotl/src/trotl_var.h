@@ -245,30 +245,7 @@ struct TROTL_EXPORT BindPar
 	/* Placeholder for Bind operations */
 	BindPar(unsigned int pos, SqlStatement &stmt, BindVarDecl &decl);
 
-	virtual ~BindPar()
-	{
-		if(indp)
-		{
-			free(indp);
-			indp = NULL;
-		}
-		if(rlenp)
-		{
-			free(rlenp);
-			rlenp = NULL;
-		}
-		// if(rcodep) { delete[] rcodep; rcodep = NULL; }
-		if(alenp)
-		{
-			free(alenp);
-			alenp = NULL;
-		}
-		if(valuep)
-		{
-			free(valuep);
-			valuep = NULL;
-		}
-	};
+	virtual ~BindPar();
 
 	// every datatype can be converted to a string
 	virtual tstring get_string(unsigned int row) const = 0;
@@ -313,6 +290,13 @@ struct TROTL_EXPORT BindPar
 
 	BindPar(const BindPar &other);
 	friend class SqlStatement;
+
+protected:
+	/* calloc replacement for define buffers, takes the memory from statement's DefineArena
+	 * NOTE: use it only for buffers released by ~BindPar (valuep, alenp, indp, rlenp)
+	 */
+	void* define_calloc(size_t cnt, size_t size);
+	void release(void *p);
 }; // class BindPar
 
 /** Factory for creating instantions of BindPar structure.
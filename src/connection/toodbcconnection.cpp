@@ -0,0 +1,220 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "connection/toodbcconnection.h"
+#include "connection/toodbcquery.h"
+#include "core/tologger.h"
+
+#include <QtCore/QMutexLocker>
+
+#include <cstring>
+
+/** Value of a connection string attribute, braced so it can contain ; and = */
+static QString braced(QString const& value)
+{
+    QString ret = value;
+    ret.replace(QChar('}'), QString::fromLatin1("}}"));
+    return QChar('{') + ret + QChar('}');
+}
+
+toODBCConnectionImpl::toODBCConnectionImpl(toConnection &conn)
+    : toConnection::connectionImpl(conn)
+{
+}
+
+toConnectionSub *toODBCConnectionImpl::createConnection(void)
+{
+    // Database is a DSN, a file DSN or a complete connection string, as with QODBC
+    QString database = parentConnection().database();
+    QString str;
+    if (database.contains(QChar('=')))
+        str = database;
+    else if (database.endsWith(QString::fromLatin1(".dsn"), Qt::CaseInsensitive))
+        str = QString::fromLatin1("FILEDSN=") + braced(database);
+    else
+        str = QString::fromLatin1("DSN=") + braced(database);
+    if (!str.endsWith(QChar(';')))
+        str += QChar(';');
+    if (!parentConnection().user().isEmpty() && !str.contains(QString::fromLatin1("UID="), Qt::CaseInsensitive))
+        str += QString::fromLatin1("UID=%1;").arg(braced(parentConnection().user()));
+    if (!parentConnection().password().isEmpty() && !str.contains(QString::fromLatin1("PWD="), Qt::CaseInsensitive))
+        str += QString::fromLatin1("PWD=%1;").arg(braced(parentConnection().password()));
+
+    SQLHENV env = SQL_NULL_HENV;
+    SQLHDBC dbc = SQL_NULL_HDBC;
+    if (!SQL_SUCCEEDED(SQLAllocHandle(SQL_HANDLE_ENV, SQL_NULL_HANDLE, &env)))
+        throw QString::fromLatin1("Failed to allocate ODBC environment");
+    SQLSetEnvAttr(env, SQL_ATTR_ODBC_VERSION, (SQLPOINTER) SQL_OV_ODBC3, 0);
+    if (!SQL_SUCCEEDED(SQLAllocHandle(SQL_HANDLE_DBC, env, &dbc)))
+    {
+        QString t = toODBCConnectionSub::errorString(SQL_HANDLE_ENV, env);
+        SQLFreeHandle(SQL_HANDLE_ENV, env);
+        throw t;
+    }
+
+    QVector<SQLWCHAR> connect = toODBCConnectionSub::toWide(str);
+    SQLRETURN rc = SQLDriverConnectW(dbc, NULL, connect.data(), SQL_NTS, NULL, 0, NULL, SQL_DRIVER_NOPROMPT);
+    if (!SQL_SUCCEEDED(rc))
+    {
+        QString t = toODBCConnectionSub::errorString(SQL_HANDLE_DBC, dbc);
+        SQLFreeHandle(SQL_HANDLE_DBC, dbc);
+        SQLFreeHandle(SQL_HANDLE_ENV, env);
+        throw t;
+    }
+    return new toODBCConnectionSub(parentConnection(), env, dbc);
+}
+
+void toODBCConnectionImpl::closeConnection(toConnectionSub *)
+{
+}
+
+toODBCConnectionSub::toODBCConnectionSub(toConnection const& parent, SQLHENV env, SQLHDBC conn)
+    : Connection(conn)
+    , ParentConnection(parent)
+    , Environment(env)
+    , Running(SQL_NULL_HSTMT)
+{
+}
+
+toODBCConnectionSub::~toODBCConnectionSub()
+{
+    SQLDisconnect(Connection);
+    SQLFreeHandle(SQL_HANDLE_DBC, Connection);
+    SQLFreeHandle(SQL_HANDLE_ENV, Environment);
+}
+
+void toODBCConnectionSub::setRunning(SQLHSTMT stmt)
+{
+    QMutexLocker lock(&RunningLock);
+    Running = stmt;
+}
+
+void toODBCConnectionSub::cancel(void)
+{
+    QMutexLocker lock(&RunningLock);
+    if (Running != SQL_NULL_HSTMT && !SQL_SUCCEEDED(SQLCancel(Running)))
+        TLOG(1, toDecorator, __HERE__) << "	SQLCancel failed: " << errorString(SQL_HANDLE_STMT, Running) << std::endl;
+}
+
+void toODBCConnectionSub::close(void)
+{
+}
+
+void toODBCConnectionSub::commit(void)
+{
+    QMutexLocker lock(&Lock);
+    if (!SQL_SUCCEEDED(SQLEndTran(SQL_HANDLE_DBC, Connection, SQL_COMMIT)))
+        throw errorString(SQL_HANDLE_DBC, Connection, QString::fromLatin1("COMMIT"));
+}
+
+void toODBCConnectionSub::rollback(void)
+{
+    QMutexLocker lock(&Lock);
+    if (!SQL_SUCCEEDED(SQLEndTran(SQL_HANDLE_DBC, Connection, SQL_ROLLBACK)))
+        throw errorString(SQL_HANDLE_DBC, Connection, QString::fromLatin1("ROLLBACK"));
+}
+
+QString toODBCConnectionSub::version()
+{
+    QMutexLocker lock(&Lock);
+    SQLWCHAR buffer[128];
+    SQLSMALLINT len = 0;
+    if (!SQL_SUCCEEDED(SQLGetInfoW(Connection, SQL_DBMS_VER, buffer, sizeof(buffer), &len)))
+        return QString::fromLatin1("unknown version");
+    QString retval = fromWide(buffer, len / sizeof(SQLWCHAR));
+    TLOG(5, toDecorator, __HERE__) << "ODBC Connection version: " << retval << std::endl;
+    return retval;
+}
+
+toQueryParams toODBCConnectionSub::sessionId()
+{
+    // ODBC has no portable session identifier
+    return toQueryParams();
+}
+
+queryImpl* toODBCConnectionSub::createQuery(toQueryAbstr *query)
+{
+    return new odbcQuery(query, this);
+}
+
+QString toODBCConnectionSub::errorString(SQLSMALLINT type, SQLHANDLE handle, QString const& sql)
+{
+    QString ret;
+    SQLWCHAR state[6];
+    SQLWCHAR message[SQL_MAX_MESSAGE_LENGTH];
+    SQLINTEGER native;
+    SQLSMALLINT len;
+    for (SQLSMALLINT i = 1; ; i++)
+    {
+        SQLRETURN rc = SQLGetDiagRecW(type, handle, i, state, &native, message, SQL_MAX_MESSAGE_LENGTH, &len);
+        if (!SQL_SUCCEEDED(rc))
+            break;
+        if (!ret.isEmpty())
+            ret += QChar('\n');
+        ret += QString::fromLatin1("%1: %2")
+               .arg(fromWide(state, 5))
+               .arg(fromWide(message, qMin((int) len, SQL_MAX_MESSAGE_LENGTH - 1)));
+    }
+    if (ret.isEmpty())
+        ret = QString::fromLatin1("Unknown error");
+    if (!sql.isEmpty())
+        ret += QString::fromLatin1("\n\n") + sql;
+    return ret;
+}
+
+QVector<SQLWCHAR> toODBCConnectionSub::toWide(QString const& str)
+{
+    QVector<SQLWCHAR> ret;
+    if (sizeof(SQLWCHAR) == sizeof(QChar))
+    {
+        ret.resize(str.size() + 1);
+        memcpy(ret.data(), str.utf16(), str.size() * sizeof(QChar));
+    }
+    else
+    {
+        QVector<uint> ucs4 = str.toUcs4();
+        ret.resize(ucs4.size() + 1);
+        for (int i = 0; i < ucs4.size(); i++)
+            ret[i] = (SQLWCHAR) ucs4.at(i);
+    }
+    ret.last() = 0;
+    return ret;
+}
+
+QString toODBCConnectionSub::fromWide(SQLWCHAR const *str, int len)
+{
+    if (sizeof(SQLWCHAR) == sizeof(QChar))
+        return QString::fromUtf16(reinterpret_cast<const ushort*>(str), len);
+    return QString::fromUcs4(reinterpret_cast<const uint*>(str), len);
+}
@@ -0,0 +1,112 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include "core/toconnection.h"
+#include "core/toconnectionsub.h"
+
+#include <QtCore/QString>
+#include <QtCore/QMutex>
+#include <QtCore/QVector>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+#include <sql.h>
+#include <sqlext.h>
+
+/** ODBC connection talking to the driver manager directly, without QSql.
+ *  Used by the QODBC provider when the "Native ODBC" option is set (or no QODBC driver is available).
+ *  Results are fetched into bound column arrays a block of rows at a time (see @ref odbcQuery)
+ *  instead of one SQLGetData call per value.
+ */
+class toODBCConnectionImpl: public toConnection::connectionImpl
+{
+        friend class toQODBCProvider;
+    protected:
+        toODBCConnectionImpl(toConnection &conn);
+    public:
+        /** Create a new connection to the database. */
+        toConnectionSub *createConnection(void) override;
+
+        /** Close a connection to the database. */
+        void closeConnection(toConnectionSub *) override;
+};
+
+class toODBCConnectionSub : public toConnectionSub
+{
+        friend class toODBCConnectionImpl;
+    public:
+        toODBCConnectionSub(toConnection const& parent, SQLHENV env, SQLHDBC conn);
+        ~toODBCConnectionSub();
+
+        /** Cancels the statement being executed (see @ref setRunning), can be called from any thread */
+        void cancel(void) override;
+        void close(void) override;
+        void commit(void) override;
+        void rollback(void) override;
+
+        QString version() override;
+        toQueryParams sessionId() override;
+
+        queryImpl* createQuery(toQueryAbstr *query) override;
+
+        toQAdditionalDescriptions* decribe(toCache::ObjectRef const&) override
+        {
+            return NULL;
+        }
+
+        /** Statement cancelled by @ref cancel, NULL when none */
+        void setRunning(SQLHSTMT stmt);
+
+        /** Diagnostic records of @p handle with optional SQL appended */
+        static QString errorString(SQLSMALLINT type, SQLHANDLE handle, QString const& sql = QString::null);
+
+        /** Zero terminated string in the encoding of SQLWCHAR (UTF-16, or UCS-4 with iODBC) */
+        static QVector<SQLWCHAR> toWide(QString const& str);
+        /** @param len number of characters (not bytes) */
+        static QString fromWide(SQLWCHAR const *str, int len);
+
+        /** Serializes the use of the connection between the query owning it and commit/rollback,
+         *  held for the whole round trip (or fetch of a block of rows), never for a single value.
+         */
+        QMutex Lock;
+        SQLHDBC Connection;
+    private:
+        toConnection const& ParentConnection;
+        SQLHENV Environment;
+        QMutex RunningLock;
+        SQLHSTMT Running;
+};
@@ -0,0 +1,661 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "connection/toodbcquery.h"
+#include "connection/toodbcconnection.h"
+#include "connection/toqsqlbindtemplate.h"
+#include "core/tologger.h"
+
+#include <QtCore/QMutexLocker>
+
+#include <cstring>
+
+// Maximal number of rows fetched at once
+#define ODBC_FETCH_ROWS 256
+// Maximal size of the arrays bound to the columns of a result
+#define ODBC_FETCH_BUFFER (4 * 1024 * 1024)
+// Longer columns (in characters or bytes) are read by SQLGetData
+#define ODBC_MAX_BOUND 8000
+// Size of the buffer used to read long columns
+#define ODBC_CHUNK 4096
+
+static bool isNumber(SQLSMALLINT type)
+{
+    switch (type)
+    {
+        case SQL_TINYINT:
+        case SQL_SMALLINT:
+        case SQL_INTEGER:
+        case SQL_BIGINT:
+        case SQL_REAL:
+        case SQL_FLOAT:
+        case SQL_DOUBLE:
+        case SQL_DECIMAL:
+        case SQL_NUMERIC:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/** Name of the type from the driver with the size appended, as it is used in DDL */
+static QString dataType(SQLSMALLINT type, QString const& name, SQLULEN size, SQLSMALLINT digits)
+{
+    QString ret = name.isEmpty() ? QString::fromLatin1("UNKNOWN(%1)").arg(type) : name;
+    if (size == 0 || ret.contains(QChar('(')))
+        return ret;
+    switch (type)
+    {
+        case SQL_CHAR:
+        case SQL_VARCHAR:
+        case SQL_WCHAR:
+        case SQL_WVARCHAR:
+        case SQL_BINARY:
+        case SQL_VARBINARY:
+            return ret + QString::fromLatin1("(%1)").arg(size);
+        case SQL_DECIMAL:
+        case SQL_NUMERIC:
+            return ret + QString::fromLatin1("(%1,%2)").arg(size).arg(digits);
+        default:
+            return ret;
+    }
+}
+
+/** Bytes of the terminator the driver appends to a value of @p ctype */
+static SQLLEN terminator(SQLSMALLINT ctype)
+{
+    switch (ctype)
+    {
+        case SQL_C_WCHAR:
+            return sizeof(SQLWCHAR);
+        case SQL_C_CHAR:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/** Numeric values with more significant digits than a double holds are kept as text */
+static toQValue numericValue(QString const& str)
+{
+    int digits = 0;
+    bool leading = true;
+    for (int i = 0; i < str.size(); i++)
+    {
+        QChar c = str.at(i);
+        if (!c.isDigit())
+            continue;
+        if (leading && c == QChar('0'))
+            continue;
+        leading = false;
+        digits++;
+    }
+    bool ok;
+    double d = str.toDouble(&ok);
+    if (ok && digits <= 15)
+        return toQValue(d);
+    return toQValue(str);
+}
+
+static QByteArray wideBytes(QString const& str)
+{
+    QVector<SQLWCHAR> w = toODBCConnectionSub::toWide(str);
+    return QByteArray(reinterpret_cast<const char*>(w.constData()), (w.size() - 1) * sizeof(SQLWCHAR));
+}
+
+odbcQuery::odbcQuery(toQueryAbstr *query, toODBCConnectionSub *conn)
+    : queryImpl(query)
+    , Connection(conn)
+    , Statement(SQL_NULL_HSTMT)
+    , Prepared(false)
+    , ArrayParams(true)
+    , EOQ(true)
+    , Processed(0)
+    , FirstUnbound(0)
+    , RowArraySize(1)
+    , Fetched(0)
+    , Row(0)
+    , Col(0)
+    , ParamsProcessed(0)
+{
+}
+
+odbcQuery::~odbcQuery()
+{
+    if (Statement == SQL_NULL_HSTMT)
+        return;
+    Connection->setRunning(SQL_NULL_HSTMT);
+    if (!EOQ)
+    {
+        // stop the transfer of rows nobody is going to read
+        SQLCancel(Statement);
+    }
+    QMutexLocker lock(&Connection->Lock);
+    SQLFreeHandle(SQL_HANDLE_STMT, Statement);
+}
+
+void odbcQuery::execute(void)
+{
+    QMutexLocker lock(&Connection->Lock);
+    toQueryParams const& params = query()->params();
+    if (params.empty())
+    {
+        run(query()->sql());
+        return;
+    }
+    prepare(query()->sql());
+    bindParams(QList<toQueryParams>() << params, 0);
+    executed(SQLExecute(Statement));
+}
+
+void odbcQuery::execute(QString const& sql)
+{
+    QMutexLocker lock(&Connection->Lock);
+    run(sql);
+}
+
+void odbcQuery::reset(void)
+{
+    if (Statement == SQL_NULL_HSTMT)
+    {
+        if (!SQL_SUCCEEDED(SQLAllocHandle(SQL_HANDLE_STMT, Connection->Connection, &Statement)))
+        {
+            Statement = SQL_NULL_HSTMT;
+            throw toConnection::exception(toODBCConnectionSub::errorString(SQL_HANDLE_DBC, Connection->Connection));
+        }
+    }
+    else
+    {
+        SQLFreeStmt(Statement, SQL_CLOSE);
+        SQLFreeStmt(Statement, SQL_UNBIND);
+        SQLFreeStmt(Statement, SQL_RESET_PARAMS);
+    }
+    SQLSetStmtAttr(Statement, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER) 1, 0);
+    SQLSetStmtAttr(Statement, SQL_ATTR_PARAM_STATUS_PTR, NULL, 0);
+    SQLSetStmtAttr(Statement, SQL_ATTR_PARAMS_PROCESSED_PTR, NULL, 0);
+    Connection->setRunning(Statement);
+
+    Columns.clear();
+    Description.clear();
+    Unbound.clear();
+    FirstUnbound = 0;
+    RowArraySize = 1;
+    Fetched = 0;
+    Row = Col = 0;
+    Processed = 0;
+    Prepared = false;
+    EOQ = true;
+}
+
+void odbcQuery::run(QString const& sql)
+{
+    reset();
+    SQL = sql;
+    QVector<SQLWCHAR> statement = toODBCConnectionSub::toWide(SQL);
+    executed(SQLExecDirectW(Statement, statement.data(), SQL_NTS));
+}
+
+void odbcQuery::prepare(QString const& sql)
+{
+    reset();
+    SQL = stripBinds(sql);
+    QVector<SQLWCHAR> statement = toODBCConnectionSub::toWide(SQL);
+    if (!SQL_SUCCEEDED(SQLPrepareW(Statement, statement.data(), SQL_NTS)))
+        throw toConnection::exception(toODBCConnectionSub::errorString(SQL_HANDLE_STMT, Statement, SQL));
+    Prepared = true;
+}
+
+int odbcQuery::bindParams(QList<toQueryParams> const& rows, int offset)
+{
+    int cols = BindParams.isEmpty() ? rows.at(offset).size() : BindParams.size();
+    int count = ArrayParams ? rows.size() - offset : 1;
+    if (!SQL_SUCCEEDED(SQLSetStmtAttr(Statement, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER)(SQLULEN) count, 0)))
+    {
+        // the driver has no arrays of parameters, rows are executed one by one
+        ArrayParams = false;
+        count = 1;
+        SQLSetStmtAttr(Statement, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER) 1, 0);
+    }
+    ParamStatus.fill(SQL_PARAM_UNUSED, count);
+    ParamsProcessed = 0;
+    SQLSetStmtAttr(Statement, SQL_ATTR_PARAM_BIND_TYPE, (SQLPOINTER) SQL_PARAM_BIND_BY_COLUMN, 0);
+    SQLSetStmtAttr(Statement, SQL_ATTR_PARAM_STATUS_PTR, ParamStatus.data(), 0);
+    SQLSetStmtAttr(Statement, SQL_ATTR_PARAMS_PROCESSED_PTR, &ParamsProcessed, 0);
+
+    // Values are passed as text (or binary data), the driver converts them to the types of the parameters
+    ParamData.resize(cols);
+    ParamIndicator.resize(cols);
+    for (int col = 0; col < cols; col++)
+    {
+        bool binary = false;
+        for (int row = 0; row < count; row++)
+            binary |= rows.at(offset + row).value(col).isBinary();
+
+        QVector<SQLLEN> &indicator = ParamIndicator[col];
+        indicator.resize(count);
+        QList<QByteArray> values;
+        SQLLEN width = sizeof(SQLWCHAR);
+        for (int row = 0; row < count; row++)
+        {
+            toQValue const& val = rows.at(offset + row).value(col);
+            if (val.isNull())
+            {
+                values << QByteArray();
+                indicator[row] = SQL_NULL_DATA;
+                continue;
+            }
+            values << (binary ? val.toByteArray() : wideBytes(QString(val)));
+            indicator[row] = values.last().size();
+            width = qMax(width, indicator[row]);
+        }
+
+        QByteArray &data = ParamData[col];
+        data.fill(0, width * count);
+        for (int row = 0; row < count; row++)
+            memcpy(data.data() + row * width, values.at(row).constData(), values.at(row).size());
+
+        SQLULEN size = binary ? width : width / sizeof(SQLWCHAR);
+        SQLSMALLINT sqlType;
+        if (binary)
+            sqlType = size > ODBC_MAX_BOUND ? SQL_LONGVARBINARY : SQL_VARBINARY;
+        else
+            sqlType = size > ODBC_MAX_BOUND / 2 ? SQL_WLONGVARCHAR : SQL_WVARCHAR;
+        SQLRETURN rc = SQLBindParameter(Statement,
+                                        col + 1,
+                                        SQL_PARAM_INPUT,
+                                        binary ? SQL_C_BINARY : SQL_C_WCHAR,
+                                        sqlType,
+                                        size,
+                                        0,
+                                        data.data(),
+                                        width,
+                                        indicator.data());
+        if (!SQL_SUCCEEDED(rc))
+            throw toConnection::exception(toODBCConnectionSub::errorString(SQL_HANDLE_STMT, Statement, SQL));
+    }
+    return count;
+}
+
+void odbcQuery::executed(SQLRETURN rc)
+{
+    if (!SQL_SUCCEEDED(rc) && rc != SQL_NO_DATA)
+    {
+        QString err = toODBCConnectionSub::errorString(SQL_HANDLE_STMT, Statement, SQL);
+        SQLFreeStmt(Statement, SQL_CLOSE);
+        throw toConnection::exception(err);
+    }
+
+    SQLSMALLINT count = 0;
+    SQLNumResultCols(Statement, &count);
+    if (count == 0)
+    {
+        SQLLEN affected = 0;
+        if (SQL_SUCCEEDED(SQLRowCount(Statement, &affected)) && affected > 0)
+            Processed = affected;
+        SQLFreeStmt(Statement, SQL_CLOSE);
+        return;
+    }
+
+    FirstUnbound = count;
+    SQLLEN rowWidth = 0;
+    for (SQLUSMALLINT i = 1; i <= count; i++)
+    {
+        SQLWCHAR name[256];
+        SQLWCHAR typeName[128];
+        SQLSMALLINT nameLen = 0, typeLen = 0, type = 0, digits = 0, nullable = SQL_NULLABLE_UNKNOWN;
+        SQLULEN size = 0;
+        if (!SQL_SUCCEEDED(SQLDescribeColW(Statement, i, name, 256, &nameLen, &type, &size, &digits, &nullable)))
+            throw toConnection::exception(toODBCConnectionSub::errorString(SQL_HANDLE_STMT, Statement, SQL));
+        if (!SQL_SUCCEEDED(SQLColAttributeW(Statement, i, SQL_DESC_TYPE_NAME, typeName, sizeof(typeName), &typeLen, NULL)))
+            typeLen = 0;
+
+        toCache::ColumnDescription desc;
+        desc.Name = toODBCConnectionSub::fromWide(name, qMin((int) nameLen, 255));
+        desc.Datatype = dataType(type, toODBCConnectionSub::fromWide(typeName, qMin((int)(typeLen / sizeof(SQLWCHAR)), 127)), size, digits);
+        desc.AlignRight = isNumber(type);
+        desc.Null = nullable != SQL_NO_NULLS;
+        Description << desc;
+
+        Column col;
+        switch (type)
+        {
+            case SQL_BIT:
+            case SQL_TINYINT:
+            case SQL_SMALLINT:
+            case SQL_INTEGER:
+            case SQL_BIGINT:
+                col.CType = SQL_C_SBIGINT;
+                col.Size = sizeof(SQLBIGINT);
+                break;
+            case SQL_REAL:
+            case SQL_FLOAT:
+            case SQL_DOUBLE:
+                col.CType = SQL_C_DOUBLE;
+                col.Size = sizeof(SQLDOUBLE);
+                break;
+            case SQL_DECIMAL:
+            case SQL_NUMERIC:
+                // sign, decimal point and terminator
+                col.CType = SQL_C_CHAR;
+                col.Size = size > 0 && size <= ODBC_MAX_BOUND ? size + 3 : 0;
+                break;
+            case SQL_BINARY:
+            case SQL_VARBINARY:
+                col.CType = SQL_C_BINARY;
+                col.Size = size > 0 && size <= ODBC_MAX_BOUND ? size : 0;
+                break;
+            case SQL_LONGVARBINARY:
+                col.CType = SQL_C_BINARY;
+                col.Size = 0;
+                break;
+            case SQL_LONGVARCHAR:
+            case SQL_WLONGVARCHAR:
+                col.CType = SQL_C_WCHAR;
+                col.Size = 0;
+                break;
+            default:
+                // character data, dates and everything else is converted to text by the driver
+                col.CType = SQL_C_WCHAR;
+                col.Size = size > 0 && size <= ODBC_MAX_BOUND ? (size + 1) * sizeof(SQLWCHAR) : 0;
+        }
+        // SQLGetData can only read the columns following the last bound one
+        if (col.Size == 0 && FirstUnbound == count)
+            FirstUnbound = i - 1;
+        if (FirstUnbound == count)
+            rowWidth += col.Size + sizeof(SQLLEN);
+        Columns << col;
+    }
+
+    RowArraySize = FirstUnbound < count ? 1 : qBound((SQLLEN) 1, ODBC_FETCH_BUFFER / qMax(rowWidth, (SQLLEN) 1), (SQLLEN) ODBC_FETCH_ROWS);
+    SQLSetStmtAttr(Statement, SQL_ATTR_ROW_BIND_TYPE, (SQLPOINTER) SQL_BIND_BY_COLUMN, 0);
+    if (!SQL_SUCCEEDED(SQLSetStmtAttr(Statement, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) RowArraySize, 0)))
+    {
+        RowArraySize = 1;
+        SQLSetStmtAttr(Statement, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) RowArraySize, 0);
+    }
+    else if (RowArraySize > 1)
+    {
+        // the driver may have used a smaller size (01S02)
+        SQLGetStmtAttr(Statement, SQL_ATTR_ROW_ARRAY_SIZE, &RowArraySize, 0, NULL);
+    }
+    SQLSetStmtAttr(Statement, SQL_ATTR_ROWS_FETCHED_PTR, &Fetched, 0);
+
+    for (int i = 0; i < FirstUnbound; i++)
+    {
+        Column &col = Columns[i];
+        col.Data.fill(0, col.Size * RowArraySize);
+        col.Indicator.resize(RowArraySize);
+        if (!SQL_SUCCEEDED(SQLBindCol(Statement, i + 1, col.CType, col.Data.data(), col.Size, col.Indicator.data())))
+            throw toConnection::exception(toODBCConnectionSub::errorString(SQL_HANDLE_STMT, Statement, SQL));
+    }
+
+    EOQ = false;
+    fetch();
+}
+
+void odbcQuery::fetch(void)
+{
+    Row = Col = 0;
+    Fetched = 0;
+    SQLRETURN rc = SQLFetch(Statement);
+    if (SQL_SUCCEEDED(rc) && RowArraySize == 1)
+        Fetched = 1;
+    if (rc == SQL_NO_DATA || (SQL_SUCCEEDED(rc) && Fetched == 0))
+    {
+        EOQ = true;
+        SQLFreeStmt(Statement, SQL_CLOSE);
+        return;
+    }
+    if (!SQL_SUCCEEDED(rc))
+    {
+        QString err = toODBCConnectionSub::errorString(SQL_HANDLE_STMT, Statement, SQL);
+        EOQ = true;
+        SQLFreeStmt(Statement, SQL_CLOSE);
+        throw toConnection::exception(err);
+    }
+    Processed += Fetched;
+
+    Unbound.clear();
+    for (int i = FirstUnbound; i < Columns.size(); i++)
+        Unbound << getData(i);
+}
+
+toQValue odbcQuery::getData(int i)
+{
+    Column const& col = Columns.at(i);
+    SQLLEN len = 0;
+    SQLRETURN rc;
+    if (col.CType == SQL_C_SBIGINT || col.CType == SQL_C_DOUBLE)
+    {
+        char buffer[sizeof(SQLBIGINT) + sizeof(SQLDOUBLE)];
+        rc = SQLGetData(Statement, i + 1, col.CType, buffer, sizeof(buffer), &len);
+        if (!SQL_SUCCEEDED(rc))
+            throw toConnection::exception(toODBCConnectionSub::errorString(SQL_HANDLE_STMT, Statement, SQL));
+        return value(col, buffer, len);
+    }
+
+    // Read in chunks, the driver terminates each chunk of character data
+    SQLLEN term = terminator(col.CType);
+    QByteArray data, chunk(ODBC_CHUNK, 0);
+    for (;;)
+    {
+        rc = SQLGetData(Statement, i + 1, col.CType, chunk.data(), chunk.size(), &len);
+        if (rc == SQL_NO_DATA)
+            break;
+        if (!SQL_SUCCEEDED(rc))
+            throw toConnection::exception(toODBCConnectionSub::errorString(SQL_HANDLE_STMT, Statement, SQL));
+        if (len == SQL_NULL_DATA)
+            return toQValue();
+        if (rc == SQL_SUCCESS_WITH_INFO && (len == SQL_NO_TOTAL || len > chunk.size() - term))
+        {
+            data.append(chunk.constData(), chunk.size() - term);
+            continue;
+        }
+        data.append(chunk.constData(), len);
+        break;
+    }
+    return value(col, data.constData(), data.size());
+}
+
+toQValue odbcQuery::value(Column const& col, char const *data, SQLLEN len) const
+{
+    if (len == SQL_NULL_DATA)
+        return toQValue();
+
+    switch (col.CType)
+    {
+        case SQL_C_SBIGINT:
+            {
+                SQLBIGINT v;
+                memcpy(&v, data, sizeof(v));
+                return toQValue(qlonglong(v));
+            }
+        case SQL_C_DOUBLE:
+            {
+                SQLDOUBLE v;
+                memcpy(&v, data, sizeof(v));
+                return toQValue(double(v));
+            }
+        case SQL_C_CHAR:
+            return numericValue(QString::fromLatin1(data, len));
+        case SQL_C_BINARY:
+            return toQValue::createBinary(QByteArray(data, len));
+        default:
+            // an empty string must not be taken for NULL
+            if (len == 0)
+                return toQValue(QString::fromLatin1(""));
+            return toQValue(toODBCConnectionSub::fromWide(reinterpret_cast<SQLWCHAR const*>(data), len / sizeof(SQLWCHAR)));
+    }
+}
+
+toQValue odbcQuery::readValue(void)
+{
+    if (EOQ)
+        throw toConnection::exception(QString::fromLatin1("Tried to read past end of query"));
+
+    toQValue retval;
+    if (Col < FirstUnbound)
+    {
+        Column const& col = Columns.at(Col);
+        SQLLEN len = col.Indicator.at(Row);
+        // truncated values are returned as they are (only possible when the driver reports a wrong size)
+        if (len != SQL_NULL_DATA && (len == SQL_NO_TOTAL || len > col.Size - terminator(col.CType)))
+            len = col.Size - terminator(col.CType);
+        retval = value(col, col.Data.constData() + Row * col.Size, len);
+    }
+    else
+        retval = Unbound.at(Col - FirstUnbound);
+
+    if (++Col == Columns.size())
+    {
+        Col = 0;
+        if (++Row == (int) Fetched)
+        {
+            QMutexLocker lock(&Connection->Lock);
+            fetch();
+        }
+    }
+    return retval;
+}
+
+bool odbcQuery::eof(void)
+{
+    return EOQ;
+}
+
+unsigned long odbcQuery::rowsProcessed(void)
+{
+    return Processed;
+}
+
+unsigned odbcQuery::columns(void)
+{
+    return Columns.size();
+}
+
+toQColumnDescriptionList odbcQuery::describe(void)
+{
+    return Description;
+}
+
+void odbcQuery::cancel(void)
+{
+    Connection->cancel();
+}
+
+int odbcQuery::executeBatch(QList<toQueryParams> const& rows, QString &error)
+{
+    BatchAffected = 0;
+    BatchErrors.clear();
+    if (rows.isEmpty())
+        return 0;
+
+    QMutexLocker lock(&Connection->Lock);
+    int done = 0;
+    try
+    {
+        // The statement is prepared on the first batch and reused for the following ones
+        if (!Prepared)
+            prepare(query()->sql());
+
+        while (done < rows.size())
+        {
+            int count = bindParams(rows, done);
+            SQLRETURN rc = SQLExecute(Statement);
+            if (SQL_SUCCEEDED(rc) || rc == SQL_NO_DATA)
+            {
+                SQLLEN affected = 0;
+                if (SQL_SUCCEEDED(SQLRowCount(Statement, &affected)) && affected > 0)
+                    BatchAffected += affected;
+                SQLFreeStmt(Statement, SQL_CLOSE);
+                done += count;
+                continue;
+            }
+
+            QString message = toODBCConnectionSub::errorString(SQL_HANDLE_STMT, Statement, SQL);
+            SQLFreeStmt(Statement, SQL_CLOSE);
+            int failed = -1;
+            for (int i = 0; i < count && failed < 0; i++)
+                if (ParamStatus.at(i) == SQL_PARAM_ERROR)
+                    failed = i;
+            if (failed < 0)
+                failed = qBound(0, (int) ParamsProcessed - 1, count - 1);
+            if (!CollectErrors)
+            {
+                error = message;
+                return done + failed;
+            }
+
+            // Drivers either stop on the failing row or continue past it, go on after the rows processed
+            int processed = qBound(failed + 1, (int) ParamsProcessed, count);
+            for (int i = 0; i < processed; i++)
+            {
+                if (i == failed || ParamStatus.at(i) == SQL_PARAM_ERROR)
+                {
+                    BatchError err = { done + i, message };
+                    BatchErrors << err;
+                }
+            }
+            done += processed;
+        }
+    }
+    catch (QString const& str)
+    {
+        error = str;
+    }
+    return done;
+}
+
+QString odbcQuery::stripBinds(QString const& in)
+{
+    BindParams.clear();
+    QString retval;
+    // TODO: no generic SQL Lexer ATM
+    toSQLBindTemplate::TokenList tokens = toSQLBindTemplate::tokens("MySQLGuiLexer", in);
+
+    for (toSQLBindTemplate::TokenList::const_iterator token = tokens.constBegin(); token != tokens.constEnd(); token++)
+    {
+        switch (token->Type)
+        {
+            case toSQLBindTemplate::Token::BIND:
+            case toSQLBindTemplate::Token::BIND_WITH_PARAMS:
+                BindParams << token->Name;
+                retval += QChar('?');
+                break;
+            default:
+                retval += token->Text;
+        }
+    }
+    return retval;
+}
@@ -0,0 +1,123 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include "core/toquery.h"
+#include "core/toqueryimpl.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+#include <sql.h>
+#include <sqlext.h>
+
+class toODBCConnectionSub;
+
+/** Query on a native ODBC connection.
+ *  Result columns are bound to arrays (SQLBindCol, column-wise binding) and fetched a block of rows
+ *  at a time (SQL_ATTR_ROW_ARRAY_SIZE). The connection lock is taken once per block, values are read
+ *  from the bound arrays without locking. Long columns (LOBs, unlimited text) can not be bound, when
+ *  the result has one the rows are fetched one by one and the columns from the first long one on are
+ *  read by SQLGetData.
+ *  Batches are executed using arrays of parameters (SQL_ATTR_PARAMSET_SIZE) in a single round trip.
+ */
+class odbcQuery : public queryImpl
+{
+    public:
+        odbcQuery(toQueryAbstr *query, toODBCConnectionSub *conn);
+        virtual ~odbcQuery();
+        virtual void execute(void);
+        virtual void execute(QString const&);
+        virtual void cancel(void);
+        virtual toQValue readValue(void);
+        virtual bool eof(void);
+        virtual unsigned long rowsProcessed(void);
+        virtual unsigned columns(void);
+        virtual toQColumnDescriptionList describe(void);
+        int executeBatch(QList<toQueryParams> const& rows, QString &error) override;
+    private:
+        /** Result column, bound to an array of RowArraySize values when Size is not 0 */
+        struct Column
+        {
+            SQLSMALLINT CType;
+            SQLLEN Size;                // bytes of one value, 0 for long columns
+            QByteArray Data;
+            QVector<SQLLEN> Indicator;
+        };
+
+        /** Allocate the statement or close the cursor and unbind everything of the previous execution */
+        void reset(void);
+        /** Execute @p sql without parameters */
+        void run(QString const& sql);
+        /** Prepare @p sql with binds replaced by ? */
+        void prepare(QString const& sql);
+        /** Bind parameters of as many rows from @p offset on as the driver accepts at once
+         * @return number of rows bound
+         */
+        int bindParams(QList<toQueryParams> const& rows, int offset);
+        /** Describe and bind the result of an executed statement and fetch the first block */
+        void executed(SQLRETURN rc);
+        /** Fetch the next block of rows, sets EOQ at the end of the result */
+        void fetch(void);
+        /** Read a column not bound to an array */
+        toQValue getData(int col);
+        toQValue value(Column const& col, char const *data, SQLLEN len) const;
+        /** Replace TOra's :name<type> binds with ? */
+        QString stripBinds(QString const& in);
+
+        toODBCConnectionSub *Connection;
+        SQLHSTMT Statement;
+        QString SQL;
+        QStringList BindParams;
+        bool Prepared, ArrayParams, EOQ;
+        unsigned long Processed;
+
+        QVector<Column> Columns;
+        int FirstUnbound;           // index of the first column read by SQLGetData
+        QList<toQValue> Unbound;    // values of these columns in the current row
+        SQLULEN RowArraySize, Fetched;
+        int Row, Col;
+        toQColumnDescriptionList Description;
+
+        QVector<QByteArray> ParamData;
+        QVector<QVector<SQLLEN> > ParamIndicator;
+        QVector<SQLUSMALLINT> ParamStatus;
+        SQLULEN ParamsProcessed;
+};
@@ -75,6 +75,10 @@ QVariant ToConfiguration::Oracle::defaultValue(int option) const
             return QVariant((bool)false);
         case XPlanFormat:
             return QVariant(QString("BASIC"));
+        case Utf16DefinesBool:
+            return QVariant((bool)false);
+        case SessionPoolBool:
+            return QVariant((bool)false);
         default:
             Q_ASSERT_X( false, qPrintable(__QHERE__), qPrintable(QString("Context Oracle un-registered enum value: %1").arg(option)));
             return QVariant();
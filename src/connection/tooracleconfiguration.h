@@ -67,6 +67,8 @@ namespace ToConfiguration
                 , RefConstraintsBool
                 , ConstraintsAsAlterBool
                 , XPlanFormat
+                , Utf16DefinesBool         // fetch VARCHAR2/CHAR columns as UTF-16
+                , SessionPoolBool          // open connection subs from OCI session pool
             };
             virtual QVariant defaultValue(int option) const;
             static QString planTable(QString const& schema);
@@ -48,6 +48,7 @@
 #include "core/toraversion.h"
 #include "core/tologger.h"
 #include "main/tooraclesetting.h"
+#include "connection/tooracleconfiguration.h"
 
 #include "trotl.h"
 #include "trotl_convertor.h"
@@ -74,9 +75,39 @@ _Noreturn void ReThrowException(const ::trotl::OciException &exc)
 toOracleConnectionImpl::toOracleConnectionImpl(toConnection &conn, ::trotl::OciEnv &env)
     : toConnection::connectionImpl(conn)
     , _env(env)
+    , _pool(NULL)
 {
 }
 
+toOracleConnectionImpl::~toOracleConnectionImpl()
+{
+    try
+    {
+        // also terminates pooled sessions still held by cached toConnectionSubs
+        delete _pool;
+    }
+    catch (const ::trotl::OciException &exc)
+    {
+        TLOG(5, toDecorator, __HERE__) << "Failed to destroy session pool:\n" << exc.what();
+    }
+}
+
+::trotl::OciLogin* toOracleConnectionImpl::pooledLogin(QString const& user, QString const& pass)
+{
+    QMutexLocker lock(&_poolLock);
+    if (!_pool)
+    {
+        _pool = new ::trotl::OciSessionPool(_env,
+                                            ::trotl::LoginPara(
+                                                user.toUtf8().constData(),
+                                                pass.toUtf8().constData(),
+                                                parentConnection().database().toUtf8().constData()
+                                            ),
+                                            256 /* max sessions, OCISessionGet blocks when reached */);
+    }
+    return new ::trotl::OciLogin(_env, *_pool, parentConnection().database().toUtf8().constData());
+}
+
 toConnectionSub* toOracleConnectionImpl::createConnection(void)
 {
     ::trotl::OciConnection *conn = NULL;
@@ -103,7 +134,27 @@ toConnectionSub* toOracleConnectionImpl::createConnection(void)
             session_mode = OCI_SYSASM;
 #endif
 
-        do
+        // Pooled sessions skip authentication when an idle session is available in the pool.
+        // Privileged and external (no username) logins always use a dedicated session
+        if (session_mode == OCI_DEFAULT
+                && !parentConnection().user().isEmpty()
+                && toConfigurationNewSingle::Instance().option(ToConfiguration::Oracle::SessionPoolBool).toBool())
+        {
+            try
+            {
+                login = pooledLogin(parentConnection().user(), parentConnection().password());
+                conn = new ::trotl::OciConnection(_env, *login);
+            }
+            catch (const ::trotl::OciException &exc)
+            {
+                // for example ORA-28001 (password expired), handled by dedicated logon bellow
+                TLOG(5, toDecorator, __HERE__) << "Session pool not used:\n" << exc.what();
+                delete login;
+                login = NULL;
+            }
+        }
+
+        while (!conn)
         {
             /* TODO
                if (!sqlNet)
@@ -187,7 +238,6 @@ toConnectionSub* toOracleConnectionImpl::createConnection(void)
                 } //  (toThread::mainThread() && exc.get_code() == 28001)
             } // catch (const ::trotl::OciException &exc)
         }
-        while (!conn);
     }
     catch (const ::trotl::OciException &exc)
     {
@@ -292,6 +342,21 @@ toOracleConnectionSub::toOracleConnectionSub(::trotl::OciConnection *conn, ::tro
 toOracleConnectionSub::~toOracleConnectionSub()
 {
     delete _hasTransactionStat;
+    if (_login->pooled())
+    {
+        // Return the session into pool, broken sessions are dropped.
+        // OciConnection rolls back while the session is still ours
+        delete _conn;
+        try
+        {
+            _login->disconnect(isBroken());
+        }
+        catch (const ::trotl::OciException &exc)
+        {
+            TLOG(5, toDecorator, __HERE__) << "Failed to release pooled session:\n" << exc.what();
+        }
+        delete _login;
+    }
 }
 
 void toOracleConnectionSub::cancel()
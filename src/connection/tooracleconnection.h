@@ -47,6 +47,8 @@
 #include "core/toconnectionsub.h"
 #include "core/utils.h"
 
+#include <QtCore/QMutex>
+
 class toOracleProvider;
 
 namespace trotl
@@ -54,6 +56,7 @@ namespace trotl
     struct OciEnv;
     struct OciConnection;
     struct OciLogin;
+    struct OciSessionPool;
     struct OciException;
     class SqlStatement;
 };
@@ -70,6 +73,8 @@ class toOracleConnectionImpl: public toConnection::connectionImpl
     protected:
         toOracleConnectionImpl(toConnection &conn, ::trotl::OciEnv &env);
     public:
+        virtual ~toOracleConnectionImpl();
+
         /** Create a new connection to the database. */
         virtual toConnectionSub *createConnection(void);
 
@@ -77,6 +82,15 @@ class toOracleConnectionImpl: public toConnection::connectionImpl
         virtual void closeConnection(toConnectionSub *);
 
         ::trotl::OciEnv &_env;
+
+    private:
+        /** Borrow a session from the session pool, the pool is created with the first session.
+         *  See ToConfiguration::Oracle::SessionPoolBool
+         */
+        ::trotl::OciLogin* pooledLogin(QString const& user, QString const& pass);
+
+        QMutex _poolLock;
+        ::trotl::OciSessionPool *_pool;
 };
 
 class toOracleConnectionSub: public toConnectionSub
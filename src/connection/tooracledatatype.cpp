@@ -50,6 +50,87 @@
 
 #endif
 
+void toOracleLobCache::touch(toOracleLobWindow *w, int oldSize)
+{
+    if (w->Prev || First == w)
+    {
+        Used -= oldSize;
+        unlink(w);
+    }
+    if (w->Data.isEmpty())
+        return;
+
+    w->Prev = Last;
+    if (Last)
+        Last->Next = w;
+    else
+        First = w;
+    Last = w;
+    Used += w->Data.size();
+
+    // Drop blocks of least recently read LOBs, the position they end at is kept
+    // so sequential reading can continue
+    while (Used > Budget && First != w)
+    {
+        toOracleLobWindow *victim = First;
+        unlink(victim);
+        Used -= victim->Data.size();
+        victim->Start += victim->Data.size();
+        victim->Data.clear();
+    }
+}
+
+void toOracleLobCache::unlink(toOracleLobWindow *w)
+{
+    if (w->Prev)
+        w->Prev->Next = w->Next;
+    else
+        First = w->Next;
+    if (w->Next)
+        w->Next->Prev = w->Prev;
+    else
+        Last = w->Prev;
+    w->Prev = w->Next = NULL;
+}
+
+toOracleLobWindow::~toOracleLobWindow()
+{
+    if (Cache)
+    {
+        QMutexLocker lock(mutex());
+        int oldSize = Data.size();
+        Data.clear();
+        Cache->touch(this, oldSize); // windows without data are not listed
+    }
+}
+
+bool toOracleLobWindow::from(oraub8 offset, QByteArray &data) const
+{
+    QMutexLocker lock(mutex());
+    if (offset < Start || offset >= Start + Data.size())
+        return false;
+    data = Data.mid(offset - Start);
+    return true;
+}
+
+void toOracleLobWindow::end(oraub8 &offset, oraub8 &nextChar) const
+{
+    QMutexLocker lock(mutex());
+    offset = Start + Data.size();
+    nextChar = NextChar;
+}
+
+void toOracleLobWindow::store(QByteArray const &data, oraub8 start, oraub8 nextChar)
+{
+    QMutexLocker lock(mutex());
+    int oldSize = Data.size();
+    Data = data;
+    Start = start;
+    NextChar = nextChar;
+    if (Cache)
+        Cache->touch(this, oldSize);
+}
+
 QString const& toOracleClob::displayData() const throw()
 {
     if (!_displayData.isNull())
@@ -82,8 +163,6 @@ QString toOracleClob::editData() const throw()
     QString retval;
     try
     {
-        ::trotl::SqlOpenLob clob_open(data, OCI_LOB_READONLY);
-
         if (data._dirname.empty())
             retval = QString(
                     "Datatype: Oracle [N]CLOB\n"
@@ -97,24 +176,20 @@ QString toOracleClob::editData() const throw()
                     .arg(data._dirname.c_str())
                     .arg(data._filename.c_str())
                     .arg(getLength());
-        char buffer[524288];
-        unsigned offset = 0;
-        unsigned to_read = 16 * data.getChunkSize();
-        oraub8 bytes_read = 0, chars_read = 0;
 
-        while (offset < MAXTOMAXLONG)
+        QByteArray content;
+        while (content.size() < MAXTOMAXLONG)
         {
-            oraub8 cr = 0, br = 0;
-            br = data.read(&buffer[0], sizeof(buffer), offset + 1, to_read, &cr);
-            offset += cr;
-            chars_read += cr;
-            bytes_read += br;
-            if (br == 0) // end of LOB reached
+            QByteArray block = read(content.size());
+            if (block.isEmpty()) // end of LOB reached
                 break;
-            retval += QString::fromUtf8(buffer, br);
+            content += block;
         }
+        retval += QString::fromUtf8(content);
 
-        if (offset != data.length())
+        oraub8 end, next;
+        _window.end(end, next);
+        if (next <= getLength())
             retval += "\n...<TRUNCATED>";
     }
     ORA_CATCH
@@ -123,55 +198,72 @@ QString toOracleClob::editData() const throw()
 
 QString toOracleClob::userData() const throw()
 {
-    QString retval;
+    QByteArray content;
     try
     {
-        ::trotl::SqlOpenLob clob_open(data, OCI_LOB_READONLY);
-        char buffer[524288];
-        unsigned offset = 0;
-        unsigned to_read = 16 * data.getChunkSize();
-        oraub8 bytes_read = 0, chars_read = 0;
-
         while (true)
         {
-            oraub8 cr = 0, br = 0;
-            br = data.read(&buffer[0], sizeof(buffer), offset + 1, to_read, &cr);
-            offset += cr;
-            chars_read += cr;
-            bytes_read += br;
-            if (br == 0) // end of LOB reached
+            QByteArray block = read(content.size());
+            if (block.isEmpty()) // end of LOB reached
                 break;
-            retval += QString::fromUtf8(buffer, br);
+            content += block;
         }
-
-        if (offset != data.length())
-            retval += "\n...<TRUNCATED>";
     }
     ORA_CATCH
-    return retval;
+    return QString::fromUtf8(content);
 }
 
-
-QByteArray toOracleClob::read(unsigned offset) const
+QByteArray toOracleClob::readNext(oraub8 &start) const
 {
-    unsigned chunksize = data.getChunkSize();
-    char *buffer = (char*)malloc( chunksize ); // TODO use alloc here(or _alloc on MSVC)
-    unsigned int bytes_read;
-    try
+    oraub8 next;
+    _window.end(start, next);
+    if (next > getLength())
+    {
+        _window.store(QByteArray(), start, next);
+        return QByteArray();
+    }
+
+    // Read as many chunks as possible in one round-trip, but no more than rest of the LOB
+    // (UTF-8 takes up to 4 bytes per character)
+    oraub8 size = qMin((oraub8)data.getChunkSize() * MAXLOBCHUNKS, (getLength() - next + 1) * 4);
+    QByteArray buffer(size, Qt::Uninitialized);
+    oraub8 chars_read = 0, bytes_read = 0;
     {
         ::trotl::SqlOpenLob clob_open(data, OCI_LOB_READONLY);
-        bytes_read = data.read(buffer, chunksize, offset + 1, chunksize);
+        bytes_read = data.read(buffer.data(), size, next, size, &chars_read);
     }
-    catch (const ::trotl::OciException &exc)
+    buffer.resize(bytes_read);
+    _window.store(buffer, start, next + chars_read);
+    return buffer;
+}
+
+QByteArray toOracleClob::read(unsigned offset) const
+{
+    try
     {
-        //if (exc.is_critical())
-        //    conn->Broken = true;
-        free(buffer);
-        ReThrowException(exc);
+        QByteArray ret;
+        if (_window.from(offset, ret))
+            return ret;
+        // Character offsets of CLOB data are only known when reading sequentially,
+        // restart also when the block was dropped by the cache (its end is kept)
+        oraub8 end, next;
+        _window.end(end, next);
+        if (offset < end)
+            _window.store(QByteArray(), 0, 1);
+        // The block just read is used directly, the window can be dropped
+        // by the cache meanwhile
+        while (true)
+        {
+            oraub8 start;
+            QByteArray block = readNext(start);
+            if (block.isEmpty()) // end of LOB reached
+                return QByteArray();
+            if (offset < start + block.size())
+                return block.mid(offset - start);
+        }
     }
-    QByteArray retval(buffer, bytes_read);
-    free(buffer);
-    return retval;
+    ORA_CATCH
+    return QByteArray();
 }
 
 QString const& toOracleBlob::displayData() const throw()
@@ -209,7 +301,6 @@ QString toOracleBlob::editData() const throw()
     QString retval;
     try
     {
-        ::trotl::SqlOpenLob clob_open(data, OCI_LOB_READONLY);
         if (data._dirname.empty())
             retval = QString(
                     "Datatype: Oracle BLOB\n"
@@ -223,28 +314,25 @@ QString toOracleBlob::editData() const throw()
                     .arg(data._dirname.c_str())
                     .arg(data._filename.c_str())
                     .arg(getLength());
-        unsigned char buffer[MAXTOMAXLONG];
-        ub4 chunk_size = data.getChunkSize();
-        unsigned offset = 0;
 
+        unsigned offset = 0;
         while (offset < MAXTOMAXLONG)
         {
-            unsigned to_read = (std::min)(MAXTOMAXLONG - offset, chunk_size);
-            unsigned bytes_read = data.read(&buffer[offset], MAXTOMAXLONG - offset, offset + 1, to_read);
-
-            if (bytes_read == 0) // end of LOB reached
+            QByteArray block = read(offset);
+            if (block.isEmpty()) // end of LOB reached
                 break;
+            block.truncate(MAXTOMAXLONG - offset);
 
-            for (unsigned i = 0; i < bytes_read; ++i)
+            for (int i = 0; i < block.size(); ++i)
             {
                 char sbuff[4];
-                snprintf(sbuff, sizeof(sbuff), " %.2X", buffer[i]);
+                snprintf(sbuff, sizeof(sbuff), " %.2X", (unsigned char)block[i]);
                 retval += sbuff;
                 if ( (offset + i) % 32 == 31)
                     retval += "\n";
             }
 
-            offset += bytes_read;
+            offset += block.size();
         }
 
         if (offset == MAXTOMAXLONG)
@@ -259,24 +347,41 @@ QString toOracleBlob::userData() const throw()
     return QString("Datape: Oracle BLOB\nSize: %1B\n").arg(data.length());
 }
 
-QByteArray toOracleBlob::read(unsigned offset) const
+QByteArray toOracleBlob::readNext(oraub8 &start) const
 {
-    unsigned chunksize = data.getChunkSize();
-    char *buffer = (char*)malloc( chunksize ); // TODO use alloc here(or _alloc on MSVC)
-    unsigned int bytes_read;
-    try
+    oraub8 next;
+    _window.end(start, next);
+    if (next > getLength())
+    {
+        _window.store(QByteArray(), start, next);
+        return QByteArray();
+    }
+
+    // Read as many chunks as possible in one round-trip, but no more than rest of the LOB
+    oraub8 size = qMin((oraub8)data.getChunkSize() * MAXLOBCHUNKS, getLength() - next + 1);
+    QByteArray buffer(size, Qt::Uninitialized);
+    oraub8 bytes_read = 0;
     {
         ::trotl::SqlOpenLob blob_open(data, OCI_LOB_READONLY);
-        bytes_read = data.read(buffer, chunksize, offset + 1, chunksize);
+        bytes_read = data.read(buffer.data(), size, next, size);
     }
-    catch (const ::trotl::OciException &exc)
+    buffer.resize(bytes_read);
+    _window.store(buffer, start, next + bytes_read);
+    return buffer;
+}
+
+QByteArray toOracleBlob::read(unsigned offset) const
+{
+    try
     {
-        //if (exc.is_critical())
-        //    conn->Broken = true;
-        free(buffer);
-        ReThrowException(exc);
+        QByteArray ret;
+        if (_window.from(offset, ret))
+            return ret;
+        // BLOB offsets are byte offsets, jump directly to the requested position
+        _window.store(QByteArray(), offset, offset + 1);
+        oraub8 start;
+        return readNext(start); // empty at the end of LOB
     }
-    QByteArray retval(buffer, bytes_read);
-    free(buffer);
-    return retval;
+    ORA_CATCH
+    return QByteArray();
 }
@@ -41,18 +41,105 @@
 #include "trotl.h"
 #include "trotl_convertor.h"
 
+#include <QtCore/QMutex>
+#include <QtCore/QSharedPointer>
+
 #define MAXTOMAXLONG 30000
 #define MAXLOBSHOWN 64
+#define MAXLOBCHUNKS 16          // LOB chunks read by one OCILobRead2 call
+#define MAXLOBCACHE  0x1000000   // 16MB of LOB data cached per query
+
+class toOracleLobWindow;
+
+/** LOB data cache shared by all LOBs fetched by one query.
+ *  Each LOB keeps the last block it read (@ref toOracleLobWindow), the cache
+ *  only sums their sizes and drops least recently used blocks when over budget.
+ *  Windows are chained in a list ordered by last use, so registering a read
+ *  does not depend on number of LOBs fetched. Blocks of all windows are
+ *  guarded by Lock, as any read can drop block of another LOB.
+ */
+class toOracleLobCache
+{
+    public:
+        toOracleLobCache(qint64 budget = MAXLOBCACHE)
+            : Budget(budget)
+            , Used(0)
+            , First(NULL)
+            , Last(NULL)
+        {}
+
+    private:
+        friend class toOracleLobWindow;
+
+        /** Account new content of @p w and mark it as most recently used,
+         *  windows without data are removed from the list.
+         *  @p oldSize is size of the block it replaces. Lock must be held.
+         */
+        void touch(toOracleLobWindow *w, int oldSize);
+        /** Remove @p w from the list, Lock must be held */
+        void unlink(toOracleLobWindow *w);
+
+        QMutex Lock;
+        qint64 Budget, Used;
+        toOracleLobWindow *First, *Last; // least recently used first
+};
+
+/** Block of LOB data read by the last OCILobRead2 call.
+ *  Offsets are byte offsets as seen by @ref toQValue::complexType::read,
+ *  for CLOBs also the (1-based) character offset following the block is kept,
+ *  because OCI addresses CLOB content in characters.
+ *  The block can be dropped by the cache at any time, owners must not
+ *  expect it to still hold what they stored.
+ */
+class toOracleLobWindow
+{
+    public:
+        toOracleLobWindow(QSharedPointer<toOracleLobCache> const &cache)
+            : Start(0)
+            , NextChar(1)
+            , Prev(NULL)
+            , Next(NULL)
+            , Cache(cache)
+        {}
+
+        ~toOracleLobWindow();
+
+        /** Copy data from byte @p offset up to the end of block into @p data
+         *  @return false if @p offset is not within the block
+         */
+        bool from(oraub8 offset, QByteArray &data) const;
+
+        /** Byte offset following the block and OCI offset following it,
+         *  both are kept when the cache drops the block */
+        void end(oraub8 &offset, oraub8 &nextChar) const;
+
+        void store(QByteArray const &data, oraub8 start, oraub8 nextChar);
+
+    private:
+        friend class toOracleLobCache;
+
+        QMutex* mutex() const
+        {
+            return Cache ? &Cache->Lock : NULL;
+        }
+
+        QByteArray Data;
+        oraub8 Start;       // byte offset of Data
+        oraub8 NextChar;    // OCI (character for CLOB) offset following Data
+        toOracleLobWindow *Prev, *Next; // neighbours in the cache list
+        QSharedPointer<toOracleLobCache> Cache;
+};
 
 class toOracleClob: public toQValue::complexType
 {
     public:
-        toOracleClob(trotl::OciConnection &_conn)
+        toOracleClob(trotl::OciConnection &_conn, QSharedPointer<toOracleLobCache> const &cache = QSharedPointer<toOracleLobCache>())
             : toQValue::complexType()
             , data(_conn)
             , _length(0)
             , _displayData()
             , _toolTipData()
+            , _window(cache)
         {};
         /* virtual */
         bool isBinary() const
@@ -100,9 +187,16 @@ class toOracleClob: public toQValue::complexType
             return _length;
         };
 
-        mutable oraub8 _length; // NOTE: OCILobGetLength makes one roundtrip to the server
+        /** Read the block following the current window (or the first one)
+         *  @param start set to byte offset of the block read
+         *  @return the block, empty at the end of LOB
+         */
+        QByteArray readNext(oraub8 &start) const;
+
+        mutable oraub8 _length; // NOTE: OCILobGetLength makes one roundtrip to the server (unless prefetched)
         mutable QString _displayData;
         mutable QString _toolTipData;
+        mutable toOracleLobWindow _window;
         toOracleClob(toOracleClob const&);
         toOracleClob operator=(toOracleClob const&);
         //TODO copying prohibited
@@ -112,12 +206,13 @@ class toOracleClob: public toQValue::complexType
 class toOracleBlob: public toQValue::complexType
 {
     public:
-        toOracleBlob(trotl::OciConnection &_conn)
+        toOracleBlob(trotl::OciConnection &_conn, QSharedPointer<toOracleLobCache> const &cache = QSharedPointer<toOracleLobCache>())
             : toQValue::complexType()
             , data(_conn)
             , _length(0)
             , _displayData()
             , _toolTipData()
+            , _window(cache)
         {};
 
         bool isBinary() const
@@ -169,9 +264,16 @@ class toOracleBlob: public toQValue::complexType
             return _length;
         };
 
-        mutable oraub8 _length; // NOTE: OCILobGetLength makes one roundtrip to the server
+        /** Read the block following the current window (or the first one)
+         *  @param start set to byte offset of the block read
+         *  @return the block, empty at the end of LOB
+         */
+        QByteArray readNext(oraub8 &start) const;
+
+        mutable oraub8 _length; // NOTE: OCILobGetLength makes one roundtrip to the server (unless prefetched)
         mutable QString _displayData;
         mutable QString _toolTipData;
+        mutable toOracleLobWindow _window;
         toOracleBlob(toOracleBlob const&);
         toOracleBlob operator=(toOracleBlob const&);
         //TODO copying prohibited
@@ -0,0 +1,80 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#ifndef TOORACLEDEFINE_H
+#define TOORACLEDEFINE_H
+
+#include <QtCore/QString>
+
+/** Decoding of values from the buffers of character select list defines.
+ *
+ * Defines are fetched as arrays, a value of row @p row starts at @p values + @p row * @p valueSize.
+ * @p lengths is the array of fetched lengths (rlenp of OCIDefineByPos), in bytes for UTF-16 too.
+ * These do not need OCI, so they can be tested with recorded buffers.
+ */
+namespace toOracleDefine
+{
+    /** SQLT_CHR define in the client character set (UTF-8) */
+    inline QString charValue(const char *values, unsigned valueSize, const quint16 *lengths, unsigned row)
+    {
+        const char *buf = values + row * valueSize;
+        return QString::fromUtf8(buf, qstrnlen(buf, lengths[row]));
+    }
+
+    /** SQLT_STR define, null terminated */
+    inline QString varcharValue(const char *values, unsigned valueSize, unsigned row)
+    {
+        const char *buf = values + row * valueSize;
+        return QString::fromUtf8(buf, qstrnlen(buf, valueSize));
+    }
+
+    /** SQLT_CHR define in UTF-16 */
+    inline QString utf16CharValue(const char *values, unsigned valueSize, const quint16 *lengths, unsigned row)
+    {
+        const ushort *buf = (const ushort*)(values + row * valueSize);
+        return QString::fromUtf16(buf, lengths[row] / 2);
+    }
+
+    /** SQLT_STR define in UTF-16, null terminated by a zero code unit */
+    inline QString utf16VarcharValue(const char *values, unsigned valueSize, unsigned row)
+    {
+        const ushort *buf = (const ushort*)(values + row * valueSize);
+        int len = 0;
+        for (int max = valueSize / 2; len < max && buf[len]; len++)
+            ;
+        return QString::fromUtf16(buf, len);
+    }
+}
+
+#endif
@@ -35,6 +35,7 @@
 #include "connection/tooracleextract.h"
 #include "core/toconnectiontraits.h"
 #include "core/toconfiguration.h"
+#include "core/toinsertscript.h"
 #include "core/toquery.h"
 #include "core/tosql.h"
 #include "core/utils.h"
@@ -4680,69 +4681,56 @@ void toOracleExtract::createTableContents(const QString &owner, const QString &n
 
         toQColumnDescriptionList desc = query.describe();
         int cols = query.columns();
-        bool first = true;
         QString dateformat(toConfigurationNewSingle::Instance().option(ToConfiguration::Oracle::ConfDateFormat).toString());
 
-        QString beg = QString("INSERT INTO %1.%2 (").arg(quote(owner)).arg(quote(name));
+        QStringList columns;
         bool *dates = new bool[desc.size()];
         try
         {
             int num = 0;
             for (toQColumnDescriptionList::iterator i = desc.begin(); i != desc.end(); i++)
             {
-                if (first)
-                    first = false;
-                else
-                    beg += ",";
-                beg += (*i).Name;
+                columns << (*i).Name;
                 dates[num] = (*i).Datatype.contains("DATE");
                 num++;
             }
-            beg += ") VALUES (";
 
             QRegExp find("'");
 
-            int row = 0;
-            int maxRow = ext.getCommitDistance();
+            toInsertScript script(ext.connection(),
+                                  QString("%1.%2").arg(quote(owner)).arg(quote(name)),
+                                  columns,
+                                  (toInsertScript::Style) ext.getInsertStyle(),
+                                  ext.getInsertBatchRows(),
+                                  ext.getCommitDistance());
 
             while (!query.eof())
             {
-                QString line = beg;
-                first = true;
+                QStringList values;
                 for (int i = 0; i < cols; i++)
                 {
-                    if (first)
-                        first = false;
-                    else
-                        line += ",";
                     QString val = (QString)query.readValue();
                     if (dates[i])
                     {
                         if (val.isNull())
-                            line += "NULL";
+                            values << "NULL";
                         else
-                            line += QString("TO_DATE('%1','%2')").arg(val).arg(dateformat);
+                            values << QString("TO_DATE('%1','%2')").arg(val).arg(dateformat);
                     }
                     else
                     {
                         if (val.isNull())
-                            line += "NULL";
+                            values << "NULL";
                         else
                         {
                             val.replace(find, "''");
-                            line += "'";
-                            line += val;
-                            line += "'";
+                            values << "'" + val + "'";
                         }
                     };
                 }
-                line += ");\n";
-                stream << line;
-
-                row++;
-                if (maxRow > 0 && row % maxRow == 0)
-                    stream << "COMMIT;\n";
+                stream << script.addRow(values);
             }
+            stream << script.finish();
         }
         catch (...)
         {
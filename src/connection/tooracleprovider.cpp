@@ -139,6 +139,7 @@ bool toOracleProvider::initialize()
         ::trotl::g_OCIPL_MAX_LONG = toMaxLong;
 
         //::trotl::g_OCIPL_BULK_ROWS = toConfigurationSingle::Instance().
+        ::trotl::g_OCIPL_UTF16_DEFINES = toConfigurationNewSingle::Instance().option(ToConfiguration::Oracle::Utf16DefinesBool).toBool();
 
         dateFormat = toConfigurationNewSingle::Instance().option(ToConfiguration::Oracle::ConfDateFormat).toString().toLatin1();
         ::trotl::g_TROTL_DEFAULT_DATE_FTM = const_cast<char*>(dateFormat.constData());
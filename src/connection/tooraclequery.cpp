@@ -33,6 +33,9 @@
  * END_COMMON_COPYRIGHT_HEADER */
 
 #include "connection/tooraclequery.h"
+#include "connection/tooracledefine.h"
+
+#include <typeinfo>
 
 oracleQuery::oracleQuery(toQueryAbstr *query, toOracleConnectionSub *) : queryImpl(query)
 {
@@ -70,6 +73,8 @@ void oracleQuery::execute(void)
         sql.replace(stripnl, "");
 
         Query = new oracleQuery::trotlQuery(*conn->_conn, ::std::string(sql.toUtf8().constData()));
+        if (query()->fetchSize())
+            Query->set_fetch_rows(query()->fetchSize());
         TLOG(0, toDecorator, __HERE__) << "SQL(conn=" << conn->_conn << ", this=" << Query << "): " << ::std::string(sql.toUtf8().constData()) << std::endl;
         conn->_hasTransaction = toOracleConnectionSub::DIRTY_FLAG;
         // TODO autocommit ??
@@ -207,6 +212,135 @@ void oracleQuery::execute(QString const& sql)
     }
 }
 
+/* The statement is parsed only once, parameter rows are copied into array bind variables
+ * and sent to the server in chunks. Size of a chunk is limited by the array size declared
+ * in the bind variable placeholder, i.e. :f1<char[4000],in[500]> binds up to 500 rows.
+ * When errors are collected the chunks are executed with OCI_BATCH_ERRORS, so a failing
+ * row does not stop the rest of the chunk.
+ */
+int oracleQuery::executeBatch(QList<toQueryParams> const& rows, QString &error)
+{
+    toOracleConnectionSub *conn = dynamic_cast<toOracleConnectionSub*>(query()->connectionSubPtr());
+    if (!conn)
+        throw QString::fromLatin1("Internal error, not an Oracle sub connection");
+
+    int done = 0;
+    BatchAffected = 0;
+    BatchErrors.clear();
+    try
+    {
+        if (Cancel)
+            throw QString::fromLatin1("Query aborted before started");
+
+        if (Query == NULL)
+        {
+            QString sql = this->query()->sql();
+            sql.replace(QRegExp("\r"), "");
+            Query = new oracleQuery::trotlQuery(*conn->_conn, ::std::string(sql.toUtf8().constData()));
+            TLOG(0, toDecorator, __HERE__) << "SQL(conn=" << conn->_conn << ", this=" << Query << "): " << ::std::string(sql.toUtf8().constData()) << std::endl;
+        }
+        conn->_hasTransaction = toOracleConnectionSub::DIRTY_FLAG;
+        Running = true;
+        Query->set_batch_errors(CollectErrors);
+
+        unsigned chunk = Query->_in_cnt ? rows.size() : 1;
+        for (unsigned i = 1; i <= Query->_in_cnt; ++i)
+            chunk = qMin(chunk, (unsigned)Query->_all_binds[Query->_in_binds[i]]->_max_cnt);
+
+        while (done < rows.size())
+        {
+            int cnt = qMin((int)chunk, rows.size() - done);
+            Query->close(); // clear EXECUTED flag, rewind bind variables
+            if (Query->_in_cnt == 0)
+                Query->execute_internal(::trotl::g_OCIPL_BULK_ROWS, OCI_DEFAULT);
+
+            for (unsigned col = 0; col < Query->_in_cnt; ++col)
+            {
+                const ::trotl::BindPar& bp = (*Query).get_curr_in_bindpar();
+                // NULL indicators are passed with the values, the last bind variable executes the statement
+                std::vector<bool> nulls;
+                nulls.reserve(cnt);
+                for (int row = done; row < done + cnt; row++)
+                    nulls.push_back(rows.at(row).value(col).isNull());
+
+                if (bp._bind_typename == "int" || bp._bind_typename == "long"
+                        || bp._bind_typename == "uint" || bp._bind_typename == "ulong")
+                {
+                    std::vector<long> vals;
+                    vals.reserve(cnt);
+                    for (int row = done; row < done + cnt; row++)
+                        vals.push_back(rows.at(row).value(col).toLong());
+                    Query->bind_array(vals, nulls);
+                }
+                else if (bp._bind_typename == "double" || bp._bind_typename == "float")
+                {
+                    std::vector<double> vals;
+                    vals.reserve(cnt);
+                    for (int row = done; row < done + cnt; row++)
+                        vals.push_back(rows.at(row).value(col).toDouble());
+                    Query->bind_array(vals, nulls);
+                }
+                else if (bp._bind_typename == "char" || bp._bind_typename == "varchar")
+                {
+                    std::vector< ::trotl::tstring> vals;
+                    vals.reserve(cnt);
+                    for (int row = done; row < done + cnt; row++)
+                    {
+                        toQValue const& v = rows.at(row).value(col);
+                        vals.push_back(v.isNull() ? ::trotl::tstring() : ::trotl::tstring(((QString)v).toUtf8().constData()));
+                    }
+                    Query->bind_array(vals, nulls);
+                }
+                else
+                {
+                    throw toConnection::exception(
+                        QString::fromLatin1("Fatal pruser error - unsupported BindPar:%1\nFor SQL:\n%2\n")
+                        .arg(bp._bind_typename.c_str())
+                        .arg(query()->sql()));
+                }
+            }
+            BatchAffected += Query->row_count();
+            for (std::vector< ::trotl::SqlStatement::BatchError>::const_iterator it = Query->get_batch_errors().begin();
+                    it != Query->get_batch_errors().end();
+                    ++it)
+            {
+                BatchError err = { done + (int)it->row, QString::fromUtf8(it->message.c_str()) };
+                BatchErrors << err;
+            }
+            done += cnt;
+        }
+        Running = false;
+    }
+    catch (const ::trotl::OciException &exc)
+    {
+        Running = false;
+        if (exc.is_critical())
+        {
+            conn->Broken = true;
+            ReThrowException(exc);
+        }
+        // OCI stops array DML on the first failing row, rows before it were already processed.
+        // Every iteration of an INSERT affects one row, so the row count is the index of the failing row.
+        if (Query && (Query->_state & ::trotl::SqlStatement::STMT_ERROR)
+                && Query->get_stmt_type() == ::trotl::SqlStatement::STMT_INSERT)
+        {
+            try
+            {
+                unsigned processed = Query->row_count();
+                done += processed;
+                BatchAffected += processed;
+            }
+            catch (const ::trotl::OciException &)
+            {
+            }
+        }
+        error = QString::fromUtf8(exc.get_mesg());
+        delete Query;
+        Query = NULL;
+    }
+    return done;
+}
+
 toQValue oracleQuery::readValue(void)
 {
     toOracleConnectionSub *conn = dynamic_cast<toOracleConnectionSub*>(query()->connectionSubPtr());
@@ -287,6 +421,7 @@ oracleQuery::trotlQuery::trotlQuery(::trotl::OciConnection &conn,
                                     ub4 lang,
                                     int bulk_rows)
     : ::trotl::SqlStatement(conn, stmt, lang, bulk_rows)
+    , _lobCache(new toOracleLobCache())
 {
     // Be compatible with otl, execute some statements immediately
     if ( get_stmt_type() == STMT_ALTER
@@ -299,7 +434,8 @@ oracleQuery::trotlQuery::trotlQuery(::trotl::OciConnection &conn,
 void oracleQuery::trotlQuery::readValue(toQValue &value)
 {
     pre_read_value();
-    trotl::BindPar const &BP(get_stmt_type() == STMT_SELECT ?
+    bool select = get_stmt_type() == STMT_SELECT;
+    trotl::BindPar const &BP(select ?
                              get_next_column() :
                              get_next_out_bindpar());
 
@@ -308,176 +444,235 @@ void oracleQuery::trotlQuery::readValue(toQValue &value)
         value = toQValue();
         //TLOG(4, toDecorator, __HERE__) << "Just read: NULL" << std::endl;
     }
+    else if (select)
+    {
+        // Defines do not change for the statement, converters are chosen when the column is read first time
+        if (_readers.size() != _column_count + 1)
+            _readers.assign(_column_count + 1, Reader());
+        Reader &r = _readers[_out_pos];
+        if (!r)
+            r = reader(BP);
+        (this->*r)(BP, _last_buff_row, value);
+    }
     else
     {
-        switch (BP.dty)
-        {
-            case SQLT_NUM:
-            case SQLT_VNU:
-                {
-                    OCINumber* vnu = (OCINumber*) & ((char*)BP.valuep)[_last_buff_row * BP.value_sz ];
-                    sword res;
-                    boolean isint;
-                    res = OCINumberIsInt(_errh, vnu, &isint);
-                    oci_check_error(__HERE__, _errh, res);
-                    try
-                    {
-                        if (isint)
-                        {
-                            long long i;
-                            res = OCINumberToInt(_errh,
-                                                 vnu,
-                                                 sizeof(long long),
-                                                 OCI_NUMBER_SIGNED,
-                                                 &i);
-                            oci_check_error(__HERE__, _errh, res);
-                            value = toQValue(i);
-                            //TLOG(4, toDecorator, __HERE__) << "Just read: '" << i << '\'' << std::endl;
-                        }
-                        else
-                        {
-                            double d;
-                            sword res = OCINumberToReal(_errh,
-                                                        vnu,
-                                                        sizeof(double),
-                                                        &d);
-                            oci_check_error(__HERE__, _errh, res);
-                            value = toQValue(d);
-                            //TLOG(4, toDecorator, __HERE__) << "Just read: '" << d << '\'' << std::endl;
-                        }
-                    }
-                    catch (const ::trotl::OciException &e)
-                    {
-                        text str_buf[65];
-                        ub4 str_len = sizeof(str_buf) / sizeof(*str_buf);
-                        //const char fmt[]="99999999999999999999999999999999999999D00000000000000000000";
-                        const char fmt[] = "TM";
-                        sword res = OCINumberToText(_errh,
-                                                    vnu,
-                                                    (const oratext*)fmt,
-                                                    sizeof(fmt) - 1,
-                                                    0, // CONST OraText *nls_params,
-                                                    0, // ub4 nls_p_length,
-                                                    (ub4*)&str_len,
-                                                    str_buf );
-                        oci_check_error(__HERE__, _env._errh, res);
-                        str_buf[str_len + 1] = '\0';
-                        value = toQValue(QString::fromUtf8((const char*)str_buf));
-                    }
-                }
-                break;
-            case SQLT_NTY:
-                {
+        (this->*reader(BP))(BP, _last_buff_row, value);
+    }
+
+    post_read_value(BP);
+}
+
+oracleQuery::trotlQuery::Reader oracleQuery::trotlQuery::reader(::trotl::BindPar const &BP) const
+{
+    switch (BP.dty)
+    {
+        case SQLT_NUM:
+        case SQLT_VNU:
+            return &trotlQuery::readNumber;
+        case SQLT_NTY:
 #ifdef ORACLE_HAS_XML
-                    if ( ::trotl::BindParXML const *bpx = dynamic_cast<const trotl::BindParXML *>(&BP))
-                    {
-                        if ((xmlnode*)bpx->_xmlvaluep[_last_buff_row] == NULL)
-                        {
-                            value = toQValue();
-                            //TLOG(4, toDecorator, __HERE__) << "Just read: NULL XML" << std::endl;
-                        }
-                        else
-                        {
-                            std::string s(BP.get_string(_last_buff_row));
-                            value = toQValue(QString::fromUtf8(s.c_str()));
-                            //TLOG(4, toDecorator, __HERE__) << "Just read: \"" << s << "\"" << std::endl;
-                        }
-                    }
+            if (dynamic_cast<const trotl::BindParXML *>(&BP))
+                return &trotlQuery::readXml;
 #endif
-                    if ( ::trotl::BindParANYDATA const *bpa = dynamic_cast<const trotl::BindParANYDATA *>(&BP))
-                    {
-                        if ( bpa->_oan_buffer[_last_buff_row] == NULL)
-                        {
-                            value = toQValue();
-                        }
-                        else
-                        {
-                            std::string s(BP.get_string(_last_buff_row));
-                            value = toQValue(QString::fromUtf8(s.c_str()));
-                        }
-                    }
-                    else if ( ::trotl::BindParCollectionTabNum const *bpc = dynamic_cast<const trotl::BindParCollectionTabNum *>(&BP))
-                    {
-                        if ( *(sb2*)(bpc->_collection_indp[_last_buff_row]) == OCI_IND_NULL)
-                        {
-                            value = toQValue();
-                            //TLOG(4, toDecorator, __HERE__) << "Just read: NULL collection" << std::endl;
-                        }
-                        else
-                        {
-                            toOracleCollection *i = new toOracleCollection(_conn);
-                            trotl::ConvertorForRead c(_last_buff_row);
-                            trotl::DispatcherForRead::Go(BP, i->data, c);
-                            QVariant v;
-                            v.setValue((toQValue::complexType*)i);
-                            value = toQValue::fromVariant(v);
-                            //TLOG(4, toDecorator, __HERE__) << "Just read: collection:" << (::trotl::tstring)i->data << std::endl;
-                        }
-                    }
-                    else if ( ::trotl::BindParCollectionTabVarchar const *bpc = dynamic_cast<const trotl::BindParCollectionTabVarchar *>(&BP))
-                    {
-                        if ( *(sb2*)(bpc->_collection_indp[_last_buff_row]) == OCI_IND_NULL)
-                        {
-                            value = toQValue();
-                            //TLOG(4, toDecorator, __HERE__) << "Just read: NULL collection" << std::endl;
-                        }
-                        else
-                        {
-                            toOracleCollection *i = new toOracleCollection(_conn);
-                            trotl::ConvertorForRead c(_last_buff_row);
-                            trotl::DispatcherForRead::Go(BP, i->data, c);
-                            QVariant v;
-                            v.setValue((toQValue::complexType*)i);
-                            value = toQValue::fromVariant(v);
-                            //TLOG(4, toDecorator, __HERE__) << "Just read: collection:" << (::trotl::tstring)i->data << std::endl;
-                        }
-                    }
+            if (dynamic_cast<const trotl::BindParANYDATA *>(&BP))
+                return &trotlQuery::readAnyData;
+            if (dynamic_cast<const trotl::BindParCollectionTabNum *>(&BP))
+                return &trotlQuery::readCollection<trotl::BindParCollectionTabNum>;
+            if (dynamic_cast<const trotl::BindParCollectionTabVarchar *>(&BP))
+                return &trotlQuery::readCollection<trotl::BindParCollectionTabVarchar>;
+            return &trotlQuery::readUnknown;
+        case SQLT_CLOB:
+        case SQLT_CFILE:
+            return &trotlQuery::readClob;
+        case SQLT_BLOB:
+        case SQLT_BFILE:
+            return &trotlQuery::readBlob;
+        case SQLT_RSET:
+            return &trotlQuery::readCursor;
+        case SQLT_CHR:
+            // Plain character defines are decoded straight from the define buffer
+            if (BP._bind_type == trotl::BindPar::DEFINE_SELECT && typeid(BP) == typeid(trotl::BindParChar))
+                return static_cast<const trotl::BindParChar &>(BP)._utf16 ? &trotlQuery::readUtf16Char : &trotlQuery::readChar;
+            return &trotlQuery::readString;
+        case SQLT_STR:
+            if (BP._bind_type == trotl::BindPar::DEFINE_SELECT && typeid(BP) == typeid(trotl::BindParVarchar))
+                return static_cast<const trotl::BindParVarchar &>(BP)._utf16 ? &trotlQuery::readUtf16Varchar : &trotlQuery::readVarchar;
+            return &trotlQuery::readString;
+        default:
+            return &trotlQuery::readString;
+    }
+}
 
-                }
-                break;
-            case SQLT_CLOB:
-            case SQLT_CFILE:
-                {
-                    toOracleClob *i = new toOracleClob(_conn);
-                    trotl::ConvertorForRead c(_last_buff_row);
-                    trotl::DispatcherForRead::Go(BP, i->data, c);
-                    QVariant v;
-                    v.setValue((toQValue::complexType*)i);
-                    value = toQValue::fromVariant(v);
-                    //int id = qMetaTypeId<toQValue::complexType*>();
-                    //TLOG(4, toDecorator, __HERE__) << "Just read: \"CLOB\"" << std::endl;
-                }
-                break;
-            case SQLT_BLOB:
-            case SQLT_BFILE:
-                {
-                    toOracleBlob *i = new toOracleBlob(_conn);
-                    trotl::ConvertorForRead c(_last_buff_row);
-                    trotl::DispatcherForRead::Go(BP, i->data, c);
-                    QVariant v;
-                    v.setValue((toQValue::complexType*)i);
-                    value = toQValue::fromVariant(v);
-                    //TLOG(4, toDecorator, __HERE__) << "Just read: \"BLOB\"" << std::endl;
-                }
-                break;
-            case SQLT_RSET:
-                {
-                    toOracleCursor *i = new toOracleCursor();
-                    trotl::ConvertorForRead c(_last_buff_row);
-                    trotl::DispatcherForRead::Go(BP, i->data, c);
-                    QVariant v;
-                    v.setValue((toQValue::complexType*)i);
-                    value = toQValue::fromVariant(v);
-                    //TLOG(4, toDecorator, __HERE__) << "Just read: \"CURSOR\"" << std::endl;
-                }
-                break;
-            default:
-                std::string s(BP.get_string(_last_buff_row));
-                value = toQValue(QString::fromUtf8(s.c_str()));
-                //TLOG(4, toDecorator, __HERE__) << "Just read: \"" << s << "\"" << std::endl;
-                break;
+void oracleQuery::trotlQuery::readNumber(::trotl::BindPar const &BP, ub4 row, toQValue &value)
+{
+    OCINumber* vnu = (OCINumber*) & ((char*)BP.valuep)[row * BP.value_sz ];
+    sword res;
+    boolean isint;
+    res = OCINumberIsInt(_errh, vnu, &isint);
+    oci_check_error(__HERE__, _errh, res);
+    try
+    {
+        if (isint)
+        {
+            long long i;
+            res = OCINumberToInt(_errh,
+                                 vnu,
+                                 sizeof(long long),
+                                 OCI_NUMBER_SIGNED,
+                                 &i);
+            oci_check_error(__HERE__, _errh, res);
+            value = toQValue(i);
+            //TLOG(4, toDecorator, __HERE__) << "Just read: '" << i << '\'' << std::endl;
+        }
+        else
+        {
+            double d;
+            sword res = OCINumberToReal(_errh,
+                                        vnu,
+                                        sizeof(double),
+                                        &d);
+            oci_check_error(__HERE__, _errh, res);
+            value = toQValue(d);
+            //TLOG(4, toDecorator, __HERE__) << "Just read: '" << d << '\'' << std::endl;
         }
     }
+    catch (const ::trotl::OciException &e)
+    {
+        text str_buf[65];
+        ub4 str_len = sizeof(str_buf) / sizeof(*str_buf);
+        //const char fmt[]="99999999999999999999999999999999999999D00000000000000000000";
+        const char fmt[] = "TM";
+        sword res = OCINumberToText(_errh,
+                                    vnu,
+                                    (const oratext*)fmt,
+                                    sizeof(fmt) - 1,
+                                    0, // CONST OraText *nls_params,
+                                    0, // ub4 nls_p_length,
+                                    (ub4*)&str_len,
+                                    str_buf );
+        oci_check_error(__HERE__, _env._errh, res);
+        str_buf[str_len + 1] = '\0';
+        value = toQValue(QString::fromUtf8((const char*)str_buf));
+    }
+}
 
-    post_read_value(BP);
+void oracleQuery::trotlQuery::readChar(::trotl::BindPar const &BP, ub4 row, toQValue &value)
+{
+    value = toQValue(toOracleDefine::charValue((const char*)BP.valuep, BP.value_sz, (const quint16*)BP.rlenp, row));
+}
+
+void oracleQuery::trotlQuery::readVarchar(::trotl::BindPar const &BP, ub4 row, toQValue &value)
+{
+    value = toQValue(toOracleDefine::varcharValue((const char*)BP.valuep, BP.value_sz, row));
+}
+
+void oracleQuery::trotlQuery::readUtf16Char(::trotl::BindPar const &BP, ub4 row, toQValue &value)
+{
+    value = toQValue(toOracleDefine::utf16CharValue((const char*)BP.valuep, BP.value_sz, (const quint16*)BP.rlenp, row));
+}
+
+void oracleQuery::trotlQuery::readUtf16Varchar(::trotl::BindPar const &BP, ub4 row, toQValue &value)
+{
+    value = toQValue(toOracleDefine::utf16VarcharValue((const char*)BP.valuep, BP.value_sz, row));
+}
+
+void oracleQuery::trotlQuery::readString(::trotl::BindPar const &BP, ub4 row, toQValue &value)
+{
+    std::string s(BP.get_string(row));
+    value = toQValue(QString::fromUtf8(s.c_str()));
+    //TLOG(4, toDecorator, __HERE__) << "Just read: \"" << s << "\"" << std::endl;
+}
+
+void oracleQuery::trotlQuery::readXml(::trotl::BindPar const &BP, ub4 row, toQValue &value)
+{
+#ifdef ORACLE_HAS_XML
+    ::trotl::BindParXML const &bpx = static_cast<const trotl::BindParXML &>(BP);
+    if ((xmlnode*)bpx._xmlvaluep[row] == NULL)
+    {
+        value = toQValue();
+        //TLOG(4, toDecorator, __HERE__) << "Just read: NULL XML" << std::endl;
+    }
+    else
+    {
+        std::string s(BP.get_string(row));
+        value = toQValue(QString::fromUtf8(s.c_str()));
+        //TLOG(4, toDecorator, __HERE__) << "Just read: \"" << s << "\"" << std::endl;
+    }
+#else
+    value = toQValue();
+#endif
+}
+
+void oracleQuery::trotlQuery::readAnyData(::trotl::BindPar const &BP, ub4 row, toQValue &value)
+{
+    ::trotl::BindParANYDATA const &bpa = static_cast<const trotl::BindParANYDATA &>(BP);
+    if ( bpa._oan_buffer[row] == NULL)
+    {
+        value = toQValue();
+    }
+    else
+    {
+        std::string s(BP.get_string(row));
+        value = toQValue(QString::fromUtf8(s.c_str()));
+    }
+}
+
+template<class T>
+void oracleQuery::trotlQuery::readCollection(::trotl::BindPar const &BP, ub4 row, toQValue &value)
+{
+    T const &bpc = static_cast<const T &>(BP);
+    if ( *(sb2*)(bpc._collection_indp[row]) == OCI_IND_NULL)
+    {
+        value = toQValue();
+        //TLOG(4, toDecorator, __HERE__) << "Just read: NULL collection" << std::endl;
+    }
+    else
+    {
+        toOracleCollection *i = new toOracleCollection(_conn);
+        trotl::ConvertorForRead c(row);
+        trotl::DispatcherForRead::Go(BP, i->data, c);
+        QVariant v;
+        v.setValue((toQValue::complexType*)i);
+        value = toQValue::fromVariant(v);
+        //TLOG(4, toDecorator, __HERE__) << "Just read: collection:" << (::trotl::tstring)i->data << std::endl;
+    }
+}
+
+void oracleQuery::trotlQuery::readClob(::trotl::BindPar const &BP, ub4 row, toQValue &value)
+{
+    toOracleClob *i = new toOracleClob(_conn, _lobCache);
+    trotl::ConvertorForRead c(row);
+    trotl::DispatcherForRead::Go(BP, i->data, c);
+    QVariant v;
+    v.setValue((toQValue::complexType*)i);
+    value = toQValue::fromVariant(v);
+    //TLOG(4, toDecorator, __HERE__) << "Just read: \"CLOB\"" << std::endl;
+}
+
+void oracleQuery::trotlQuery::readBlob(::trotl::BindPar const &BP, ub4 row, toQValue &value)
+{
+    toOracleBlob *i = new toOracleBlob(_conn, _lobCache);
+    trotl::ConvertorForRead c(row);
+    trotl::DispatcherForRead::Go(BP, i->data, c);
+    QVariant v;
+    v.setValue((toQValue::complexType*)i);
+    value = toQValue::fromVariant(v);
+    //TLOG(4, toDecorator, __HERE__) << "Just read: \"BLOB\"" << std::endl;
+}
+
+void oracleQuery::trotlQuery::readCursor(::trotl::BindPar const &BP, ub4 row, toQValue &value)
+{
+    toOracleCursor *i = new toOracleCursor();
+    trotl::ConvertorForRead c(row);
+    trotl::DispatcherForRead::Go(BP, i->data, c);
+    QVariant v;
+    v.setValue((toQValue::complexType*)i);
+    value = toQValue::fromVariant(v);
+    //TLOG(4, toDecorator, __HERE__) << "Just read: \"CURSOR\"" << std::endl;
+}
+
+void oracleQuery::trotlQuery::readUnknown(::trotl::BindPar const &, ub4, toQValue &value)
+{
+    // object type without a known wrapper
+    value = toQValue();
 }
@@ -62,6 +62,35 @@ class oracleQuery : public queryImpl
                 trotlQuery(::trotl::OciConnection &conn, const ::trotl::tstring &stmt, ub4 lang = OCI_NTV_SYNTAX, int bulk_rows =::trotl::g_OCIPL_BULK_ROWS);
 
                 void readValue(toQValue &value);
+
+            private:
+                /** Converter of a single fetched value into toQValue.
+                 *  Chosen once per select list column, see @ref reader
+                 */
+                typedef void (trotlQuery::*Reader)(::trotl::BindPar const &BP, ub4 row, toQValue &value);
+
+                /** Choose converter for values of @p BP by its datatype and class */
+                Reader reader(::trotl::BindPar const &BP) const;
+
+                void readNumber(::trotl::BindPar const &BP, ub4 row, toQValue &value);
+                void readChar(::trotl::BindPar const &BP, ub4 row, toQValue &value);
+                void readVarchar(::trotl::BindPar const &BP, ub4 row, toQValue &value);
+                void readUtf16Char(::trotl::BindPar const &BP, ub4 row, toQValue &value);
+                void readUtf16Varchar(::trotl::BindPar const &BP, ub4 row, toQValue &value);
+                void readString(::trotl::BindPar const &BP, ub4 row, toQValue &value);
+                void readXml(::trotl::BindPar const &BP, ub4 row, toQValue &value);
+                void readAnyData(::trotl::BindPar const &BP, ub4 row, toQValue &value);
+                template<class T> void readCollection(::trotl::BindPar const &BP, ub4 row, toQValue &value);
+                void readClob(::trotl::BindPar const &BP, ub4 row, toQValue &value);
+                void readBlob(::trotl::BindPar const &BP, ub4 row, toQValue &value);
+                void readCursor(::trotl::BindPar const &BP, ub4 row, toQValue &value);
+                void readUnknown(::trotl::BindPar const &BP, ub4 row, toQValue &value);
+
+                // Converters of select list columns, indexed by column position
+                std::vector<Reader> _readers;
+
+                // Content of LOBs fetched by this statement
+                QSharedPointer<toOracleLobCache> _lobCache;
         };
         trotlQuery * Query;
 
@@ -73,6 +102,8 @@ class oracleQuery : public queryImpl
 
         virtual void execute(QString const&);
 
+        virtual int executeBatch(QList<toQueryParams> const& rows, QString &error);
+
         virtual toQValue readValue(void);
 
         virtual void cancel(void);
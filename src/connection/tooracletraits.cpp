@@ -39,6 +39,8 @@
 #include "core/toconnection.h"
 #include "editor/toworksheettext.h"
 
+#include <QtCore/QRegExp>
+
 /** Return a string representation to address an object.
 *
 * mrj: todo copied from tooracleconnection
@@ -123,6 +125,22 @@ QString toOracleTraits::schemaSwitchSQL(QString const & schema) const
     return ALTER_SESSION.arg(schema);
 }
 
+QString toOracleTraits::sessionSetupSQL(QStringList const& statements) const
+{
+    QString ret = QString::fromLatin1("BEGIN\n");
+    Q_FOREACH(QString sql, statements)
+    {
+        sql = sql.trimmed();
+        // the terminating semicolon belongs to PL/SQL blocks only
+        QString start = sql.section(QRegExp(QString::fromLatin1("\\s")), 0, 0).toUpper();
+        if (start != QLatin1String("BEGIN") && start != QLatin1String("DECLARE"))
+            while (sql.endsWith(QChar(';')))
+                sql.chop(1);
+        ret += QString::fromLatin1("  EXECUTE IMMEDIATE %1;\n").arg(quoteVarchar(sql));
+    }
+    return ret + QString::fromLatin1("END;");
+}
+
 QList<QString> toOracleTraits::primaryKeys(toConnection &conn, toCache::ObjectRef const&obj) const
 {
     static const QString ROWID(QString::fromLatin1("ROWID"));
@@ -134,3 +152,34 @@ QList<QString> toOracleTraits::primaryKeys(toConnection &conn, toCache::ObjectRe
     else
         return QList<QString>(); // no primary keys for views
 }
+
+toConnectionTraits::TypeClass toOracleTraits::typeClass(QString const& datatype, int &size, int &scale) const
+{
+    TypeClass ret = toConnectionTraits::typeClass(datatype, size, scale);
+    return ret == TYPE_DATE ? TYPE_TIMESTAMP : ret;
+}
+
+QString toOracleTraits::typeName(TypeClass type, int size, int scale) const
+{
+    switch (type)
+    {
+        case TYPE_INTEGER:
+            return QString::fromLatin1("NUMBER(%1)").arg(size > 0 ? size : 19);
+        case TYPE_DECIMAL:
+            if (size > 0)
+                return QString::fromLatin1("NUMBER(%1,%2)").arg(qMin(size, 38)).arg(scale);
+            return QString::fromLatin1("NUMBER");
+        case TYPE_FLOAT:
+            return QString::fromLatin1("BINARY_DOUBLE");
+        case TYPE_BOOLEAN:
+            return QString::fromLatin1("NUMBER(1)");
+        case TYPE_TEXT:
+            if (size > 0 && size <= 4000)
+                return QString::fromLatin1("VARCHAR2(%1 CHAR)").arg(size);
+            return QString::fromLatin1("CLOB");
+        case TYPE_BINARY:
+            return QString::fromLatin1("BLOB");
+        default:
+            return toConnectionTraits::typeName(type, size, scale);
+    }
+}
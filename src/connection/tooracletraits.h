@@ -60,6 +60,9 @@ class toOracleTraits: public toConnectionTraits
          */
         QString schemaSwitchSQL(QString const&) const override;
 
+        /** Anonymous block running each statement by EXECUTE IMMEDIATE */
+        QString sessionSetupSQL(QStringList const& statements) const override;
+
         /** Check if connection provider supports table level comments.
          *  @return bool return true if database supports table level comments
          *  See toSQL: toResultCols:TableComment
@@ -75,4 +78,9 @@ class toOracleTraits: public toConnectionTraits
         }
 
         QList<QString> primaryKeys(toConnection &, toCache::ObjectRef const&) const override;
+
+        /** Oracle DATE holds time of day too */
+        TypeClass typeClass(QString const& datatype, int &size, int &scale) const override;
+
+        QString typeName(TypeClass type, int size, int scale) const override;
 };
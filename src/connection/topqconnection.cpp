@@ -0,0 +1,236 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "connection/topqconnection.h"
+#include "connection/topqquery.h"
+#include "connection/topqcopy.h"
+#include "core/tologger.h"
+
+#include <QtCore/QIODevice>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QVector>
+
+toPQConnectionImpl::toPQConnectionImpl(toConnection &conn)
+    : toConnection::connectionImpl(conn)
+{
+}
+
+toConnectionSub *toPQConnectionImpl::createConnection(void)
+{
+    QByteArray host, port;
+    QString h = parentConnection().host();
+    int pos = h.indexOf(QString(":"));
+    if (pos < 0)
+        host = h.toUtf8();
+    else
+    {
+        host = h.mid(0, pos).toUtf8();
+        port = h.mid(pos + 1).toUtf8();
+    }
+    QByteArray database = parentConnection().database().toUtf8();
+    QByteArray user = parentConnection().user().toUtf8();
+    QByteArray password = parentConnection().password().toUtf8();
+
+    // Empty values are ignored by libpq, host defaults to the local socket. Other settings
+    // (sslmode, connect_timeout, ...) can be given by the usual PG* environment variables.
+    QVector<const char*> keywords, values;
+    keywords << "host" << "port" << "dbname" << "user" << "password" << "application_name" << "client_encoding";
+    values << host.constData() << port.constData() << database.constData() << user.constData() << password.constData()
+           << "TOra" << "UTF8";
+    keywords << NULL;
+    values << NULL;
+
+    PGconn *conn = PQconnectdbParams(keywords.constData(), values.constData(), 0);
+    if (!conn)
+        throw QString::fromLatin1("Out of memory while connecting to PostgreSQL");
+    if (PQstatus(conn) != CONNECTION_OK)
+    {
+        QString t = QString::fromUtf8(PQerrorMessage(conn)).trimmed();
+        PQfinish(conn);
+        throw t;
+    }
+    return new toPQConnectionSub(parentConnection(), conn);
+}
+
+void toPQConnectionImpl::closeConnection(toConnectionSub *)
+{
+}
+
+toPQConnectionSub::toPQConnectionSub(toConnection const& parent, PGconn *conn)
+    : Connection(conn)
+    , ParentConnection(parent)
+    , Cancel(PQgetCancel(conn))
+    , IntegerDatetimes(qstrcmp(PQparameterStatus(conn, "integer_datetimes"), "on") == 0)
+{
+}
+
+toPQConnectionSub::~toPQConnectionSub()
+{
+    if (Cancel)
+        PQfreeCancel(Cancel);
+    PQfinish(Connection);
+}
+
+QTimeZone const& toPQConnectionSub::timeZone(void)
+{
+    // reported by the server whenever it changes (SET TIME ZONE)
+    QByteArray name(PQparameterStatus(Connection, "TimeZone"));
+    if (name != ZoneName)
+    {
+        ZoneName = name;
+        Zone = name.isEmpty() ? QTimeZone() : QTimeZone(name);
+    }
+    return Zone;
+}
+
+void toPQConnectionSub::cancel(void)
+{
+    if (!Cancel)
+        return;
+    char errbuf[256];
+    if (!PQcancel(Cancel, errbuf, sizeof(errbuf)))
+        TLOG(1, toDecorator, __HERE__) << "	PQcancel failed: " << errbuf << std::endl;
+}
+
+void toPQConnectionSub::close(void)
+{
+}
+
+void toPQConnectionSub::commit(void)
+{
+    exec(QString::fromLatin1("COMMIT"));
+}
+
+void toPQConnectionSub::rollback(void)
+{
+    exec(QString::fromLatin1("ROLLBACK"));
+}
+
+QString toPQConnectionSub::version()
+{
+    // 90605 => 0906, 120003 => 1200 (since 10 the second number is the minor release)
+    int ver = PQserverVersion(Connection);
+    int major = ver / 10000;
+    int minor = ver >= 100000 ? 0 : (ver / 100) % 100;
+    QString retval = QString::fromLatin1("%1%2").arg(major, 2, 10, QChar('0')).arg(minor, 2, 10, QChar('0'));
+    TLOG(5, toDecorator, __HERE__) << "PQ Connection version: " << retval << std::endl;
+    return retval;
+}
+
+toQueryParams toPQConnectionSub::sessionId()
+{
+    return toQueryParams() << QString::number(PQbackendPID(Connection));
+}
+
+queryImpl* toPQConnectionSub::createQuery(toQueryAbstr *query)
+{
+    return new pqQuery(query, this);
+}
+
+void toPQConnectionSub::exec(QString const& sql)
+{
+    QMutexLocker lock(&Lock);
+    PGresult *res = PQexec(Connection, sql.toUtf8().constData());
+    ExecStatusType status = PQresultStatus(res);
+    if (status != PGRES_COMMAND_OK && status != PGRES_TUPLES_OK)
+    {
+        QString err = errorString(res, sql);
+        PQclear(res);
+        throw err;
+    }
+    PQclear(res);
+}
+
+QString toPQConnectionSub::errorString(PGresult const *res, QString const& sql) const
+{
+    QString ret = QString::fromUtf8(res ? PQresultErrorMessage(res) : PQerrorMessage(Connection)).trimmed();
+    if (ret.isEmpty())
+        ret = QString::fromLatin1("Unknown error");
+    if (!sql.isEmpty())
+        ret += QString::fromLatin1("\n\n") + sql;
+    return ret;
+}
+
+toBulkLoad* toPQConnectionSub::createBulkLoad(QString const& table, QStringList const& columns, int bufferSize, bool binary)
+{
+    return new toPQBulkLoad(Connection, Lock, table, columns, bufferSize, binary);
+}
+
+qint64 toPQConnectionSub::exportCsv(QString const& sql, QChar separator, QChar quote, bool header, QIODevice &out)
+{
+    QString select = sql.trimmed();
+    while (select.endsWith(QChar(';')))
+        select = select.left(select.size() - 1).trimmed();
+    QString sep = separator == QChar('\'') ? QString::fromLatin1("''") : QString(separator);
+    QString quo = quote == QChar('\'') ? QString::fromLatin1("''") : QString(quote);
+    QString copy = QString::fromLatin1("COPY (%1) TO STDOUT WITH (FORMAT csv, HEADER %2, DELIMITER '%3', QUOTE '%4')")
+                   .arg(select, header ? QString::fromLatin1("true") : QString::fromLatin1("false"), sep, quo);
+
+    QMutexLocker lock(&Lock);
+    PGresult *res = PQexec(Connection, copy.toUtf8().constData());
+    if (PQresultStatus(res) != PGRES_COPY_OUT)
+    {
+        // not a query COPY accepts (or old server), the caller falls back to the row by row export
+        TLOG(2, toDecorator, __HERE__) << "	COPY not possible: " << errorString(res) << std::endl;
+        PQclear(res);
+        return -1;
+    }
+    PQclear(res);
+
+    qint64 total = 0;
+    QString error;
+    char *buf;
+    int len;
+    while ((len = PQgetCopyData(Connection, &buf, 0)) > 0)
+    {
+        if (error.isEmpty() && out.write(buf, len) != len)
+        {
+            // keep reading until the end of the copy, the connection must not be left in COPY state
+            error = out.errorString();
+            cancel();
+        }
+        total += len;
+        PQfreemem(buf);
+    }
+
+    while ((res = PQgetResult(Connection)) != NULL)
+    {
+        if (PQresultStatus(res) != PGRES_COMMAND_OK && error.isEmpty())
+            error = errorString(res, copy);
+        PQclear(res);
+    }
+    if (!error.isEmpty())
+        throw error;
+    return total;
+}
@@ -0,0 +1,127 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include "core/toconnection.h"
+#include "core/toconnectionsub.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QString>
+#include <QtCore/QMutex>
+#include <QtCore/QTimeZone>
+
+#include <libpq-fe.h>
+
+/** PostgreSQL connection talking to libpq directly, without QSql.
+ *  Used by the QPSQL provider when the "Native libpq" option is set (or no QPSQL driver is available),
+ *  so all the PostgreSQL specific SQL of the tools is shared with the QSql based connection.
+ */
+class toPQConnectionImpl: public toConnection::connectionImpl
+{
+        friend class toQPSqlProvider;
+    protected:
+        toPQConnectionImpl(toConnection &conn);
+    public:
+        /** Create a new connection to the database. */
+        toConnectionSub *createConnection(void) override;
+
+        /** Close a connection to the database. */
+        void closeConnection(toConnectionSub *) override;
+};
+
+class toPQConnectionSub : public toConnectionSub
+{
+        friend class toPQConnectionImpl;
+    public:
+        toPQConnectionSub(toConnection const& parent, PGconn *conn);
+        ~toPQConnectionSub();
+
+        /** Sends cancel request using PQcancel, can be called from any thread */
+        void cancel(void) override;
+        void close(void) override;
+        void commit(void) override;
+        void rollback(void) override;
+
+        QString version() override;
+        toQueryParams sessionId() override;
+
+        queryImpl* createQuery(toQueryAbstr *query) override;
+
+        toQAdditionalDescriptions* decribe(toCache::ObjectRef const&) override
+        {
+            return NULL;
+        }
+
+        /** Export using COPY (...) TO STDOUT, see @ref toConnectionSub::exportCsv */
+        qint64 exportCsv(QString const& sql, QChar separator, QChar quote, bool header, QIODevice &out) override;
+
+        /** Load using COPY ... FROM STDIN, see @ref toPQBulkLoad */
+        toBulkLoad* createBulkLoad(QString const& table, QStringList const& columns, int bufferSize, bool binary) override;
+
+        /** Execute a statement not returning rows, throws on error */
+        void exec(QString const& sql);
+
+        /** Error message of the connection (or of @p res when given) with optional SQL appended */
+        QString errorString(PGresult const *res = NULL, QString const& sql = QString::null) const;
+
+        /** True when the server sends timestamps as 64bit integers (all servers since 8.4 by default) */
+        bool integerDatetimes(void) const
+        {
+            return IntegerDatetimes;
+        }
+
+        /** Time zone of the session (its TimeZone parameter), invalid when Qt does not know it.
+         *  Must be called with the connection locked.
+         */
+        QTimeZone const& timeZone(void);
+
+        /** Serializes the use of the connection between the query owning it and commit/rollback,
+         *  held for the whole round trip (or fetch of a chunk of rows), never for a single value.
+         */
+        QMutex Lock;
+        PGconn *Connection;
+
+        /** Result format learned from the first execution of a statement on this session, true when
+         *  all its columns can be read in binary format, see @ref pqQuery. Used with the connection locked.
+         */
+        QHash<QString, bool> ResultFormats;
+    private:
+        toConnection const& ParentConnection;
+        PGcancel *Cancel;
+        bool IntegerDatetimes;
+        QByteArray ZoneName;
+        QTimeZone Zone;
+};
@@ -0,0 +1,398 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "connection/topqcopy.h"
+#include "core/tologger.h"
+#include "core/utils.h"
+
+#include <QtCore/QMutexLocker>
+#include <QtCore/QtEndian>
+
+#include <cstring>
+
+// Types with a binary representation written by appendBinary (from pg_type.h)
+enum
+{
+    BOOLOID         = 16,
+    BYTEAOID        = 17,
+    INT8OID         = 20,
+    INT2OID         = 21,
+    INT4OID         = 23,
+    TEXTOID         = 25,
+    FLOAT4OID       = 700,
+    FLOAT8OID       = 701,
+    BPCHAROID       = 1042,
+    VARCHAROID      = 1043
+};
+
+static bool binaryType(Oid type)
+{
+    switch (type)
+    {
+        case BOOLOID:
+        case BYTEAOID:
+        case INT8OID:
+        case INT2OID:
+        case INT4OID:
+        case TEXTOID:
+        case FLOAT4OID:
+        case FLOAT8OID:
+        case BPCHAROID:
+        case VARCHAROID:
+            return true;
+        default:
+            return false;
+    }
+}
+
+template <typename T> static inline void appendNetwork(QByteArray &buf, T value)
+{
+    T net = qToBigEndian(value);
+    buf.append(reinterpret_cast<const char*>(&net), sizeof(T));
+}
+
+toPQBulkLoad::toPQBulkLoad(PGconn *conn, QMutex &lock, QString const& table, QStringList const& columns, int bufferSize, bool binary)
+    : Connection(conn)
+    , Lock(lock)
+    , BufferSize(qMax(bufferSize, 4096))
+    , Binary(binary)
+    , Active(false)
+    , Rows(0)
+    , Sent(0)
+{
+    describe(table, columns);
+    for (int i = 0; i < Types.size() && Binary; i++)
+        Binary = binaryType(Types.at(i));
+
+    SQL = QString::fromLatin1("COPY %1 (%2) FROM STDIN WITH (FORMAT %3)")
+          .arg(table)
+          .arg(columns.join(QString::fromLatin1(", ")))
+          .arg(Binary ? QString::fromLatin1("binary") : QString::fromLatin1("text"));
+
+    QMutexLocker locker(&Lock);
+    PGresult *res = PQexec(Connection, SQL.toUtf8().constData());
+    if (PQresultStatus(res) != PGRES_COPY_IN)
+    {
+        QString err = errorString(res);
+        PQclear(res);
+        throw err;
+    }
+    PQclear(res);
+    Active = true;
+
+    Buffer.reserve(BufferSize + 1024);
+    if (Binary)
+    {
+        // signature, flags and header extension length
+        Buffer.append("PGCOPY\n\377\r\n\0", 11);
+        appendNetwork<qint32>(Buffer, 0);
+        appendNetwork<qint32>(Buffer, 0);
+    }
+}
+
+toPQBulkLoad::~toPQBulkLoad()
+{
+    if (Active)
+    {
+        try
+        {
+            abort(QString::fromLatin1("Load cancelled"));
+        }
+        catch (...)
+        {
+            TLOG(1, toDecorator, __HERE__) << "	Ignored exception." << std::endl;
+        }
+    }
+}
+
+void toPQBulkLoad::describe(QString const& table, QStringList const& columns)
+{
+    QString sql = QString::fromLatin1("SELECT %1 FROM %2 WHERE 1=0").arg(columns.join(QString::fromLatin1(", "))).arg(table);
+
+    QMutexLocker locker(&Lock);
+    PGresult *res = PQexec(Connection, sql.toUtf8().constData());
+    if (PQresultStatus(res) != PGRES_TUPLES_OK)
+    {
+        QString err = errorString(res);
+        PQclear(res);
+        throw err;
+    }
+    Types.resize(PQnfields(res));
+    for (int i = 0; i < Types.size(); i++)
+        Types[i] = PQftype(res, i);
+    PQclear(res);
+}
+
+void toPQBulkLoad::addRow(toQueryParams const& row)
+{
+    if (!Active)
+        throw QString::fromLatin1("COPY is not in progress");
+    if (row.size() != Types.size())
+        throw QString::fromLatin1("Expected %1 values for COPY, got %2").arg(Types.size()).arg(row.size());
+
+    if (Binary)
+    {
+        appendNetwork<qint16>(Buffer, Types.size());
+        for (int i = 0; i < row.size(); i++)
+            appendBinary(i, row.at(i));
+    }
+    else
+    {
+        for (int i = 0; i < row.size(); i++)
+        {
+            if (i > 0)
+                Buffer.append('\t');
+            appendText(row.at(i));
+        }
+        Buffer.append('\n');
+    }
+    Rows++;
+
+    if (Buffer.size() >= BufferSize)
+        flush();
+}
+
+void toPQBulkLoad::appendText(toQValue const& value)
+{
+    if (value.isNull())
+    {
+        Buffer.append("\\N", 2);
+        return;
+    }
+
+    QByteArray data;
+    if (value.isBinary())
+        data = "\\x" + value.toByteArray().toHex();     // bytea hex format
+    else
+        data = value.toQVariant().toString().toUtf8();
+
+    const char *p = data.constData();
+    for (int i = 0; i < data.size(); i++)
+    {
+        switch (p[i])
+        {
+            case '\\':
+                Buffer.append("\\\\", 2);
+                break;
+            case '\t':
+                Buffer.append("\\t", 2);
+                break;
+            case '\n':
+                Buffer.append("\\n", 2);
+                break;
+            case '\r':
+                Buffer.append("\\r", 2);
+                break;
+            default:
+                Buffer.append(p[i]);
+        }
+    }
+}
+
+void toPQBulkLoad::appendBinary(int column, toQValue const& value)
+{
+    if (value.isNull())
+    {
+        appendNetwork<qint32>(Buffer, -1);
+        return;
+    }
+
+    QVariant v = value.toQVariant();
+    bool ok = true;
+    switch (Types.at(column))
+    {
+        case BOOLOID:
+            {
+                // the spellings accepted by the boolean input function of PostgreSQL
+                QString s = v.toString().trimmed().toLower();
+                bool b = v.toBool();
+                if (v.type() != QVariant::Bool)
+                {
+                    if (s == QLatin1String("t") || s == QLatin1String("true") || s == QLatin1String("y")
+                            || s == QLatin1String("yes") || s == QLatin1String("on") || s == QLatin1String("1"))
+                        b = true;
+                    else if (s == QLatin1String("f") || s == QLatin1String("false") || s == QLatin1String("n")
+                             || s == QLatin1String("no") || s == QLatin1String("off") || s == QLatin1String("0"))
+                        b = false;
+                    else
+                        ok = false;
+                }
+                appendNetwork<qint32>(Buffer, 1);
+                Buffer.append(b ? '\1' : '\0');
+            }
+            break;
+        case INT2OID:
+            {
+                int i = v.toInt(&ok);
+                ok = ok && i >= -32768 && i <= 32767;
+                appendNetwork<qint32>(Buffer, 2);
+                appendNetwork<qint16>(Buffer, (qint16) i);
+            }
+            break;
+        case INT4OID:
+            {
+                int i = v.toInt(&ok);
+                appendNetwork<qint32>(Buffer, 4);
+                appendNetwork<qint32>(Buffer, i);
+            }
+            break;
+        case INT8OID:
+            {
+                qlonglong l = v.toLongLong(&ok);
+                appendNetwork<qint32>(Buffer, 8);
+                appendNetwork<qint64>(Buffer, l);
+            }
+            break;
+        case FLOAT4OID:
+            {
+                float f = (float) v.toDouble(&ok);
+                quint32 bits;
+                std::memcpy(&bits, &f, sizeof(bits));
+                appendNetwork<qint32>(Buffer, 4);
+                appendNetwork<quint32>(Buffer, bits);
+            }
+            break;
+        case FLOAT8OID:
+            {
+                double d = v.toDouble(&ok);
+                quint64 bits;
+                std::memcpy(&bits, &d, sizeof(bits));
+                appendNetwork<qint32>(Buffer, 8);
+                appendNetwork<quint64>(Buffer, bits);
+            }
+            break;
+        case BYTEAOID:
+            {
+                QByteArray data;
+                if (value.isBinary())
+                    data = value.toByteArray();
+                else
+                {
+                    QString s = v.toString();
+                    data = s.startsWith(QLatin1String("\\x")) ? QByteArray::fromHex(s.mid(2).toLatin1()) : s.toUtf8();
+                }
+                appendNetwork<qint32>(Buffer, data.size());
+                Buffer.append(data);
+            }
+            break;
+        default: // text types
+            {
+                QByteArray data = v.toString().toUtf8();
+                appendNetwork<qint32>(Buffer, data.size());
+                Buffer.append(data);
+            }
+            break;
+    }
+    if (!ok)
+    {
+        // the row is half written, the whole load has to be abandoned
+        QString err = QString::fromLatin1("Invalid value \"%1\" for column %2 of row %3").arg(v.toString()).arg(column + 1).arg(Rows + 1);
+        abort(err);
+        throw err;
+    }
+}
+
+void toPQBulkLoad::flush(void)
+{
+    if (Buffer.isEmpty())
+        return;
+
+    QMutexLocker locker(&Lock);
+    if (PQputCopyData(Connection, Buffer.constData(), Buffer.size()) != 1)
+    {
+        QString err = errorString();
+        locker.unlock();
+        abort(err);
+        throw err;
+    }
+    Sent += Buffer.size();
+    Buffer.resize(0);
+}
+
+qint64 toPQBulkLoad::finish(void)
+{
+    if (!Active)
+        throw QString::fromLatin1("COPY is not in progress");
+    if (Binary)
+        appendNetwork<qint16>(Buffer, -1);     // file trailer
+    flush();
+
+    QMutexLocker locker(&Lock);
+    Active = false;
+    QString err;
+    if (PQputCopyEnd(Connection, NULL) != 1)
+        err = errorString();
+
+    // the server reports bad data only now, COPY is all or nothing
+    qint64 ret = Rows;
+    PGresult *res;
+    while ((res = PQgetResult(Connection)) != NULL)
+    {
+        if (PQresultStatus(res) != PGRES_COMMAND_OK)
+        {
+            if (err.isEmpty())
+                err = errorString(res);
+        }
+        else if (*PQcmdTuples(res))
+            ret = QString::fromLatin1(PQcmdTuples(res)).toLongLong();
+        PQclear(res);
+    }
+    if (!err.isEmpty())
+        throw err;
+    return ret;
+}
+
+void toPQBulkLoad::abort(QString const& reason)
+{
+    if (!Active)
+        return;
+
+    QMutexLocker locker(&Lock);
+    Active = false;
+    Buffer.clear();
+    PQputCopyEnd(Connection, reason.toUtf8().constData());
+    PGresult *res;
+    while ((res = PQgetResult(Connection)) != NULL)
+        PQclear(res); // the error caused by the abort
+}
+
+QString toPQBulkLoad::errorString(PGresult const *res) const
+{
+    QString ret = QString::fromUtf8(res ? PQresultErrorMessage(res) : PQerrorMessage(Connection)).trimmed();
+    if (ret.isEmpty())
+        ret = QString::fromLatin1("Unknown error");
+    if (!SQL.isEmpty())
+        ret += QString::fromLatin1("\n\n") + SQL;
+    return ret;
+}
@@ -0,0 +1,93 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include "core/toconnectionsub.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QMutex>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#include <libpq-fe.h>
+
+/** Bulk load of a PostgreSQL table using COPY ... FROM STDIN.
+ *  Works on any libpq connection, both the native one (toPQConnectionSub) and the handle
+ *  of the QPSQL driver (toQPSqlConnectionSub).
+ *  Binary format is used only when asked for and all the columns have a type encoded here,
+ *  the text format is used otherwise.
+ */
+class toPQBulkLoad : public toBulkLoad
+{
+    public:
+        /** Starts the COPY, throws when the table (or columns) can not be loaded.
+         * @param lock mutex serializing the use of @p conn, locked while talking to the server
+         * @param columns column names, quoted as needed
+         */
+        toPQBulkLoad(PGconn *conn, QMutex &lock, QString const& table, QStringList const& columns, int bufferSize, bool binary);
+        ~toPQBulkLoad();
+
+        void addRow(toQueryParams const& row) override;
+        qint64 finish(void) override;
+        void abort(QString const& reason) override;
+
+        qint64 bytesSent(void) const override
+        {
+            return Sent;
+        }
+
+        bool isBinary(void) const
+        {
+            return Binary;
+        }
+    private:
+        /** Column types of the target, to decide on the format and encode binary values */
+        void describe(QString const& table, QStringList const& columns);
+        void flush(void);
+        void appendText(toQValue const& value);
+        void appendBinary(int column, toQValue const& value);
+        QString errorString(PGresult const *res = NULL) const;
+
+        PGconn *Connection;
+        QMutex &Lock;
+        QString SQL;
+        QVector<Oid> Types;
+        QByteArray Buffer;
+        int BufferSize;
+        bool Binary;
+        bool Active;
+        qint64 Rows;
+        qint64 Sent;
+};
@@ -0,0 +1,117 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+
+#include "connection/topqdecode.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QtEndian>
+
+#include <limits>
+
+QString toPQDecode::numeric(const uchar *data)
+{
+    int ndigits = qFromBigEndian<qint16>(data);
+    int weight = qFromBigEndian<qint16>(data + 2);
+    quint16 sign = qFromBigEndian<quint16>(data + 4);
+    int dscale = qFromBigEndian<qint16>(data + 6);
+    switch (sign)
+    {
+        case 0xC000:
+            return QString::fromLatin1("NaN");
+        case 0xD000:
+            return QString::fromLatin1("Infinity");
+        case 0xF000:
+            return QString::fromLatin1("-Infinity");
+    }
+
+    QString ret;
+    if (sign == 0x4000)
+        ret += QChar('-');
+    if (weight < 0)
+        ret += QChar('0');
+    for (int i = 0; i <= weight; i++)
+    {
+        int d = i < ndigits ? qFromBigEndian<qint16>(data + 8 + 2 * i) : 0;
+        ret += i == 0 ? QString::number(d) : QString::fromLatin1("%1").arg(d, 4, 10, QChar('0'));
+    }
+    if (dscale > 0)
+    {
+        QString frac;
+        for (int i = weight + 1; frac.size() < dscale; i++)
+        {
+            int d = (i >= 0 && i < ndigits) ? qFromBigEndian<qint16>(data + 8 + 2 * i) : 0;
+            frac += QString::fromLatin1("%1").arg(d, 4, 10, QChar('0'));
+        }
+        ret += QChar('.') + frac.left(dscale);
+    }
+    return ret;
+}
+
+QString toPQDecode::timestamp(qint64 usec, bool tz, QTimeZone const& zone)
+{
+    if (usec == std::numeric_limits<qint64>::max())
+        return QString::fromLatin1("infinity");
+    if (usec == std::numeric_limits<qint64>::min())
+        return QString::fromLatin1("-infinity");
+
+    qint64 frac = usec % 1000000;
+    qint64 secs = usec / 1000000;
+    if (frac < 0)
+    {
+        frac += 1000000;
+        secs--;
+    }
+    QDateTime ts = QDateTime(QDate(2000, 1, 1), QTime(0, 0), Qt::UTC).addSecs(secs);
+    if (tz && zone.isValid())
+        ts = ts.toTimeZone(zone);
+    QString ret = ts.toString(QString::fromLatin1("yyyy-MM-dd hh:mm:ss"));
+    if (frac)
+    {
+        QString f = QString::fromLatin1("%1").arg(frac, 6, 10, QChar('0'));
+        while (f.endsWith(QChar('0')))
+            f.chop(1);
+        ret += QChar('.') + f;
+    }
+    if (tz)
+    {
+        int offset = ts.offsetFromUtc();
+        ret += offset < 0 ? QChar('-') : QChar('+');
+        offset = qAbs(offset);
+        ret += QString::fromLatin1("%1").arg(offset / 3600, 2, 10, QChar('0'));
+        if (offset % 3600)
+            ret += QString::fromLatin1(":%1").arg((offset % 3600) / 60, 2, 10, QChar('0'));
+        if (offset % 60)
+            ret += QString::fromLatin1(":%1").arg(offset % 60, 2, 10, QChar('0'));
+    }
+    return ret;
+}
@@ -0,0 +1,52 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QTimeZone>
+
+/** Values of PostgreSQL binary results without a Qt counterpart, formatted the way the server
+ *  formats them in text results. Kept apart from the query so they can be tested without a server.
+ */
+namespace toPQDecode
+{
+    /** Binary numeric: ndigits, weight, sign, dscale and ndigits base 10000 digits, all int16 big endian */
+    QString numeric(const uchar *data);
+
+    /** Binary timestamp: microseconds since 2000-01-01.
+     * @param tz timestamp with time zone, shown in @p zone (the TimeZone of the session).
+     *        When Qt does not know the zone the time is shown in UTC, which is still the same instant.
+     */
+    QString timestamp(qint64 usec, bool tz, QTimeZone const& zone = QTimeZone());
+}
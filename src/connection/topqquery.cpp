@@ -0,0 +1,551 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "connection/topqquery.h"
+#include "connection/topqconnection.h"
+#include "connection/topqdecode.h"
+#include "core/tologger.h"
+#include "core/utils.h"
+#include "connection/toqsqlbindtemplate.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QVector>
+#include <QtCore/QtEndian>
+
+#include <cstring>
+#include <limits>
+
+// Number of rows taken from the server at once in chunked mode
+#define PQ_CHUNK_ROWS 256
+
+// Statements whose result format is remembered per session
+#define PQ_RESULT_FORMATS 256
+
+// Datatypes (from pg_type.h) decoded here
+enum
+{
+    BOOLOID         = 16,
+    BYTEAOID        = 17,
+    CHAROID         = 18,
+    NAMEOID         = 19,
+    INT8OID         = 20,
+    INT2OID         = 21,
+    INT4OID         = 23,
+    TEXTOID         = 25,
+    OIDOID          = 26,
+    JSONOID         = 114,
+    FLOAT4OID       = 700,
+    FLOAT8OID       = 701,
+    UNKNOWNOID      = 705,
+    BPCHAROID       = 1042,
+    VARCHAROID      = 1043,
+    DATEOID         = 1082,
+    TIMEOID         = 1083,
+    TIMESTAMPOID    = 1114,
+    TIMESTAMPTZOID  = 1184,
+    INTERVALOID     = 1186,
+    NUMERICOID      = 1700
+};
+
+static bool hasBinaryDecoder(Oid type, bool integerDatetimes)
+{
+    switch (type)
+    {
+        case BOOLOID:
+        case BYTEAOID:
+        case CHAROID:
+        case NAMEOID:
+        case INT8OID:
+        case INT2OID:
+        case INT4OID:
+        case TEXTOID:
+        case OIDOID:
+        case JSONOID:
+        case FLOAT4OID:
+        case FLOAT8OID:
+        case UNKNOWNOID:
+        case BPCHAROID:
+        case VARCHAROID:
+        case DATEOID:
+        case NUMERICOID:
+            return true;
+        case TIMESTAMPOID:
+        case TIMESTAMPTZOID:
+            return integerDatetimes;
+        default:
+            return false;
+    }
+}
+
+static QString typeName(Oid type, int mod)
+{
+    switch (type)
+    {
+        case BOOLOID:
+            return QString::fromLatin1("boolean");
+        case BYTEAOID:
+            return QString::fromLatin1("bytea");
+        case CHAROID:
+            return QString::fromLatin1("\"char\"");
+        case NAMEOID:
+            return QString::fromLatin1("name");
+        case INT8OID:
+            return QString::fromLatin1("bigint");
+        case INT2OID:
+            return QString::fromLatin1("smallint");
+        case INT4OID:
+            return QString::fromLatin1("integer");
+        case TEXTOID:
+            return QString::fromLatin1("text");
+        case OIDOID:
+            return QString::fromLatin1("oid");
+        case JSONOID:
+            return QString::fromLatin1("json");
+        case FLOAT4OID:
+            return QString::fromLatin1("real");
+        case FLOAT8OID:
+            return QString::fromLatin1("double precision");
+        case BPCHAROID:
+            return mod > 4 ? QString::fromLatin1("character(%1)").arg(mod - 4) : QString::fromLatin1("character");
+        case VARCHAROID:
+            return mod > 4 ? QString::fromLatin1("character varying(%1)").arg(mod - 4) : QString::fromLatin1("character varying");
+        case DATEOID:
+            return QString::fromLatin1("date");
+        case TIMEOID:
+            return QString::fromLatin1("time");
+        case TIMESTAMPOID:
+            return QString::fromLatin1("timestamp");
+        case TIMESTAMPTZOID:
+            return QString::fromLatin1("timestamp with time zone");
+        case INTERVALOID:
+            return QString::fromLatin1("interval");
+        case NUMERICOID:
+            if (mod < 4)
+                return QString::fromLatin1("numeric");
+            return QString::fromLatin1("numeric(%1,%2)").arg(((mod - 4) >> 16) & 0xffff).arg((mod - 4) & 0xffff);
+        default:
+            return QString::fromLatin1("UNKNOWN(%1)").arg(type);
+    }
+}
+
+static bool isNumber(Oid type)
+{
+    return type == INT2OID || type == INT4OID || type == INT8OID || type == OIDOID
+           || type == FLOAT4OID || type == FLOAT8OID || type == NUMERICOID;
+}
+
+/** Numeric values with more significant digits than a double holds are kept as text */
+static toQValue numericValue(QString const& str)
+{
+    int digits = 0;
+    bool leading = true;
+    for (int i = 0; i < str.size(); i++)
+    {
+        QChar c = str.at(i);
+        if (!c.isDigit())
+            continue;
+        if (leading && c == QChar('0'))
+            continue;
+        leading = false;
+        digits++;
+    }
+    bool ok;
+    double d = str.toDouble(&ok);
+    if (ok && digits <= 15)
+        return toQValue(d);
+    return toQValue(str);
+}
+
+pqQuery::pqQuery(toQueryAbstr *query, toPQConnectionSub *conn)
+    : queryImpl(query)
+    , Connection(conn)
+    , Result(NULL)
+    , Row(0)
+    , Rows(0)
+    , Column(0)
+    , Binary(false)
+    , Pending(false)
+    , EOQ(true)
+    , Learn(false)
+    , Retry(false)
+    , Processed(0)
+{
+}
+
+pqQuery::~pqQuery()
+{
+    if (Pending)
+    {
+        // stop the transfer of rows nobody is going to read
+        Connection->cancel();
+        QMutexLocker lock(&Connection->Lock);
+        drain();
+    }
+    PQclear(Result);
+}
+
+void pqQuery::execute(void)
+{
+    send(query()->sql(), query()->params());
+    fetch();
+}
+
+void pqQuery::execute(QString const& sql)
+{
+    // Session setup, possibly several statements, sent using the simple protocol
+    send(sql, toQueryParams(), true);
+    fetch();
+}
+
+void pqQuery::send(QString const& sql, toQueryParams const& params, bool simple)
+{
+    // parameters are passed as text, the server converts them to the types it infers for the $n placeholders
+    SQL = params.empty() ? sql : stripBinds(sql);
+    QByteArray statement = SQL.toUtf8();
+    QVector<QByteArray> values;
+    QVector<const char*> pointers;
+    for (int i = 0; i < BindParams.size() && !params.empty(); i++)
+    {
+        if (i >= params.size() || params.at(i).isNull())
+        {
+            values << QByteArray();
+            pointers << NULL;
+        }
+        else
+        {
+            values << QString(params.at(i)).toUtf8();
+            pointers << values.last().constData();
+        }
+    }
+
+    QMutexLocker lock(&Connection->Lock);
+    PGconn *conn = Connection->Connection;
+    PQclear(Result);
+    Result = NULL;
+    Row = Rows = Column = 0;
+    Processed = 0;
+    Types.clear();
+    Description.clear();
+    Zone = Connection->timeZone();
+
+    // The result format is chosen before the column types are known. The first execution of a statement
+    // gets text results and the format for the next ones is learned from its column types.
+    QHash<QString, bool>::const_iterator known = Connection->ResultFormats.constFind(SQL);
+    Learn = !simple && known == Connection->ResultFormats.constEnd();
+    Binary = !simple && !Learn && known.value();
+    // scripts with several statements are refused by the extended protocol, they are sent again in fetch
+    Retry = !simple && pointers.empty();
+    int sent = simple
+               ? PQsendQuery(conn, statement.constData())
+               : PQsendQueryParams(conn, statement.constData(), pointers.size(), NULL, pointers.constData(), NULL, NULL, Binary ? 1 : 0);
+    if (!sent)
+        throw toConnection::exception(Connection->errorString(NULL, SQL));
+    stream(conn);
+}
+
+void pqQuery::stream(PGconn *conn)
+{
+#ifdef LIBPQ_HAS_CHUNK_MODE
+    PQsetChunkedRowsMode(conn, PQ_CHUNK_ROWS);
+#else
+    PQsetSingleRowMode(conn);
+#endif
+    Pending = true;
+    EOQ = false;
+}
+
+void pqQuery::setColumns(PGresult const *res)
+{
+    bool binary = PQnfields(res) > 0;
+    for (int i = 0; i < PQnfields(res); i++)
+    {
+        Oid type = PQftype(res, i);
+        binary &= hasBinaryDecoder(type, Connection->integerDatetimes());
+        Types << type;
+
+        toCache::ColumnDescription desc;
+        desc.Name = QString::fromUtf8(PQfname(res, i));
+        desc.Datatype = typeName(type, PQfmod(res, i));
+        desc.AlignRight = isNumber(type);
+        desc.Null = true;
+        Description << desc;
+    }
+
+    if (Learn)
+    {
+        if (Connection->ResultFormats.size() >= PQ_RESULT_FORMATS)
+            Connection->ResultFormats.clear();
+        Connection->ResultFormats.insert(SQL, binary);
+        Learn = false;
+    }
+    else if (Binary && !binary)
+    {
+        // the objects changed since the format was learned, learn it again next time
+        Connection->ResultFormats.remove(SQL);
+    }
+}
+
+void pqQuery::fetch(void)
+{
+    QMutexLocker lock(&Connection->Lock);
+    PGconn *conn = Connection->Connection;
+    for (;;)
+    {
+        PQclear(Result);
+        Result = PQgetResult(conn);
+        Row = Rows = Column = 0;
+        if (!Result)
+        {
+            Pending = false;
+            EOQ = true;
+            return;
+        }
+
+        switch (PQresultStatus(Result))
+        {
+            case PGRES_SINGLE_TUPLE:
+#ifdef LIBPQ_HAS_CHUNK_MODE
+            case PGRES_TUPLES_CHUNK:
+#endif
+            case PGRES_TUPLES_OK:
+                // the last, empty, result of a streamed query ends with PGRES_TUPLES_OK
+                if (Types.isEmpty())
+                    setColumns(Result);
+                Rows = PQntuples(Result);
+                if (Rows == 0)
+                    break;
+                Processed += Rows;
+                return;
+            case PGRES_COMMAND_OK:
+                Processed = QByteArray(PQcmdTuples(Result)).toULong();
+                break;
+            case PGRES_EMPTY_QUERY:
+                break;
+            case PGRES_COPY_OUT:
+            case PGRES_COPY_IN:
+            case PGRES_COPY_BOTH:
+            {
+                QString err = QString::fromLatin1("COPY to/from the client is not supported here\n\n") + SQL;
+                drain();
+                throw toConnection::exception(err);
+            }
+            default:
+            {
+                // scripts with several statements can only be sent using the simple protocol (text results)
+                bool script = Retry && qstrcmp(PQresultErrorField(Result, PG_DIAG_SQLSTATE), "42601") == 0;
+                QString err = Connection->errorString(Result, SQL);
+                drain();
+                if (!script)
+                    throw toConnection::exception(err);
+                Retry = Learn = Binary = false;
+                if (!PQsendQuery(conn, SQL.toUtf8().constData()))
+                    throw toConnection::exception(Connection->errorString(NULL, SQL));
+                stream(conn);
+                break;
+            }
+        }
+    }
+}
+
+void pqQuery::drain(void)
+{
+    PGconn *conn = Connection->Connection;
+    PGresult *res;
+    while ((res = PQgetResult(conn)) != NULL)
+    {
+        ExecStatusType status = PQresultStatus(res);
+        PQclear(res);
+        if (status == PGRES_COPY_IN)
+            PQputCopyEnd(conn, "cancelled");
+        else if (status == PGRES_COPY_OUT)
+        {
+            char *buf;
+            while (PQgetCopyData(conn, &buf, 0) > 0)
+                PQfreemem(buf);
+        }
+        else if (status == PGRES_COPY_BOTH)
+            break; // replication protocol, never started by TOra
+    }
+    Pending = false;
+    EOQ = true;
+}
+
+toQValue pqQuery::value(int row, int col) const
+{
+    if (PQgetisnull(Result, row, col))
+        return toQValue();
+
+    const char *data = PQgetvalue(Result, row, col);
+    int len = PQgetlength(Result, row, col);
+    const uchar *raw = reinterpret_cast<const uchar*>(data);
+    Oid type = Types.value(col);
+
+    if (!Binary)
+    {
+        switch (type)
+        {
+            case INT2OID:
+            case INT4OID:
+            case INT8OID:
+            case OIDOID:
+                return toQValue(QByteArray(data, len).toLongLong());
+            case FLOAT4OID:
+            case FLOAT8OID:
+            case NUMERICOID:
+                return numericValue(QString::fromLatin1(data, len));
+            default:
+                return toQValue(QString::fromUtf8(data, len));
+        }
+    }
+
+    switch (type)
+    {
+        case BOOLOID:
+            return toQValue(QString::fromLatin1(*data ? "t" : "f"));
+        case BYTEAOID:
+            return toQValue::createBinary(QByteArray(data, len));
+        case INT2OID:
+            return toQValue(qlonglong(qFromBigEndian<qint16>(raw)));
+        case INT4OID:
+            return toQValue(qlonglong(qFromBigEndian<qint32>(raw)));
+        case INT8OID:
+            return toQValue(qlonglong(qFromBigEndian<qint64>(raw)));
+        case OIDOID:
+            return toQValue(qlonglong(qFromBigEndian<quint32>(raw)));
+        case FLOAT4OID:
+            {
+                quint32 bits = qFromBigEndian<quint32>(raw);
+                float f;
+                memcpy(&f, &bits, sizeof(f));
+                return toQValue(double(f));
+            }
+        case FLOAT8OID:
+            {
+                quint64 bits = qFromBigEndian<quint64>(raw);
+                double d;
+                memcpy(&d, &bits, sizeof(d));
+                return toQValue(d);
+            }
+        case NUMERICOID:
+            return numericValue(toPQDecode::numeric(raw));
+        case DATEOID:
+            {
+                qint32 days = qFromBigEndian<qint32>(raw);
+                if (days == std::numeric_limits<qint32>::max())
+                    return toQValue(QString::fromLatin1("infinity"));
+                if (days == std::numeric_limits<qint32>::min())
+                    return toQValue(QString::fromLatin1("-infinity"));
+                return toQValue(QDate(2000, 1, 1).addDays(days).toString(QString::fromLatin1("yyyy-MM-dd")));
+            }
+        case TIMESTAMPOID:
+        case TIMESTAMPTZOID:
+            return toQValue(toPQDecode::timestamp(qFromBigEndian<qint64>(raw), type == TIMESTAMPTZOID, Zone));
+        default:
+            // the column types changed since the result format was chosen
+            if (!hasBinaryDecoder(type, Connection->integerDatetimes()))
+                return toQValue::createBinary(QByteArray(data, len));
+            // text like types are sent as they are in binary format too
+            return toQValue(QString::fromUtf8(data, len));
+    }
+}
+
+toQValue pqQuery::readValue(void)
+{
+    if (EOQ)
+        throw toConnection::exception(QString::fromLatin1("Tried to read past end of query"));
+
+    toQValue retval = value(Row, Column);
+    if (++Column == Types.size())
+    {
+        Column = 0;
+        if (++Row == Rows)
+            fetch();
+    }
+    return retval;
+}
+
+bool pqQuery::eof(void)
+{
+    return EOQ;
+}
+
+unsigned long pqQuery::rowsProcessed(void)
+{
+    return Processed;
+}
+
+unsigned pqQuery::columns(void)
+{
+    return Types.size();
+}
+
+toQColumnDescriptionList pqQuery::describe(void)
+{
+    return Description;
+}
+
+void pqQuery::cancel(void)
+{
+    Connection->cancel();
+}
+
+QString pqQuery::stripBinds(QString const& in)
+{
+    BindParams.clear();
+    QString retval;
+    // TODO: no PostgreSQL Lexer ATM
+    toSQLBindTemplate::TokenList tokens = toSQLBindTemplate::tokens("MySQLGuiLexer", in);
+
+    for (toSQLBindTemplate::TokenList::const_iterator token = tokens.constBegin(); token != tokens.constEnd(); token++)
+    {
+        switch (token->Type)
+        {
+            case toSQLBindTemplate::Token::BIND:
+            case toSQLBindTemplate::Token::BIND_WITH_PARAMS:
+                if (retval.endsWith(QChar(':')))
+                {
+                    // type cast (value::type), not a bind variable
+                    retval += token->Text;
+                    break;
+                }
+                BindParams << token->Name;
+                retval += QString::fromLatin1("$%1").arg(BindParams.size());
+                break;
+            default:
+                retval += token->Text;
+        }
+    }
+    return retval;
+}
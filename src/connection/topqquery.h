@@ -0,0 +1,99 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include "core/toquery.h"
+#include "core/toqueryimpl.h"
+
+#include <QtCore/QList>
+#include <QtCore/QStringList>
+#include <QtCore/QTimeZone>
+
+#include <libpq-fe.h>
+
+class toPQConnectionSub;
+
+/** Query on a native libpq connection.
+ *  Rows are streamed from the server in chunked (libpq >= 17) or single row mode, so the first
+ *  rows are available before the whole result is transferred. The connection lock is taken once
+ *  per chunk of rows, values are read from the received chunk without locking.
+ *  Statements are sent in one round trip (PQsendQueryParams), so the result format is chosen before
+ *  the column types are known: the first execution of a statement on a session gets text results,
+ *  later ones binary results when all its columns are of types decoded here (numbers, timestamps,
+ *  text), libpq only allows one format for all the columns. See toPQConnectionSub::ResultFormats.
+ */
+class pqQuery : public queryImpl
+{
+    public:
+        pqQuery(toQueryAbstr *query, toPQConnectionSub *conn);
+        virtual ~pqQuery();
+        virtual void execute(void);
+        virtual void execute(QString const&);
+        virtual void cancel(void);
+        virtual toQValue readValue(void);
+        virtual bool eof(void);
+        virtual unsigned long rowsProcessed(void);
+        virtual unsigned columns(void);
+        virtual toQColumnDescriptionList describe(void);
+    private:
+        /** Send the statement for execution
+         * @param simple send it using the simple query protocol (text results, no binds)
+         */
+        void send(QString const& sql, toQueryParams const& params, bool simple = false);
+        /** Switch the connection into chunked (or single row) mode after a statement was sent */
+        void stream(PGconn *conn);
+        /** Set the column types from the first result, learns the result format of the statement */
+        void setColumns(PGresult const *res);
+        /** Take the next chunk of rows, sets EOQ when the statement is finished */
+        void fetch(void);
+        /** Read and drop the rest of the results, must be called with the connection locked */
+        void drain(void);
+        toQValue value(int row, int col) const;
+        /** Replace TOra's :name<type> binds with $1, $2 ... */
+        QString stripBinds(QString const& in);
+
+        toPQConnectionSub *Connection;
+        PGresult *Result;
+        int Row, Rows, Column;
+        bool Binary, Pending, EOQ;
+        bool Learn;                 // remember the result format of this statement
+        bool Retry;                 // might be a script, send it again using the simple protocol if refused
+        QTimeZone Zone;             // TimeZone of the session
+        unsigned long Processed;
+        QString SQL;
+        QStringList BindParams;
+        QList<Oid> Types;
+        toQColumnDescriptionList Description;
+};
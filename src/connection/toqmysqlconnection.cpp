@@ -39,6 +39,11 @@
 
 #include <QtSql/QSqlError>
 #include <QtSql/QSqlQuery>
+#include <QtSql/QSqlDriver>
+
+#ifdef HAVE_MYSQL_H
+#include <mysql.h>
+#endif
 
 static toSQL SQLVersion("toQSqlConnection:Version",
                         "SHOW VARIABLES LIKE 'version'",
@@ -126,6 +131,79 @@ void toQMySqlConnectionImpl::closeConnection(toConnectionSub *)
 
 }
 
+void toQMySqlConnectionSub::cancel()
+{
+    if (ConnectionID.isEmpty())
+        return;
+
+    // the running query holds the sub's Lock, KILL is sent from the control connection
+    toConnection &conn = const_cast<toConnection&>(ParentConnection);
+    const QString &sql = toSQL::sql("toQSqlConnection:Cancel", conn);
+    if (!sql.isEmpty() && sql != "native")
+        conn.controlExecute(sql, toQueryParams() << toQValue(ConnectionID));
+}
+
+void toQMySqlConnectionSub::commit()
+{
+    {
+        LockingPtr<QSqlDatabase> ptr(Connection, Lock);
+        endStream();
+    }
+    toQSqlConnectionSub::commit();
+}
+
+void toQMySqlConnectionSub::rollback()
+{
+    {
+        LockingPtr<QSqlDatabase> ptr(Connection, Lock);
+        endStream();
+    }
+    toQSqlConnectionSub::rollback();
+}
+
+void toQMySqlConnectionSub::endStream()
+{
+    if (!Streaming)
+        return;
+    Streaming->closeStream();
+    Streaming = NULL;
+}
+
+toQMySqlConnectionSub::toQMySqlConnectionSub(toConnection const& parent, QSqlDatabase const& db, QString const& dbname)
+    : toQSqlConnectionSub(parent, db, dbname)
+    , Streaming(NULL)
+{
+    // Connection id is only used to KILL the running query (see cancel),
+    // do not ask for it when the server can not cancel this way
+    try
+    {
+        QString const& kill = toSQL::sql("toQSqlConnection:Cancel", parent);
+        if (kill.isEmpty() || kill == "native")
+            return;
+    }
+    catch (QString const&)
+    {
+        return;
+    }
+    toQueryParams id = sessionId();
+    if (!id.isEmpty())
+        ConnectionID = id.first();
+}
+
+toQueryParams toQMySqlConnectionSub::sessionId()
+{
+#ifdef HAVE_MYSQL_H
+    QVariant v = Connection.driver()->handle();
+    if (v.isValid() && qstrcmp(v.typeName(), "MYSQL*") == 0)
+    {
+        MYSQL *handle = *static_cast<MYSQL **>(v.data());
+        if (handle)
+            return toQueryParams() << QString::number(mysql_thread_id(handle));
+    }
+#endif
+    return toQSqlConnectionSub::sessionId();
+}
+
 queryImpl* toQMySqlConnectionSub::createQuery(toQueryAbstr *query)
 {
     return new mysqlQuery(query, this);
@@ -41,6 +41,8 @@
 #include <QtCore/QString>
 #include <QtSql/QSqlDatabase>
 
+class mysqlQuery;
+
 // MySQL datatypes (From mysql_com.h)
 enum enum_field_types { FIELD_TYPE_DECIMAL, FIELD_TYPE_TINY,
                         FIELD_TYPE_SHORT, FIELD_TYPE_LONG,
@@ -77,24 +79,24 @@ class toQMySqlConnectionImpl: public toQSqlConnectionImpl
 class toQMySqlConnectionSub : public toQSqlConnectionSub
 {
         friend class toQMySqlConnectionImpl;
+        friend class mysqlQuery;
     public:
-        toQMySqlConnectionSub(toConnection const& parent, QSqlDatabase const& db, QString const& dbname)
-            : toQSqlConnectionSub(parent, db, dbname)
-        {
-        }
+        toQMySqlConnectionSub(toConnection const& parent, QSqlDatabase const& db, QString const& dbname);
 
         virtual ~toQMySqlConnectionSub()
         {
             LockingPtr<QSqlDatabase> ptr(Connection, Lock);
+            endStream();
             ptr->close();
         }
 
         /** Implemented abstract method inherited from toConnectionSub */
 
-        void cancel(void) override
-        {
-            throw QString("Not implemented yet: toQMySqlConnectionSub::close");
-        };
+        void cancel(void) override;
+
+        void commit(void) override;
+
+        void rollback(void) override;
 
         /** Close connection. */
         void close(void) override
@@ -109,5 +111,14 @@ class toQMySqlConnectionSub : public toQSqlConnectionSub
             throw QString("Not implemented yet: toQMySqlConnectionSub::describe");
         }
 
+        /** Connection id from the client library, no round trip (empty when not available) */
+        toQueryParams sessionId() override;
+
+        /** Abort the unbuffered result still being read from this connection (if any).
+         *  The server does not accept any other statement until the result is consumed or freed.
+         *  Must be called with Lock held.
+         */
+        void endStream(void);
     private:
+        mysqlQuery *Streaming;     // query owning the open unbuffered result
 };
@@ -36,11 +36,12 @@
 #include "connection/toqmysqlprovider.h"
 #include "connection/toqmysqltraits.h"
 #include "connection/toqmysqlsetting.h"
+#include "connection/toqmysqlstream.h"
 #include "core/toconfiguration.h"
 #include "core/tosql.h"
 #include "core/tocache.h"
 #include "core/utils.h"
-#include "parsing/tsqllexer.h"
+#include "connection/toqsqlbindtemplate.h"
 
 #include <QtSql/QSqlQuery>
 #include <QtSql/QSqlField>
@@ -62,6 +63,8 @@ using namespace ToConfiguration;
 
 QSqlQuery* mysqlQuery::createQuery(const QString &sql)
 {
+    Connection->endStream();
+    Streamed = false;
     QSqlQuery *ret = new QSqlQuery(Connection->Connection);
     ret->setForwardOnly(true);
     bool executed;
@@ -85,12 +88,22 @@ mysqlQuery::mysqlQuery(toQueryAbstr *query, toQMySqlConnectionSub *conn)
     , Connection(conn)
     , CurrentColumn(0)
     , EOQ(true)
+    , Stream(NULL)
+    , StreamRows(0)
+    , Streamed(false)
+    , StreamClosed(false)
 {
 }
 
 mysqlQuery::~mysqlQuery()
 {
+    // Freeing an unbuffered result reads the rest of the rows, stop the server from sending them first
+    if (Stream && !EOQ)
+        cancel();
     LockingPtr<QSqlDatabase> ptr(Connection->Connection, Connection->Lock);
+    if (Connection->Streaming == this)
+        Connection->endStream();
+    closeStream();
     delete Query;
 }
 
@@ -99,6 +112,8 @@ void mysqlQuery::execute(void)
 	LockingPtr<QSqlDatabase> ptr(Connection->Connection, Connection->Lock);
 	ExtraQuery = queryParam(query()->sql(), query()->params());
 	QString sql = ExtraQuery.takeFirst();
+	if (streamable(sql) && openStream(sql))
+		return;
 	Query = createQuery(sql);
     checkQuery();
 }
@@ -109,71 +124,99 @@ void mysqlQuery::execute(QString const& sql)
     Query = createQuery(sql);
     checkQuery();
 }
-void mysqlQuery::cancel(void)
+int mysqlQuery::executeBatch(QList<toQueryParams> const& rows, QString &error)
 {
     LockingPtr<QSqlDatabase> ptr(Connection->Connection, Connection->Lock);
-    if (!Connection->ConnectionID.isEmpty())
+
+    // The statement is prepared on the first batch and reused for the following ones
+    if (!Query)
     {
-        try
+        Query = new QSqlQuery(Connection->Connection);
+        if (!Query->prepare(stripBinds(query()->sql())))
         {
-            toConnection const &conn = query()->connection();
-            const QString &sql = toSQL::sql(SQLCancel, conn);
-            if (!sql.isEmpty() && sql != "native")
-            {
-                toConnectionSubLoan c(const_cast<toConnection&>(conn));
-                toQuery(c, sql, toQueryParams() << Connection->ConnectionID);
-            }
-            else
-            {
-                // don't lock here or deadlock while waiting
-                // for query to finish
-                QSqlDatabase *c = const_cast<QSqlDatabase *>(&(Connection->Connection));
-                //TODO PgSQL only? native_cancel(c->driver());
-            }
-        }
-        catch (...)
-        {
-            TLOG(1, toDecorator, __HERE__) << "	Ignored exception." << std::endl;
+            error = toQMySqlConnectionSub::ErrorString(Query->lastError(), query()->sql());
+            delete Query;
+            Query = NULL;
+            return 0;
         }
     }
+    return batchExec(*Query, BindParams, rows, error, BatchAffected);
 }
 
-toQValue mysqlQuery::readValue(void)
+void mysqlQuery::cancel(void)
 {
-    LockingPtr<QSqlDatabase> ptr(Connection->Connection, Connection->Lock);
+    try
+    {
+        Connection->cancel();
+    }
+    catch (...)
+    {
+        TLOG(1, toDecorator, __HERE__) << "	Ignored exception." << std::endl;
+    }
+}
 
-    if (!Query)
+toQValue mysqlQuery::readValue(void)
+{
+    if (Streamed && StreamClosed)
+        throw toConnection::exception(QString::fromLatin1("Result set was closed by another statement on the same connection"));
+    if (!Query && !Stream)
         throw toConnection::exception(QString::fromLatin1("Fetching from not executed query"));
     if (EOQ)
         throw toConnection::exception(QString::fromLatin1("Tried to read past end of query"));
 
-    QVariant retval;
+#ifdef HAVE_MYSQL_H
+    if (Stream)
     {
-        retval = Query->value(CurrentColumn);
-        if (Query->isNull(CurrentColumn))
-            retval.clear();
+        toQValue ret = Stream->value(CurrentColumn);
+        CurrentColumn++;
+        if (CurrentColumn < Stream->columns())
+            return ret;
+
+        LockingPtr<QSqlDatabase> ptr(Connection->Connection, Connection->Lock);
+        CurrentColumn = 0;
+        EOQ = !Stream->next();
+        if (EOQ)
+        {
+            Connection->endStream();
+            while (EOQ && !ExtraQuery.isEmpty())
+            {
+                QString sql = ExtraQuery.takeFirst();
+                if (streamable(sql) && openStream(sql))
+                    continue;
+                Query = createQuery(sql);
+                checkQuery();
+            }
+        }
+        return ret;
     }
+#endif
 
-    CurrentColumn++;
-    if (CurrentColumn == (unsigned int) Record.count())
+    if (Buffer.empty())
     {
-        CurrentColumn = 0;
-        EOQ = !Query->next();
+        LockingPtr<QSqlDatabase> ptr(Connection->Connection, Connection->Lock);
+        Buffer.fill(*Query, Record.count());
     }
+
+    toQValue retval = Buffer.take();
+    EOQ = Buffer.eof();
     if (EOQ)
     {
+        LockingPtr<QSqlDatabase> ptr(Connection->Connection, Connection->Lock);
         delete Query;
         Query = NULL;
         if (!ExtraQuery.isEmpty())
         {
         	QString sql = ExtraQuery.takeFirst();
-        	Query = createQuery(sql);
-            checkQuery();
-        	EOQ = false;
+        	if (!streamable(sql) || !openStream(sql))
+        	{
+        		Query = createQuery(sql);
+        		checkQuery();
+        		EOQ = false;
+        	}
         }
     }
 
-    return toQValue::fromVariant(retval);
+    return retval;
 }
 
 bool mysqlQuery::eof(void)
@@ -187,6 +230,8 @@ unsigned long mysqlQuery::rowsProcessed(void)
     {
         LockingPtr<QSqlDatabase> ptr(Connection->Connection, Connection->Lock, true);
 
+        if (Streamed)
+            return Stream ? Stream->rows() : StreamRows;
         if (!Query)
             return 0L;
         return Query->numRowsAffected();
@@ -200,6 +245,8 @@ unsigned long mysqlQuery::rowsProcessed(void)
 unsigned mysqlQuery::columns(void)
 {
     LockingPtr<QSqlDatabase> ptr(Connection->Connection, Connection->Lock);
+    if (Streamed)
+        return ColumnDescriptions.size();
     return Record.count();
 }
 
@@ -207,6 +254,8 @@ toQColumnDescriptionList mysqlQuery::describe(void)
 {
     LockingPtr<QSqlDatabase> ptr(Connection->Connection, Connection->Lock);
     toQColumnDescriptionList ret;
+    if (Streamed)
+        return ColumnDescriptions;
     if (Query && Query->isSelect())
     {
         ret = describe(Query->record());
@@ -214,6 +263,57 @@ toQColumnDescriptionList mysqlQuery::describe(void)
     return ret;
 }
 
+bool mysqlQuery::streamable(QString const& sql)
+{
+    if (!query()->params().empty())
+        return false;
+    if (!toConfigurationNewSingle::Instance().option(MySQL::StreamResultsBool).toBool())
+        return false;
+    QString s = sql.trimmed();
+    while (s.startsWith('('))
+        s = s.mid(1).trimmed();
+    return s.startsWith(QString::fromLatin1("SELECT"), Qt::CaseInsensitive)
+           || s.startsWith(QString::fromLatin1("WITH"), Qt::CaseInsensitive);
+}
+
+bool mysqlQuery::openStream(QString const& sql) // Must be called while locked
+{
+#ifdef HAVE_MYSQL_H
+    Connection->endStream();
+    toQMySqlStream *stream = toQMySqlStream::open(Connection->Connection, sql);
+    if (!stream)
+        return false;               // driver does not expose the MYSQL handle, use QSqlQuery
+
+    delete Query;
+    Query = NULL;
+    Stream = stream;
+    Streamed = true;
+    StreamClosed = false;
+    StreamRows = 0;
+    ColumnDescriptions = Stream->describe();
+    CurrentColumn = 0;
+    Connection->Streaming = this;
+    EOQ = !Stream->next();
+    if (EOQ)
+        Connection->endStream();
+    return true;
+#else
+    return false;
+#endif
+}
+
+void mysqlQuery::closeStream(void)
+{
+#ifdef HAVE_MYSQL_H
+    if (!Stream)
+        return;
+    StreamRows = Stream->rows();
+    StreamClosed = !EOQ;
+    delete Stream;
+    Stream = NULL;
+#endif
+}
+
 void mysqlQuery::checkQuery(void) // Must *not* call while locked
 {
     if (!Query->isActive())
@@ -228,7 +328,7 @@ void mysqlQuery::checkQuery(void) // Must *not* call while locked
     {
         Record = Query->record();
         EOQ = !Query->next();
-        CurrentColumn = 0;
+        Buffer.clear();
     }
     else
     {
@@ -346,32 +446,23 @@ QString mysqlQuery::stripBinds(const QString &in)
 {
     BindParams.clear();
     QString retval;
-    std::unique_ptr <SQLLexer::Lexer> lexer = LexerFactTwoParmSing::Instance().create("MySQLLexer", "", "toCustomLexer");
-    lexer->setStatement(in);
+    toSQLBindTemplate::TokenList tokens = toSQLBindTemplate::tokens("MySQLLexer", in);
 
-    SQLLexer::Lexer::token_const_iterator start = lexer->begin();
-    while (start->getTokenType() != SQLLexer::Token::X_EOF)
+    for (toSQLBindTemplate::TokenList::const_iterator token = tokens.constBegin(); token != tokens.constEnd(); token++)
     {
-        switch (start->getTokenType())
+        switch (token->Type)
         {
-            case SQLLexer::Token::L_BIND_VAR:
-                retval += start->getText();
-                BindParams << start->getText();
+            case toSQLBindTemplate::Token::BIND:
+                retval += token->Text;
+                BindParams << token->Name;
                 break;
-            case SQLLexer::Token::L_BIND_VAR_WITH_PARAMS:
-                {
-                    QString l1 = start->getText();
-                    QString l2 = l1.left( l1.indexOf('<'));
-                    QString l3 = l2.leftJustified( l1.length(), ' ');
-                    BindParams << l2;
-                    retval += l3;
-                }
+            case toSQLBindTemplate::Token::BIND_WITH_PARAMS:
+                BindParams << token->Name;
+                retval += token->Name.leftJustified(token->Text.length(), ' ');
                 break;
             default:
-                retval += start->getText();
-                //no break here
+                retval += token->Text;
         }
-        start++;
     }
     return retval;
 }
@@ -395,16 +486,14 @@ QStringList mysqlQuery::queryParam(const QString &in, toQueryParams &params)
     toQueryParams::const_iterator cpar = params.constBegin();
     toQueryParams filteredParams;
 
-    std::unique_ptr <SQLLexer::Lexer> lexer = LexerFactTwoParmSing::Instance().create("MySQLGuiLexer", "", "toCustomLexer");
-    lexer->setStatement(in);
+    toSQLBindTemplate::TokenList tokens = toSQLBindTemplate::tokens("MySQLGuiLexer", in);
 
-    SQLLexer::Lexer::token_const_iterator start = lexer->begin();
-    while (start->getTokenType() != SQLLexer::Token::X_EOF)
+    for (toSQLBindTemplate::TokenList::const_iterator token = tokens.constBegin(); token != tokens.constEnd(); token++)
     {
-    	QString str = start->getText();
-        switch (start->getTokenType())
+    	QString str = token->Text;
+        switch (token->Type)
         {
-            case SQLLexer::Token::L_BIND_VAR:
+            case toSQLBindTemplate::Token::BIND:
                 if (useBinds)
                 {
                     BindParams << str;
@@ -414,14 +503,11 @@ QStringList mysqlQuery::queryParam(const QString &in, toQueryParams &params)
                 }
                 cpar++;
             	break;
-            case SQLLexer::Token::L_BIND_VAR_WITH_PARAMS:
+            case toSQLBindTemplate::Token::BIND_WITH_PARAMS:
             {
-                QString text = start->getText();                                // ":f1<alldatabases>", ":f1<varchar,noquote>" or ":f1<int>"
-                QString name = text.left(text.indexOf('<'));                    // ":f1"
-                QString bindname = name.mid(1);                                 // "f1"
-				QString option = text.mid(text.indexOf('<') + 1); 
-				option.chop(1);                                                 //  "alldatabases" or "varchar,noquote"
-				QStringList options = option.split(',');
+                QString const& text = token->Text;                              // ":f1<alldatabases>", ":f1<varchar,noquote>" or ":f1<int>"
+                QString const& name = token->Name;                              // ":f1"
+				QStringList const& options = token->Options;                    //  "alldatabases" or "varchar,noquote"
                 QString name2 = name.leftJustified(text.length(), ' ');         // ":f1             " space padded
 
                 if (options.contains("alldatabases"))
@@ -459,7 +545,6 @@ QStringList mysqlQuery::queryParam(const QString &in, toQueryParams &params)
             default: // do nothing
                 break;
         }
-        start++;
         sql.append(str);
     }
 
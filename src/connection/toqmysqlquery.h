@@ -43,9 +43,11 @@
 
 class QSqlQuery;
 class toQMySqlConnectionSub;
+class toQMySqlStream;
 
 class mysqlQuery : public qsqlQuery
 {
+        friend class toQMySqlConnectionSub;
     public:
         mysqlQuery(toQueryAbstr *query, toQMySqlConnectionSub *conn);
 
@@ -66,20 +68,34 @@ class mysqlQuery : public qsqlQuery
         unsigned columns(void) override;
 
         toQColumnDescriptionList describe(void) override;
+
+        int executeBatch(QList<toQueryParams> const& rows, QString &error) override;
     protected:
         toQColumnDescriptionList describe(QSqlRecord record);
         QString stripBinds(const QString &in);
         void bindParam(QSqlQuery *q, toQueryParams const &params);
         QStringList queryParam(const QString &in, toQueryParams &params);
 
+        /** Plain SELECTs without bind variables are read unbuffered (see toQMySqlStream) */
+        bool streamable(QString const& sql);
+        /** Run @p sql unbuffered. @return false when the native handle is not available */
+        bool openStream(QString const& sql);
+        /** Free the unbuffered result, called by toQMySqlConnectionSub::endStream */
+        void closeStream(void);
+
         QSqlQuery *Query;
         QSqlRecord Record;
         QStringList BindParams;
         QStringList ExtraQuery;                            // see toAnalyze
         toQMySqlConnectionSub *Connection;
         toQColumnDescriptionList ColumnDescriptions;
-        unsigned CurrentColumn;
+        toQSqlRowBuffer Buffer;
+        unsigned CurrentColumn;                            // of Stream
         bool EOQ;
+        toQMySqlStream *Stream;
+        unsigned long StreamRows;
+        bool Streamed;                                     // last statement was read unbuffered
+        bool StreamClosed;                                 // result dropped before it was read completely
 
         void checkQuery(void);
 
@@ -54,6 +54,7 @@ namespace ToConfiguration
                 BreakConnectionsBool = 6000
                 , UseBindsBool
                 , BeforeCreateActionInt  // #define CONF_CREATE_ACTION
+                , StreamResultsBool
             };
             virtual QVariant defaultValue(int option) const
             {
@@ -65,6 +66,8 @@ namespace ToConfiguration
                     	return QVariant((bool)false);
                     case BeforeCreateActionInt:
                         return QVariant((int)0);
+                    case StreamResultsBool:
+                        return QVariant((bool)true);
                     default:
                         Q_ASSERT_X( false, qPrintable(__QHERE__), qPrintable(QString("Context MySQL un-registered enum value: %1").arg(option)));
                         return QVariant();
@@ -0,0 +1,259 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "connection/toqmysqlstream.h"
+#include "core/toconnection.h"
+
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlDriver>
+
+#include <mysql.h>
+
+// charsetnr of binary strings and blobs
+#define BINARY_CHARSET 63
+
+static QString typeName(int type)
+{
+    switch (type)
+    {
+        case MYSQL_TYPE_DECIMAL:
+            return QString::fromLatin1("DECIMAL");
+        case MYSQL_TYPE_NEWDECIMAL:
+            return QString::fromLatin1("NEWDECIMAL");
+        case MYSQL_TYPE_TINY:
+            return QString::fromLatin1("TINY");
+        case MYSQL_TYPE_SHORT:
+            return QString::fromLatin1("SHORT");
+        case MYSQL_TYPE_LONG:
+            return QString::fromLatin1("LONG");
+        case MYSQL_TYPE_FLOAT:
+            return QString::fromLatin1("FLOAT");
+        case MYSQL_TYPE_DOUBLE:
+            return QString::fromLatin1("DOUBLE");
+        case MYSQL_TYPE_NULL:
+            return QString::fromLatin1("NULL");
+        case MYSQL_TYPE_TIMESTAMP:
+            return QString::fromLatin1("TIMESTAMP");
+        case MYSQL_TYPE_LONGLONG:
+            return QString::fromLatin1("LONGLONG");
+        case MYSQL_TYPE_INT24:
+            return QString::fromLatin1("INT24");
+        case MYSQL_TYPE_DATE:
+            return QString::fromLatin1("DATE");
+        case MYSQL_TYPE_TIME:
+            return QString::fromLatin1("TIME");
+        case MYSQL_TYPE_DATETIME:
+            return QString::fromLatin1("DATETIME");
+        case MYSQL_TYPE_YEAR:
+            return QString::fromLatin1("YEAR");
+        case MYSQL_TYPE_NEWDATE:
+            return QString::fromLatin1("NEWDATE");
+        case MYSQL_TYPE_VARCHAR:
+            return QString::fromLatin1("VARCHAR");
+        case MYSQL_TYPE_BIT:
+            return QString::fromLatin1("BIT");
+        case MYSQL_TYPE_ENUM:
+            return QString::fromLatin1("ENUM");
+        case MYSQL_TYPE_SET:
+            return QString::fromLatin1("SET");
+        case MYSQL_TYPE_TINY_BLOB:
+            return QString::fromLatin1("TINY_BLOB");
+        case MYSQL_TYPE_MEDIUM_BLOB:
+            return QString::fromLatin1("MEDIUM_BLOB");
+        case MYSQL_TYPE_LONG_BLOB:
+            return QString::fromLatin1("LONG_BLOB");
+        case MYSQL_TYPE_BLOB:
+            return QString::fromLatin1("BLOB");
+        case MYSQL_TYPE_VAR_STRING:
+            return QString::fromLatin1("VAR_STRING");
+        case MYSQL_TYPE_STRING:
+            return QString::fromLatin1("STRING");
+        case MYSQL_TYPE_GEOMETRY:
+            return QString::fromLatin1("GEOMETRY");
+        default:
+            return QString::fromLatin1("UNKNOWN");
+    }
+}
+
+static QString errorString(MYSQL *handle, QString const& sql)
+{
+    QString ret = QString::fromUtf8(mysql_error(handle));
+    if (ret.isEmpty())
+        ret = QString::fromLatin1("Unknown error");
+    if (!sql.isEmpty())
+        ret += QString::fromLatin1("\n\n") + sql;
+    return ret;
+}
+
+toQMySqlStream* toQMySqlStream::open(QSqlDatabase &db, QString const& sql)
+{
+    QVariant v = db.driver()->handle();
+    if (!v.isValid() || qstrcmp(v.typeName(), "MYSQL*") != 0)
+        return NULL;
+    MYSQL *handle = *static_cast<MYSQL **>(v.data());
+    if (!handle)
+        return NULL;
+
+    QByteArray statement = sql.toUtf8();
+    if (mysql_real_query(handle, statement.constData(), statement.size()))
+        throw toConnection::exception(errorString(handle, sql));
+
+    MYSQL_RES *result = mysql_use_result(handle);
+    if (!result && mysql_errno(handle))
+        throw toConnection::exception(errorString(handle, sql));
+    return new toQMySqlStream(handle, result);
+}
+
+toQMySqlStream::toQMySqlStream(void *handle, void *result)
+    : Handle(handle)
+    , Result(result)
+    , Row(NULL)
+    , Lengths(NULL)
+    , Columns(0)
+    , Rows(0)
+{
+    if (!result)
+        return; // statement without a result set
+
+    MYSQL_RES *res = static_cast<MYSQL_RES*>(result);
+    Columns = mysql_num_fields(res);
+    MYSQL_FIELD *fields = mysql_fetch_fields(res);
+    for (unsigned i = 0; i < Columns; i++)
+    {
+        MYSQL_FIELD const& field = fields[i];
+        Types << field.type;
+        Binary << (field.charsetnr == BINARY_CHARSET && (IS_BLOB(field.flags) || field.type == MYSQL_TYPE_STRING
+                   || field.type == MYSQL_TYPE_VAR_STRING || field.type == MYSQL_TYPE_BIT));
+
+        toCache::ColumnDescription desc;
+        desc.Name = QString::fromUtf8(field.name);
+        desc.Datatype = typeName(field.type);
+        if (field.length > 1)
+        {
+            desc.Datatype += QString::fromLatin1(" (%1").arg(field.length);
+            if (field.decimals > 0 && IS_NUM(field.type))
+                desc.Datatype += QString::fromLatin1(",%1").arg(field.decimals);
+            desc.Datatype += QString::fromLatin1(")");
+        }
+        desc.Null = !(field.flags & NOT_NULL_FLAG);
+        desc.AlignRight = IS_NUM(field.type);
+        Description << desc;
+    }
+}
+
+toQMySqlStream::~toQMySqlStream()
+{
+    if (!Result)
+        return;
+    mysql_free_result(static_cast<MYSQL_RES*>(Result));
+
+    // leave the connection ready for the next statement
+    MYSQL *handle = static_cast<MYSQL*>(Handle);
+    while (mysql_more_results(handle) && mysql_next_result(handle) == 0)
+    {
+        MYSQL_RES *res = mysql_use_result(handle);
+        if (res)
+            mysql_free_result(res);
+    }
+}
+
+bool toQMySqlStream::next(void)
+{
+    if (!Result)
+        return false;
+    MYSQL_RES *res = static_cast<MYSQL_RES*>(Result);
+    Row = mysql_fetch_row(res);
+    if (!Row)
+    {
+        // end of rows or a network/server error (e.g. the query was killed) in the middle of the result
+        MYSQL *handle = static_cast<MYSQL*>(Handle);
+        if (mysql_errno(handle))
+            throw toConnection::exception(errorString(handle, QString::null));
+        return false;
+    }
+    Lengths = mysql_fetch_lengths(res);
+    Rows++;
+    return true;
+}
+
+toQValue toQMySqlStream::value(unsigned column) const
+{
+    if (!Row || column >= Columns || !Row[column])
+        return toQValue();
+
+    QByteArray data(Row[column], Lengths[column]);
+    if (Binary.at(column))
+        return toQValue::createBinary(data);
+
+    bool ok = false;
+    switch (Types.at(column))
+    {
+        case MYSQL_TYPE_TINY:
+        case MYSQL_TYPE_SHORT:
+        case MYSQL_TYPE_LONG:
+        case MYSQL_TYPE_INT24:
+        case MYSQL_TYPE_LONGLONG:
+        case MYSQL_TYPE_YEAR:
+            {
+                qlonglong l = data.toLongLong(&ok);
+                if (ok)
+                    return toQValue(l);
+                break; // unsigned bigint out of range
+            }
+        case MYSQL_TYPE_FLOAT:
+        case MYSQL_TYPE_DOUBLE:
+            {
+                double d = data.toDouble(&ok);
+                if (ok)
+                    return toQValue(d);
+                break;
+            }
+        case MYSQL_TYPE_DECIMAL:
+        case MYSQL_TYPE_NEWDECIMAL:
+            {
+                // keep decimals that do not fit into a double as text
+                int digits = 0;
+                for (int i = 0; i < data.size(); i++)
+                    if (data.at(i) >= '0' && data.at(i) <= '9')
+                        digits++;
+                double d = data.toDouble(&ok);
+                if (ok && digits <= 15)
+                    return toQValue(d);
+                break;
+            }
+        default:
+            break;
+    }
+    return toQValue(QString::fromUtf8(data));
+}
@@ -0,0 +1,95 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include "core/toqvalue.h"
+#include "core/tocache.h"
+
+#include <QtCore/QList>
+
+class QSqlDatabase;
+
+/** Unbuffered result of a MySQL query (mysql_use_result).
+ *  Uses the native connection handle of a QMYSQL database, rows are read from the server as they
+ *  are consumed instead of being stored on the client before the first one is available.
+ *  No other statement can be run on the connection until the stream is closed, see
+ *  @ref toQMySqlConnectionSub::endStream.
+ *  mysql.h is only included by the implementation, its declarations clash with the
+ *  field types defined in toqmysqlconnection.h.
+ */
+class toQMySqlStream
+{
+    public:
+        /** Execute @p sql on the native handle of @p db.
+         * @return NULL when the native handle of the driver is not available
+         */
+        static toQMySqlStream* open(QSqlDatabase &db, QString const& sql);
+
+        /** Frees the result, the rest of the rows is read and dropped by the client library */
+        ~toQMySqlStream();
+
+        /** Move to the next row. @return false after the last row */
+        bool next(void);
+
+        toQValue value(unsigned column) const;
+
+        unsigned columns(void) const
+        {
+            return Columns;
+        }
+
+        /** Rows read so far */
+        unsigned long rows(void) const
+        {
+            return Rows;
+        }
+
+        toQColumnDescriptionList const& describe(void) const
+        {
+            return Description;
+        }
+    private:
+        toQMySqlStream(void *handle, void *result);
+
+        void *Handle;               // MYSQL*
+        void *Result;               // MYSQL_RES*
+        char **Row;                 // MYSQL_ROW
+        unsigned long *Lengths;
+        unsigned Columns;
+        unsigned long Rows;
+        QList<int> Types;
+        QList<bool> Binary;
+        toQColumnDescriptionList Description;
+};
@@ -52,3 +52,73 @@ QString toQMySqlTraits::schemaSwitchSQL(const QString &schema) const
     static const QString USE_DATABASE("USE `%1`");
     return USE_DATABASE.arg(schema);
 }
+
+toConnectionTraits::TypeClass toQMySqlTraits::typeClass(QString const& datatype, int &size, int &scale) const
+{
+    QString name = datatype.trimmed().toUpper().section(QChar(' '), 0, 0);
+    scale = 0;
+    if (name == QLatin1String("TINY") || name == QLatin1String("YEAR"))
+    {
+        size = 4;
+        return TYPE_INTEGER;
+    }
+    if (name == QLatin1String("SHORT"))
+    {
+        size = 5;
+        return TYPE_INTEGER;
+    }
+    if (name == QLatin1String("INT24") || name == QLatin1String("INT23") || name == QLatin1String("LONG"))
+    {
+        size = 10;
+        return TYPE_INTEGER;
+    }
+    if (name == QLatin1String("LONGLONG"))
+    {
+        size = 19;
+        return TYPE_INTEGER;
+    }
+    if (name == QLatin1String("NEWDECIMAL"))
+        return toConnectionTraits::typeClass(datatype.mid(3), size, scale); // DECIMAL (p,s)
+    if (name == QLatin1String("VAR_STRING") || name == QLatin1String("STRING") || name == QLatin1String("ENUM")
+            || name == QLatin1String("SET"))
+    {
+        toConnectionTraits::typeClass(datatype, size, scale);
+        return TYPE_TEXT;
+    }
+    if (name.endsWith(QLatin1String("BLOB")))
+    {
+        // TEXT columns are described as blobs too
+        size = 0;
+        return TYPE_LONG_TEXT;
+    }
+    if (name == QLatin1String("NEWDATE"))
+        return TYPE_DATE;
+    return toConnectionTraits::typeClass(datatype, size, scale);
+}
+
+QString toQMySqlTraits::typeName(TypeClass type, int size, int scale) const
+{
+    switch (type)
+    {
+        case TYPE_DECIMAL:
+            if (size > 0 && size <= 65)
+                return QString::fromLatin1("DECIMAL(%1,%2)").arg(size).arg(qBound(0, scale, 30));
+            return QString::fromLatin1("DECIMAL(65,30)");
+        case TYPE_FLOAT:
+            return QString::fromLatin1("DOUBLE");
+        case TYPE_BOOLEAN:
+            return QString::fromLatin1("TINYINT(1)");
+        case TYPE_TEXT:
+            if (size > 0 && size <= 16383)
+                return QString::fromLatin1("VARCHAR(%1)").arg(size);
+            return QString::fromLatin1("LONGTEXT");
+        case TYPE_LONG_TEXT:
+            return QString::fromLatin1("LONGTEXT");
+        case TYPE_TIMESTAMP:
+            return QString::fromLatin1("DATETIME(6)");
+        case TYPE_BINARY:
+            return QString::fromLatin1("LONGBLOB");
+        default:
+            return toConnectionTraits::typeName(type, size, scale);
+    }
+}
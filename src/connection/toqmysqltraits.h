@@ -57,6 +57,11 @@ class toQMySqlTraits: public toConnectionTraits
          */
         QString schemaSwitchSQL(QString const&) const override;
 
+        /** MySQL names integers TINY, SHORT, LONG, ... (see mysqlQuery::describe) */
+        TypeClass typeClass(QString const& datatype, int &size, int &scale) const override;
+
+        QString typeName(TypeClass type, int size, int scale) const override;
+
         /** Check if connection provider supports table level comments.
          *  @return bool return true if database supports table level comments
          *  See toSql: toResultCols:TableComment
@@ -71,6 +76,12 @@ class toQMySqlTraits: public toConnectionTraits
             return false;
         }
 
+        /** KILL is sent from the control connection */
+        bool hasControlCancel() const override
+        {
+            return true;
+        }
+
         QString quoteVarchar(const QString &name) const override
         {
         	return quoteVarcharStatic(name);
@@ -36,10 +36,14 @@
 #include "core/tologger.h"
 #include "connection/toqodbcprovider.h"
 #include "connection/toqsqlconnection.h"
+#ifdef HAVE_ODBC
+#include "connection/toodbcconnection.h"
+#endif
 
 #define QT_DRIVER_NAME "QODBC"
 
 #include <QtCore/QSettings>
+#include <QtSql/QSqlDatabase>
 
 QString toQODBCProvider::m_name = QT_DRIVER_NAME;
 QString toQODBCProvider::m_displayName = ODBC_PROVIDER;
@@ -50,9 +54,23 @@ toQODBCProvider::toQODBCProvider(toConnectionProviderFinder::ConnectionProvirerP
 
 toConnection::connectionImpl* toQODBCProvider::createConnectionImpl(toConnection &conn)
 {
+#ifdef HAVE_ODBC
+    // Both implementations share the provider name, so all the "QODBC" checks of the tools work with either
+    if (conn.options().contains(ODBC_NATIVE_OPTION) || !QSqlDatabase::isDriverAvailable(QT_DRIVER_NAME))
+        return new toODBCConnectionImpl(conn);
+#endif
     return new toQSqlConnectionImpl(conn);
 }
 
+QList<QString> toQODBCProvider::options() const
+{
+    QList<QString> ret;
+#ifdef HAVE_ODBC
+    ret << "*" ODBC_NATIVE_OPTION;
+#endif
+    return ret;
+}
+
 QList<QString> toQODBCProvider::databases(const QString &host, const QString &user, const QString &pwd) const
 {
     QList<QString> ret;
@@ -59,6 +59,9 @@ class toQODBCProvider : public toQSqlProvider
         /** see: @ref toConnectionProvider::databases() */
         QList<QString> databases(const QString &host, const QString &user, const QString &pwd) const override;
 
+        /** see: @ref toConnectionProvider::options() */
+        QList<QString> options() const override;
+
 // TODO DEFINE THESE
 #if 0
         /** see: @ref toConnectionProvider::initialize() */
@@ -41,6 +41,7 @@
 #include <QtSql/QSqlDriver>
 
 #ifdef HAVE_POSTGRESQL_LIBPQ_FE_H
+#include "connection/topqcopy.h"
 #include <libpq-fe.h>
 #endif
 
@@ -196,6 +197,20 @@ queryImpl* toQPSqlConnectionSub::createQuery(toQueryAbstr *query)
     return new psqlQuery(query, this);
 }
 
+toBulkLoad* toQPSqlConnectionSub::createBulkLoad(QString const& table, QStringList const& columns, int bufferSize, bool binary)
+{
+#ifdef HAVE_POSTGRESQL_LIBPQ_FE_H
+    QVariant v = Connection.driver()->handle();
+    if (v.isValid() && v.typeName() == QString("PGconn*"))
+    {
+        PGconn *handle = *static_cast<PGconn **>(v.data());
+        if (handle)
+            return new toPQBulkLoad(handle, Lock, table, columns, bufferSize, binary);
+    }
+#endif
+    return NULL;
+}
+
 int toQPSqlConnectionSub::nativeVersion()
 {
     QVariant v = Connection.driver()->handle();
@@ -224,7 +239,7 @@ int toQPSqlConnectionSub::nativeSessionId()
     return 0;
 }
 
-void toQPSqlConnectionSub::nativeCancel()
+bool toQPSqlConnectionSub::nativeCancel()
 {
     QVariant v = Connection.driver()->handle();
     if (v.isValid() && v.typeName() == QString("PGconn*"))
@@ -232,16 +247,31 @@ void toQPSqlConnectionSub::nativeCancel()
 #ifdef LIBPQ_DECL_CANCEL
         PGconn *handle = *static_cast<PGconn **>(v.data());
         if (!handle)
-            return;
+            return false;
 
         PGcancel *cancel = PQgetCancel(handle);
         if (!cancel)
-            return;
+            return false;
 
-        char *errbuf = new char[1024];
-        PQcancel(cancel, errbuf, 1024);
+        char errbuf[256];
+        int ret = PQcancel(cancel, errbuf, sizeof(errbuf));
         PQfreeCancel(cancel);
-        delete[] errbuf;
+        return ret == 1;
 #endif
     }
+    return false;
+}
+
+void toQPSqlConnectionSub::cancel()
+{
+    // PQcancel sends the request over its own short lived socket
+    if (nativeCancel())
+        return;
+
+    if (ConnectionID.isEmpty())
+        return;
+
+    // the running query holds the sub's Lock, pg_cancel_backend is sent from the control connection
+    toConnection &conn = const_cast<toConnection&>(ParentConnection);
+    conn.controlExecute(toSQL::sql("toQSqlConnection:Cancel", conn), toQueryParams() << toQValue(ConnectionID));
 }
@@ -75,10 +75,7 @@ class toQPSqlConnectionSub : public toQSqlConnectionSub
 
         /** Implemented abstract method inherited from toConnectionSub */
 
-        void cancel(void) override
-        {
-            // NOT SUPPORTED YET
-        };
+        void cancel(void) override;
 
         /** Close connection. */
         void close(void) override
@@ -96,10 +93,13 @@ class toQPSqlConnectionSub : public toQSqlConnectionSub
             throw QString("Not implemented yet: toQPSqlConnectionSub::describe");
         }
 
+        /** COPY ... FROM STDIN using the libpq handle of the driver (when available) */
+        toBulkLoad* createBulkLoad(QString const& table, QStringList const& columns, int bufferSize, bool binary) override;
+
     private:
         int nativeVersion();
         int nativeSessionId();
-        void nativeCancel();
+        bool nativeCancel();
 };
 
 #endif
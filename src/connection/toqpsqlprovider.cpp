@@ -36,6 +36,11 @@
 #include "connection/toqpsqlsetting.h"
 #include "connection/toqpsqlconnection.h"
 #include "connection/toqpsqltraits.h"
+#ifdef HAVE_POSTGRESQL_LIBPQ_FE_H
+#include "connection/topqconnection.h"
+#endif
+
+#include <QtSql/QSqlDatabase>
 
 #define QT_DRIVER_NAME "QPSQL"
 
@@ -57,6 +62,15 @@ QMap<QString,QString> toQPSqlProvider::defaultConnection() const
 	//return QMap<QString,QString>{{"HOST", "localhost"}, {"PORT", "5432"}, {"DB", "postgres"}, {"USER", "postgres"}}; Qt >= 5.2 only
 }
 
+QList<QString> toQPSqlProvider::options() const
+{
+    QList<QString> ret;
+#ifdef HAVE_POSTGRESQL_LIBPQ_FE_H
+    ret << "*" PQ_NATIVE_OPTION;
+#endif
+    return ret;
+}
+
 QWidget* toQPSqlProvider::configurationTab(QWidget *parent)
 {
 #ifdef Q_OS_WIN
@@ -68,6 +82,11 @@ QWidget* toQPSqlProvider::configurationTab(QWidget *parent)
 
 toConnection::connectionImpl* toQPSqlProvider::createConnectionImpl(toConnection &conn)
 {
+#ifdef HAVE_POSTGRESQL_LIBPQ_FE_H
+    // Both implementations share the provider name, so all the "QPSQL" SQL of the tools works with either
+    if (conn.options().contains(PQ_NATIVE_OPTION) || !QSqlDatabase::isDriverAvailable(QT_DRIVER_NAME))
+        return new toPQConnectionImpl(conn);
+#endif
     return new toQPSqlConnectionImpl(conn);
 }
 
@@ -61,6 +61,9 @@ class toQPSqlProvider : public toQSqlProvider
         /** see: @ref toConnectionProvider::defaultConnection() */
         QMap<QString,QString> defaultConnection() const override;
 
+        /** see: @ref toConnectionProvider::options() */
+        QList<QString> options() const override;
+
 // TODO DEFINE THESE
         #if 0
         /** see: @ref toConnectionProvider::databases() */
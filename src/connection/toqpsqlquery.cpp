@@ -36,10 +36,11 @@
 #include "connection/toqpsqlprovider.h"
 #include "connection/toqpsqlquery.h"
 #include "connection/toqpsqlconnection.h"
+#include "connection/toqsqlquery.h"
 #include "core/tosql.h"
 #include "core/tocache.h"
 #include "core/utils.h"
-#include "parsing/tsqllexer.h"
+#include "connection/toqsqlbindtemplate.h"
 
 #ifdef HAVE_POSTGRESQL_LIBPQ_FE_H
 #include <libpq-fe.h>
@@ -89,9 +90,7 @@ psqlQuery::psqlQuery(toQueryAbstr *query, toQPSqlConnectionSub *conn)
     : queryImpl(query)
     , Query(NULL)
     , Connection(conn)
-    , CurrentColumn(0)
     , EOQ(true)
-
 {
 }
 
@@ -108,36 +107,45 @@ void psqlQuery::execute(void)
 
 void psqlQuery::execute(QString const& sql)
 {
-    Query = createQuery(query()->sql());
+    {
+        // Session setup: never has binds, may be several statements (sent by PQexec)
+        LockingPtr<QSqlDatabase> ptr(Connection->Connection, Connection->Lock);
+        Query = new QSqlQuery(*ptr);
+        Query->setForwardOnly(true);
+        Query->exec(sql);
+    }
     checkQuery();
 }
 
-void psqlQuery::cancel(void)
+int psqlQuery::executeBatch(QList<toQueryParams> const& rows, QString &error)
 {
-    if (!Connection->ConnectionID.isEmpty())
+    LockingPtr<QSqlDatabase> ptr(Connection->Connection, Connection->Lock);
+
+    // The statement is prepared on the first batch and reused for the following ones
+    if (!Query)
     {
-        try
+        Query = new QSqlQuery(*ptr);
+        if (!Query->prepare(stripBinds(query()->sql())))
         {
-            toConnection const &conn = query()->connection();
-            const QString &sql = toSQL::sql(SQLCancelPg, conn);
-            if (!sql.isEmpty() && sql != "native")
-            {
-                toConnectionSubLoan c(const_cast<toConnection&>(conn));
-                toQuery(c, sql, toQueryParams() << Connection->ConnectionID);
-            }
-            else
-            {
-                // don't lock here or deadlock while waiting
-                // for query to finish
-                QSqlDatabase *c = const_cast<QSqlDatabase *>(&(Connection->Connection));
-                //TODO PgSQL only? native_cancel(c->driver());
-            }
-        }
-        catch (...)
-        {
-            TLOG(1, toDecorator, __HERE__) << "	Ignored exception." << std::endl;
+            error = toQPSqlConnectionSub::ErrorString(Query->lastError(), query()->sql());
+            delete Query;
+            Query = NULL;
+            return 0;
         }
     }
+    return qsqlQuery::batchExec(*Query, BindParams, rows, error, BatchAffected);
+}
+
+void psqlQuery::cancel(void)
+{
+    try
+    {
+        Connection->cancel();
+    }
+    catch (...)
+    {
+        TLOG(1, toDecorator, __HERE__) << "	Ignored exception." << std::endl;
+    }
 }
 
 toQValue psqlQuery::readValue(void)
@@ -147,27 +155,22 @@ toQValue psqlQuery::readValue(void)
     if (EOQ)
         throw toConnection::exception(QString::fromLatin1("Tried to read past end of query"));
 
-    LockingPtr<QSqlDatabase> ptr(Connection->Connection, Connection->Lock);
-    QVariant retval;
+    if (Buffer.empty())
     {
-        retval = Query->value(CurrentColumn);
-        if (Query->isNull(CurrentColumn))
-            retval.clear();
+        LockingPtr<QSqlDatabase> ptr(Connection->Connection, Connection->Lock);
+        Buffer.fill(*Query, Record.count());
     }
 
-    CurrentColumn++;
-    if (CurrentColumn == (unsigned int) Record.count())
-    {
-        CurrentColumn = 0;
-        EOQ = !Query->next();
-    }
+    toQValue retval = Buffer.take();
+    EOQ = Buffer.eof();
     if (EOQ)
     {
+        LockingPtr<QSqlDatabase> ptr(Connection->Connection, Connection->Lock);
         delete Query;
         Query = NULL;
     }
 
-    return toQValue::fromVariant(retval);
+    return retval;
 }
 
 bool psqlQuery::eof(void)
@@ -222,7 +225,7 @@ void psqlQuery::checkQuery(void) // Must *not* call while locked
     {
         Record = Query->record();
         EOQ = !Query->next();
-        CurrentColumn = 0;
+        Buffer.clear();
     }
     else
     {
@@ -406,32 +409,23 @@ QString psqlQuery::stripBinds(const QString &in)
     BindParams.clear();
     QString retval;
     // TODO: no PostgreSQL Lexer ATM
-    std::unique_ptr <SQLLexer::Lexer> lexer = LexerFactTwoParmSing::Instance().create("MySQLGuiLexer", "", "toCustomLexer");
-    lexer->setStatement(in);
+    toSQLBindTemplate::TokenList tokens = toSQLBindTemplate::tokens("MySQLGuiLexer", in);
 
-    SQLLexer::Lexer::token_const_iterator start = lexer->begin();
-    while (start->getTokenType() != SQLLexer::Token::X_EOF)
+    for (toSQLBindTemplate::TokenList::const_iterator token = tokens.constBegin(); token != tokens.constEnd(); token++)
     {
-        switch (start->getTokenType())
+        switch (token->Type)
         {
-            case SQLLexer::Token::L_BIND_VAR:
-                retval += start->getText();
-                BindParams << start->getText();
-                break;
-            case SQLLexer::Token::L_BIND_VAR_WITH_PARAMS:
-                {
-                    QString l1 = start->getText();
-                    QString l2 = l1.left( l1.indexOf('<'));
-                    QString l3 = l2.leftJustified( l1.length(), ' ');
-                    BindParams << l2;
-                    retval += l3;
-                }
+            case toSQLBindTemplate::Token::BIND:
+                retval += token->Text;
+                BindParams << token->Name;
+                break;
+            case toSQLBindTemplate::Token::BIND_WITH_PARAMS:
+                BindParams << token->Name;
+                retval += token->Name.leftJustified(token->Text.length(), ' ');
                 break;
             default:
-                retval += start->getText();
-                //no break here
+                retval += token->Text;
         }
-        start++;
     }
     return retval;
 }
@@ -37,6 +37,7 @@
 
 #include "core/toquery.h"
 #include "core/toqueryimpl.h"
+#include "connection/toqsqlquery.h"
 
 #include <QtSql/QSqlRecord>
 #include <QtCore/QList>
@@ -105,6 +106,7 @@ class psqlQuery : public queryImpl
         virtual unsigned long rowsProcessed(void);
         virtual unsigned columns(void);
         virtual toQColumnDescriptionList describe(void);
+        virtual int executeBatch(QList<toQueryParams> const& rows, QString &error);
     private:
         toQColumnDescriptionList describe(QSqlRecord record);
         QString stripBinds(const QString &in);
@@ -115,7 +117,7 @@ class psqlQuery : public queryImpl
         QStringList BindParams;
         toQPSqlConnectionSub *Connection;
         toQColumnDescriptionList ColumnDescriptions;
-        unsigned CurrentColumn;
+        toQSqlRowBuffer Buffer;
         bool EOQ;
         void checkQuery(void);
         QSqlQuery *createQuery(const QString &sql);
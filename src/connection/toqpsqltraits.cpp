@@ -39,3 +39,37 @@ QString toQPSqlTraits::schemaSwitchSQL(const QString &schema) const
     static const QString USE_DATABASE("SET search_path TO %1,\"$user\",public");
     return USE_DATABASE.arg(schema);
 }
+
+QString toQPSqlTraits::sessionSetupSQL(QStringList const& statements) const
+{
+    QStringList ret;
+    Q_FOREACH(QString sql, statements)
+    {
+        sql = sql.trimmed();
+        while (sql.endsWith(QChar(';')))
+            sql.chop(1);
+        ret << sql;
+    }
+    return ret.join(QString::fromLatin1(";\n"));
+}
+
+QString toQPSqlTraits::typeName(TypeClass type, int size, int scale) const
+{
+    switch (type)
+    {
+        case TYPE_DECIMAL:
+            if (size > 0)
+                return QString::fromLatin1("NUMERIC(%1,%2)").arg(size).arg(qMax(scale, 0));
+            return QString::fromLatin1("NUMERIC");
+        case TYPE_TEXT:
+            if (size > 0 && size <= 10485760)
+                return QString::fromLatin1("VARCHAR(%1)").arg(size);
+            return QString::fromLatin1("TEXT");
+        case TYPE_LONG_TEXT:
+            return QString::fromLatin1("TEXT");
+        case TYPE_BINARY:
+            return QString::fromLatin1("BYTEA");
+        default:
+            return toConnectionTraits::typeName(type, size, scale);
+    }
+}
@@ -45,6 +45,22 @@ class toQPSqlTraits: public toQSqlTraits
          * @return SQL statement
          */
         virtual QString schemaSwitchSQL(QString const&) const;
+
+        /** Statements separated by semicolons, sent using the simple query protocol */
+        virtual QString sessionSetupSQL(QStringList const& statements) const;
+
+        virtual QString typeName(TypeClass type, int size, int scale) const;
+
+        /** PQcancel opens its own socket, pg_cancel_backend from the control connection
+         *  is only used when built without libpq */
+        virtual bool hasControlCancel() const
+        {
+#ifdef LIBPQ_DECL_CANCEL
+            return false;
+#else
+            return true;
+#endif
+        }
 };
 
 #endif
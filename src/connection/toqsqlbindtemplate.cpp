@@ -0,0 +1,97 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "connection/toqsqlbindtemplate.h"
+#include "parsing/tsqllexer.h"
+
+#include <QtCore/QCache>
+#include <QtCore/QMutex>
+
+// Statements are mostly the toSQL texts of the tools, the cache only has to outlive their refresh interval
+#define TEMPLATE_CACHE_SIZE 500
+
+static QMutex CacheLock;
+static QCache<QString, toSQLBindTemplate::TokenList> Cache(TEMPLATE_CACHE_SIZE);
+
+toSQLBindTemplate::TokenList toSQLBindTemplate::tokens(const char *lexerName, QString const& sql)
+{
+    QString key = QString::fromLatin1(lexerName) + QChar('\n') + sql;
+    {
+        QMutexLocker lock(&CacheLock);
+        TokenList *cached = Cache.object(key);
+        if (cached)
+            return *cached;
+    }
+
+    TokenList ret;
+    std::unique_ptr <SQLLexer::Lexer> lexer = LexerFactTwoParmSing::Instance().create(lexerName, "", "toCustomLexer");
+    lexer->setStatement(sql);
+
+    SQLLexer::Lexer::token_const_iterator start = lexer->begin();
+    while (start->getTokenType() != SQLLexer::Token::X_EOF)
+    {
+        Token token;
+        token.Text = start->getText();
+        switch (start->getTokenType())
+        {
+            case SQLLexer::Token::L_BIND_VAR:
+                token.Type = Token::BIND;
+                token.Name = token.Text;
+                break;
+            case SQLLexer::Token::L_BIND_VAR_WITH_PARAMS:
+                {
+                    token.Type = Token::BIND_WITH_PARAMS;
+                    int pos = token.Text.indexOf('<');
+                    token.Name = token.Text.left(pos);              // ":f1"
+                    QString options = token.Text.mid(pos + 1);      // "varchar,noquote>"
+                    options.chop(1);
+                    token.Options = options.split(',');
+                }
+                break;
+            default:
+                token.Type = Token::TEXT;
+                break;
+        }
+        // merge plain text, the consumers only look at bind variables
+        if (token.Type == Token::TEXT && !ret.isEmpty() && ret.last().Type == Token::TEXT)
+            ret.last().Text += token.Text;
+        else
+            ret << token;
+        start++;
+    }
+
+    QMutexLocker lock(&CacheLock);
+    Cache.insert(key, new TokenList(ret));
+    return ret;
+}
@@ -99,7 +99,11 @@ QList<toConnectionProviderFinder::ConnectionProvirerParams>  toQSqlFinder::find(
         mysql.insert("PROVIDER", QT_MYSQL_DRIVER);
         retval.append(mysql);
     }
-    if (drivers.contains(QT_PGSQL_DRIVER))
+    bool pgsql = drivers.contains(QT_PGSQL_DRIVER);
+#ifdef HAVE_POSTGRESQL_LIBPQ_FE_H
+    pgsql = true; // the native libpq connection does not need the QSql driver
+#endif
+    if (pgsql)
     {
         ConnectionProvirerParams psql;
         TLOG(5, toNoDecorator, __HERE__) << "Tora Supports:'" QT_PGSQL_DRIVER "'" << std::endl;
@@ -108,7 +112,11 @@ QList<toConnectionProviderFinder::ConnectionProvirerParams>  toQSqlFinder::find(
         psql.insert("PROVIDER", QT_PGSQL_DRIVER);
         retval.append(psql);
     }
-    if (drivers.contains(QT_ODBC_DRIVER))
+    bool odbc = drivers.contains(QT_ODBC_DRIVER);
+#ifdef HAVE_ODBC
+    odbc = true; // the native ODBC connection does not need the QSql driver
+#endif
+    if (odbc)
     {
         ConnectionProvirerParams odbc;
         TLOG(5, toNoDecorator, __HERE__) << "Tora Supports:'" QT_ODBC_DRIVER "'" << std::endl;
@@ -45,6 +45,8 @@
 #define QT_MYSQL_DRIVER "QMYSQL"
 #define QT_PGSQL_DRIVER "QPSQL"
 #define QT_ODBC_DRIVER  "QODBC"
+#define PQ_NATIVE_OPTION "Native libpq"
+#define ODBC_NATIVE_OPTION "Native ODBC"
 
 class toQSqlProvider : public toConnectionProvider
 {
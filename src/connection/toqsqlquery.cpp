@@ -42,6 +42,72 @@
 #include <QtSql/QSqlQuery>
 #include <QtSql/QSqlField>
 #include <QtSql/QSqlError>
+#include <QtSql/QSqlDriver>
+
+toQSqlRowBuffer::toQSqlRowBuffer(bool zeroDates)
+    : Rows(0)
+    , Row(0)
+    , Column(0)
+    , More(true)
+    , ZeroDates(zeroDates)
+{
+}
+
+void toQSqlRowBuffer::fill(QSqlQuery &q, unsigned columns, int rows)
+{
+    if (Values.size() != (int) columns)
+        Values.resize(columns);
+    for (unsigned c = 0; c < columns; c++)
+    {
+        Values[c].clear();
+        Values[c].reserve(rows);
+    }
+    Rows = Row = Column = 0;
+
+    do
+    {
+        for (unsigned c = 0; c < columns; c++)
+        {
+            if (q.isNull(c))
+            {
+                Values[c].append(toQValue());
+                continue;
+            }
+            QVariant val = q.value(c);
+            if (ZeroDates && val.isNull())
+            {
+                // empty dates (0000-00-00) are not null
+                if (val.type() == QVariant::Date)
+                    val = QVariant(QString("0000-00-00"));
+                else if (val.type() == QVariant::DateTime)
+                    val = QVariant(QString("0000-00-00T00:00:00"));
+            }
+            Values[c].append(toQValue::fromVariant(val));
+        }
+        Rows++;
+        More = q.next();
+    }
+    while (More && Rows < rows);
+}
+
+toQValue toQSqlRowBuffer::take(void)
+{
+    Q_ASSERT_X(!empty(), qPrintable(__QHERE__), "Row buffer is empty");
+    toQValue ret = Values.at(Column).at(Row);
+    if (++Column == Values.size())
+    {
+        Column = 0;
+        Row++;
+    }
+    return ret;
+}
+
+void toQSqlRowBuffer::clear(void)
+{
+    Values.clear();
+    Rows = Row = Column = 0;
+    More = true;
+}
 
 QSqlQuery* qsqlQuery::createQuery(const QString &query)
 {
@@ -57,7 +123,7 @@ QSqlQuery* qsqlQuery::createQuery(const QString &query)
 qsqlQuery::qsqlQuery(toQueryAbstr *query, toQSqlConnectionSub *conn)
     : queryImpl(query)
     , Connection(conn)
-    , Column(0)
+    , Buffer(true)
 {
     EOQ = true;
     Query = NULL;
@@ -109,42 +175,17 @@ toQValue qsqlQuery::readValue(void)
     if (EOQ)
         throw QString::fromLatin1("Tried to read past end of query");
 
-    LockingPtr<QSqlDatabase> ptr(Connection->Connection, Connection->Lock);
-    QVariant val;
-    bool fixEmpty = false;
-    {
-        val = Query->value(Column);
-        if (Query->isNull(Column))
-            val.clear();
-        else if ((val.type() == QVariant::Date || val.type() == QVariant::DateTime) && val.isNull())
-            fixEmpty = true;
-    }
-    if (fixEmpty)
+    if (Buffer.empty())
     {
-        switch (val.type())
-        {
-            case QVariant::Date:
-                val = QVariant(QString("0000-00-00"));
-                break;
-            case QVariant::DateTime:
-                val = QVariant(QString("0000-00-00T00:00:00"));
-                break;
-            default:
-                break;
-                // Do nothing
-        }
+        LockingPtr<QSqlDatabase> ptr(Connection->Connection, Connection->Lock);
+        Buffer.fill(*Query, Record.count());
     }
 
     // sapdb marks value as invalid on some views
     // for example tables,indexes etc, so ignore this check
-    Column++;
-    if (Column == (unsigned int) Record.count())
-    {
-        Column = 0;
-        EOQ = !Query->next();
-    }
-
-    return toQValue::fromVariant(val);
+    toQValue ret = Buffer.take();
+    EOQ = Buffer.eof();
+    return ret;
 }
 
 bool qsqlQuery::eof(void)
@@ -202,7 +243,7 @@ void qsqlQuery::checkQuery(void) // Must *not* call while locked
     {
         Record = Query->record();
         EOQ = !Query->next();
-        Column = 0;
+        Buffer.clear();
     }
     else
     {
@@ -210,6 +251,82 @@ void qsqlQuery::checkQuery(void) // Must *not* call while locked
     }
 }
 
+int qsqlQuery::executeBatch(QList<toQueryParams> const& rows, QString &error)
+{
+    LockingPtr<QSqlDatabase> ptr(Connection->Connection, Connection->Lock);
+
+    // The statement is prepared on the first batch and reused for the following ones
+    if (!Query)
+    {
+        Query = new QSqlQuery(*ptr);
+        if (!Query->prepare(query()->sql()))
+        {
+            error = Query->lastError().text();
+            delete Query;
+            Query = NULL;
+            return 0;
+        }
+    }
+    return batchExec(*Query, QStringList(), rows, error, BatchAffected);
+}
+
+static inline QVariant batchValue(toQValue const& val)
+{
+    return val.isNull() ? QVariant(QVariant::String) : val.toQVariant();
+}
+
+int qsqlQuery::batchExec(QSqlQuery &q, QStringList const& binds, QList<toQueryParams> const& rows, QString &error, unsigned long &affected)
+{
+    affected = 0;
+    if (rows.isEmpty())
+        return 0;
+    int cols = binds.isEmpty() ? rows.first().size() : binds.size();
+
+    if (q.driver()->hasFeature(QSqlDriver::BatchOperations))
+    {
+        for (int col = 0; col < cols; col++)
+        {
+            QVariantList vals;
+            Q_FOREACH(toQueryParams const& row, rows)
+                vals << batchValue(row.value(col));
+            if (binds.isEmpty())
+                q.bindValue(col, vals);
+            else
+                q.bindValue(binds.at(col), vals);
+        }
+        bool ok = q.execBatch();
+        affected = qMax(q.numRowsAffected(), 0);
+        if (ok)
+            return rows.size();
+
+        error = q.lastError().text();
+        // Native batch stops on the first failing row, rows affected so far precede it
+        return qBound(0, (int)affected, rows.size() - 1);
+    }
+
+    // QSqlQuery::execBatch is emulated by a loop over exec() for this driver. Do the same
+    // here, so the failing row is known.
+    int done = 0;
+    Q_FOREACH(toQueryParams const& row, rows)
+    {
+        for (int col = 0; col < cols; col++)
+        {
+            if (binds.isEmpty())
+                q.bindValue(col, batchValue(row.value(col)));
+            else
+                q.bindValue(binds.at(col), batchValue(row.value(col)));
+        }
+        if (!q.exec())
+        {
+            error = q.lastError().text();
+            break;
+        }
+        affected += qMax(q.numRowsAffected(), 0);
+        done++;
+    }
+    return done;
+}
+
 toQColumnDescriptionList qsqlQuery::Describe(const QString &type, QSqlRecord record)
 {
     toQColumnDescriptionList ret;
@@ -39,10 +39,50 @@
 
 #include <QtSql/QSqlRecord>
 #include <QtCore/QList>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
 
 class QSqlQuery;
 class toQSqlConnectionSub;
 
+/** Values of a QSqlQuery read in batches of rows.
+ *  The whole batch is read while the connection is locked once, readValue then only walks the buffer.
+ */
+class toQSqlRowBuffer
+{
+    public:
+        toQSqlRowBuffer(bool zeroDates = false);
+
+        /** Read up to @p rows rows of @p q starting at its current (valid) row.
+         *  Must be called with the connection locked.
+         */
+        void fill(QSqlQuery &q, unsigned columns, int rows = 256);
+
+        /** Next value in row order, @ref fill must be called when @ref empty */
+        toQValue take(void);
+
+        /** All values of the last batch were taken */
+        bool empty(void) const
+        {
+            return Row >= Rows;
+        }
+
+        /** All values were taken and the query has no more rows */
+        bool eof(void) const
+        {
+            return empty() && !More;
+        }
+
+        void clear(void);
+    private:
+        QVector<QVector<toQValue> > Values;     // one vector per column
+        int Rows;
+        int Row;
+        int Column;
+        bool More;
+        bool ZeroDates;                         // return empty dates as 0000-00-00 (see qsqlQuery)
+};
+
 class qsqlQuery : public queryImpl
 {
     public:
@@ -65,6 +105,15 @@ class qsqlQuery : public queryImpl
         unsigned columns(void) override;
 
         toQColumnDescriptionList describe(void) override;
+
+        int executeBatch(QList<toQueryParams> const& rows, QString &error) override;
+
+        /** Execute prepared query @p q once for each of @p rows. Values are bound by name when
+         * @p binds is not empty, by position otherwise.
+         * @param affected Set to the number of rows affected
+         * @return Number of leading rows executed successfully (see @ref queryImpl::executeBatch)
+         */
+        static int batchExec(QSqlQuery &q, QStringList const& binds, QList<toQueryParams> const& rows, QString &error, unsigned long &affected);
     protected:
         static toQColumnDescriptionList Describe(const QString &type, QSqlRecord record);
 
@@ -72,7 +121,7 @@ class qsqlQuery : public queryImpl
         QSqlRecord Record;
         toQSqlConnectionSub *Connection;
         bool EOQ;
-        unsigned int Column;
+        toQSqlRowBuffer Buffer;
 
         void checkQuery(void);
 
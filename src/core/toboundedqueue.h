@@ -0,0 +1,108 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QQueue>
+#include <QtCore/QWaitCondition>
+
+/** Bounded queue between a producer and a consumer thread. The producer is blocked when the
+ *  consumer can not keep up, so memory usage does not depend on the amount of data passed.
+ */
+template <typename T> class toBoundedQueue
+{
+    public:
+        toBoundedQueue(int capacity)
+            : Capacity(capacity)
+            , Finished(false)
+            , Cancelled(false)
+        { }
+
+        /** @return false when the queue was cancelled */
+        bool push(T const& item)
+        {
+            QMutexLocker lock(&Mutex);
+            while (Queue.size() >= Capacity && !Cancelled)
+                NotFull.wait(&Mutex);
+            if (Cancelled)
+                return false;
+            Queue.enqueue(item);
+            NotEmpty.wakeOne();
+            return true;
+        }
+
+        /** @return false when there is no more data (or the queue was cancelled) */
+        bool pop(T &item)
+        {
+            QMutexLocker lock(&Mutex);
+            while (Queue.isEmpty() && !Finished && !Cancelled)
+                NotEmpty.wait(&Mutex);
+            if (Cancelled || Queue.isEmpty())
+                return false;
+            item = Queue.dequeue();
+            NotFull.wakeOne();
+            return true;
+        }
+
+        /** Producer has no more data */
+        void finish(void)
+        {
+            QMutexLocker lock(&Mutex);
+            Finished = true;
+            NotEmpty.wakeAll();
+        }
+
+        /** Stop both sides */
+        void cancel(void)
+        {
+            QMutexLocker lock(&Mutex);
+            Cancelled = true;
+            NotEmpty.wakeAll();
+            NotFull.wakeAll();
+        }
+
+        bool isCancelled(void)
+        {
+            QMutexLocker lock(&Mutex);
+            return Cancelled;
+        }
+    private:
+        QMutex Mutex;
+        QWaitCondition NotEmpty, NotFull;
+        QQueue<T> Queue;
+        int Capacity;
+        bool Finished, Cancelled;
+};
@@ -44,8 +44,137 @@
 #include "core/toconnectionprovider.h"
 #include "widgets/toworkspace.h"
 #include "core/todatabaseconfig.h"
+#include "core/tosql.h"
 
 #include <QMenu>
+#include <QtCore/QTimer>
+#include <QtCore/QThreadPool>
+#include <QtCore/QRunnable>
+#include <QtCore/QElapsedTimer>
+
+// A round trip of a session check taking longer is cancelled (ms)
+#define KEEP_ALIVE_TIMEOUT 10000
+// How often a running check is watched (ms)
+#define KEEP_ALIVE_POLL 1000
+// How long a closed connection waits for its check (ms), see ~toConnection
+#define KEEP_ALIVE_CLOSE_WAIT 2000
+
+static toSQL SQLPing("toConnection:Ping",
+                     "SELECT 1 FROM DUAL",
+                     "Cheap statement used to check that an idle session is still alive");
+
+static toSQL SQLPingAny("toConnection:Ping",
+                        "SELECT 1",
+                        "",
+                        "",
+                        "Any");
+
+/* State shared by a connection and its session check. The check can outlive the connection:
+ * when it is stuck in the network, ~toConnection abandons it with the sessions it holds.
+ * The check touches the connection only under Lock and only when not Abandoned.
+ */
+struct toConnectionKeepAliveGuard
+{
+    toConnectionKeepAliveGuard()
+        : Pinging(NULL)
+        , Running(false)
+        , Cancelled(false)
+        , Abandoned(false)
+    {}
+
+    QMutex Lock;
+    toConnectionSub *Pinging;   // session with a round trip in progress
+    QElapsedTimer Started;      // of this round trip
+    bool Running, Cancelled, Abandoned;
+};
+
+/* Checks idle sessions of a connection from a pool thread (see toConnection::slotKeepAlive).
+ * The sessions are lent while being checked, so no query can take them meanwhile.
+ * Dropped sessions are reopened in firewall mode only, otherwise the next borrowSub opens one.
+ */
+class toConnectionKeepAlive : public QRunnable
+{
+    public:
+        toConnectionKeepAlive(toConnection &conn, QSharedPointer<toConnectionKeepAliveGuard> const& guard, QList<toConnectionSub*> const& subs, bool replace)
+            : Connection(conn)
+            , Guard(guard)
+            , Subs(subs)
+            , Replace(replace)
+        {}
+
+        void run() override
+        {
+            bool reconnect = Replace;
+            Q_FOREACH(toConnectionSub *sub, Subs)
+            {
+                {
+                    QMutexLocker lock(&Guard->Lock);
+                    if (Guard->Abandoned)
+                        return;
+                    // the connection is being closed, the sessions are returned unchecked
+                    if (Connection.Abort)
+                    {
+                        Connection.keepAliveDone(sub);
+                        continue;
+                    }
+                    Guard->Pinging = sub;
+                    Guard->Cancelled = false;
+                    Guard->Started.start();
+                }
+
+                int latency = ping(sub);
+
+                {
+                    QMutexLocker lock(&Guard->Lock);
+                    Guard->Pinging = NULL;
+                    if (Guard->Abandoned)
+                        return;
+                    Connection.pingDone(sub, latency);
+                    if (latency >= 0 || !reconnect || Connection.Abort)
+                        continue;
+                }
+
+                // when the database is not reachable do not wait for a timeout on each dropped session
+                toConnectionSub *fresh = Connection.openSub();
+                QMutexLocker lock(&Guard->Lock);
+                if (Guard->Abandoned)
+                    return;
+                reconnect = Connection.replaceSub(fresh);
+            }
+            QMutexLocker lock(&Guard->Lock);
+            Guard->Running = false;
+        }
+    private:
+        /* Runs a cheap statement on a session which was idle for a while.
+         * Returns its round trip (ms), -1 when it failed or was cancelled by toConnection::slotKeepAlive.
+         */
+        int ping(toConnectionSub *sub)
+        {
+            QElapsedTimer timer;
+            timer.start();
+            try
+            {
+                toConnectionSubLoan loan(Connection, sub);
+                toQuery query(loan, SQLPing, toQueryParams());
+                query.eof();
+                return timer.elapsed();
+            }
+            catch (const QString &str)
+            {
+                TLOG(1, toDecorator, __HERE__) << "toConnection session check failed: " << str << std::endl;
+            }
+            catch (...)
+            {
+                TLOG(1, toDecorator, __HERE__) << "toConnection session check failed" << std::endl;
+            }
+            return -1;
+        }
+
+        toConnection &Connection;
+        QSharedPointer<toConnectionKeepAliveGuard> Guard;
+        QList<toConnectionSub*> Subs;
+        bool Replace;
+};
 
 toConnection::toConnection(const QString &provider,
                            const QString &user, const QString &password,
@@ -67,6 +196,11 @@ toConnection::toConnection(const QString &provider,
     , ConnectionOptions(provider, host, database, user, password, schema, color , 0, options)
     , pCache(NULL)
     , LoanCnt(0)
+    , ControlSub(NULL)
+    , KeepAliveTimer(NULL)
+    , KeepAlivePool(NULL)
+    , Latency(-1)
+    , Lost(false)
 {
     pConnectionImpl = toConnectionProviderRegistrySing::Instance().get(provider).createConnectionImpl(*this);
     pTrait = toConnectionProviderRegistrySing::Instance().get(provider).createConnectionTrait();
@@ -85,6 +219,7 @@ toConnection::toConnection(const QString &provider,
         QMutexLocker clock(&ConnectionLock);
         if (toConfigurationNewSingle::Instance().option(ToConfiguration::Database::ObjectCacheInt).toInt() == toCache::ON_CONNECT)
             pCache->readCache();
+        startKeepAlive();
     }
 }
 
@@ -103,6 +238,11 @@ toConnection::toConnection(const toConnectionOptions &opts)
     , ConnectionOptions(opts)
     , pCache(NULL)
     , LoanCnt(0)
+    , ControlSub(NULL)
+    , KeepAliveTimer(NULL)
+    , KeepAlivePool(NULL)
+    , Latency(-1)
+    , Lost(false)
 {
     pConnectionImpl = toConnectionProviderRegistrySing::Instance().get(Provider).createConnectionImpl(*this);
     pTrait = toConnectionProviderRegistrySing::Instance().get(Provider).createConnectionTrait();
@@ -121,6 +261,7 @@ toConnection::toConnection(const toConnectionOptions &opts)
         QMutexLocker clock(&ConnectionLock);
         if (toConfigurationNewSingle::Instance().option(ToConfiguration::Database::ObjectCacheInt) == toCache::ON_CONNECT)
             pCache->readCache();
+        startKeepAlive();
     }
 }
 
@@ -140,6 +281,11 @@ toConnection::toConnection(const toConnection &other)
     , ConnectionOptions(other.ConnectionOptions)
     , pCache(NULL)
     , LoanCnt(0)
+    , ControlSub(NULL)
+    , KeepAliveTimer(NULL)
+    , KeepAlivePool(NULL)
+    , Latency(-1)
+    , Lost(false)
 {
     //tool Connection = toConnectionProvider::connection(Provider, this);
     //ConnectionPool = new toConnectionPool(this);
@@ -159,9 +305,174 @@ toConnectionSub* toConnection::addConnection()
 {
     Utils::toBusy busy;
     toConnectionSub *sub = pConnectionImpl->createConnection();
+    sub->setLastUsed();
+    if (isLost())
+        setHealth(latency(), false); // the database is reachable again
     return sub;
 }
 
+/* The timer runs at half of the connection test interval, so no idle session
+ * waits longer than 1.5 interval for its check. The interval is re-read on each
+ * tick, changing the option does not require reconnecting.
+ */
+static int keepAliveTick()
+{
+    int interval = toConfigurationNewSingle::Instance().option(ToConfiguration::Database::ConnTestIntervalInt).toInt();
+    return interval > 0 ? qMax(interval, 10) * 500 : 60000;
+}
+
+void toConnection::startKeepAlive()
+{
+    KeepAlivePool = new QThreadPool(this);
+    KeepAlivePool->setMaxThreadCount(1);
+    KeepAliveGuard = QSharedPointer<toConnectionKeepAliveGuard>(new toConnectionKeepAliveGuard());
+
+    KeepAliveTimer = new QTimer(this);
+    connect(KeepAliveTimer, SIGNAL(timeout()), this, SLOT(slotKeepAlive()));
+    KeepAliveTimer->start(keepAliveTick());
+}
+
+void toConnection::slotKeepAlive()
+{
+    // While a check runs it is watched more often, no other check is started
+    {
+        QMutexLocker lock(&KeepAliveGuard->Lock);
+        if (KeepAliveGuard->Running)
+        {
+            KeepAliveTimer->setInterval(KEEP_ALIVE_POLL);
+            if (KeepAliveGuard->Pinging && !KeepAliveGuard->Cancelled && KeepAliveGuard->Started.hasExpired(KEEP_ALIVE_TIMEOUT))
+            {
+                // the session fails the check when the provider breaks the round trip, it is dropped then
+                TLOG(1, toDecorator, __HERE__) << "toConnection session check timed out" << std::endl;
+                KeepAliveGuard->Cancelled = true;
+                KeepAliveGuard->Pinging->cancel();
+                setHealth(latency(), true);
+            }
+            return;
+        }
+    }
+    KeepAliveTimer->setInterval(keepAliveTick());
+
+    int interval = toConfigurationNewSingle::Instance().option(ToConfiguration::Database::ConnTestIntervalInt).toInt();
+    if (Abort || interval <= 0)
+        return;
+    bool replace = toConfigurationNewSingle::Instance().option(ToConfiguration::Database::FirewallModeBool).toBool();
+
+    QList<toConnectionSub*> idle;
+    {
+        QMutexLocker clock(&ConnectionLock);
+        QDateTime now = QDateTime::currentDateTime();
+        Q_FOREACH(toConnectionSub *sub, Connections)
+        {
+            if (sub->lastUsed().secsTo(now) >= interval)
+                idle << sub;
+        }
+        Q_FOREACH(toConnectionSub *sub, idle)
+        {
+            Connections.remove(sub);
+            LentConnections.insert(sub);
+            LoanCnt.fetchAndAddAcquire(1);
+        }
+    }
+    if (idle.isEmpty())
+        return;
+    {
+        QMutexLocker lock(&KeepAliveGuard->Lock);
+        KeepAliveGuard->Running = true;
+    }
+    KeepAlivePool->start(new toConnectionKeepAlive(*this, KeepAliveGuard, idle, replace));
+}
+
+/* Records the round trip of a session check (-1 when it failed) and returns the session.
+ * A session which failed the check is marked broken, keepAliveDone drops it then.
+ */
+void toConnection::pingDone(toConnectionSub *sub, int latency)
+{
+    if (latency < 0)
+    {
+        sub->setBroken();
+        setHealth(this->latency(), true);
+    }
+    else
+    {
+        sub->setLastUsed();
+        setHealth(latency, false);
+    }
+    keepAliveDone(sub);
+}
+
+/* Returns a session checked by toConnectionKeepAlive. Unlike putBackSub there is
+ * no rollback, the session was idle in the pool before the check.
+ */
+void toConnection::keepAliveDone(toConnectionSub *sub)
+{
+    QMutexLocker clock(&ConnectionLock);
+    LoanCnt.deref();
+    bool removed = LentConnections.remove(sub);
+    Q_ASSERT_X(removed, qPrintable(__QHERE__), "Lent connection not found");
+    if (sub->isBroken())
+        delete sub;
+    else
+        Connections.insert(sub);
+}
+
+/* Opens a session in place of a dropped one, NULL when the database is not reachable.
+ * Nothing but pConnectionImpl is used, it is kept when ~toConnection abandons the check.
+ */
+toConnectionSub* toConnection::openSub()
+{
+    try
+    {
+        return pConnectionImpl->createConnection();
+    }
+    catch (const QString &str)
+    {
+        TLOG(1, toDecorator, __HERE__) << "toConnection could not reopen a dropped session: " << str << std::endl;
+    }
+    catch (...)
+    {
+        TLOG(1, toDecorator, __HERE__) << "toConnection could not reopen a dropped session" << std::endl;
+    }
+    return NULL;
+}
+
+/* Pools a session opened by openSub, so the next borrowSub does not have to wait for one. */
+bool toConnection::replaceSub(toConnectionSub *sub)
+{
+    if (!sub)
+        return false;
+    sub->setLastUsed();
+    if (isLost())
+        setHealth(latency(), false); // the database is reachable again
+    QMutexLocker clock(&ConnectionLock);
+    Connections.insert(sub);
+    return true;
+}
+
+int toConnection::latency() const
+{
+    QMutexLocker lock(&HealthLock);
+    return Latency;
+}
+
+bool toConnection::isLost() const
+{
+    QMutexLocker lock(&HealthLock);
+    return Lost;
+}
+
+void toConnection::setHealth(int latency, bool lost)
+{
+    {
+        QMutexLocker lock(&HealthLock);
+        if (Latency == latency && Lost == lost)
+            return;
+        Latency = latency;
+        Lost = lost;
+    }
+    emit healthChanged();
+}
+
 
 void toConnection::closeConnection(toConnectionSub *sub)
 {
@@ -200,15 +511,75 @@ void toConnection::cancelAll(void)
     //conn ConnectionPool->cancelAll();
 }
 
+void toConnection::openControl(void)
+{
+    QMutexLocker lock(&ControlLock);
+    if (ControlSub && ControlSub->isBroken())
+    {
+        delete ControlSub;
+        ControlSub = NULL;
+    }
+    if (!ControlSub && !Abort)
+        ControlSub = pConnectionImpl->createConnection();
+}
+
+void toConnection::controlExecute(QString const& sql, toQueryParams const& params)
+{
+    openControl();
+    QMutexLocker lock(&ControlLock);
+    if (!ControlSub)
+        throw exception(tr("Control connection is not available"));
+    try
+    {
+        toConnectionSubLoan c(*this, ControlSub);
+        toQuery query(c, sql, params);
+        query.eof();
+    }
+    catch (...)
+    {
+        // do not keep a session which failed, the next request opens a new one
+        delete ControlSub;
+        ControlSub = NULL;
+        throw;
+    }
+}
+
 toConnection::~toConnection()
 {
     Utils::toBusy busy;
     Abort = true;
 
+    // Wait for the session check, it holds loans too. A check stuck in the network (no answer to the
+    // cancel either) is abandoned with its sessions, its thread pool and pConnectionImpl.
+    bool abandoned = false;
+    if (KeepAlivePool)
+    {
+        {
+            QMutexLocker lock(&KeepAliveGuard->Lock);
+            if (KeepAliveGuard->Pinging && !KeepAliveGuard->Cancelled)
+            {
+                KeepAliveGuard->Cancelled = true;
+                KeepAliveGuard->Pinging->cancel();
+            }
+        }
+        if (!KeepAlivePool->waitForDone(KEEP_ALIVE_CLOSE_WAIT))
+        {
+            QMutexLocker lock(&KeepAliveGuard->Lock);
+            if (KeepAliveGuard->Running)
+            {
+                TLOG(1, toDecorator, __HERE__) << "toConnection session check abandoned" << std::endl;
+                KeepAliveGuard->Abandoned = abandoned = true;
+                // ~QThreadPool would wait for it
+                KeepAlivePool->setParent(NULL);
+                KeepAlivePool = NULL;
+            }
+        }
+    }
+
 #if QT_VERSION < 0x050000
-    Q_ASSERT_X( (int)LoanCnt == 0 , qPrintable(__QHERE__), "toConnection deleted while BG query is running");
+    Q_ASSERT_X( abandoned || (int)LoanCnt == 0 , qPrintable(__QHERE__), "toConnection deleted while BG query is running");
 #else
-    Q_ASSERT_X( LoanCnt.loadAcquire() == 0 , qPrintable(__QHERE__), "toConnection deleted while BG query is running");
+    Q_ASSERT_X( abandoned || LoanCnt.loadAcquire() == 0 , qPrintable(__QHERE__), "toConnection deleted while BG query is running");
 #endif
 
     if(pCache)
@@ -233,7 +604,13 @@ toConnection::~toConnection()
 
         QMutexLocker lock(&ConnectionLock);
     }
-    delete pConnectionImpl;
+    {
+        QMutexLocker lock(&ControlLock);
+        delete ControlSub;
+        ControlSub = NULL;
+    }
+    if (!abandoned)
+        delete pConnectionImpl;
 }
 
 void toConnection::commit(toConnectionSub *sub)
@@ -445,6 +822,8 @@ toConnection& toConnection::currentConnection(QObject *cur)
 
 toConnectionSub* toConnection::borrowSub()
 {
+    // Sessions idle for too long are checked by slotKeepAlive in the background, no round trip here:
+    // a check on the GUI thread blocks it as long as the network does not answer
     QMutexLocker clock(&ConnectionLock);
     if (!Connections.empty())
     {
@@ -459,18 +838,16 @@ toConnectionSub* toConnection::borrowSub()
 #endif
         return retval;
     }
-    else
-    {
-        toConnectionSub* retval = addConnection();
-        LoanCnt.fetchAndAddAcquire(1);
-        LentConnections.insert(retval);
+
+    toConnectionSub* retval = addConnection();
+    LoanCnt.fetchAndAddAcquire(1);
+    LentConnections.insert(retval);
 #if QT_VERSION < 0x050000
-        Q_ASSERT_X((int)LoanCnt == LentConnections.size(), qPrintable(__QHERE__), "Invalid number of lent toConnectionSub(s)");
+    Q_ASSERT_X((int)LoanCnt == LentConnections.size(), qPrintable(__QHERE__), "Invalid number of lent toConnectionSub(s)");
 #else
-        Q_ASSERT_X(LoanCnt.loadAcquire() == LentConnections.size(), qPrintable(__QHERE__), "Invalid number of lent toConnectionSub(s)");
+    Q_ASSERT_X(LoanCnt.loadAcquire() == LentConnections.size(), qPrintable(__QHERE__), "Invalid number of lent toConnectionSub(s)");
 #endif
-        return retval;
-    }
+    return retval;
 }
 
 void toConnection::putBackSub(toConnectionSub *conn)
@@ -481,7 +858,7 @@ void toConnection::putBackSub(toConnectionSub *conn)
 
     try
     {
-        if (conn->hasTransaction())
+        if (!conn->isBroken() && conn->hasTransaction())
             conn->rollback();
     }
     TOCATCH
@@ -495,7 +872,10 @@ void toConnection::putBackSub(toConnectionSub *conn)
         delete conn;
     }
     else
+    {
+        conn->setLastUsed();
         Connections.insert(conn);
+    }
     bool removed = LentConnections.remove(conn);
     Q_ASSERT_X(removed, qPrintable(__QHERE__), "Lent connection not found");
 #if QT_VERSION < 0x050000
@@ -38,6 +38,7 @@
 #include "core/tora_export.h"
 #include "core/toconfenum.h"
 #include "core/toconnectionoptions.h"
+#include "core/toqvalue.h"
 
 #include <QtCore/QObject>
 #include <QtCore/QPointer>
@@ -50,10 +51,14 @@
 #include <QtCore/QAtomicInt>
 #include <QtCore/QVariant>
 #include <QtCore/QMutex>
+#include <QtCore/QSharedPointer>
 
 class QWidget;
 class QAction;
 class QMenu;
+class QTimer;
+class QThreadPool;
+struct toConnectionKeepAliveGuard;
 
 class toConnectionSub;
 class toConnectionTraits;
@@ -207,6 +212,12 @@ class toConnection : public QObject
             return *pTrait;
         }
 
+        /** Round trip time (msecs) of the last check of an idle session, -1 when none was checked yet. */
+        int latency() const;
+
+        /** True when the last check of an idle session failed and no new session could be opened since. */
+        bool isLost() const;
+
         // SETTERS
 
         /** Change password of connection. */
@@ -277,6 +288,18 @@ class toConnection : public QObject
         /** Try to stop all running queries. */
         void cancelAll(void);
 
+        /** Open the control connection unless it is open already.
+         * The control connection is not part of the pool, it is kept open for cancel requests
+         * (see @ref toConnectionSub::cancel) so they do not have to wait for a new session.
+         * Blocks, call it from a background thread.
+         */
+        void openControl(void);
+
+        /** Execute a statement on the control connection, opens it when needed.
+         * Blocks, call it from a background thread.
+         */
+        void controlExecute(QString const& sql, toQueryParams const& params);
+
         // NESTED CLASSES - types
 
         /** Class that could be used to throw exceptions in connection errors. Must use if you
@@ -343,6 +366,10 @@ class toConnection : public QObject
                 virtual void closeConnection(toConnectionSub *) = 0;
         };
 
+    signals:
+        /** Emitted when @ref latency or @ref isLost changes, can be emitted from a background thread. */
+        void healthChanged();
+
     protected:
         bool Abort;
         mutable QMutex ConnectionLock;
@@ -350,6 +377,11 @@ class toConnection : public QObject
     private slots:
         void commandCallback(QAction *);
 
+        /** Check the sessions idle for longer than the connection test interval, reopen dropped ones in firewall mode.
+         *  Cancels the round trip of a check running for too long.
+         */
+        void slotKeepAlive();
+
     private:
 
         // Utility class to store any pointer inside QVariant
@@ -376,6 +408,14 @@ class toConnection : public QObject
         toConnectionSub* addConnection(void);
         void closeConnection(toConnectionSub *sub);
 
+        void startKeepAlive(void);
+        void pingDone(toConnectionSub *sub, int latency);
+        void keepAliveDone(toConnectionSub *sub);
+        toConnectionSub* openSub(void);
+        bool replaceSub(toConnectionSub *sub);
+        void setHealth(int latency, bool lost);
+        friend class toConnectionKeepAlive;
+
         QString Provider;
         QString User;
         QString Password;
@@ -394,6 +434,14 @@ class toConnection : public QObject
         toCache *pCache;
         QAtomicInt LoanCnt;
         QSet<QAction*> ConnectionActions;
+        QMutex ControlLock;
+        toConnectionSub *ControlSub;  // see openControl
+        QTimer *KeepAliveTimer;
+        QThreadPool *KeepAlivePool;   // session checks run here, one at a time
+        QSharedPointer<toConnectionKeepAliveGuard> KeepAliveGuard;
+        mutable QMutex HealthLock;
+        int Latency;
+        bool Lost;
 }; // toConnection
 
 Q_DECLARE_METATYPE(toConnection::exception);
@@ -37,12 +37,18 @@
 #include "core/toglobalconfiguration.h"
 #include "core/utils.h"
 #include "core/tooracleconst.h"
+#include "core/toconnection.h"
+#include "core/toconnectionregistry.h"
 
 #include <QtCore/QSettings>
 
 toConnectionModel::toConnectionModel(QObject *parent)
     : QAbstractTableModel(parent)
 {
+    toConnectionRegistry *registry = &toConnectionRegistrySing::Instance();
+    connect(registry, SIGNAL(dataChanged(const QModelIndex &, const QModelIndex &)), this, SLOT(slotConnectionsChanged()));
+    connect(registry, SIGNAL(rowsInserted(const QModelIndex &, int, int)), this, SLOT(slotConnectionsChanged()));
+    connect(registry, SIGNAL(rowsRemoved(const QModelIndex &, int, int)), this, SLOT(slotConnectionsChanged()));
 }
 
 void toConnectionModel::setupData(QMap<int, toConnectionOptions> list)
@@ -140,6 +146,83 @@ int toConnectionModel::findConnection(toConnectionOptions const &conn) const
     return m_data.key(conn, -1);
 }
 
+toConnectionOptions toConnectionModel::connectOptions(toConnectionOptions const &opt)
+{
+    toConnectionOptions retval(opt);
+    retval.port = 0;
+
+    if (opt.port)
+        retval.host += ":" + QString::number(opt.port);
+
+    if (opt.provider == ORACLE_INSTANTCLIENT)
+    {
+        // create the rest of the connect string. this will work
+        // without an ORACLE_HOME.
+        retval.database = "//" + retval.host + "/" + opt.database;
+        retval.host = "";
+    }
+
+    if (opt.provider.startsWith("Oracle"))
+        retval.provider = "Oracle";
+
+    return retval;
+}
+
+/* @p conn are the options the connection is opened with, schema can be empty when the saved one is */
+static bool sameConnection(toConnectionOptions const &opt, toConnectionOptions const &conn)
+{
+    toConnectionOptions const c = toConnectionModel::connectOptions(opt);
+    return conn.username == c.username &&
+           conn.provider == c.provider &&
+           conn.host == c.host &&
+           conn.database == c.database &&
+           (c.schema.isEmpty() || conn.schema == c.schema);
+}
+
+toConnection* toConnectionModel::openConnection(toConnectionOptions const &opt) const
+{
+    Q_FOREACH(toConnection *conn, toConnectionRegistrySing::Instance().connections())
+    {
+        // called from data() on each repaint, a failing connection must not break the view
+        try
+        {
+            toConnectionOptions c(conn->connectionOptions());
+            c.schema = conn->defaultSchema();
+            if (sameConnection(opt, c))
+                return conn;
+        }
+        catch (...) {}
+    }
+    return NULL;
+}
+
+void toConnectionModel::setStatus(toConnectionOptions const &conn, QString const &status)
+{
+    if (status.isEmpty())
+        m_status.remove(conn);
+    else
+        m_status.insert(conn, status);
+    slotConnectionsChanged();
+}
+
+QString toConnectionModel::status(toConnectionOptions const &opt) const
+{
+    QMapIterator<toConnectionOptions, QString> i(m_status);
+    while (i.hasNext())
+    {
+        i.next();
+        if (sameConnection(opt, i.key()))
+            return i.value();
+    }
+    return QString();
+}
+
+void toConnectionModel::slotConnectionsChanged()
+{
+    if (!m_data.isEmpty())
+        emit dataChanged(index(0, 6), index(rowCount() - 1, 6));
+}
+
 void toConnectionModel::saveConnection(toConnectionOptions const &opt)
 {
     int pos = findConnection(opt);
@@ -195,6 +278,8 @@ QVariant toConnectionModel::headerData(int section, Qt::Orientation orientation,
             return "Username";
         case 5 :
             return "Schema";
+        case 6 :
+            return "Status";
     }
     return "oops!";
 }
@@ -223,6 +308,17 @@ QVariant toConnectionModel::data(const QModelIndex & index, int role) const
                     return opt.username;
                 case 5 :
                     return opt.schema;
+                case 6 :
+                    {
+                        toConnection *conn = openConnection(opt);
+                        if (!conn)
+                            return status(opt);
+                        if (conn->isLost())
+                            return tr("Lost");
+                        if (conn->latency() < 0)
+                            return tr("Open");
+                        return tr("%1 ms").arg(conn->latency());
+                    }
                 default :
                     return "oops!";
             }
@@ -230,6 +326,26 @@ QVariant toConnectionModel::data(const QModelIndex & index, int role) const
         case Qt::DecorationRole:
             if (index.column() == 1 && toConfigurationNewSingle::Instance().option(ToConfiguration::Global::ColorizedConnectionsBool).toBool())
                 return Utils::connectionColorPixmap(opt.color);
+            if (index.column() == 6)
+            {
+                // connection quality by the round trip of the last idle session check
+                toConnection *conn = openConnection(opt);
+                if (!conn || (!conn->isLost() && conn->latency() < 0))
+                    return QVariant();
+                if (conn->isLost() || conn->latency() >= 1000)
+                    return Utils::connectionColorPixmap("red");
+                if (conn->latency() >= 100)
+                    return Utils::connectionColorPixmap("orange");
+                return Utils::connectionColorPixmap("green");
+            }
+            break;
+        case Qt::ToolTipRole:
+            if (index.column() == 6)
+            {
+                if (!openConnection(opt))
+                    return status(opt);
+                return tr("Round trip of the last check of an idle session");
+            }
             break;
     }
     return QVariant();
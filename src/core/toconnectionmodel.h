@@ -39,6 +39,8 @@
 
 #include <QtCore/QAbstractTableModel>
 
+class toConnection;
+
 /*! \brief Display imported/available connections in
 the Import dialog's view.
 \author Petr Vanek <petr@scribus.info>
@@ -70,13 +72,23 @@ class toConnectionModel : public QAbstractTableModel
         //! \brief Find connection's index
         int findConnection(toConnectionOptions const&) const;
 
+        //! \brief Find the open connection made from saved options, NULL when there is none
+        toConnection* openConnection(toConnectionOptions const&) const;
+
+        //! \brief Translate saved options into the ones the connection is opened with (host:port, instant client, ...)
+        static toConnectionOptions connectOptions(toConnectionOptions const&);
+
+        //! \brief Show progress of a connection being opened, empty @p status removes it
+        //! \param conn options the connection is opened with (see @ref connectOptions)
+        void setStatus(toConnectionOptions const& conn, QString const& status);
+
         void saveConnection(toConnectionOptions const&);
 
         QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
         QVariant data(const QModelIndex & index, int role = Qt::DisplayRole) const;
         int columnCount(const QModelIndex & parent = QModelIndex()) const
         {
-            return 6;
+            return 7;
         };
         int rowCount(const QModelIndex & parent = QModelIndex()) const
         {
@@ -85,8 +97,17 @@ class toConnectionModel : public QAbstractTableModel
         Qt::ItemFlags flags(const QModelIndex & index) const;
 
         void disableConnection(int ix);
+
+    private slots:
+        //! \brief Refresh the status column when connections are opened, closed or their health changes
+        void slotConnectionsChanged();
+
     private:
+        //! \brief Status of the connection being opened for saved options, empty when there is none
+        QString status(toConnectionOptions const&) const;
+
         QMap<int, toConnectionOptions> m_data;
+        QMap<toConnectionOptions, QString> m_status;
 };
 
 #endif
@@ -90,6 +90,7 @@ void toConnectionRegistry::addConnection(toConnection *conn)
     m_ConnectionsList.append(conn);
     m_currentConnection = index(m_ConnectionsList.size()-1);
     endInsertRows();
+    connect(conn, SIGNAL(healthChanged()), this, SLOT(slotConnectionHealth()));
     emit activeConnectionChanged(m_currentConnection);
     emit activeConnectionChanged(m_currentConnection.row());
 }
@@ -186,6 +187,13 @@ void toConnectionRegistry::slotViewIndexChanged(int idx)
     }
 }
 
+void toConnectionRegistry::slotConnectionHealth()
+{
+    int pos = m_ConnectionsList.indexOf(static_cast<toConnection*>(sender()));
+    if (pos != -1)
+        emit dataChanged(index(pos), index(pos));
+}
+
 QList<toConnection*> const& toConnectionRegistry::connections(void) const
 {
     return m_ConnectionsList;
@@ -92,6 +92,9 @@ class TORA_EXPORT toConnectionRegistry : public QAbstractListModel
     private slots:
         void slotViewIndexChanged(int);
 
+        /** Relays toConnection::healthChanged as dataChanged of its row */
+        void slotConnectionHealth();
+
     private:
         QModelIndex m_currentConnection;
         QMap<toConnectionOptions, toConnection *> m_ConnectionsMap;
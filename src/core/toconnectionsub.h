@@ -8,6 +8,31 @@
 
 class queryImpl;
 class toQueryAbstr;
+class QIODevice;
+
+/** Fast load of rows into one table, bypassing INSERT statements (COPY FROM STDIN on PostgreSQL).
+ *  Created by @ref toConnectionSub::createBulkLoad, the connection can not be used for anything else
+ *  until @ref finish or @ref abort is called.
+ */
+class TORA_EXPORT toBulkLoad
+{
+    public:
+        virtual ~toBulkLoad() {}
+
+        /** Add one row, values in the order of the columns. Data are sent when the buffer is full. */
+        virtual void addRow(toQueryParams const& row) = 0;
+
+        /** Send the rest of the buffer and end the load, throws when the database rejected the data.
+         * @return Number of rows loaded
+         */
+        virtual qint64 finish(void) = 0;
+
+        /** End the load discarding all the rows sent */
+        virtual void abort(QString const& reason) = 0;
+
+        /** Number of bytes sent to the database so far */
+        virtual qint64 bytesSent(void) const = 0;
+};
 
 /** This class is an abstract definition of an actual connection to a database.
  * Each @ref toConnection object can have one or more actual connections to the
@@ -21,7 +46,7 @@ class TORA_EXPORT toConnectionSub
     public:
 
         /** Create connection to database. */
-        toConnectionSub() : Query(NULL), Broken(false), Initialized(false), mutex(QMutex::NonRecursive) {}
+        toConnectionSub() : Query(NULL), Broken(false), SetupHash(0), mutex(QMutex::NonRecursive) {}
 
         /** Close connection. */
         virtual ~toConnectionSub() {}
@@ -70,6 +95,24 @@ class TORA_EXPORT toConnectionSub
         /** get additional details about db object */
         virtual toQAdditionalDescriptions* decribe(toCache::ObjectRef const&) = 0;
 
+        /** Write the result of @p sql into @p out as CSV, without fetching it row by row.
+         * @return Number of bytes written or -1 when the provider (or the statement) does not support it
+         */
+        virtual qint64 exportCsv(QString const& sql, QChar separator, QChar quote, bool header, QIODevice &out)
+        {
+            return -1;
+        }
+
+        /** Start a bulk load of @p columns of @p table.
+         * @param bufferSize bytes collected before they are sent to the database
+         * @param binary use binary format when the provider (and the column types) allow it
+         * @return NULL when the provider does not support it, INSERT statements have to be used then
+         */
+        virtual toBulkLoad* createBulkLoad(QString const& table, QStringList const& columns, int bufferSize, bool binary)
+        {
+            return NULL;
+        }
+
         /** resolve object name (synonym) */
         virtual toCache::ObjectRef resolve(toCache::ObjectRef const& objectName)
         {
@@ -87,14 +130,21 @@ class TORA_EXPORT toConnectionSub
             return Broken;
         }
 
-        inline bool isInitialized()
+        /** Mark the connection as unusable, it will be dropped instead of returning into the pool */
+        inline void setBroken()
+        {
+            Broken = true;
+        }
+
+        /** Hash of the init strings last executed on this connection (0 when none were executed yet) */
+        inline uint setupHash() const
         {
-            return Initialized;
+            return SetupHash;
         }
 
-        inline void setInitialized(bool initialized)
+        inline void setSetupHash(uint hash)
         {
-            Initialized = initialized;
+            SetupHash = hash;
         }
 
         inline QString const& schema() const
@@ -122,7 +172,8 @@ class TORA_EXPORT toConnectionSub
         }
 
         toQueryAbstr *Query;
-        bool Broken, Initialized;
+        bool Broken;
+        uint SetupHash;
         QString Schema;
         QDateTime LastUsed; // last time this db connection was actually used
 
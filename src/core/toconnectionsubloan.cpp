@@ -41,6 +41,7 @@ toConnectionSubLoan::toConnectionSubLoan(toConnection &con)
     : ParentConnection(con)
     , SchemaInitialized(false)
     , ConnectionSub(con.borrowSub())
+    , Pooled(true)
 {}
 
 toConnectionSubLoan::toConnectionSubLoan(toConnection &con, QString const & schema)
@@ -48,6 +49,7 @@ toConnectionSubLoan::toConnectionSubLoan(toConnection &con, QString const & sche
     , SchemaInitialized(false)
     , Schema(schema)
     , ConnectionSub(con.borrowSub())
+    , Pooled(true)
 {
     Q_ASSERT_X(!schema.isEmpty(), qPrintable(__QHERE__), "schema is empty");
     SchemaInitialized = ConnectionSub->schema() == schema;
@@ -58,11 +60,19 @@ toConnectionSubLoan::toConnectionSubLoan(toConnection &con, int*)
     : ParentConnection(con)
     , SchemaInitialized(false)
     , ConnectionSub(NULL)
+    , Pooled(true)
+{}
+
+toConnectionSubLoan::toConnectionSubLoan(toConnection &con, toConnectionSub *sub)
+    : ParentConnection(con)
+    , SchemaInitialized(false)
+    , ConnectionSub(sub)
+    , Pooled(false)
 {}
 
 toConnectionSubLoan::~toConnectionSubLoan()
 {
-    if (ConnectionSub)
+    if (ConnectionSub && Pooled)
     {
         const_cast<toConnection&>(ParentConnection).putBackSub(ConnectionSub);
     }
@@ -20,6 +20,9 @@ class toConnectionSubLoan
         /** This special kind of constructor is used by @ref toQuery while testing the connections*/
         toConnectionSubLoan(toConnection &con, int*);
 
+        /** Wrap a connection which is not part of the pool (see @ref toConnection::controlExecute), it is not put back */
+        toConnectionSubLoan(toConnection &con, toConnectionSub *sub);
+
         ~toConnectionSubLoan();
 
         /** return pointer onto wrapped type @ref toConnectionSub*/
@@ -61,4 +64,5 @@ class toConnectionSubLoan
         toConnectionSubLoan(toConnectionSubLoan const& other); // do not clone me
     protected:
         toConnectionSub *ConnectionSub;
+        bool Pooled;
 };
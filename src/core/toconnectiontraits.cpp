@@ -0,0 +1,125 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "core/toconnectiontraits.h"
+
+#include <QtCore/QRegExp>
+
+QString toConnectionTraits::sessionSetupSQL(QStringList const&) const
+{
+    return QString();
+}
+
+toConnectionTraits::TypeClass toConnectionTraits::typeClass(QString const& datatype, int &size, int &scale) const
+{
+    // "NUMBER(10,2)", "VARCHAR2(20 CHAR)", "numeric(10,2)", "TIMESTAMP(6) WITH TIME ZONE", ...
+    QString type = datatype.trimmed().toUpper();
+    size = scale = 0;
+    static QRegExp args(QString::fromLatin1("\\(\\s*(\\d+)\\s*(?:,\\s*(-?\\d+))?[^)]*\\)"));
+    if (args.indexIn(type) >= 0)
+    {
+        size = args.cap(1).toInt();
+        scale = args.cap(2).toInt();
+    }
+    QString name = type.section(QChar('('), 0, 0).trimmed();
+
+    if (name == QLatin1String("NUMBER") || name == QLatin1String("NUMERIC") || name == QLatin1String("DECIMAL")
+            || name == QLatin1String("DEC"))
+    {
+        if (scale == 0 && size > 0 && size <= 18)
+            return TYPE_INTEGER;
+        return TYPE_DECIMAL;
+    }
+    if (name.contains(QLatin1String("INT")) || name.contains(QLatin1String("SERIAL")) || name == QLatin1String("OID"))
+    {
+        if (name.contains(QLatin1String("INTERVAL")))
+            return TYPE_TEXT;
+        if (name == QLatin1String("SMALLINT") || name == QLatin1String("INT2"))
+            size = 5;
+        else if (name == QLatin1String("INTEGER") || name == QLatin1String("INT") || name == QLatin1String("INT4"))
+            size = 10;
+        else
+            size = 19;
+        scale = 0;
+        return TYPE_INTEGER;
+    }
+    if (name.startsWith(QLatin1String("FLOAT")) || name.startsWith(QLatin1String("DOUBLE")) || name == QLatin1String("REAL")
+            || name.startsWith(QLatin1String("BINARY_")))
+        return TYPE_FLOAT;
+    if (name.startsWith(QLatin1String("BOOL")))
+        return TYPE_BOOLEAN;
+    if (name == QLatin1String("DATE"))
+        return TYPE_DATE;
+    if (name.startsWith(QLatin1String("TIMESTAMP")) || name == QLatin1String("DATETIME"))
+        return TYPE_TIMESTAMP;
+    if (name.contains(QLatin1String("BLOB")) || name == QLatin1String("BYTEA") || name.contains(QLatin1String("RAW"))
+            || name.contains(QLatin1String("BINARY")))
+        return TYPE_BINARY;
+    if (name.contains(QLatin1String("CLOB")) || name.contains(QLatin1String("TEXT")) || name == QLatin1String("LONG")
+            || name == QLatin1String("JSON") || name == QLatin1String("JSONB") || name == QLatin1String("XMLTYPE"))
+        return TYPE_LONG_TEXT;
+    return TYPE_TEXT;
+}
+
+QString toConnectionTraits::typeName(TypeClass type, int size, int scale) const
+{
+    switch (type)
+    {
+        case TYPE_INTEGER:
+            if (size > 0 && size <= 4)
+                return QString::fromLatin1("SMALLINT");
+            if (size > 0 && size <= 9)
+                return QString::fromLatin1("INTEGER");
+            return QString::fromLatin1("BIGINT");
+        case TYPE_DECIMAL:
+            if (size > 0)
+                return QString::fromLatin1("DECIMAL(%1,%2)").arg(size).arg(qMax(scale, 0));
+            return QString::fromLatin1("DECIMAL");
+        case TYPE_FLOAT:
+            return QString::fromLatin1("DOUBLE PRECISION");
+        case TYPE_BOOLEAN:
+            return QString::fromLatin1("BOOLEAN");
+        case TYPE_TEXT:
+            return QString::fromLatin1("VARCHAR(%1)").arg(size > 0 ? size : 4000);
+        case TYPE_LONG_TEXT:
+            return QString::fromLatin1("CLOB");
+        case TYPE_DATE:
+            return QString::fromLatin1("DATE");
+        case TYPE_TIMESTAMP:
+            return QString::fromLatin1("TIMESTAMP");
+        case TYPE_BINARY:
+            return QString::fromLatin1("BLOB");
+    }
+    return QString::fromLatin1("VARCHAR(4000)");
+}
@@ -37,6 +37,7 @@
 #include "core/tocache.h"
 
 #include <QtCore/QString>
+#include <QtCore/QStringList>
 #include <QtCore/QList>
 
 class toConnection;
@@ -80,6 +81,12 @@ class toConnectionTraits
          */
         virtual QString schemaSwitchSQL(QString const&) const = 0;
 
+        /** Combine session setup statements (schema switch and @ref toConnection::initStrings)
+         *  into one statement, so they are executed in a single round trip.
+         *  @return empty string when the provider can not execute them together
+         */
+        virtual QString sessionSetupSQL(QStringList const& statements) const;
+
         /** Check if connection provider supports table level comments.
          *  @return bool return true if database supports table level comments
          *  See toSQL: toResultCols:TableComment
@@ -91,6 +98,14 @@ class toConnectionTraits
          */
         virtual bool hasAsyncBreak() const = 0;
 
+        /** Check if query cancel is sent over the control connection (@ref toConnection::openControl).
+         *  @return bool return true if the control connection should be opened in advance
+         */
+        virtual bool hasControlCancel() const
+        {
+            return false;
+        }
+
         /**
          * Return list of primary key columns for a table
          * By default return an empty list => table can not be modified using toResultTableViewEdit
@@ -100,5 +115,28 @@ class toConnectionTraits
             return QList<QString>();
         };
 
+        /** Database independent kind of a column type, used to create tables copied between databases */
+        enum TypeClass
+        {
+            TYPE_INTEGER,
+            TYPE_DECIMAL,
+            TYPE_FLOAT,
+            TYPE_BOOLEAN,
+            TYPE_TEXT,
+            TYPE_LONG_TEXT,
+            TYPE_DATE,
+            TYPE_TIMESTAMP,
+            TYPE_BINARY
+        };
+
+        /** Classify a datatype as described by this database (@ref toCache::ColumnDescription::Datatype).
+         * @param size Set to the length or precision found in the description (0 when none)
+         * @param scale Set to the scale found in the description
+         */
+        virtual TypeClass typeClass(QString const& datatype, int &size, int &scale) const;
+
+        /** Datatype of this database to be used for a column of @p type, see @ref typeClass */
+        virtual QString typeName(TypeClass type, int size, int scale) const;
+
         virtual ~toConnectionTraits() {};
 };
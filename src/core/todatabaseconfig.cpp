@@ -61,6 +61,10 @@ QVariant ToConfiguration::Database::defaultValue(int option) const
             return QVariant((int)100);
         case MaxColDispInt:
             return QVariant((int)300);
+        case FetchSizeInt:
+            return QVariant((int)0);
+        case StatementTimeoutInt:
+            return QVariant((int)0);
         case IndicateEmptyBool:
             return QVariant((bool)true);
         case IndicateEmptyColor:
@@ -56,6 +56,8 @@ namespace ToConfiguration
                 , InitialFetchInt     // #define CONF_MAX_NUMBER (InitialFetch)
                 , MaxContentInt       // #define CONF_MAX_CONTENT (InitialEditorContent)
                 , MaxColDispInt       // #define CONF_MAX_COL_DISP
+                , FetchSizeInt        // rows fetched in one round-trip, 0 = automatic
+                , StatementTimeoutInt // seconds after which a query is cancelled, 0 = no limit
                 , IndicateEmptyBool   // #define CONF_INDICATE_EMPTY
                 , IndicateEmptyColor  // #define CONF_INDICATE_EMPTY_COLOR
                 , NumberFormatInt     // #define CONF_NUMBER_FORMAT
@@ -38,10 +38,53 @@
 #include "core/toeventqueryworker.h"
 //#include "widgets/toresultstats.h"
 #include "core/toconnection.h"
+#include "core/toconfiguration.h"
+#include "core/todatabaseconfig.h"
 #include "core/toconnectionsub.h"
 #include "core/toconnectionsubloan.h"
 #include "core/toconnectiontraits.h"
 
+#include <QtCore/QRunnable>
+#include <QtCore/QThreadPool>
+#include <QtCore/QTimer>
+
+// how long (msecs) the worker may ignore a cancel request before its session is dropped
+#define CANCEL_GRACE 10000
+
+/* Sends the cancel request from a pool thread, so neither the main thread nor the blocked worker waits for it.
+ * Holds the loan, so the toConnectionSub can not be put back (and deleted) meanwhile.
+ */
+class toEventQueryCancel : public QRunnable
+{
+    public:
+        toEventQueryCancel(QSharedPointer<toConnectionSubLoan> const& conn, bool warmUp)
+            : Connection(conn)
+            , WarmUp(warmUp)
+        {}
+
+        void run() override
+        {
+            try
+            {
+                if (WarmUp)
+                    const_cast<toConnection&>(Connection->ParentConnection).openControl();
+                else
+                    (*Connection)->cancel();
+            }
+            catch (const QString &str)
+            {
+                TLOG(1, toDecorator, __HERE__) << "toEventQuery cancel failed: " << str << std::endl;
+            }
+            catch (...)
+            {
+                TLOG(1, toDecorator, __HERE__) << "	Ignored exception." << std::endl;
+            }
+        }
+    private:
+        QSharedPointer<toConnectionSubLoan> Connection;
+        bool WarmUp;
+};
+
 toEventQuery::toEventQuery(QObject *parent
                            , toConnection &conn
                            , QString const& sql
@@ -63,6 +106,10 @@ toEventQuery::toEventQuery(QObject *parent
     , Connection(new toConnectionSubLoan(conn))
     , CancelCondition(new toEventQuery::WaitConditionWithMutex())
     , Mode(mode)
+    , FetchSize(toConfigurationNewSingle::Instance().option(ToConfiguration::Database::FetchSizeInt).toUInt())
+    , Timeout(toConfigurationNewSingle::Instance().option(ToConfiguration::Database::StatementTimeoutInt).toUInt())
+    , Deadline(NULL)
+    , TimedOut(false)
 {
     /* BIG FAT WARNING QThread's parent must be  NULL, so it is not disposed when toEventQuery is deleted.
      * Theoretically (and practically) it can be freed after ~toEventQuery is processed
@@ -93,6 +140,10 @@ toEventQuery::toEventQuery(QObject *parent
     , Connection(conn)
     , CancelCondition(new toEventQuery::WaitConditionWithMutex())
     , Mode(mode)
+    , FetchSize(toConfigurationNewSingle::Instance().option(ToConfiguration::Database::FetchSizeInt).toUInt())
+    , Timeout(toConfigurationNewSingle::Instance().option(ToConfiguration::Database::StatementTimeoutInt).toUInt())
+    , Deadline(NULL)
+    , TimedOut(false)
 {
     /* BIG FAT WARNING QThread's parent must be  NULL, so it is not disposed when toEventQuery is deleted.
      * Theoretically (and practically) it can be freed after ~toEventQuery is processed
@@ -115,6 +166,7 @@ void toEventQuery::start()
         throw tr("toEventQuery::start - can not restart already stared query");
 
     Worker = new toEventQueryWorker(this, Connection, CancelCondition, SQL, Param);
+    Worker->Query.setFetchSize(FetchSize);
     Worker->moveToThread(Thread);
     Thread->Slave = Worker;
 
@@ -134,6 +186,9 @@ void toEventQuery::start()
     connect(Worker, SIGNAL(rowsProcessed(unsigned long)),                  //  BG -> main
             this, SLOT(slotRowsProcessed(unsigned long)));
 
+    connect(Worker, SIGNAL(busy(bool)),                                    //  BG -> main
+            this, SLOT(slotBusy(bool)));
+
     connect(this,   SIGNAL(dataRequested()),  Worker, SLOT(slotRead()));   // main -> BG
 
     connect(this,   SIGNAL(consumed()),       Worker, SLOT(slotRead()));   // main -> BG
@@ -152,9 +207,35 @@ void toEventQuery::start()
     connect(Thread, SIGNAL(destroyed()),      this,   SLOT(slotThreadEnd())); // main -> main
     connect(this,   SIGNAL(stopRequested()),  Worker, SLOT(slotStop()));      // main -> BG
 
+    if (Timeout)
+    {
+        Deadline = new QTimer(this);
+        Deadline->setSingleShot(true);
+        Deadline->setInterval(Timeout * 1000);
+        connect(Deadline, SIGNAL(timeout()), this, SLOT(slotDeadline()));
+    }
+
     TLOG(7, toDecorator, __HERE__) << "toEventQuery start" << std::endl;
     // finally start the thread
     Thread->start();
+
+    // providers which cancel through the control connection, open it in advance
+    if (Connection->ParentConnection.getTraits().hasControlCancel())
+        QThreadPool::globalInstance()->start(new toEventQueryCancel(Connection, true));
+}
+
+void toEventQuery::setFetchSize(unsigned rows)
+{
+    if ( Worker || Started )
+        throw tr("toEventQuery::setFetchSize - query already started");
+    FetchSize = rows;
+}
+
+void toEventQuery::setTimeout(unsigned seconds)
+{
+    if ( Worker || Started )
+        throw tr("toEventQuery::setTimeout - query already started");
+    Timeout = seconds;
 }
 
 void toEventQuery::setFetchMode(FETCH_MODE m)
@@ -232,18 +313,25 @@ void toEventQuery::stop(void)
         if (!succeeded)
         {
             TLOG(7, toDecorator, __HERE__) << "toEventQuery stop bg did not respond" << std::endl;
-            if (Connection->ParentConnection.getTraits().hasAsyncBreak())
-                try
-                {
-                    (*Connection)->cancel();
-                }
-            TOCATCH;
+            cancel();
         }
         //Thread->wait();
     }
     WorkDone = true;
 }
 
+void toEventQuery::cancel(void)
+{
+    if (WorkDone || !Worker || CancelTime.isValid())
+        return;
+
+    TLOG(7, toDecorator, __HERE__) << "toEventQuery cancel" << std::endl;
+    CancelTime.start();
+    emit stopRequested();    // processed by the worker as soon as the db call returns
+    QThreadPool::globalInstance()->start(new toEventQueryCancel(Connection, false));
+    QTimer::singleShot(CANCEL_GRACE, this, SLOT(slotTeardown()));
+}
+
 // private slots
 
 void toEventQuery::slotStarted()
@@ -298,7 +386,18 @@ void toEventQuery::slotError(const toConnection::exception &msg)
 void toEventQuery::slotFinished()
 {
     TLOG(7, toDecorator, __HERE__) << "toEventQuery slot finish" << std::endl;
+    if (CancelTime.isValid())
+    {
+        qint64 msecs = CancelTime.elapsed();
+        TLOG(7, toDecorator, __HERE__) << "toEventQuery stopped " << msecs << "ms after cancel" << std::endl;
+        if (TimedOut)
+            emit error(this, toConnection::exception(tr("Statement timeout (%1 s) expired, the query was cancelled").arg(Timeout)));
+        Utils::toStatusMessage(tr("Query stopped %1 ms after cancel request").arg(msecs), false, false);
+        emit cancelled(this, msecs);
+    }
     WorkDone = true;
+    if (Deadline)
+        Deadline->stop();
     disconnect(SIGNAL(consumed()));
     disconnect(SIGNAL(dataRequested()));
     emit done(this, Processed);
@@ -316,3 +415,35 @@ void toEventQuery::slotThreadEnd()
     Thread = NULL;
     Worker = NULL;
 }
+
+void toEventQuery::slotBusy(bool busy)
+{
+    if (!Deadline)
+        return;
+    if (busy && !WorkDone)
+        Deadline->start();
+    else
+        Deadline->stop();
+}
+
+void toEventQuery::slotDeadline()
+{
+    if (WorkDone || CancelTime.isValid())
+        return;
+    TLOG(7, toDecorator, __HERE__) << "toEventQuery statement timeout" << std::endl;
+    TimedOut = true;
+    cancel();
+}
+
+void toEventQuery::slotTeardown()
+{
+    if (WorkDone || !Thread || !Thread->isRunning())
+        return;
+
+    // the worker is still blocked in the database call, give up on its session.
+    // The sub is in use by the worker thread, only the worker marks it broken
+    // (see toEventQueryWorker::close), the session is then dropped instead of returning into the pool
+    TLOG(1, toDecorator, __HERE__) << "toEventQuery worker did not stop, dropping the session" << std::endl;
+    CancelCondition->Abandoned.storeRelease(1);
+    emit error(this, toConnection::exception(tr("Query did not stop %1 s after cancel request, the session will be closed").arg(CANCEL_GRACE / 1000)));
+}
@@ -46,6 +46,9 @@
 #include <QtCore/QPointer>
 #include <QtCore/QSharedPointer>
 #include <QtCore/QWaitCondition>
+#include <QtCore/QAtomicInt>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QTimer>
 
 class toResultStats;
 class toEventQueryWorker;
@@ -101,6 +104,8 @@ class toEventQuery : public QObject
             public:
                 QMutex Mutex;
                 QWaitCondition WaitCondition;
+                // set when the worker did not stop after cancel, it drops its session once the db call returns
+                QAtomicInt Abandoned;
         };
 
         /**
@@ -148,6 +153,20 @@ class toEventQuery : public QObject
 
         void setFetchMode(FETCH_MODE);
 
+        /**
+         * Set number of rows fetched in one round-trip (0 means default).
+         * Must be called before start
+         */
+        void setFetchSize(unsigned rows);
+
+        /**
+         * Set statement timeout in seconds (0 means no limit). Only database calls are timed: the query
+         * is cancelled when its execution or the fetch of one batch of rows takes longer. The time
+         * a result waits for the user to request more rows (READ_FIRST) does not count.
+         * Default is taken from Database::StatementTimeoutInt. Must be called before start
+         */
+        void setTimeout(unsigned seconds);
+
         /**
          * Get description of columns.
          * @return Description of columns list.
@@ -193,6 +212,14 @@ class toEventQuery : public QObject
          */
         void stop(void);
 
+        /**
+         * Request cancellation of the running query and return immediately.
+         * The request is sent from a background thread (see @ref toConnectionSub::cancel),
+         * if the worker does not stop in time its session is dropped.
+         * Emits cancelled() once the worker has stopped.
+         */
+        void cancel(void);
+
     signals:
         /**
          * Emitted when header descriptions are available
@@ -217,6 +244,11 @@ class toEventQuery : public QObject
          */
         void done(toEventQuery*, unsigned long);
 
+        /**
+         * Emitted when the query stopped after cancel(), msecs is the time from the cancel request
+         */
+        void cancelled(toEventQuery*, qint64 msecs);
+
         /**
          * Signals to be sent to Worker
          */
@@ -248,6 +280,15 @@ class toEventQuery : public QObject
         // emitted immediately before the Thread is destroyed
         void slotThreadEnd();
 
+        // worker entered (true) or left (false) a database call, arms the statement timeout
+        void slotBusy(bool busy);
+
+        // statement timeout expired
+        void slotDeadline();
+
+        // worker did not stop after cancel
+        void slotTeardown();
+
     private:
         /** Undefined copy contructor.Don't clone me. */
         toEventQuery(toEventQuery const& other);
@@ -282,6 +323,18 @@ class toEventQuery : public QObject
         QSharedPointer<WaitConditionWithMutex> CancelCondition;
 
         FETCH_MODE Mode;
+
+        // rows fetched in one round-trip, 0 = provider's choice
+        unsigned FetchSize;
+
+        // statement timeout in seconds, 0 = no limit
+        unsigned Timeout;
+        // runs while the worker is in a database call, NULL without timeout
+        QTimer *Deadline;
+
+        // runs since cancel() was called
+        QElapsedTimer CancelTime;
+        bool TimedOut;
 };
 
 #endif
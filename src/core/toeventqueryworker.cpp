@@ -84,33 +84,8 @@ void toEventQueryWorker::toQueryPriv::init()
 {
     try
     {
-        // Try to switch the current db schema
-        if (m_ConnectionSubLoan.SchemaInitialized == false && !m_ConnectionSubLoan.Schema.isEmpty())
-        {
-            QString sql = m_ConnectionSubLoan.ParentConnection.getTraits().schemaSwitchSQL(m_ConnectionSubLoan.Schema);
-            if (!sql.isEmpty())
-            {
-                m_Query = m_ConnectionSubLoan->createQuery(this);
-                m_ConnectionSubLoan->setQuery(this);
-                m_Query->execute(sql);
-                delete m_Query;
-            }
-            m_ConnectionSubLoan.SchemaInitialized = true;
-            m_ConnectionSubLoan->setSchema(m_ConnectionSubLoan.Schema); // assign value in toConnectionSub from toConnectionSubLoan
-        }
+        initSession();
 
-        // Try to switch the current NLS_SETTINGS (not implemented yet)
-        if ( m_ConnectionSubLoan->isInitialized() == false)
-        {
-            Q_FOREACH(QString sql, m_ConnectionSubLoan.ParentConnection.initStrings())
-            {
-                m_Query = m_ConnectionSubLoan->createQuery(this);
-                m_ConnectionSubLoan->setQuery(this);
-                m_Query->execute(sql);
-                delete m_Query;
-            }
-            m_ConnectionSubLoan->setInitialized(true);
-        }
 #if defined(TORA_EXPERIMENTAL) && 0
 // This breaks Mysql, PostgreSQL, ODBC
         {
@@ -166,13 +141,16 @@ void toEventQueryWorker::init()
     TLOG(7, toDecorator, __HERE__) << "toEventQueryWorker init a" << std::endl;
     try
     {
+        emit busy(true);
         Query.init();
         emit started();
         toQColumnDescriptionList desc = Query.describe();
         ColumnCount = Query.columns();
+        bool eof = Query.eof();
+        emit busy(false);
         emit headers(desc, ColumnCount);
 
-        if (Query.eof())
+        if (eof)
         {
             // emit empty result
             // ValuesList values;
@@ -199,6 +177,10 @@ void toEventQueryWorker::close()
     if (Closed)
         return;
 
+    // the consumer gave up waiting for this query (toEventQuery::slotTeardown), do not reuse the session
+    if (CancelCondition->Abandoned.loadAcquire())
+        (*Connection)->setBroken();
+
     unsigned long p = Query.rowsProcessed();
     if (p > 0)
         emit rowsProcessed(p);
@@ -224,16 +206,19 @@ void toEventQueryWorker::slotRead()
 
         unsigned maxRead = toConfigurationNewSingle::Instance().option(ToConfiguration::Database::InitialFetchInt).toInt();
         ValuesList values;
+        emit busy(true);
         for (unsigned row = 0; row < maxRead; row++)
         {
             for (unsigned i = 0; i < ColumnCount && !Query.eof(); i++)
                 values.append(Query.readValue());
         }
+        bool eof = Query.eof();
+        emit busy(false);
 
         if (values.size() > 0)
             emit data(values);    // must not access after this line
 
-        if (Query.eof())
+        if (eof)
         {
             Stopped = true;
             close();
@@ -139,6 +139,12 @@ class toEventQueryWorker : public QObject
         */
         void rowsProcessed(unsigned long rows);
 
+        /**
+        * Emitted before (true) and after (false) the execution and the fetch of each batch,
+        * the statement timeout only runs in between.
+        */
+        void busy(bool busy);
+
     protected:
         class toQueryPriv : public toQueryAbstr {
         public:
@@ -76,6 +76,8 @@ toExtract::toExtract(toConnection &conn, QWidget *parent)
     , Initialized(false)
     , Replace(false)
     , CommitDistance(0)
+    , InsertStyle(0)
+    , InsertBatchRows(1)
     , BlockSize(8192)
 {
     ext = ExtractorFactorySing::Instance().create(Connection.provider().toStdString(), *this);
@@ -261,6 +261,8 @@ public:
         bool Replace; // if object creation extracts should support RE-creation of existing objects
 
         int CommitDistance;
+        int InsertStyle;
+        int InsertBatchRows;
 
         // Database info
         int BlockSize;
@@ -419,6 +421,15 @@ public:
             Contents = val;
             CommitDistance = commitdistance;
         }
+        /** Set how contents of tables are scripted.
+         * @param style Insert statement style, see toInsertScript::Style.
+         * @param batchRows Maximum number of rows per statement.
+         */
+        void setInsertStyle(int style, int batchRows)
+        {
+            InsertStyle = style;
+            InsertBatchRows = batchRows;
+        }
         /** Include comments in extraction.
          * @param val Include indexes.
          */
@@ -533,6 +544,19 @@ public:
         {
             return CommitDistance;
         }
+        /** Get the insert statement style used for contents of tables.
+         * @return Style, see toInsertScript::Style.
+         */
+        int getInsertStyle(void)
+        {
+            return InsertStyle;
+        }
+        /** Get the maximum number of rows per insert statement.
+         */
+        int getInsertBatchRows(void)
+        {
+            return InsertBatchRows;
+        }
         /** Check if comments are generated.
          * @return If comments are generated.
          */
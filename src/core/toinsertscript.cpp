@@ -0,0 +1,185 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "core/toinsertscript.h"
+#include "core/toconnection.h"
+
+static const char *BIND_NAME = "tora_ins";
+
+toInsertScript::toInsertScript(toConnection &conn,
+                               const QString &table,
+                               const QStringList &columns,
+                               Style style,
+                               int batchRows,
+                               int commitDistance)
+    : Db(Generic)
+    , UsedStyle(style)
+    , Table(table)
+    , Columns(columns)
+    , BatchRows(qMax(1, batchRows))
+    , CommitDistance(qMax(0, commitDistance))
+    , Rows(0)
+    , ValueCount(0)
+    , Upper(true)
+    , Prepared(false)
+    , EOL("\n")
+{
+    if (conn.providerIs("Oracle"))
+        Db = Oracle;
+    else if (conn.providerIs("QPSQL"))
+        Db = PostgreSQL;
+    else if (conn.providerIs("QMYSQL"))
+        Db = MySQL;
+
+    // Oracle needs column names to declare the bind variables (%TYPE),
+    // MySQL prepared statements are not usable from plain scripts
+    if (UsedStyle == BindBlock && !(Db == Oracle && !Columns.isEmpty()) && Db != PostgreSQL)
+        UsedStyle = MultiRow;
+    if (UsedStyle == SingleRow)
+        BatchRows = 1;
+}
+
+void toInsertScript::setUpperKeywords(bool upper)
+{
+    Upper = upper;
+}
+
+void toInsertScript::setLineEnd(const QString &eol)
+{
+    EOL = eol;
+}
+
+QString toInsertScript::addRow(const QStringList &values)
+{
+    Pending << values.join(", ");
+    ValueCount = values.size();
+    Rows++;
+
+    bool commit = CommitDistance > 0 && Rows % CommitDistance == 0;
+    if (commit || Pending.size() >= BatchRows)
+        return flush(commit);
+    return QString();
+}
+
+QString toInsertScript::finish()
+{
+    QString ret = flush(false);
+    if (Prepared)
+    {
+        ret += keyword("DEALLOCATE ") + BIND_NAME + ";" + EOL;
+        Prepared = false;
+    }
+    return ret;
+}
+
+QString toInsertScript::keyword(const QString &kw) const
+{
+    return Upper ? kw : kw.toLower();
+}
+
+QString toInsertScript::target() const
+{
+    if (Columns.isEmpty())
+        return Table;
+    return Table + " (" + Columns.join(", ") + ")";
+}
+
+QString toInsertScript::flush(bool commit)
+{
+    QString ret;
+    if (Pending.isEmpty())
+        return ret;
+
+    switch (UsedStyle)
+    {
+        case SingleRow:
+            Q_FOREACH(const QString &row, Pending)
+                ret += keyword("INSERT INTO ") + target() + keyword(" VALUES (") + row + ");" + EOL;
+            break;
+        case MultiRow:
+            if (Db == Oracle)
+            {
+                ret += keyword("INSERT ALL") + EOL;
+                Q_FOREACH(const QString &row, Pending)
+                    ret += keyword("  INTO ") + target() + keyword(" VALUES (") + row + ")" + EOL;
+                ret += keyword("SELECT * FROM dual;") + EOL;
+            }
+            else
+            {
+                ret += keyword("INSERT INTO ") + target() + keyword(" VALUES") + EOL;
+                for (int i = 0; i < Pending.size(); i++)
+                    ret += "  (" + Pending.at(i) + (i + 1 < Pending.size() ? ")," : ");") + EOL;
+            }
+            break;
+        case BindBlock:
+            if (Db == Oracle)
+            {
+                // the INSERT inside the local procedure is static SQL, parsed once per block
+                QStringList params, binds;
+                for (int i = 0; i < Columns.size(); i++)
+                {
+                    params << QString("p%1 %2.%3%TYPE").arg(i + 1).arg(Table).arg(Columns.at(i));
+                    binds << QString("p%1").arg(i + 1);
+                }
+                ret += keyword("DECLARE") + EOL;
+                ret += keyword("  PROCEDURE ") + BIND_NAME + "(" + params.join(", ") + keyword(") IS") + EOL;
+                ret += keyword("  BEGIN") + EOL;
+                ret += keyword("    INSERT INTO ") + target() + keyword(" VALUES (") + binds.join(", ") + ");" + EOL;
+                ret += keyword("  END;") + EOL;
+                ret += keyword("BEGIN") + EOL;
+                Q_FOREACH(const QString &row, Pending)
+                    ret += QString("  ") + BIND_NAME + "(" + row + ");" + EOL;
+                ret += keyword("END;") + EOL + "/" + EOL;
+            }
+            else
+            {
+                if (!Prepared)
+                {
+                    QStringList binds;
+                    for (int i = 0; i < ValueCount; i++)
+                        binds << QString("$%1").arg(i + 1);
+                    ret += keyword("PREPARE ") + BIND_NAME + keyword(" AS INSERT INTO ") + target() + keyword(" VALUES (") + binds.join(", ") + ");" + EOL;
+                    Prepared = true;
+                }
+                Q_FOREACH(const QString &row, Pending)
+                    ret += keyword("EXECUTE ") + BIND_NAME + "(" + row + ");" + EOL;
+            }
+            break;
+    }
+    Pending.clear();
+
+    if (commit)
+        ret += keyword("COMMIT;") + EOL;
+    return ret;
+}
@@ -0,0 +1,114 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+class toConnection;
+
+/**
+ * Generates data load scripts (INSERT statements with literal values).
+ *
+ * Rows are collected into batches so that a re-load of the script does not
+ * hard-parse every single row. The syntax of a batch depends on the database
+ * of the connection passed to the constructor.
+ */
+class toInsertScript
+{
+    public:
+        enum Style
+        {
+            SingleRow = 0,  ///< one INSERT statement per row
+            MultiRow,       ///< INSERT ... VALUES (...), (...); INSERT ALL ... SELECT * FROM dual on Oracle
+            BindBlock       ///< INSERT parsed once and executed with bind variables for each row of the batch
+        };
+
+        /**
+         * @param conn Connection the script is generated for.
+         * @param table Name of the table (already quoted and qualified).
+         * @param columns Column names, can be empty.
+         * @param style Requested style, falls back to a supported one for the database.
+         * @param batchRows Maximum number of rows per statement (block).
+         * @param commitDistance Emit COMMIT after this many rows, 0 means never.
+         */
+        toInsertScript(toConnection &conn,
+                       const QString &table,
+                       const QStringList &columns,
+                       Style style,
+                       int batchRows,
+                       int commitDistance);
+
+        /** Use lowercase keywords (uppercase is the default) */
+        void setUpperKeywords(bool upper);
+
+        /** Line end used in generated text ("\n" by default) */
+        void setLineEnd(const QString &eol);
+
+        /** Style really used for the connection */
+        Style style() const
+        {
+            return UsedStyle;
+        }
+
+        /**
+         * Add a row of already formatted SQL literals.
+         * @return Script text completed by this row (empty while the batch is not full).
+         */
+        QString addRow(const QStringList &values);
+
+        /** Flush remaining rows. @return Rest of the script. */
+        QString finish();
+
+    private:
+        enum Dialect { Generic, Oracle, PostgreSQL, MySQL };
+
+        QString flush(bool commit);
+        QString keyword(const QString &kw) const;
+        QString target() const;
+
+        Dialect Db;
+        Style UsedStyle;
+        QString Table;
+        QStringList Columns;
+        QStringList Pending;
+        int BatchRows;
+        int CommitDistance;
+        int Rows;
+        int ValueCount;
+        bool Upper;
+        bool Prepared;
+        QString EOL;
+};
@@ -33,8 +33,11 @@
  * END_COMMON_COPYRIGHT_HEADER */
 
 #include "core/tolistviewformatter.h"
+#include "core/tolobstream.h"
 #include "ts_log/ts_log_utils.h"
 
+#include <QtCore/QAbstractItemModel>
+
 QVariant ToConfiguration::Exporter::defaultValue(int option) const
 {
     switch (option)
@@ -43,6 +46,12 @@ QVariant ToConfiguration::Exporter::defaultValue(int option) const
             return QVariant(QString(";"));
         case CsvDelimiter:
             return QVariant(QString("\""));
+        case SqlInsertStyle:
+            return QVariant((int)0);
+        case SqlBatchRows:
+            return QVariant((int)100);
+        case SqlCommitDistance:
+            return QVariant((int)0);
         default:
             Q_ASSERT_X( false, qPrintable(__QHERE__), qPrintable(QString("Context Exporter un-registered enum value: %1").arg(option)));
             return QVariant();
@@ -59,6 +68,16 @@ toListViewFormatter::~toListViewFormatter()
 {
 }
 
+QByteArray toListViewFormatter::getFormattedData(toExportSettings &settings, const QAbstractItemModel * model)
+{
+    return getFormattedString(settings, model).toUtf8();
+}
+
+bool toListViewFormatter::isBinary() const
+{
+    return false;
+}
+
 void toListViewFormatter::endLine(QString &output)
 {
 #ifdef Q_OS_WIN32
@@ -95,3 +114,15 @@ QVector<int> toListViewFormatter::selectedColumns(const QModelIndexList &selecte
 
     return ret;
 }
+
+QString toListViewFormatter::cellText(const QAbstractItemModel * model, const QModelIndex &index) const
+{
+    QVariant v = model->data(index, Qt::UserRole);
+    if (v.userType() == qMetaTypeId<toQValue::complexType*>())
+    {
+        toQValue::complexType *i = v.value<toQValue::complexType*>();
+        if (i && i->isLarge() && !i->isBinary())
+            return QString::fromUtf8(toLobStream::readLob(i));
+    }
+    return model->data(index, Qt::EditRole).toString();
+}
@@ -37,6 +37,7 @@
 #include "core/toconfenum.h"
 
 #include <QtCore/QString>
+#include <QtCore/QByteArray>
 #include <QtCore/QModelIndexList>
 #include <QtCore/QVector>
 
@@ -55,6 +56,9 @@ namespace ToConfiguration
             {
                 CsvDelimiter = 13000
                 , CsvSeparator
+                , SqlInsertStyle      // toInsertScript::Style
+                , SqlBatchRows
+                , SqlCommitDistance
             };
             virtual QVariant defaultValue(int) const;
     };
@@ -90,6 +94,10 @@ class toExportSettings
         QString delimiter;
         QString extension;
         QString owner; // owner (schema) of the object
+        int insertStyle;    // SQL export only, see toInsertScript::Style
+        int batchRows;      // SQL export only, rows per INSERT statement/block
+        int commitDistance; // SQL export only, 0 means no COMMIT
+        bool directCsv;     // CSV export only, written by the database, see toConnectionSub::exportCsv
         QString objectName; // name of object data of which is being exported
 
         QModelIndexList selected;
@@ -109,6 +117,10 @@ class toExportSettings
             columnsHeader = _columnsHeader;
             separator = _sep;
             delimiter = _del;
+            insertStyle = 0;
+            batchRows = 1;
+            commitDistance = 0;
+            directCsv = false;
 
             switch (type)
             {
@@ -124,6 +136,9 @@ class toExportSettings
                 case 4:
                     extension = "*.sql";
                     break;
+                case 6:
+                    extension = "*.arrow";
+                    break;
             };
         }
 
@@ -142,10 +157,16 @@ public:
 	toListViewFormatter();
 	virtual ~toListViewFormatter();
 	virtual QString getFormattedString(toExportSettings &settings, const QAbstractItemModel * model) = 0;
+	/** Binary formats (see isBinary) override this, text formats return getFormattedString as UTF-8 */
+	virtual QByteArray getFormattedData(toExportSettings &settings, const QAbstractItemModel * model);
+	/** Returns true if the output must be written as raw bytes (no codec, no line-end conversion) */
+	virtual bool isBinary() const;
 
 protected:
 	virtual void endLine(QString &output);
 	// build a vector of selected rows for easy searching
 	virtual QVector<int> selectedRows(const QModelIndexList &selected);
 	virtual QVector<int> selectedColumns(const QModelIndexList &selected);
+	/** Text of a cell for export. Character LOBs are streamed whole (Qt::EditRole holds a truncated preview). */
+	QString cellText(const QAbstractItemModel * model, const QModelIndex &index) const;
 };
@@ -0,0 +1,615 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "core/tolistviewformatterarrow.h"
+#include "core/tolistviewformatterfactory.h"
+#include "core/tolistviewformatteridentifier.h"
+#include "core/toqvalue.h"
+
+#include <QtCore/QAbstractItemModel>
+#include <QtCore/QDateTime>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QtEndian>
+#include <QtCore/QVector>
+
+#include <algorithm>
+#include <limits>
+#include <string.h>
+
+namespace
+{
+    toListViewFormatter* createArrow()
+    {
+        return new toListViewFormatterArrow();
+    }
+    const bool registered = toListViewFormatterFactory::Instance().Register(toListViewFormatterIdentifier::ARROW, createArrow);
+
+    // Constants from Schema.fbs, Message.fbs and File.fbs of the Arrow format specification
+    enum
+    {
+        MetadataV5 = 4,
+        HeaderSchema = 1,
+        HeaderRecordBatch = 3,
+        TypeInt = 2,
+        TypeFloatingPoint = 3,
+        TypeUtf8 = 5,
+        TypeDate = 8,
+        TypeTimestamp = 10,
+        PrecisionDouble = 2,
+        DateUnitDay = 0,
+        TimeUnitMillisecond = 1
+    };
+
+    template<typename T> void appendLE(QByteArray &buf, T value)
+    {
+        T le = qToLittleEndian<T>(value);
+        buf.append((const char*) &le, sizeof(T));
+    }
+
+    void padTo(QByteArray &buf, int align)
+    {
+        while (buf.size() % align)
+            buf.append('\0');
+    }
+
+    class FbTable;
+    typedef QSharedPointer<FbTable> FbTablePtr;
+
+    /**
+     * Description of a flatbuffers table, just enough to serialize Arrow metadata.
+     * Fields are identified by their index in the .fbs table definition.
+     */
+    class FbTable
+    {
+        public:
+            struct Field
+            {
+                enum Kind { Scalar, Table, String, Tables, Structs };
+                int id;
+                Kind kind;
+                int size;                   // size of the scalar or alignment of the struct elements
+                int count;                  // number of vector elements
+                QByteArray bytes;           // little endian scalar, utf8 string or packed structs
+                QList<FbTablePtr> tables;   // referenced table(s)
+            };
+
+            template<typename T> FbTable& scalar(int id, T value)
+            {
+                Field f = field(id, Field::Scalar);
+                f.size = sizeof(T);
+                appendLE<T>(f.bytes, value);
+                Fields << f;
+                return *this;
+            }
+
+            FbTable& table(int id, FbTablePtr t)
+            {
+                Field f = field(id, Field::Table);
+                f.tables << t;
+                Fields << f;
+                return *this;
+            }
+
+            FbTable& string(int id, const QString &str)
+            {
+                Field f = field(id, Field::String);
+                f.bytes = str.toUtf8();
+                Fields << f;
+                return *this;
+            }
+
+            FbTable& tables(int id, const QList<FbTablePtr> &t)
+            {
+                Field f = field(id, Field::Tables);
+                f.count = t.size();
+                f.tables = t;
+                Fields << f;
+                return *this;
+            }
+
+            FbTable& structs(int id, const QByteArray &packed, int count, int align)
+            {
+                Field f = field(id, Field::Structs);
+                f.size = align;
+                f.count = count;
+                f.bytes = packed;
+                Fields << f;
+                return *this;
+            }
+
+            QList<Field> Fields;
+
+        private:
+            static Field field(int id, Field::Kind kind)
+            {
+                Field f;
+                f.id = id;
+                f.kind = kind;
+                f.size = 4;
+                f.count = 0;
+                return f;
+            }
+    };
+
+    /**
+     * Serializes FbTable trees. Unlike the reference flatbuffers builder this one writes
+     * front to back, every object is followed by the objects it references, so all
+     * unsigned offsets point forward as the format requires.
+     */
+    class FbWriter
+    {
+        public:
+            static QByteArray finish(const FbTable &root)
+            {
+                FbWriter w;
+                appendLE<quint32>(w.Buf, 0);
+                w.patch(0, w.table(root));
+                padTo(w.Buf, 8);
+                return w.Buf;
+            }
+
+        private:
+            QByteArray Buf;
+
+            static int inlineSize(const FbTable::Field &f)
+            {
+                return f.kind == FbTable::Field::Scalar ? f.size : 4;
+            }
+
+            void patch(int at, int target)
+            {
+                quint32 le = qToLittleEndian<quint32>(target - at);
+                memcpy(Buf.data() + at, &le, sizeof(le));
+            }
+
+            int table(const FbTable &t)
+            {
+                // biggest fields first, so that only the leading soffset may need padding
+                QList<FbTable::Field> fields = t.Fields;
+                std::stable_sort(fields.begin(), fields.end(),
+                                 [](const FbTable::Field &a, const FbTable::Field &b)
+                {
+                    return inlineSize(a) > inlineSize(b);
+                });
+
+                int maxId = -1;
+                Q_FOREACH(const FbTable::Field &f, fields)
+                    maxId = qMax(maxId, f.id);
+
+                QVector<int> offsets(maxId + 1, 0);
+                int size = 4; // soffset of the vtable
+                Q_FOREACH(const FbTable::Field &f, fields)
+                {
+                    int s = inlineSize(f);
+                    size = (size + s - 1) / s * s;
+                    offsets[f.id] = size;
+                    size += s;
+                }
+
+                padTo(Buf, 2);
+                int vtable = Buf.size();
+                appendLE<quint16>(Buf, 4 + 2 * offsets.size());
+                appendLE<quint16>(Buf, size);
+                Q_FOREACH(int o, offsets)
+                    appendLE<quint16>(Buf, o);
+
+                padTo(Buf, 8);
+                int start = Buf.size();
+                Buf.append(QByteArray(size, '\0'));
+                qint32 soffset = qToLittleEndian<qint32>(start - vtable);
+                memcpy(Buf.data() + start, &soffset, sizeof(soffset));
+
+                Q_FOREACH(const FbTable::Field &f, fields)
+                {
+                    if (f.kind == FbTable::Field::Scalar)
+                        memcpy(Buf.data() + start + offsets[f.id], f.bytes.constData(), f.size);
+                }
+                Q_FOREACH(const FbTable::Field &f, fields)
+                {
+                    if (f.kind != FbTable::Field::Scalar)
+                        patch(start + offsets[f.id], reference(f));
+                }
+                return start;
+            }
+
+            int reference(const FbTable::Field &f)
+            {
+                int pos;
+                switch (f.kind)
+                {
+                    case FbTable::Field::Table:
+                        return table(*f.tables.first());
+                    case FbTable::Field::String:
+                        padTo(Buf, 4);
+                        pos = Buf.size();
+                        appendLE<quint32>(Buf, f.bytes.size());
+                        Buf.append(f.bytes);
+                        Buf.append('\0');
+                        return pos;
+                    case FbTable::Field::Tables:
+                        {
+                            padTo(Buf, 4);
+                            pos = Buf.size();
+                            appendLE<quint32>(Buf, f.count);
+                            int first = Buf.size();
+                            Buf.append(QByteArray(4 * f.count, '\0'));
+                            for (int i = 0; i < f.count; i++)
+                                patch(first + 4 * i, table(*f.tables.at(i)));
+                            return pos;
+                        }
+                    case FbTable::Field::Structs:
+                        // struct elements must be aligned, the length prefix precedes them
+                        while ((Buf.size() + 4) % f.size)
+                            Buf.append('\0');
+                        pos = Buf.size();
+                        appendLE<quint32>(Buf, f.count);
+                        Buf.append(f.bytes);
+                        return pos;
+                    default:
+                        Q_ASSERT_X(false, "FbWriter::reference", "scalar is not a reference");
+                        return 0;
+                }
+            }
+    };
+
+    struct ArrowColumn
+    {
+        enum Type { None, Int64, UInt64, Float64, Date32, TimestampMs, Utf8 };
+        int source;       // column in the model
+        QString name;
+        Type type;
+    };
+
+    ArrowColumn::Type valueType(const QVariant &v)
+    {
+        switch (v.userType())
+        {
+            case QMetaType::Short:
+            case QMetaType::UShort:
+            case QMetaType::Int:
+            case QMetaType::UInt:
+            case QMetaType::Long:
+            case QMetaType::LongLong:
+                return ArrowColumn::Int64;
+            case QMetaType::ULong:
+            case QMetaType::ULongLong:
+                // Int64 unless the value does not fit
+                if (v.toULongLong() > quint64(std::numeric_limits<qint64>::max()))
+                    return ArrowColumn::UInt64;
+                return ArrowColumn::Int64;
+            case QMetaType::Float:
+            case QMetaType::Double:
+                return ArrowColumn::Float64;
+            case QMetaType::QDate:
+                return ArrowColumn::Date32;
+            case QMetaType::QDateTime:
+                return ArrowColumn::TimestampMs;
+            default:
+                return ArrowColumn::Utf8;
+        }
+    }
+
+    ArrowColumn::Type mergeTypes(ArrowColumn::Type a, ArrowColumn::Type b)
+    {
+        if (a == ArrowColumn::None || a == b)
+            return b;
+        if (b == ArrowColumn::None)
+            return a;
+        bool aInt = a == ArrowColumn::Int64 || a == ArrowColumn::UInt64;
+        bool bInt = b == ArrowColumn::Int64 || b == ArrowColumn::UInt64;
+        // negative values in an UInt64 column are checked by the caller
+        if (aInt && bInt)
+            return ArrowColumn::UInt64;
+        if ((aInt && b == ArrowColumn::Float64) || (a == ArrowColumn::Float64 && bInt))
+            return ArrowColumn::Float64;
+        return ArrowColumn::Utf8;
+    }
+
+    bool isNullValue(const QVariant &v)
+    {
+        return !v.isValid() || v.isNull();
+    }
+
+    /* Raw (not formatted) value of the cell, complex types (LOBs, collections, ...) are exported as text */
+    QVariant cellValue(const QAbstractItemModel *model, int row, int column)
+    {
+        if (column == 0) // row number
+            return model->data(model->index(row, 0), Qt::DisplayRole);
+        QVariant v = model->data(model->index(row, column), Qt::UserRole);
+        if (v.userType() == qMetaTypeId<toQValue::complexType*>())
+            return model->data(model->index(row, column), Qt::EditRole);
+        return v;
+    }
+
+    /* Body and buffer/node descriptors of one record batch */
+    struct ArrowBatch
+    {
+        QByteArray Body;
+        QByteArray Nodes;
+        QByteArray Buffers;
+        int BufferCount;
+
+        ArrowBatch() : BufferCount(0) {}
+
+        void addNode(qint64 length, qint64 nullCount)
+        {
+            appendLE<qint64>(Nodes, length);
+            appendLE<qint64>(Nodes, nullCount);
+        }
+
+        void addBuffer(const QByteArray &data)
+        {
+            appendLE<qint64>(Buffers, Body.size());
+            appendLE<qint64>(Buffers, data.size());
+            Body.append(data);
+            padTo(Body, 8);
+            BufferCount++;
+        }
+
+        void addColumn(ArrowColumn::Type type, const QVector<QVariant> &values)
+        {
+            static const QDate epoch(1970, 1, 1);
+            int n = values.size();
+            qint64 nulls = 0;
+            QByteArray validity((n + 7) / 8, '\0');
+            QByteArray offsets;
+            QByteArray data;
+
+            if (type == ArrowColumn::Utf8)
+                appendLE<qint32>(offsets, 0);
+            for (int i = 0; i < n; i++)
+            {
+                const QVariant &v = values.at(i);
+                bool null = isNullValue(v);
+                if (null)
+                    nulls++;
+                else
+                    validity[i / 8] = char(validity.at(i / 8) | (1 << (i % 8)));
+
+                switch (type)
+                {
+                    case ArrowColumn::Int64:
+                        appendLE<qint64>(data, null ? 0 : v.toLongLong());
+                        break;
+                    case ArrowColumn::UInt64:
+                        appendLE<quint64>(data, null ? 0 : v.toULongLong());
+                        break;
+                    case ArrowColumn::Float64:
+                        {
+                            double d = null ? 0 : v.toDouble();
+                            quint64 bits;
+                            memcpy(&bits, &d, sizeof(bits));
+                            appendLE<quint64>(data, bits);
+                        }
+                        break;
+                    case ArrowColumn::Date32:
+                        appendLE<qint32>(data, null ? 0 : qint32(epoch.daysTo(v.toDate())));
+                        break;
+                    case ArrowColumn::TimestampMs:
+                        {
+                            // timestamps without time zone hold the wall clock time
+                            QDateTime dt = v.toDateTime();
+                            appendLE<qint64>(data, null ? 0 : QDateTime(dt.date(), dt.time(), Qt::UTC).toMSecsSinceEpoch());
+                        }
+                        break;
+                    default:
+                        if (!null)
+                            data.append(v.toString().toUtf8());
+                        appendLE<qint32>(offsets, data.size());
+                        break;
+                }
+            }
+
+            addNode(n, nulls);
+            addBuffer(validity);
+            if (type == ArrowColumn::Utf8)
+                addBuffer(offsets);
+            addBuffer(data);
+        }
+    };
+
+    FbTablePtr schemaTable(const QList<ArrowColumn> &columns)
+    {
+        QList<FbTablePtr> fields;
+        Q_FOREACH(const ArrowColumn &c, columns)
+        {
+            FbTablePtr type(new FbTable);
+            quint8 typeType = TypeUtf8;
+            switch (c.type)
+            {
+                case ArrowColumn::Int64:
+                    typeType = TypeInt;
+                    type->scalar<qint32>(0, 64).scalar<quint8>(1, 1); // bitWidth, is_signed
+                    break;
+                case ArrowColumn::UInt64:
+                    typeType = TypeInt;
+                    type->scalar<qint32>(0, 64).scalar<quint8>(1, 0);
+                    break;
+                case ArrowColumn::Float64:
+                    typeType = TypeFloatingPoint;
+                    type->scalar<qint16>(0, PrecisionDouble);
+                    break;
+                case ArrowColumn::Date32:
+                    typeType = TypeDate;
+                    type->scalar<qint16>(0, DateUnitDay);
+                    break;
+                case ArrowColumn::TimestampMs:
+                    typeType = TypeTimestamp;
+                    type->scalar<qint16>(0, TimeUnitMillisecond);
+                    break;
+                default:
+                    break;
+            }
+
+            FbTablePtr field(new FbTable);
+            field->string(0, c.name)
+            .scalar<quint8>(1, 1) // nullable
+            .scalar<quint8>(2, typeType)
+            .table(3, type)
+            .tables(5, QList<FbTablePtr>()); // children
+            fields << field;
+        }
+
+        FbTablePtr schema(new FbTable);
+        schema->scalar<qint16>(0, 0) // little endian
+        .tables(1, fields);
+        return schema;
+    }
+
+    /* Encapsulated IPC message: continuation marker, metadata length, Message flatbuffer and body */
+    void writeMessage(QByteArray &output, quint8 headerType, FbTablePtr header, const QByteArray &body, QByteArray *blocks)
+    {
+        FbTable message;
+        message.scalar<qint16>(0, MetadataV5)
+        .scalar<quint8>(1, headerType)
+        .table(2, header)
+        .scalar<qint64>(3, body.size());
+        QByteArray meta = FbWriter::finish(message);
+
+        qint64 offset = output.size();
+        appendLE<quint32>(output, 0xFFFFFFFF);
+        appendLE<qint32>(output, meta.size());
+        output.append(meta);
+        output.append(body);
+
+        if (blocks)
+        {
+            appendLE<qint64>(*blocks, offset);
+            appendLE<qint32>(*blocks, 8 + meta.size());
+            appendLE<qint32>(*blocks, 0); // padding
+            appendLE<qint64>(*blocks, body.size());
+        }
+    }
+}
+
+toListViewFormatterArrow::toListViewFormatterArrow() : toListViewFormatter()
+{
+}
+
+toListViewFormatterArrow::~toListViewFormatterArrow()
+{
+}
+
+QString toListViewFormatterArrow::getFormattedString(toExportSettings &, const QAbstractItemModel *)
+{
+    return QString();
+}
+
+QByteArray toListViewFormatterArrow::getFormattedData(toExportSettings &settings, const QAbstractItemModel * model)
+{
+    int columns = model->columnCount();
+    int rows    = model->rowCount();
+
+    QVector<int> rlist = selectedRows(settings.selected);
+    QVector<int> clist = selectedColumns(settings.selected);
+
+    QVector<int> exported;
+    for (int row = 0; row < rows; row++)
+    {
+        if (settings.rowsExport == toExportSettings::RowsSelected && !rlist.contains(row))
+            continue;
+        exported << row;
+    }
+
+    QList<ArrowColumn> cols;
+    for (int i = (settings.rowsHeader ? 0 : 1); i < columns; i++)
+    {
+        if (settings.columnsExport == toExportSettings::ColumnsSelected && !clist.contains(i))
+            continue;
+
+        ArrowColumn c;
+        c.source = i;
+        c.name = model->headerData(i, Qt::Horizontal, Qt::DisplayRole).toString();
+        c.type = i == 0 ? ArrowColumn::Int64 : ArrowColumn::None;
+        bool negative = false;
+        // the schema precedes the data, so the column types are resolved in a separate pass
+        for (int r = 0; i != 0 && r < exported.size() && c.type != ArrowColumn::Utf8; r++)
+        {
+            QVariant v = cellValue(model, exported.at(r), i);
+            if (isNullValue(v))
+                continue;
+            ArrowColumn::Type t = valueType(v);
+            if (t == ArrowColumn::Int64 && v.toLongLong() < 0)
+                negative = true;
+            c.type = mergeTypes(c.type, t);
+        }
+        // no 64 bit integer type holds both, exported as decimal text
+        if (c.type == ArrowColumn::None || (c.type == ArrowColumn::UInt64 && negative))
+            c.type = ArrowColumn::Utf8;
+        cols << c;
+    }
+
+    QByteArray output("ARROW1\0\0", 8);
+    FbTablePtr schema = schemaTable(cols);
+    writeMessage(output, HeaderSchema, schema, QByteArray(), NULL);
+
+    QByteArray blocks;
+    int blockCount = 0;
+    for (int first = 0; first < exported.size(); first += BatchRows)
+    {
+        int count = qMin<int>(BatchRows, exported.size() - first);
+        ArrowBatch batch;
+        Q_FOREACH(const ArrowColumn &c, cols)
+        {
+            QVector<QVariant> values;
+            values.reserve(count);
+            for (int r = first; r < first + count; r++)
+                values << cellValue(model, exported.at(r), c.source);
+            batch.addColumn(c.type, values);
+        }
+
+        FbTablePtr recordBatch(new FbTable);
+        recordBatch->scalar<qint64>(0, count)
+        .structs(1, batch.Nodes, cols.size(), 8)
+        .structs(2, batch.Buffers, batch.BufferCount, 8);
+        writeMessage(output, HeaderRecordBatch, recordBatch, batch.Body, &blocks);
+        blockCount++;
+    }
+
+    // end of stream marker
+    appendLE<quint32>(output, 0xFFFFFFFF);
+    appendLE<qint32>(output, 0);
+
+    FbTable footer;
+    footer.scalar<qint16>(0, MetadataV5)
+    .table(1, schema)
+    .structs(2, QByteArray(), 0, 8) // dictionaries
+    .structs(3, blocks, blockCount, 8);
+    QByteArray footerData = FbWriter::finish(footer);
+    output.append(footerData);
+    appendLE<qint32>(output, footerData.size());
+    output.append("ARROW1", 6);
+
+    return output;
+}
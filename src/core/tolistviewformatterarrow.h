@@ -0,0 +1,68 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include "core/tolistviewformatter.h"
+
+#include <QtCore/QByteArray>
+
+/**
+ * Exports result data in the Apache Arrow IPC file format.
+ *
+ * The writer is self-contained (the flatbuffers metadata are serialized by hand),
+ * so no Arrow library is needed. Column types are taken from the raw values held
+ * by the model (Qt::UserRole): integers are written as Int64 (UInt64 when an unsigned
+ * value does not fit, text when the column also holds negative values), floating point
+ * values as Float64, dates as Date32 and timestamps as Timestamp(ms). Everything else
+ * becomes an Utf8 column. Data are written in record batches of BatchRows rows.
+ */
+class toListViewFormatterArrow : public toListViewFormatter
+{
+    public:
+        toListViewFormatterArrow();
+        virtual ~toListViewFormatterArrow();
+
+        /** Arrow is a binary format, use getFormattedData. This returns an empty string. */
+        QString getFormattedString(toExportSettings &settings, const QAbstractItemModel * model) override;
+
+        QByteArray getFormattedData(toExportSettings &settings, const QAbstractItemModel * model) override;
+
+        bool isBinary() const override
+        {
+            return true;
+        }
+
+        enum { BatchRows = 65536 };
+};
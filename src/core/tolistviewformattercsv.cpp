@@ -120,7 +120,7 @@ QString toListViewFormatterCSV::getFormattedString(toExportSettings &settings,
                 continue;
 
             mi = model->index(row, i);
-            QString text = model->data(mi, Qt::EditRole).toString();
+            QString text = cellText(model, mi);
             line += indent;
 
             line += QString::fromLatin1("%1%2%3%4").
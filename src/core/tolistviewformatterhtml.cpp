@@ -122,7 +122,7 @@ QString toListViewFormatterHTML::getFormattedString(toExportSettings &settings,
             endLine(output);
 
             mi = model->index(row, i);
-            QString text = TO_ESCAPE(QString(model->data(mi, Qt::EditRole).toString()));
+            QString text = TO_ESCAPE(cellText(model, mi));
 
             output += "\t\t" + text;
             endLine(output);
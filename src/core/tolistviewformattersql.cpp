@@ -43,6 +43,7 @@
 #include "core/toconfiguration.h"
 #include "core/tolistviewformatterfactory.h"
 #include "core/tolistviewformatteridentifier.h"
+#include "core/toinsertscript.h"
 #include "core/utils.h"
 #include "editor/toworksheettext.h"
 #include "connection/tooracleconfiguration.h"
@@ -79,16 +80,10 @@ QString toListViewFormatterSQL::getFormattedString(toExportSettings &settings,
     QVector<int> rlist = selectedRows(settings.selected);
     QVector<int> clist = selectedColumns(settings.selected);
 
-    QString sql;
     QString objectName;
-    QString columnNames;
+    QStringList columnNames;
     QString output;
 
-    if (toConfigurationNewSingle::Instance().option(Editor::KeywordUpperBool).toBool())
-        sql = "INSERT INTO %1%2 VALUES (%3);";
-    else
-        sql = "insert into %1%2 values (%3);";
-
     if (!settings.objectName.isEmpty())
     {
         if (!settings.owner.isEmpty())
@@ -105,24 +100,32 @@ QString toListViewFormatterSQL::getFormattedString(toExportSettings &settings,
 
     if (settings.columnsHeader)
     {
-        columnNames += " (";
         for (int j = 1; j < columns; j++)
         {
             if (settings.columnsExport == toExportSettings::ColumnsSelected && !clist.contains(j))
                 continue;
-            columnNames += model->headerData(
-                               j,
-                               Qt::Horizontal,
-                               Qt::DisplayRole).toString();
-            columnNames += ", ";
+            columnNames << model->headerData(
+                            j,
+                            Qt::Horizontal,
+                            Qt::DisplayRole).toString();
         }
-        columnNames = columnNames.left(columnNames.length() - 2) + ")";
     }
 
     const toResultModel *resultModel = reinterpret_cast<const toResultModel*>(model);
     if (!model)
         return "-- cannot access data result. Maybe it's not a SQL export";
 
+    QString eol;
+    endLine(eol);
+    toInsertScript script(conn,
+                          objectName,
+                          columnNames,
+                          (toInsertScript::Style) settings.insertStyle,
+                          settings.batchRows,
+                          settings.commitDistance);
+    script.setUpperKeywords(toConfigurationNewSingle::Instance().option(Editor::KeywordUpperBool).toBool());
+    script.setLineEnd(eol);
+
     QModelIndex mi;
     toResultModel::HeaderList hdr = resultModel->headers();
     for (int row = 0; row < rows; row++)
@@ -130,7 +133,7 @@ QString toListViewFormatterSQL::getFormattedString(toExportSettings &settings,
         if (settings.rowsExport == toExportSettings::RowsSelected && !rlist.contains(row))
             continue;
 
-        QString values;
+        QStringList values;
         for (int i = 1; i < columns; i++)
         {
             if (settings.columnsExport == toExportSettings::ColumnsSelected && !clist.contains(i))
@@ -145,24 +148,20 @@ QString toListViewFormatterSQL::getFormattedString(toExportSettings &settings,
             if (h.contains("DATE"))
             {
                 if (currVal.toString().isEmpty())
-                    values += "NULL";
+                    values << "NULL";
                 else
                 {
-                    values += conn.getTraits().formatDate(currVal);
+                    values << conn.getTraits().formatDate(currVal);
                 }
             }
             else if (h.contains("CHAR"))
-            	values += currVal.toString().isEmpty() ? "NULL" : conn.getTraits().quoteVarchar(currVal.toString());
+            	values << (currVal.toString().isEmpty() ? "NULL" : conn.getTraits().quoteVarchar(currVal.toString()));
             else
-                values += currVal.toString().isEmpty() ? "NULL" : currVal.toString();
-
-            values += ", ";
+                values << (currVal.toString().isEmpty() ? "NULL" : currVal.toString());
         }
-        values = values.left(values.length() - 2);
-        QString line(sql.arg(objectName).arg(columnNames).arg(values));
-        endLine(line);
-        output += line;
+        output += script.addRow(values);
     }
+    output += script.finish();
 
     return output;
 }
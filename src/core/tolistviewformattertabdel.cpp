@@ -104,7 +104,7 @@ QString toListViewFormatterTabDel::getFormattedString(toExportSettings &settings
             if (!settings.rowsHeader && i == 0)
                 continue;
             mi = model->index(row, i);
-            QString text = model->data(mi, Qt::EditRole).toString();
+            QString text = cellText(model, mi);
             line += indent;
             line += QString::fromLatin1("%1\t").arg(text);
         }
@@ -0,0 +1,109 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "core/tolobstream.h"
+
+#include <cstring>
+
+toLobStream::toLobStream(toQValue::complexType const *lob, QObject *parent)
+    : QIODevice(parent)
+    , Lob(lob)
+    , BlockPos(0)
+    , Offset(0)
+    , Eof(lob == NULL)
+    , Failed(false)
+{
+    open(QIODevice::ReadOnly);
+}
+
+bool toLobStream::atEnd() const
+{
+    return Eof && BlockPos >= Block.size() && QIODevice::bytesAvailable() == 0;
+}
+
+qint64 toLobStream::bytesAvailable() const
+{
+    return (Block.size() - BlockPos) + QIODevice::bytesAvailable();
+}
+
+QByteArray toLobStream::readLob(toQValue::complexType const *lob)
+{
+    toLobStream stream(lob);
+    QByteArray ret = stream.readAll();
+    if (stream.failed())
+        throw stream.errorString();
+    return ret;
+}
+
+bool toLobStream::fetch()
+{
+    if (BlockPos < Block.size())
+        return true;
+    if (Eof)
+        return false;
+
+    Block = Lob->read(Offset);
+    BlockPos = 0;
+    Offset += Block.size();
+    if (Block.isEmpty())
+        Eof = true;
+    return !Eof;
+}
+
+qint64 toLobStream::readData(char *data, qint64 maxSize)
+{
+    qint64 copied = 0;
+    try
+    {
+        while (copied < maxSize && fetch())
+        {
+            qint64 len = qMin(maxSize - copied, (qint64)(Block.size() - BlockPos));
+            memcpy(data + copied, Block.constData() + BlockPos, len);
+            BlockPos += len;
+            copied += len;
+        }
+    }
+    catch (const QString &str)
+    {
+        // complexType::read throws toConnection::exception (a QString)
+        setErrorString(str);
+        Failed = true;
+        Eof = true;
+        Block.clear();
+        BlockPos = 0;
+    }
+    if (copied == 0 && Eof)
+        return -1;
+    return copied;
+}
@@ -0,0 +1,96 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include "core/toqvalue.h"
+
+#include <QtCore/QIODevice>
+#include <QtCore/QByteArray>
+
+/** Sequential read-only device over content of a large value (LOB).
+ *
+ * Data are pulled from @ref toQValue::complexType::read block by block, so even
+ * very large LOBs can be copied into a file or parsed without holding them in memory.
+ * The complexType must outlive the stream.
+ */
+class toLobStream : public QIODevice
+{
+    public:
+        toLobStream(toQValue::complexType const *lob, QObject *parent = NULL);
+
+        bool isSequential() const override
+        {
+            return true;
+        }
+
+        bool atEnd() const override;
+
+        qint64 bytesAvailable() const override;
+
+        /** True when reading from the LOB failed, the reason is in errorString().
+         *  The stream reports end of data after a failure, so callers must check
+         *  this before trusting what they have read.
+         */
+        bool failed() const
+        {
+            return Failed;
+        }
+
+        /** Read whole content of @p lob, convenience for small values
+         *  @exception QString when the LOB can not be read
+         */
+        static QByteArray readLob(toQValue::complexType const *lob);
+
+    protected:
+        qint64 readData(char *data, qint64 maxSize) override;
+
+        qint64 writeData(const char *, qint64) override
+        {
+            return -1;
+        }
+
+    private:
+        /** Read next block from the LOB if current one is consumed.
+         *  @return false at the end of LOB
+         */
+        bool fetch();
+
+        toQValue::complexType const *Lob;
+        QByteArray Block;
+        int BlockPos;
+        quint64 Offset; // LOB offset following Block
+        bool Eof;
+        bool Failed;
+};
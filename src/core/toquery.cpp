@@ -49,6 +49,7 @@ toQueryAbstr::toQueryAbstr(toConnectionSubLoan &conn, const toSQL &sql, toQueryP
     , m_SQLName(sql.name())
     , m_eof(false)
     , m_rowsProcessed(0)
+    , m_FetchSize(0)
     , m_Query(NULL)
 {
 	conn->setLastSql(sql.name());
@@ -62,6 +63,7 @@ toQueryAbstr::toQueryAbstr(toConnectionSubLoan &conn, QString const& sql, toQuer
     , m_SQLName(sql.left(20))
     , m_eof(false)
     , m_rowsProcessed(0)
+    , m_FetchSize(0)
     , m_Query(NULL)
 {
 	conn->setLastSql(sql.left(20));
@@ -137,37 +139,58 @@ toQColumnDescriptionList toQueryAbstr::describe(void)
     return m_Query->describe();
 }
 
+void toQueryAbstr::initSession()
+{
+    toConnectionTraits const& traits = m_ConnectionSubLoan.ParentConnection.getTraits();
+    QStringList setup;
+
+    // Try to switch the current db schema
+    bool switchSchema = m_ConnectionSubLoan.SchemaInitialized == false && !m_ConnectionSubLoan.Schema.isEmpty();
+    if (switchSchema)
+    {
+        QString sql = traits.schemaSwitchSQL(m_ConnectionSubLoan.Schema);
+        if (!sql.isEmpty())
+            setup << sql;
+    }
+
+    // Init strings (NLS settings, DBMS_OUTPUT, ...) are executed again only when they were changed
+    QStringList init = m_ConnectionSubLoan.ParentConnection.initStrings();
+    uint hash = init.isEmpty() ? 0 : qHash(init.join(QString::fromLatin1("\n")));
+    if (m_ConnectionSubLoan->setupHash() != hash)
+        setup << init;
+
+    // All of them are sent in a single round trip when the provider can combine them
+    QString combined = setup.size() > 1 ? traits.sessionSetupSQL(setup) : QString();
+    if (!combined.isEmpty())
+        executeSetup(combined);
+    else
+    {
+        Q_FOREACH(QString const& sql, setup)
+            executeSetup(sql);
+    }
+
+    if (switchSchema)
+    {
+        m_ConnectionSubLoan.SchemaInitialized = true;
+        m_ConnectionSubLoan->setSchema(m_ConnectionSubLoan.Schema); // assign value in toConnectionSub from toConnectionSubLoan
+    }
+    m_ConnectionSubLoan->setSetupHash(hash);
+}
+
+void toQueryAbstr::executeSetup(QString const& sql)
+{
+    m_Query = m_ConnectionSubLoan->createQuery(this);
+    m_ConnectionSubLoan->setQuery(this);
+    m_Query->execute(sql);
+    delete m_Query;
+    m_Query = NULL;
+}
+
 void toQuery::init()
 {
     try
     {
-        // Try to switch the current db schema
-        if (m_ConnectionSubLoan.SchemaInitialized == false && !m_ConnectionSubLoan.Schema.isEmpty())
-        {
-            QString sql = m_ConnectionSubLoan.ParentConnection.getTraits().schemaSwitchSQL(m_ConnectionSubLoan.Schema);
-            if (!sql.isEmpty())
-            {
-                m_Query = m_ConnectionSubLoan->createQuery(this);
-                m_ConnectionSubLoan->setQuery(this);
-                m_Query->execute(sql);
-                delete m_Query;
-            }
-            m_ConnectionSubLoan.SchemaInitialized = true;
-            m_ConnectionSubLoan->setSchema(m_ConnectionSubLoan.Schema); // assign value in toConnectionSub from toConnectionSubLoan
-        }
-
-        // Try to switch the current NLS_SETTINGS (not implemented yet)
-        if ( m_ConnectionSubLoan->isInitialized() == false)
-        {
-            Q_FOREACH(QString sql, m_ConnectionSubLoan.ParentConnection.initStrings())
-            {
-                m_Query = m_ConnectionSubLoan->createQuery(this);
-                m_ConnectionSubLoan->setQuery(this);
-                m_Query->execute(sql);
-                delete m_Query;
-            }
-            m_ConnectionSubLoan->setInitialized(true);
-        }
+        initSession();
 
         m_Query = m_ConnectionSubLoan->createQuery(this);
         m_ConnectionSubLoan->setQuery(this);
@@ -183,6 +206,74 @@ void toQuery::init()
     }
 }
 
+void toQueryBatch::init()
+{
+    try
+    {
+        initSession();
+
+        m_Query = m_ConnectionSubLoan->createQuery(this);
+        m_ConnectionSubLoan->setQuery(this);
+    }
+    catch (...)
+    {
+        if (m_Query)
+            delete m_Query;
+        m_ConnectionSubLoan->setQuery(NULL);
+        m_Query = NULL;
+        throw;
+    }
+}
+
+int toQueryBatch::execute(QList<toQueryParams> const& rows, QString &error)
+{
+    if (!m_Query)
+        init();
+    if (connection().Abort)
+        throw qApp->translate("toQuery", "Query aborted");
+    m_Query->setCollectErrors(m_CollectErrors);
+    int retval = m_Query->executeBatch(rows, error);
+    m_rowsProcessed = m_Query->batchAffected();
+    return retval;
+}
+
+int queryImpl::executeBatch(QList<toQueryParams> const& rows, QString &error)
+{
+    int done = 0;
+    BatchAffected = 0;
+    BatchErrors.clear();
+    Q_FOREACH(toQueryParams const& row, rows)
+    {
+        query()->params() = row;
+        QString rowError;
+        try
+        {
+            execute();
+            BatchAffected += rowsProcessed();
+        }
+        catch (QString const& str)
+        {
+            rowError = str.isNull() ? QString::fromLatin1("") : str;
+        }
+        catch (std::exception const& e)
+        {
+            rowError = QString::fromUtf8(e.what());
+        }
+        if (!rowError.isNull())
+        {
+            if (!CollectErrors)
+            {
+                error = rowError;
+                break;
+            }
+            BatchError err = { done, rowError };
+            BatchErrors << err;
+        }
+        done++;
+    }
+    return done;
+}
+
 toQList toQuery::readQuery(toConnection &conn, toSQL const& sql, toQueryParams const& params)
 {
     Utils::toBusy busy;
@@ -141,6 +141,20 @@ class toQueryAbstr : public QObject
         /** Get a list of descriptions for the columns. This function is relatively slow. */
         toQColumnDescriptionList describe(void);
 
+        /** Set number of rows fetched from the database in one round-trip.
+         * Must be called before the query is executed, 0 lets the provider choose.
+         * Not all providers support this.
+         */
+        inline void setFetchSize(unsigned rows)
+        {
+            m_FetchSize = rows;
+        }
+
+        inline unsigned fetchSize(void) const
+        {
+            return m_FetchSize;
+        }
+
         /** Get the number of columns in the resultset of the query.*/
         inline unsigned columns(void) const
         {
@@ -155,17 +169,45 @@ class toQueryAbstr : public QObject
 
         virtual void init() = 0;
 
+        /** Switch the loaned connection into requested schema and run connection
+         * init strings (if not done yet). Called from init() before the query is created.
+         */
+        void initSession();
+
+        /** Execute a session setup statement using a temporary queryImpl */
+        void executeSetup(QString const& sql);
+
         toConnectionSubLoan& m_ConnectionSubLoan;
         toQueryParams m_Params;
         QString m_SQL;
         QString m_SQLName;
         bool m_eof;
         unsigned long m_rowsProcessed;
+        unsigned m_FetchSize;
 
         queryImpl *m_Query;
         toQueryAbstr(const toQuery &);
 };
 
+/** Prepares a loaned connection the way a query does (schema switch and init strings)
+ *  for provider calls made without a query, like @ref toConnectionSub::exportCsv.
+ */
+class toQuerySession : public toQueryAbstr
+{
+public:
+    toQuerySession(toConnectionSubLoan &conn, QString const& sql)
+        : toQueryAbstr(conn, sql, toQueryParams())
+    {
+        init();
+    }
+
+protected:
+    void init() override
+    {
+        initSession();
+    }
+};
+
 class toQuery : public toQueryAbstr
 {
 public:
@@ -210,5 +252,47 @@ private:
     void *operator new[](size_t);
 };
 
+/** Query used to load data. The statement is prepared once by calling @ref init and then
+ *  executed for batches of parameter rows (see @ref queryImpl::executeBatch).
+ *  Unlike @ref toQuery it can be created on heap, and it can be used from a background thread.
+ */
+class toQueryBatch : public toQueryAbstr
+{
+public:
+    toQueryBatch(toConnectionSubLoan &conn, QString const& sql)
+        : toQueryAbstr(conn, sql, toQueryParams())
+        , m_CollectErrors(false)
+    {
+    }
+
+    /** Execute all the rows and collect errors of the failing ones instead of stopping on the first one */
+    void setCollectErrors(bool collect)
+    {
+        m_CollectErrors = collect;
+    }
+
+    /** Row errors of the last call of @ref execute, see @ref setCollectErrors */
+    QList<queryImpl::BatchError> errors(void) const
+    {
+        return m_Query ? m_Query->batchErrors() : QList<queryImpl::BatchError>();
+    }
+
+    /** Execute the statement once for each row of @p rows.
+     * @return Number of leading rows executed successfully, see @ref queryImpl::executeBatch
+     */
+    int execute(QList<toQueryParams> const& rows, QString &error);
+
+    /** Number of rows affected by the last call of @ref execute */
+    unsigned long affectedRows(void) const
+    {
+        return m_rowsProcessed;
+    }
+
+    void init() override;
+
+private:
+    bool m_CollectErrors;
+};
+
 #endif
 
@@ -67,6 +67,8 @@ class TORA_EXPORT queryImpl : public QObject
         queryImpl(toQueryAbstr *query)
             : QObject()
             , Parent(query)
+            , BatchAffected(0)
+            , CollectErrors(false)
         { }
         /** Destroy query implementation.
          */
@@ -103,7 +105,48 @@ class TORA_EXPORT queryImpl : public QObject
          * thread than is executing the query.
          */
         virtual void cancel(void) = 0;
+
+        /** Execute the query once for every row of parameters (array DML).
+         * The default implementation sets the parameters and calls @ref execute for each
+         * row. Providers able to send a whole batch in a single round trip override it.
+         * @param rows Bind values, one list of parameters per execution.
+         * @param error Set to the error message of the failing row (if any).
+         * @return Number of leading rows executed successfully. When lower than rows.size()
+         *         the row at this index failed and the rows following it were not executed.
+         *         When errors are collected (see @ref setCollectErrors) all rows are executed,
+         *         failing rows are listed by @ref batchErrors and rows.size() is returned.
+         */
+        virtual int executeBatch(QList<toQueryParams> const& rows, QString &error);
+
+        /** Get the number of rows affected by the last call of @ref executeBatch.
+         */
+        unsigned long batchAffected(void) const
+        {
+            return BatchAffected;
+        }
+
+        /** Error of one row of a batch */
+        struct BatchError
+        {
+            int Row;  // index into rows passed to executeBatch
+            QString Message;
+        };
+
+        /** Continue past failing rows in @ref executeBatch and collect their errors (OCI_BATCH_ERRORS on Oracle) */
+        void setCollectErrors(bool collect)
+        {
+            CollectErrors = collect;
+        }
+
+        /** Row errors of the last call of @ref executeBatch, see @ref setCollectErrors */
+        QList<BatchError> const& batchErrors(void) const
+        {
+            return BatchErrors;
+        }
     private:
         toQueryAbstr *Parent;
     protected:
+        unsigned long BatchAffected;
+        bool CollectErrors;
+        QList<BatchError> BatchErrors;
 };
@@ -306,6 +306,13 @@ namespace Utils
     */
     bool toWriteFile(const QString &filename, const QByteArray &data);
 
+    /** Write raw bytes to filename. Unlike toWriteFile neither codec
+    * nor line end conversion is applied (used for binary exports).
+    * @param filename Filename to write file to.
+    * @param data Data to write to file.
+    */
+    bool toWriteFileB(const QString &filename, const QByteArray &data);
+
     /** Write file to filename, encoded according to current locale settings.
     * @param filename Filename to write file to.
     * @param data Data to write to file.
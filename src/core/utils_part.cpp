@@ -321,6 +321,34 @@ namespace Utils
         return true;
     }
 
+    bool toWriteFileB(const QString &filename, const QByteArray &data)
+    {
+        QString expanded = toExpandFile(filename);
+        QFile file(expanded);
+        if (!file.open(QIODevice::WriteOnly))
+        {
+            TOMessageBox::warning(
+                toQMainWindow(),
+                QT_TRANSLATE_NOOP("toWriteFile", "File error"),
+                QT_TRANSLATE_NOOP(
+                    "toWriteFile",
+                    QString("Couldn't open %1 for writing").arg(filename).toLatin1().constData()));
+            return false;
+        }
+        file.write(data);
+
+        if (file.error() != QFile::NoError)
+        {
+            TOMessageBox::warning(
+                toQMainWindow(),
+                QT_TRANSLATE_NOOP("toWriteFile", "File error"),
+                QT_TRANSLATE_NOOP("toWriteFile", "Couldn't write data to file"));
+            return false;
+        }
+        toStatusMessage(QT_TRANSLATE_NOOP("toWriteFile", "File saved successfully"), false, false);
+        return true;
+    }
+
     void toStatusMessage(const QString &str, bool save, bool log)
     {
         // If there is no main widget yet (e.g. style init error)
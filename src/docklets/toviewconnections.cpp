@@ -100,57 +100,27 @@ void toViewConnections::handleActivated(const QModelIndex &index)
     QModelIndex baseIndex = toNewConnection::proxyModel()->index(index.row(), 0);
     int ind = toNewConnection::proxyModel()->data(baseIndex, Qt::DisplayRole).toInt();
     toConnectionOptions opt = toNewConnection::connectionModel()->availableConnection(ind);
-
-    QString database = opt.database;
-    QString host     = opt.host;
-    QString provider = opt.provider;
-
-    if (opt.port)
-        host += ":" + QString::number(opt.port);
-
-    if (provider == ORACLE_INSTANTCLIENT)
-    {
-        // create the rest of the connect string. this will work
-        // without an ORACLE_HOME.
-
-        database = "//" + host + "/" + database;
-        host = "";
-    }
-
-    if (opt.provider.startsWith("Oracle"))
-        provider = "Oracle";
+    toConnectionOptions c = toConnectionModel::connectOptions(opt);
 
     // checks for existing connection
-    QList<toConnection*> const& connections = toConnectionRegistrySing::Instance().connections();
-    foreach(toConnection * conn, connections)
+    if (toNewConnection::connectionModel()->openConnection(opt))
     {
-        try
-        {
-            if (conn->user() == opt.username &&
-                    conn->provider() == provider &&
-                    conn->host() == host &&
-                    conn->database() == database &&
-                    (opt.schema.isEmpty() || (conn->defaultSchema() == opt.schema)))
-            {
-                toGlobalEventSingle::Instance().createDefaultTool();
-                emit activated();
-                return;
-            }
-        }
-        catch (...) {}
+        toGlobalEventSingle::Instance().createDefaultTool();
+        emit activated();
+        return;
     }
 
     try
     {
         toConnection *retCon = new toConnection(
-            provider,
-            opt.username,
-            opt.password,
-            host,
-            database,
-            opt.schema,
-            opt.color,
-            opt.options);
+            c.provider,
+            c.username,
+            c.password,
+            c.host,
+            c.database,
+            c.schema,
+            c.color,
+            c.options);
 
         if (retCon)
             toGlobalEventSingle::Instance().addConnection(retCon, true);
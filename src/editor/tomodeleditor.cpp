@@ -79,8 +79,19 @@ void toModelEditor::saveFile()
                                   .arg(fn).toLatin1().constData())); // TODO test this in MSVC
             return;
         }
-        offset = 0;
+        Stream.reset(new toLobStream(data.value<toQValue::complexType*>()));
         bool retval = Utils::toWriteLargeFile(file, *this, /*progressbar*/false, /*parent*/this);
+        if (Stream->failed())
+        {
+            // Do not leave a truncated copy of the LOB behind
+            file.remove();
+            TOMessageBox::warning(
+                toMainWindow::lookup(),
+                QT_TRANSLATE_NOOP("toWriteFile", "File error"),
+                Stream->errorString());
+            retval = false;
+        }
+        Stream.reset();
         if (retval)
             toGlobalEventSingle::Instance().addRecentFile(fn);
     }
@@ -92,18 +103,10 @@ void toModelEditor::saveFile()
 
 QByteArray toModelEditor::nextData() const
 {
-    QVariant const &data = Model->data(Current, Qt::UserRole);
-    if (data.type() == QVariant::UserType)
-    {
-        toQValue::complexType *i = data.value<toQValue::complexType*>();
-        QByteArray a = i->read(offset);
-        offset += a.size();
-        return a;
-    }
+    if (Stream)
+        return Stream->read(0x40000);
     else
-    {
         return QByteArray();
-    }
 }
 
 toModelEditor::toModelEditor(QWidget *parent,
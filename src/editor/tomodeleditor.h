@@ -38,11 +38,13 @@
 #include "editor/tomarkededitor.h"
 #include "editor/tohighlightededitor.h"
 #include "core/utils.h"
+#include "core/tolobstream.h"
 
 #include <QDialog>
 #include <QLabel>
 #include <QToolBar>
 #include <QtCore/QModelIndex>
+#include <QtCore/QScopedPointer>
 
 class QCheckBox;
 class QToolBar;
@@ -147,7 +149,8 @@ class toModelEditor : public QDialog
         QModelIndex         Current;
         QAbstractItemModel *Model;
 
-        mutable unsigned offset;
+        // LOB being saved into a file, see nextData
+        QScopedPointer<toLobStream> Stream;
 };
 
 #endif
@@ -0,0 +1,292 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "main/toconnectionrestore.h"
+#include "main/tonewconnection.h"
+#include "core/toconnection.h"
+#include "core/toconnectionmodel.h"
+#include "core/tocache.h"
+#include "core/toconfiguration.h"
+#include "core/toglobalconfiguration.h"
+#include "core/tologger.h"
+#include "core/utils.h"
+
+#include <QtCore/QSettings>
+#include <QtCore/QThreadPool>
+#include <QtCore/QRunnable>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QSet>
+#include <QApplication>
+
+// connections opened at once, they mostly wait for the network
+#define MAX_THREADS 16
+// how long quitting waits for the connections being opened (ms)
+#define STOP_WAIT 3000
+
+/* Shared by toConnectionRestore and its workers, which can outlive it */
+struct toConnectionRestoreState
+{
+    QMutex Lock;
+    bool Stopped;
+    // opened connections posted to slotOpened and not received yet, closed if it never comes
+    QSet<QObject*> Posted;
+
+    toConnectionRestoreState()
+        : Stopped(false)
+    {}
+};
+
+/* Opens one connection in a pool thread and passes it to toConnectionRestore::slotOpened.
+ * Once stopped it touches nothing but the shared state: the application may be gone already,
+ * with QApplication and the singletons used by ~toConnection.
+ */
+class toConnectionRestoreWorker : public QRunnable
+{
+    public:
+        toConnectionRestoreWorker(toConnectionRestore *restore,
+                                  QSharedPointer<toConnectionRestoreState> const& state,
+                                  int index,
+                                  toConnectionOptions const& opts)
+            : Restore(restore)
+            , State(state)
+            , Index(index)
+            , Options(opts)
+        {}
+
+        void run() override
+        {
+            toConnection *conn = NULL;
+            QString error;
+            try
+            {
+                conn = new toConnection(Options);
+            }
+            catch (const QString &str)
+            {
+                error = str;
+            }
+            catch (...)
+            {
+                // translated by slotOpened
+            }
+
+            QMutexLocker lock(&State->Lock);
+            if (State->Stopped)
+            {
+                // TOra is closing, the connection is leaked rather than closed
+                return;
+            }
+            if (conn)
+            {
+                // there is no event loop in this thread, hand the connection (and its cache) to the main thread
+                conn->moveToThread(qApp->thread());
+                conn->getCache().moveToThread(qApp->thread());
+                State->Posted.insert(conn);
+            }
+            QMetaObject::invokeMethod(Restore, "slotOpened", Qt::QueuedConnection,
+                                      Q_ARG(int, Index),
+                                      Q_ARG(QObject*, conn),
+                                      Q_ARG(QString, error));
+        }
+    private:
+        toConnectionRestore *Restore;
+        QSharedPointer<toConnectionRestoreState> State;
+        int Index;
+        toConnectionOptions Options;
+};
+
+toConnectionRestore::toConnectionRestore(QObject *parent)
+    : QObject(parent)
+    , Pool(new QThreadPool())
+    , State(new toConnectionRestoreState())
+    , Running(0)
+    , Opened(0)
+{
+    // the main window is not deleted before QApplication, stop while it is still there
+    connect(qApp, SIGNAL(aboutToQuit()), this, SLOT(stop()));
+}
+
+toConnectionRestore::~toConnectionRestore()
+{
+    stop();
+    // deleting the pool waits for its threads, leave it to them when some are still connecting
+    if (Pool->activeThreadCount() == 0)
+        delete Pool;
+}
+
+void toConnectionRestore::stop()
+{
+    // connections not started yet are not opened at all
+    Pool->clear();
+    {
+        // posted ones would never be received
+        QMutexLocker lock(&State->Lock);
+        if (State->Stopped)
+            return;
+        State->Stopped = true;
+        qDeleteAll(State->Posted);
+        State->Posted.clear();
+    }
+    if (!Pool->waitForDone(STOP_WAIT))
+        TLOG(1, toDecorator, __HERE__) << "toConnectionRestore: connections still being opened are abandoned" << std::endl;
+}
+
+void toConnectionRestore::saveConnections(QList<toConnection*> const& connections)
+{
+    QSettings Settings;
+    Settings.beginGroup("connections");
+    Settings.remove("restore");
+    if (!toConfigurationNewSingle::Instance().option(ToConfiguration::Global::RestoreSessionBool).toBool())
+        return;
+
+    Settings.beginGroup("restore");
+    int pos = 0;
+    Q_FOREACH(toConnection *conn, connections)
+    {
+        toConnectionOptions const& opt = conn->connectionOptions();
+        Settings.beginGroup(QString::number(pos++));
+
+        Settings.setValue("provider", opt.provider);
+        Settings.setValue("username", opt.username);
+        if (toConfigurationNewSingle::Instance().option(ToConfiguration::Global::SavePasswordBool).toBool())
+        {
+            Settings.setValue("password", Utils::toObfuscate(conn->password()));
+        }
+        Settings.setValue("host",     opt.host);
+        Settings.setValue("port",     opt.port);
+        Settings.setValue("database", opt.database);
+        Settings.setValue("schema",   conn->defaultSchema());
+        Settings.setValue("color",    conn->color());
+
+        Settings.beginGroup("options");
+        Q_FOREACH(QString s, opt.options)
+        {
+            Settings.setValue(s, true);
+        }
+        Settings.endGroup(); // options
+
+        Settings.endGroup(); // restore/##pos
+    }
+    Settings.endGroup(); // restore
+    Settings.endGroup(); // connections section
+}
+
+int toConnectionRestore::start()
+{
+    if (!toConfigurationNewSingle::Instance().option(ToConfiguration::Global::RestoreSessionBool).toBool())
+        return 0;
+
+    QSettings Settings;
+    Settings.beginGroup("connections");
+    Settings.beginGroup("restore");
+    for (int pos = 0; pos < Settings.childGroups().count(); ++pos)
+    {
+        Settings.beginGroup(QString::number(pos)); // restore\## entry in TOra.conf
+        if (!Settings.contains("provider"))
+        {
+            Settings.endGroup();
+            break;
+        }
+
+        Settings.beginGroup("options");
+        QSet<QString> options;
+        Q_FOREACH(QString const & s, Settings.allKeys())
+        {
+            if (Settings.value(s, false).toBool())
+                options.insert(s);
+        }
+        Settings.endGroup();
+
+        Pending << toConnectionOptions(
+                    Settings.value("provider", "").toString(),
+                    Settings.value("host", "").toString(),
+                    Settings.value("database", "").toString(),
+                    Settings.value("username", "").toString(),
+                    Utils::toUnobfuscate(Settings.value("password", "").toString()),
+                    Settings.value("schema", "").toString(),
+                    Settings.value("color", "").toString(),
+                    Settings.value("port", 0).toInt(),
+                    options);
+        Settings.endGroup();
+    }
+    Settings.endGroup(); // restore section
+    Settings.endGroup(); // connections section
+
+    if (Pending.isEmpty())
+        return 0;
+
+    Pool->setMaxThreadCount(qMin(Pending.size(), MAX_THREADS));
+    for (int i = 0; i < Pending.size(); i++)
+    {
+        toNewConnection::connectionModel()->setStatus(Pending.at(i), tr("Connecting..."));
+        Pool->start(new toConnectionRestoreWorker(this, State, i, Pending.at(i)));
+    }
+    Running = Pending.size();
+    return Running;
+}
+
+void toConnectionRestore::slotOpened(int index, QObject *conn, QString const& error)
+{
+    toConnectionOptions const& opt = Pending.at(index);
+    {
+        QMutexLocker lock(&State->Lock);
+        // posted before stop, the connection is closed already
+        if (State->Stopped)
+            return;
+        if (conn)
+            State->Posted.remove(conn);
+    }
+    Running--;
+
+    if (conn)
+    {
+        Opened++;
+        toNewConnection::connectionModel()->setStatus(opt, QString());
+        try
+        {
+            emit connectionOpened(static_cast<toConnection*>(conn));
+        }
+        TOCATCH
+    }
+    else
+    {
+        QString message = error.isEmpty() ? tr("Unknown error") : error;
+        toNewConnection::connectionModel()->setStatus(opt, tr("Failed: %1").arg(message));
+        Utils::toStatusMessage(tr("Could not restore connection %1@%2\n%3").arg(opt.username).arg(opt.database).arg(message));
+    }
+
+    if (Running == 0)
+        emit finished(Opened);
+}
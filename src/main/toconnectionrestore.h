@@ -0,0 +1,99 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#ifndef TOCONNECTIONRESTORE_H
+#define TOCONNECTIONRESTORE_H
+
+#include "core/toconnectionoptions.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QList>
+#include <QtCore/QSharedPointer>
+
+class QThreadPool;
+class toConnection;
+struct toConnectionRestoreState;
+
+/** Reopens the connections which were open when TOra was closed (see Global::RestoreSessionBool).
+ *
+ * The connections are opened concurrently in background threads, the main window does not
+ * wait for them. Progress is shown in the status column of the connections docklet and each
+ * connection is passed on by @ref connectionOpened as soon as it is ready.
+ */
+class toConnectionRestore : public QObject
+{
+        Q_OBJECT;
+
+    public:
+        toConnectionRestore(QObject *parent);
+
+        /** Stops opening connections, see @ref stop. */
+        ~toConnectionRestore();
+
+        /** Remember open connections for the next start, forgets them when the option is off. */
+        static void saveConnections(QList<toConnection*> const& connections);
+
+        /** Start opening the remembered connections.
+         * @return number of connections being opened
+         */
+        int start(void);
+
+    public slots:
+        /** Stop opening connections, called when the application is about to quit.
+         *  Waits a while for the connections being opened, the ones still not ready then
+         *  are left to their threads (see toConnectionRestoreWorker).
+         */
+        void stop(void);
+
+    signals:
+        /** Emitted in the main thread for each connection opened. */
+        void connectionOpened(toConnection *conn);
+
+        /** Emitted when all the connections were tried.
+         * @param opened number of connections opened successfully
+         */
+        void finished(int opened);
+
+    private slots:
+        /** Called by the worker when it is done, @p conn is NULL when it failed with @p error (empty when unknown) */
+        void slotOpened(int index, QObject *conn, QString const& error);
+
+    private:
+        QThreadPool *Pool;
+        QSharedPointer<toConnectionRestoreState> State;
+        QList<toConnectionOptions> Pending;
+        int Running, Opened;
+};
+
+#endif
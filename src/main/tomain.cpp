@@ -74,6 +74,7 @@
 #include "widgets/tohelp.h"
 #include "tomessage.h"
 #include "tonewconnection.h"
+#include "toconnectionrestore.h"
 #include "topreferences.h"
 
 
@@ -185,7 +186,12 @@ toMain::toMain()
     toProvidersList &allProviders = toProvidersListSing::Instance(); // already populated in main.cpp see splash
     Q_UNUSED(allProviders);
 
-    if (Connections.isEmpty())
+    // connections of the last run are opened in background, ask for a new one only when there are none
+    toConnectionRestore *restore = new toConnectionRestore(this);
+    connect(restore, SIGNAL(connectionOpened(toConnection*)), this, SLOT(addConnection(toConnection*)));
+    connect(restore, SIGNAL(finished(int)), this, SLOT(restoreFinished(int)));
+
+    if (Connections.isEmpty() && restore->start() == 0)
     {
         try
         {
@@ -951,6 +957,13 @@ void toMain::addConnection(toConnection *newconn)
     createDefault();
 }
 
+void toMain::restoreFinished(int opened)
+{
+    sender()->deleteLater();
+    if (opened == 0 && Connections.isEmpty())
+        addConnection();
+}
+
 void toMain::setNeedCommit(toToolWidget *tool, bool needCommit)
 {
     if (tool == NULL)
@@ -995,6 +1008,8 @@ void toMain::closeEvent(QCloseEvent *event)
         return;
     }
 
+    toConnectionRestore::saveConnections(Connections.connections());
+
     while (!Connections.isEmpty())
     {
         if (!delCurrentConnection())
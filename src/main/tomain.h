@@ -238,6 +238,9 @@ class toMain : public toMainWindow
         /** Add a connection */
         void addConnection(void);
 
+        /** Connections of the last run were tried, asks for a new one when none of them could be opened */
+        void restoreFinished(int opened);
+
         /** Remove a connection */
         bool delCurrentConnection(void);
 
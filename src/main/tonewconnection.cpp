@@ -201,6 +201,7 @@ void toNewConnection::readSettings()
     checkBoxRememberPasswords->setChecked(toConfigurationNewSingle::Instance().option(ToConfiguration::Global::SavePasswordBool).toBool());
 
     Previous->hideColumn(0);
+    Previous->hideColumn(6);
 }
 
 
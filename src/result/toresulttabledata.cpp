@@ -38,6 +38,7 @@
 #include "core/toconnectionsub.h"
 #include "widgets/toresultmodeledit.h"
 #include "core/toconnectiontraits.h"
+#include "core/toquery.h"
 #include "editor/toscintilla.h"
 #include "ui_toresultcontentfilterui.h"
 
@@ -412,28 +413,65 @@ bool toResultTableData::commitChanges()
 
 
     toConnectionSubLoan conn(connection());
-    // No primary keys
+
+    // Build bind variable statements first, values are bound separately
+    QStringList statements;
+    QList<toQueryParams> values;
     for (int changeIndex = 0; changeIndex < Changes.size(); changeIndex++)
+    {
+        struct toResultModelEdit::ChangeSet const& change = Changes[changeIndex];
+        toQueryParams params;
+        QString sql;
+
+        switch (change.kind)
+        {
+            case toResultModelEdit::Delete:
+                sql = deleteStatement(conn, change, params);
+                break;
+            case toResultModelEdit::Add:
+                sql = addStatement(conn, change, params);
+                break;
+            case toResultModelEdit::Update:
+                sql = updateStatement(conn, change, params);
+                break;
+            default:
+                Utils::toStatusMessage(tr("Internal error."));
+                break;
+        }
+        statements << sql;
+        values << params;
+    }
+
+    // Consecutive changes sharing the same statement are executed as one batch (array DML where supported).
+    // Only neighbours are grouped so that the changes are still applied in the order they were made.
+    for (int changeIndex = 0; changeIndex < Changes.size();)
     {
         ProgressBar->setValue(changeIndex);
 
+        int first = changeIndex++;
+        if (statements[first].isEmpty())
+            continue;
+
+        QList<toQueryParams> rows;
+        rows << values[first];
+        while (changeIndex < Changes.size()
+                && rows.size() < SaveBatch
+                && statements[changeIndex] == statements[first])
+            rows << values[changeIndex++];
+
         try
         {
-            struct toResultModelEdit::ChangeSet &change = Changes[changeIndex];
-
-            switch (change.kind)
+            unsigned processed = commitBatch(conn, Changes[first].kind, statements[first], rows);
+            switch (Changes[first].kind)
             {
                 case toResultModelEdit::Delete:
-                    deleted += commitDelete(conn, change);
+                    deleted += processed;
                     break;
                 case toResultModelEdit::Add:
-                    added += commitAdd(conn, change);
+                    added += processed;
                     break;
                 case toResultModelEdit::Update:
-                    updated += commitUpdate(conn, change);
-                    break;
-                default:
-                    Utils::toStatusMessage(tr("Internal error."));
+                    updated += processed;
                     break;
             }
         }
@@ -450,7 +488,7 @@ bool toResultTableData::commitChanges()
     {
         conn->commit();
         ProgressBar->setValue(Changes.size());
-        Changes.clear();
+        Model->clearChanges();
     }
 
     Utils::toStatusMessage(tr("Saved %1 changes(updated %2, added %3, deleted %4)")
@@ -534,7 +572,15 @@ void toResultTableData::refreshWarn()
     refresh();
 }
 
-unsigned toResultTableData::commitUpdate(toConnectionSubLoan &conn, toResultModelEdit::ChangeSet &change)
+QString toResultTableData::bindName(toConnectionSubLoan &conn, int pos) const
+{
+    // Oracle binds need type and array size declared, see trotl bind syntax
+    if (conn.ParentConnection.providerIs("Oracle"))
+        return QString::fromLatin1(":f%1<char[4000],in[%2]>").arg(pos).arg(SaveBatch);
+    return QString::fromLatin1(":f%1").arg(pos);
+}
+
+QString toResultTableData::updateStatement(toConnectionSubLoan &conn, toResultModelEdit::ChangeSet const& change, toQueryParams &params)
 {
     static const QString UPDATE = QString("UPDATE %1.%2 SET %3 WHERE 1=1 %4");
     static const QString CONJUNCTION = QString(" AND %1 = %2");
@@ -543,17 +589,16 @@ unsigned toResultTableData::commitUpdate(toConnectionSubLoan &conn, toResultMode
     if (Model->getPriKeys().empty())
     {
         Utils::toStatusMessage(tr("This table has no known primary keys"));
-        return 0;
+        return QString();
     }
 
     toConnectionTraits const& connTraits = conn.ParentConnection.getTraits();
     QString sqlValuePlaceHolders, sqlCondPlaceHolders;
 
     // set new value in update statement
-    if (change.newValue.isNull())
-        sqlValuePlaceHolders = ASSIGNMENT.arg(change.columnName).arg("NULL");
-    else
-        sqlValuePlaceHolders = ASSIGNMENT.arg(change.columnName).arg((QString)change.newValue);
+    QString columnName = Model->headerData(change.column, Qt::Horizontal, Qt::DisplayRole).toString();
+    sqlValuePlaceHolders = ASSIGNMENT.arg(connTraits.quote(columnName)).arg(bindName(conn, 1));
+    params << (change.newValue.isNull() ? toQValue() : toQValue(change.newValue.editData()));
 
     for (int i = 1; i < Model->getPriKeys().size() + 1; i++)
     {
@@ -562,25 +607,14 @@ unsigned toResultTableData::commitUpdate(toConnectionSubLoan &conn, toResultMode
                                            i,
                                            Qt::Horizontal,
                                            Qt::DisplayRole).toString()))
-                               .arg(connTraits.quoteVarchar(change.row[i].editData()));
+                               .arg(bindName(conn, i + 1));
+        params << toQValue(change.row[i].editData());
     }
 
-    QString sql = UPDATE.arg(connTraits.quote(Owner)).arg(connTraits.quote(Table)).arg(sqlValuePlaceHolders).arg(sqlCondPlaceHolders);
-    Logging->appendPlainText(sql);
-    {
-        toQuery q(conn, sql, toQueryParams());
-        q.eof();
-        if (q.rowsProcessed() > 1)
-        {
-            Logging->appendPlainText("Rollback;");
-            conn->rollback();
-            return 0;
-        }
-        return q.rowsProcessed();
-    }
+    return UPDATE.arg(connTraits.quote(Owner)).arg(connTraits.quote(Table)).arg(sqlValuePlaceHolders).arg(sqlCondPlaceHolders);
 }
 
-unsigned toResultTableData::commitAdd(toConnectionSubLoan &conn, toResultModelEdit::ChangeSet &change)
+QString toResultTableData::addStatement(toConnectionSubLoan &conn, toResultModelEdit::ChangeSet const& change, toQueryParams &params)
 {
     static const QString INSERT = QString("INSERT INTO %1.%2 ( %3 ) VALUES( %4 ) ");
 
@@ -598,12 +632,12 @@ unsigned toResultTableData::commitAdd(toConnectionSubLoan &conn, toResultModelEd
                                            Qt::Horizontal,
                                            Qt::DisplayRole).toString());
 
-        toQValue const &val = change.row[i].editData();
+        toQValue const &val = change.row[i];
         if (val.isComplexType()) // If it's a complex type then it's not NULL
         {
             Utils::toStatusMessage(tr("This table contains complex/user defined columns "
                                       "and can not be edited"));
-            return 0;
+            return QString();
         }
 
         if (col > 0)
@@ -618,40 +652,33 @@ unsigned toResultTableData::commitAdd(toConnectionSubLoan &conn, toResultModelEd
             }
 
             Utils::toStatusMessage(QString("Unsupported datatype(%1)").arg(Headers[i].datatype));
-            return 0;
+            return QString();
         }
 
         // Everything else --> varchar
         {
-            if (Headers[col].datatype.toUpper().contains("LOB"))
+            if (Headers[i].datatype.toUpper().contains("LOB"))
             {
                 sqlValuePlaceHolders += ("empty_clob()");
                 continue;
             }
-            sqlValuePlaceHolders += connTraits.quoteVarchar(val.editData());
+            sqlValuePlaceHolders += bindName(conn, params.size() + 1);
+            params << (val.isNull() ? toQValue() : toQValue(val.editData()));
             continue;
         }
     }
 
-    QString sql = INSERT.arg(connTraits.quote(Owner)).arg(connTraits.quote(Table)).arg(sqlColumns).arg(sqlValuePlaceHolders);
-    Logging->appendPlainText(sql);
-
-    {
-        // TODO use event query
-        toQuery q(conn, sql, toQueryParams());
-        q.eof();
-        return q.rowsProcessed();
-    }
+    return INSERT.arg(connTraits.quote(Owner)).arg(connTraits.quote(Table)).arg(sqlColumns).arg(sqlValuePlaceHolders);
 }
 
-unsigned toResultTableData::commitDelete(toConnectionSubLoan &conn, toResultModelEdit::ChangeSet &change)
+QString toResultTableData::deleteStatement(toConnectionSubLoan &conn, toResultModelEdit::ChangeSet const& change, toQueryParams &params)
 {
     static const QString DELETESTAT = QString::fromLatin1("DELETE FROM %1.%2 WHERE 1=1 %3");
     static const QString CONJUNCTION = QString::fromLatin1(" AND %1 = %2");
     if (Model->getPriKeys().empty())
     {
         Utils::toStatusMessage(tr("This table has no known primary keys"));
-        return 0;
+        return QString();
     }
 
     toConnectionTraits const& connTraits = conn.ParentConnection.getTraits();
@@ -663,21 +690,55 @@ unsigned toResultTableData::commitDelete(toConnectionSubLoan &conn, toResultMode
                                             i,
                                             Qt::Horizontal,
                                             Qt::DisplayRole).toString()))
-                                .arg(connTraits.quoteVarchar(change.row[i].editData()));
+                                .arg(bindName(conn, i));
+        params << toQValue(change.row[i].editData());
     }
 
-    QString sql = DELETESTAT.arg(connTraits.quote(Owner)).arg(connTraits.quote(Table)).arg(sqlValuePlaceHolders);
+    return DELETESTAT.arg(connTraits.quote(Owner)).arg(connTraits.quote(Table)).arg(sqlValuePlaceHolders);
+}
+
+unsigned toResultTableData::commitBatch(toConnectionSubLoan &conn,
+                                        toResultModelEdit::ChangeKind kind,
+                                        QString const& sql,
+                                        QList<toQueryParams> const& rows)
+{
     Logging->appendPlainText(sql);
+    if (rows.size() > 1)
+        Logging->appendPlainText(QString::fromLatin1("-- %1 rows").arg(rows.size()));
 
+    toQueryBatch q(conn, sql);
+    QString error;
+    if (kind == toResultModelEdit::Add)
     {
-        toQuery q(conn, sql, toQueryParams());
-        q.eof();
-        if (q.rowsProcessed() > 1)
+        int done = q.execute(rows, error);
+        if (done < rows.size())
         {
+            Logging->appendPlainText(error);
             Logging->appendPlainText("Rollback;");
-            conn->rollback();
-            return 0;
+            throw error;
+        }
+        return q.affectedRows();
+    }
+
+    // Updated and deleted rows are identified by primary key, each change must affect one row at most.
+    // Only the total row count of a batch is known, so these are executed one row at a time
+    // (the statement is still prepared once).
+    unsigned long affected = 0;
+    for (int i = 0; i < rows.size(); i++)
+    {
+        if (q.execute(QList<toQueryParams>() << rows.at(i), error) < 1)
+        {
+            Logging->appendPlainText(error);
+            Logging->appendPlainText("Rollback;");
+            throw error;
+        }
+        if (q.affectedRows() > 1)
+        {
+            Logging->appendPlainText("Rollback;");
+            throw tr("Primary key does not identify a single row, %1 rows affected by one change")
+            .arg(q.affectedRows());
         }
-        return q.rowsProcessed();
+        affected += q.affectedRows();
     }
+    return affected;
 }
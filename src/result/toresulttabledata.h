@@ -109,9 +109,27 @@ class toResultTableData
 
         void commitUpdate(toConnectionSubLoan &conn, const toQueryAbstr::Row &row, unsigned int &updated);
 
-        unsigned commitUpdate(toConnectionSubLoan &conn, toResultModelEdit::ChangeSet &change);
-        unsigned commitAdd(toConnectionSubLoan &conn, toResultModelEdit::ChangeSet &change);
-        unsigned commitDelete(toConnectionSubLoan &conn, toResultModelEdit::ChangeSet &change);
+        /** Build DML statement with bind variables for a change, the values to bind are appended to @p params.
+         *  @return Empty string if the change can not be saved
+         */
+        QString updateStatement(toConnectionSubLoan &conn, toResultModelEdit::ChangeSet const& change, toQueryParams &params);
+        QString addStatement(toConnectionSubLoan &conn, toResultModelEdit::ChangeSet const& change, toQueryParams &params);
+        QString deleteStatement(toConnectionSubLoan &conn, toResultModelEdit::ChangeSet const& change, toQueryParams &params);
+
+        /** Name of bind variable at position @p pos (starting from 1) */
+        QString bindName(toConnectionSubLoan &conn, int pos) const;
+
+        /** Execute statement once for each of @p rows, throws on error or when an update or delete
+         *  affects more than one row.
+         *  @return Number of rows affected
+         */
+        unsigned commitBatch(toConnectionSubLoan &conn,
+                             toResultModelEdit::ChangeKind kind,
+                             QString const& sql,
+                             QList<toQueryParams> const& rows);
+
+        // Maximum number of changes saved by single execution of a statement
+        static const int SaveBatch = 100;
 
         toResultModelEdit* Model;
 
@@ -0,0 +1,145 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+/* Decoding of Oracle character defines (connection/tooracledefine.h).
+ *
+ * The buffers below are written by hand in the layout trotl allocates for 3 row fetches of a
+ * CHAR(5 CHAR) and a VARCHAR2(3 CHAR) column with the AL32UTF8 character set (both describe
+ * a data size of 4 bytes per character): BindParChar uses value_sz = data size * 4,
+ * BindParVarchar (data size + 1) * 4, for UTF-16 defines too. The rest of each row is zero,
+ * as the define arena is cleared, unless stated otherwise.
+ */
+
+#include "connection/tooracledefine.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QString>
+
+#include <iostream>
+
+static int Failures = 0;
+
+static void check(QString const& got, QString const& expected, const char *what)
+{
+    if (got == expected)
+        return;
+    std::cerr << what << ": got '" << got.toUtf8().constData() << "' expected '" << expected.toUtf8().constData() << "'" << std::endl;
+    Failures++;
+}
+
+// CHAR(5 CHAR): data size 20
+#define CHAR_SZ (20 * 4)
+// VARCHAR2(3 CHAR): data size 12
+#define VARCHAR_SZ ((12 + 1) * 4)
+
+// SQLT_CHR, rlenp in bytes
+static const char CharValues[3][CHAR_SZ] =
+{
+    { 'X', ' ', ' ', ' ', ' ' },
+    { 'z', 'l', 'u', 't', ' ' },
+    { 'a', ' ', 'b', ' ', ' ' },
+};
+static const quint16 CharLengths[3] = { 5, 5, 5 };
+
+// the same, multibyte row: "žluť " is c5 be 6c 75 c5 a5 20 (7 bytes)
+static const char CharUtf8Values[1][CHAR_SZ] =
+{
+    { '\xc5', '\xbe', 'l', 'u', '\xc5', '\xa5', ' ' },
+};
+static const quint16 CharUtf8Lengths[1] = { 7 };
+
+// SQLT_STR, null terminated, NULL row left with stale bytes of an earlier fetch after the terminator
+static const char VarcharValues[3][VARCHAR_SZ] =
+{
+    { 'A', 'B', 'C' },
+    { 'k', '\xc5', '\xaf', '\xc5', '\x88' },
+    { 0, 'B', 'C' },
+};
+
+// UTF-16 defines (little endian, as the client delivers them on x86), same buffer sizes in bytes
+static const ushort Utf16CharValues[3][CHAR_SZ / 2] =
+{
+    { 'X', ' ', ' ', ' ', ' ' },
+    { 0x017e, 'l', 'u', 0x0165, ' ' },
+    { 'a', ' ', 'b', ' ', ' ' },
+};
+static const quint16 Utf16CharLengths[3] = { 10, 10, 10 };
+
+static const ushort Utf16VarcharValues[3][VARCHAR_SZ / 2] =
+{
+    { 'A', 'B', 'C' },
+    { 'k', 0x016f, 0x0148 },
+    { 0, 'x', 'x' },
+};
+
+// Not a trotl layout: a value filling its 8 byte buffer without a terminator,
+// the decoder must stop at the end of the buffer
+static const ushort Utf16FullValues[2 * 4] =
+{
+    'k', 0x016f, 0x0148, '!',
+    'x', 'x', 'x', 'x',
+};
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    const char *chars = (const char*)CharValues;
+    check(toOracleDefine::charValue(chars, CHAR_SZ, CharLengths, 0), "X    ", "char row 0");
+    check(toOracleDefine::charValue(chars, CHAR_SZ, CharLengths, 1), "zlut ", "char row 1");
+    check(toOracleDefine::charValue(chars, CHAR_SZ, CharLengths, 2), "a b  ", "char row 2");
+    check(toOracleDefine::charValue((const char*)CharUtf8Values, CHAR_SZ, CharUtf8Lengths, 0), QString::fromUtf8("\xc5\xbelu\xc5\xa5 "), "char utf-8");
+
+    const char *varchars = (const char*)VarcharValues;
+    check(toOracleDefine::varcharValue(varchars, VARCHAR_SZ, 0), "ABC", "varchar row 0");
+    check(toOracleDefine::varcharValue(varchars, VARCHAR_SZ, 1), QString::fromUtf8("k\xc5\xaf\xc5\x88"), "varchar row 1");
+    check(toOracleDefine::varcharValue(varchars, VARCHAR_SZ, 2), "", "varchar row 2");
+
+    const char *utf16Char = (const char*)Utf16CharValues;
+    check(toOracleDefine::utf16CharValue(utf16Char, CHAR_SZ, Utf16CharLengths, 0), "X    ", "utf-16 char row 0");
+    check(toOracleDefine::utf16CharValue(utf16Char, CHAR_SZ, Utf16CharLengths, 1), QString::fromUtf8("\xc5\xbelu\xc5\xa5 "), "utf-16 char row 1");
+    check(toOracleDefine::utf16CharValue(utf16Char, CHAR_SZ, Utf16CharLengths, 2), "a b  ", "utf-16 char row 2");
+
+    const char *utf16Varchar = (const char*)Utf16VarcharValues;
+    check(toOracleDefine::utf16VarcharValue(utf16Varchar, VARCHAR_SZ, 0), "ABC", "utf-16 varchar row 0");
+    check(toOracleDefine::utf16VarcharValue(utf16Varchar, VARCHAR_SZ, 1), QString::fromUtf8("k\xc5\xaf\xc5\x88"), "utf-16 varchar row 1");
+    check(toOracleDefine::utf16VarcharValue(utf16Varchar, VARCHAR_SZ, 2), "", "utf-16 varchar row 2");
+
+    const char *utf16Full = (const char*)Utf16FullValues;
+    check(toOracleDefine::utf16VarcharValue(utf16Full, 8, 0), QString::fromUtf8("k\xc5\xaf\xc5\x88!"), "utf-16 full buffer");
+
+    if (Failures)
+        std::cerr << Failures << " check(s) failed" << std::endl;
+    return Failures ? 1 : 0;
+}
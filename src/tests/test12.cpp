@@ -0,0 +1,156 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+/* Array DML through toQueryBatch (oracleQuery::executeBatch) with NULL values.
+ * Needs an Oracle database, the user must be able to create a table:
+ *
+ *   test12 user/password@database
+ */
+
+#include "core/toconfiguration.h"
+#include "core/toconnection.h"
+#include "core/toconnectionprovider.h"
+#include "core/toconnectionsubloan.h"
+#include "core/tologger.h"
+#include "core/toquery.h"
+#include "core/toqvalue.h"
+#include "core/tooracleconst.h"
+#include "tests/tocheck.h"
+
+#include <QApplication>
+#include <QtCore/QDir>
+#include <QtCore/QString>
+
+#include <memory>
+
+static void usage()
+{
+    printf("Usage:\n\n  test12 connectstring\n\n");
+    exit(2);
+}
+
+static void loadOracleProvider()
+{
+    std::vector<std::string> finders = ConnectionProviderFinderFactory::Instance().keys();
+    QList<toConnectionProviderFinder::ConnectionProvirerParams> allProviders;
+    for (std::vector<std::string>::const_iterator i = finders.begin(); i != finders.end(); ++i)
+    {
+        std::unique_ptr<toConnectionProviderFinder> finder = ConnectionProviderFinderFactory::Instance().create(*i, 0);
+        allProviders.append(finder->find());
+    }
+    foreach(toConnectionProviderFinder::ConnectionProvirerParams const& params, allProviders)
+    {
+        if (params.value("PROVIDER").toString() != ORACLE_PROVIDER)
+            continue;
+        toConnectionProviderRegistrySing::Instance().load(params);
+        return;
+    }
+    throw QString::fromLatin1("Oracle client not found");
+}
+
+int main(int argc, char **argv)
+{
+    toConfigurationNew::setQSettingsEnv();
+    QApplication app(argc, argv);
+
+    if (argc != 2)
+        usage();
+
+    try
+    {
+        qRegisterMetaType<toConnection::exception>("toConnection::exception");
+
+        QString connect = QString::fromLatin1(argv[1]);
+        QStringList atList = connect.split("@", QString::SkipEmptyParts);
+        if (atList.size() != 2 || !atList.at(0).contains("/"))
+            usage();
+        QString user = atList.at(0).section('/', 0, 0);
+        QString password = atList.at(0).section('/', 1);
+        QString database = atList.at(1);
+
+        loadOracleProvider();
+
+        QSet<QString> options;
+        toConnection oraCon(QString("Oracle"), user, password, "", database, "", "", options);
+        toConnectionSubLoan conn(oraCon);
+
+        toQuery create(conn, "CREATE TABLE TORA_TEST12 (ID NUMBER, AMOUNT NUMBER, NAME VARCHAR2(10))", toQueryParams());
+        try
+        {
+            QList<toQueryParams> rows;
+            rows << (toQueryParams() << toQValue(1) << toQValue(1.5) << toQValue(QString("one")));
+            rows << (toQueryParams() << toQValue(2) << toQValue() << toQValue(QString("two")));
+            rows << (toQueryParams() << toQValue(3) << toQValue(0.0) << toQValue());
+            rows << (toQueryParams() << toQValue() << toQValue(4.5) << toQValue(QString("four")));
+
+            {
+                toQueryBatch insert(conn, "INSERT INTO TORA_TEST12 (ID, AMOUNT, NAME) VALUES (:id<int>, :amount<double>, :name<char[11]>)");
+                QString error;
+                int done = insert.execute(rows, error);
+                check(done == rows.size(), "all rows inserted");
+                check(insert.affectedRows() == (unsigned long)rows.size(), "affected rows");
+                if (!error.isEmpty())
+                    printf("%s\n", qPrintable(error));
+            }
+
+            toQuery select(conn, "SELECT ID, AMOUNT, NAME FROM TORA_TEST12 ORDER BY NVL(ID, 4)", toQueryParams());
+            QList<toQValue> v;
+            while (!select.eof())
+                v << select.readValue();
+            check(v.size() == 12, "four rows read back");
+            if (v.size() == 12)
+            {
+                check(v[0].toInt() == 1 && v[1].toDouble() == 1.5 && (QString)v[2] == "one", "row 1 values");
+                check(!v[3].isNull() && v[4].isNull(), "NULL number stays NULL (not 0)");
+                check((QString)v[5] == "two", "value after NULL number");
+                check(!v[7].isNull() && v[7].toDouble() == 0.0, "zero is not NULL");
+                check(v[8].isNull(), "NULL string");
+                check(v[9].isNull() && v[10].toDouble() == 4.5, "NULL integer in the first bind");
+            }
+        }
+        catch (...)
+        {
+            toQuery drop(conn, "DROP TABLE TORA_TEST12", toQueryParams());
+            throw;
+        }
+        toQuery drop(conn, "DROP TABLE TORA_TEST12", toQueryParams());
+    }
+    catch (const QString &str)
+    {
+        printf("Unhandled exception: %s\n", qPrintable(str));
+        return 1;
+    }
+
+    return checkResult();
+}
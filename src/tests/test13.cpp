@@ -0,0 +1,249 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+/* toAQPoller driven by a fake toAQSource, no database needed.
+ *
+ * Checks sampling and browsing of the selected queue, listening on an empty queue,
+ * cancelling a pending listen (change of queue, refresh, stop), interval changes
+ * while the poller runs and reporting of source errors.
+ */
+
+#include "tools/toaqpoller.h"
+#include "tests/tocheck.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QAtomicInt>
+
+#include <functional>
+
+/** Wait (up to 5s) for @p cond to become true */
+static bool waitFor(std::function<bool()> cond)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!cond())
+    {
+        if (timer.elapsed() > 5000)
+            return false;
+        QThread::msleep(5);
+    }
+    return true;
+}
+
+/** Two queues, listen blocks until a message "arrives", it is cancelled or the wait expires */
+class toAQFakeSource : public toAQSource
+{
+    public:
+        toAQFakeSource()
+            : QueuesCalls(0)
+            , BrowseCalls(0)
+            , BrowseMax(0)
+            , ListenCalls(0)
+            , ListenWait(0)
+            , Listening(false)
+            , Arrived(false)
+            , Cancelled(false)
+            , Ready(0)
+        {}
+
+        QList<toAQQueueStat> queues(void) override
+        {
+            QMutexLocker lock(&Mutex);
+            QueuesCalls++;
+            if (!Error.isEmpty())
+                throw Error;
+            QList<toAQQueueStat> ret;
+            ret << stat("ORDERS", Ready) << stat("EVENTS", 3);
+            return ret;
+        }
+
+        QList<toAQMessage> browse(toAQQueueStat const& queue, int max) override
+        {
+            QMutexLocker lock(&Mutex);
+            BrowseCalls++;
+            BrowseMax = max;
+            BrowsedQueue = queue.Name;
+            QList<toAQMessage> ret;
+            for (int i = 0; i < qMin<qint64>(queue.Ready, max); i++)
+            {
+                toAQMessage msg;
+                msg.MsgId = QString::number(i);
+                msg.Priority = 1;
+                msg.Retries = 0;
+                ret << msg;
+            }
+            return ret;
+        }
+
+        bool listen(toAQQueueStat const&, int wait) override
+        {
+            QMutexLocker lock(&Mutex);
+            ListenCalls++;
+            ListenWait = wait;
+            Listening = true;
+            // a cancel or message that came just before the call counts too
+            QElapsedTimer timer;
+            timer.start();
+            while (!Arrived && !Cancelled && timer.elapsed() < wait * 1000)
+                Wake.wait(&Mutex, 10);
+            Listening = false;
+            bool arrived = Arrived, cancelled = Cancelled;
+            Arrived = Cancelled = false;
+            if (cancelled)
+                throw QString::fromLatin1("ORA-01013: user requested cancel of current operation");
+            return arrived;
+        }
+
+        void cancel(void) override
+        {
+            QMutexLocker lock(&Mutex);
+            Cancelled = true;
+            Wake.wakeAll();
+        }
+
+        /** A message was enqueued into ORDERS */
+        void arrive(void)
+        {
+            QMutexLocker lock(&Mutex);
+            Ready++;
+            Arrived = true;
+            Wake.wakeAll();
+        }
+
+        static toAQQueueStat stat(QString const& name, qint64 ready)
+        {
+            toAQQueueStat s;
+            s.Owner = QString::fromLatin1("SCOTT");
+            s.Name = name;
+            s.Table = name + QString::fromLatin1("_QT");
+            s.MultiConsumer = false;
+            s.Ready = ready;
+            s.Waiting = s.Expired = 0;
+            s.Enqueued = s.Dequeued = -1;
+            return s;
+        }
+
+        QMutex Mutex;
+        QWaitCondition Wake;
+        int QueuesCalls, BrowseCalls, BrowseMax, ListenCalls, ListenWait;
+        bool Listening, Arrived, Cancelled;
+        qint64 Ready;
+        QString BrowsedQueue, Error;
+};
+
+#define LOCKED(src, expr) [&]() { QMutexLocker l(&(src)->Mutex); return (expr); }
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    // sample, browse the selected queue, listen while it is empty
+    {
+        toAQFakeSource *src = new toAQFakeSource();
+        toAQPoller poller(src, 60, 5);
+        poller.setQueue(QString::fromLatin1("SCOTT.EVENTS"));
+        poller.start();
+
+        check(waitFor(LOCKED(src, src->BrowseCalls == 1)), "selected queue browsed");
+        check(waitFor([&]() { return poller.stats().size() == 2; }), "stats published");
+        check(poller.messages().size() == 3, "browsed messages published");
+        check(poller.sampled().isValid(), "sample time set");
+        {
+            QMutexLocker l(&src->Mutex);
+            check(src->BrowsedQueue == "EVENTS" && src->BrowseMax == 5, "browse arguments");
+            check(src->ListenCalls == 0, "no listen on a queue with ready messages");
+        }
+
+        // empty queue: the poller listens, the refresh interval is passed as the wait
+        poller.setQueue(QString::fromLatin1("SCOTT.ORDERS"));
+        check(waitFor(LOCKED(src, src->Listening)), "listen on an empty queue");
+        check(LOCKED(src, src->ListenWait == 60)(), "listen waits for the refresh interval");
+
+        // a message arrives, the next sample is taken right away
+        int sampled = LOCKED(src, src->QueuesCalls)();
+        src->arrive();
+        check(waitFor(LOCKED(src, src->QueuesCalls > sampled)), "resample after a message arrived");
+        check(waitFor([&]() { return poller.messages().size() == 1; }), "arrived message browsed");
+
+        poller.stop();
+        check(poller.wait(5000), "poller stopped");
+    }
+
+    // interval change while the poller runs, refresh cancels a pending listen
+    {
+        toAQFakeSource *src = new toAQFakeSource();
+        toAQPoller poller(src, 60, 5);
+        poller.setQueue(QString::fromLatin1("SCOTT.ORDERS"));
+        poller.start();
+        check(waitFor(LOCKED(src, src->Listening)), "listening");
+
+        poller.setInterval(7);
+        int listens = LOCKED(src, src->ListenCalls)();
+        poller.refresh();
+        check(waitFor(LOCKED(src, src->ListenCalls > listens && src->Listening)), "listen restarted after refresh");
+        check(LOCKED(src, src->ListenWait == 7)(), "new interval used by the next listen");
+
+        // stop interrupts the pending listen, the cancelled listen is not reported as an error
+        QAtomicInt failed(0);
+        QObject::connect(&poller, &toAQPoller::failed, &poller, [&](QString const&) { failed.storeRelease(1); }, Qt::DirectConnection);
+        QElapsedTimer timer;
+        timer.start();
+        poller.stop();
+        check(poller.wait(5000) && timer.elapsed() < 2000, "stop cancels the listen");
+        check(!failed.loadAcquire(), "cancelled listen is not an error");
+    }
+
+    // source errors end the poller with failed()
+    {
+        toAQFakeSource *src = new toAQFakeSource();
+        src->Error = QString::fromLatin1("ORA-00942: table or view does not exist");
+        toAQPoller poller(src, 60, 5);
+        QString error;
+        QMutex errorLock;
+        // the poller object lives in this thread which runs no event loop, so connect directly
+        QObject::connect(&poller, &toAQPoller::failed, &poller, [&](QString const& str)
+        {
+            QMutexLocker l(&errorLock);
+            error = str;
+        }, Qt::DirectConnection);
+        poller.start();
+        check(poller.wait(5000), "poller ends after an error");
+        QMutexLocker l(&errorLock);
+        check(error.startsWith("ORA-00942"), "error reported");
+    }
+
+    return checkResult();
+}
@@ -0,0 +1,310 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+/* Key partitioning and checkpoint/resume of the table copy tool, no database needed.
+ *
+ * The copy of each partition is simulated: rows are read in the order of the key from
+ * (Done, High] and committed every few rows through toTableCopyCommitter, like the writer does.
+ * The copy is interrupted, also by crashes just before and just after the commit of the
+ * destination, restarted from the checkpoint file and every key must end up copied exactly once.
+ */
+
+#include "tools/totablecopypartition.h"
+#include "tests/tocheck.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QMap>
+
+#include <limits>
+
+/** Ranges must be contiguous, cover [min, max] and not be more than requested */
+static bool covers(QVector<toTableCopyPartition> const& parts, qlonglong min, qlonglong max, int count)
+{
+    if (parts.isEmpty() || parts.size() > count)
+        return false;
+    if (parts.first().Low != min - 1 || parts.last().High != max)
+        return false;
+    for (int i = 0; i < parts.size(); i++)
+    {
+        toTableCopyPartition const& p = parts.at(i);
+        if (!p.Ranged || p.Low >= p.High || p.Done != p.Low || p.Rows != 0 || p.Finished)
+            return false;
+        if (i > 0 && parts.at(i - 1).High != p.Low)
+            return false;
+    }
+    return true;
+}
+
+enum Crash
+{
+    NoCrash,
+    BeforeCommit,   // the process dies in the commit, the rows are lost
+    AfterCommit     // the process dies after the commit, before the checkpoint is saved
+};
+
+struct Crashed
+{
+};
+
+/** Copy rows of @p part into @p copied, committing every @p commit rows.
+ *  Stops (without committing the pending rows) after @p limit rows, -1 to copy all.
+ *  With @p crash the first commit throws Crashed at that point.
+ */
+static void copy(QList<qlonglong> const& keys, int index, toTableCopyPartition const& part, toTableCopyCheckpoint &checkpoint,
+                 QMap<qlonglong, int> &copied, int commit, int limit, Crash crash = NoCrash)
+{
+    toTableCopyCommitter committer(index, part, &checkpoint);
+    QList<qlonglong> pending;
+    auto destination = [&]()
+    {
+        if (crash == BeforeCommit)
+            throw Crashed();
+        Q_FOREACH(qlonglong k, pending)
+            copied[k]++;
+        if (crash == AfterCommit)
+            throw Crashed();
+    };
+    int read = 0;
+    Q_FOREACH(qlonglong key, keys)  // sorted, like ORDER BY key
+    {
+        if (key <= part.Done || key > part.High)
+            continue;
+        if (limit >= 0 && read++ >= limit)
+            return; // interrupted, pending rows rolled back
+        pending << key;
+        committer.loaded(1, key);
+        if (pending.size() == commit)
+        {
+            committer.commit(destination, false);
+            pending.clear();
+        }
+    }
+    committer.commit(destination, true);
+}
+
+/** What the restart does with a commit in doubt: count its rows in the destination */
+static void resolve(toTableCopyPartition &part, QMap<qlonglong, int> const& copied)
+{
+    qint64 rows = 0;
+    Q_FOREACH(qlonglong k, copied.keys())
+    {
+        if (k > part.Done && k <= part.Pending)
+            rows++;
+    }
+    part.resolve(rows);
+}
+
+/** Every key copied exactly once */
+static bool once(QList<qlonglong> const& keys, QMap<qlonglong, int> const& copied)
+{
+    bool ret = copied.size() == keys.size();
+    Q_FOREACH(qlonglong k, keys)
+        ret = ret && copied.value(k) == 1;
+    return ret;
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    // integer key values
+    {
+        qlonglong k = 0;
+        check(toTableCopyPartition::key(toQValue(42), k) && k == 42, "int key");
+        check(toTableCopyPartition::key(toQValue(QString::fromLatin1("-7")), k) && k == -7, "text key");
+        check(toTableCopyPartition::key(toQValue((qlonglong) 5000000000LL), k) && k == 5000000000LL, "64 bit key");
+        check(toTableCopyPartition::key(toQValue(3.0), k) && k == 3, "integral number key");
+        check(!toTableCopyPartition::key(toQValue(1.5), k), "fraction rejected");
+        check(!toTableCopyPartition::key(toQValue(QString::fromLatin1("A17")), k), "text rejected");
+        check(!toTableCopyPartition::key(toQValue(), k), "NULL rejected");
+    }
+
+    // splitting key ranges
+    {
+        QVector<toTableCopyPartition> parts = toTableCopyPartition::split(1, 100, 3);
+        check(covers(parts, 1, 100, 3) && parts.size() == 3, "1..100 in 3 ranges");
+        check(parts.at(0).High == 34 && parts.at(1).High == 68, "ranges of the same size");
+        check(parts.at(1).remaining(QString::fromLatin1("ID")) == QString::fromLatin1("ID > 34 AND ID <= 68"), "range condition");
+
+        check(covers(toTableCopyPartition::split(5, 5, 4), 5, 5, 1), "single key");
+        check(covers(toTableCopyPartition::split(1, 2, 8), 1, 2, 2), "fewer keys than ranges");
+        check(covers(toTableCopyPartition::split(-50, 49, 4), -50, 49, 4), "negative keys");
+
+        qlonglong min = std::numeric_limits<qlonglong>::min() + 1, max = std::numeric_limits<qlonglong>::max();
+        check(covers(toTableCopyPartition::split(min, max, 4), min, max, 4), "whole 64 bit range");
+
+        bool thrown = false;
+        try
+        {
+            toTableCopyPartition::split(std::numeric_limits<qlonglong>::min(), 0, 2);
+        }
+        catch (QString const&)
+        {
+            thrown = true;
+        }
+        check(thrown, "lowest key value rejected");
+    }
+
+    // interrupted copy resumed from the checkpoint
+    {
+        QTemporaryDir dir;
+        QString file = dir.path() + QString::fromLatin1("/copy.ini");
+        QString signature = QString::fromLatin1("src|T|||dst|T|3|ID");
+
+        QList<qlonglong> keys;
+        for (qlonglong k = 1; k <= 200; k += (k % 7) ? 1 : 5)  // with gaps
+            keys << k;
+        QMap<qlonglong, int> copied;
+
+        {
+            toTableCopyCheckpoint checkpoint(file, signature);
+            QVector<toTableCopyPartition> parts;
+            check(!checkpoint.load(parts), "no checkpoint before the first run");
+            parts = toTableCopyPartition::split(keys.first(), keys.last(), 3);
+            checkpoint.reset(parts);
+
+            copy(keys, 0, parts[0], checkpoint, copied, 7, 30); // 4 commits, 2 rows lost
+            copy(keys, 1, parts[1], checkpoint, copied, 7, -1);
+            copy(keys, 2, parts[2], checkpoint, copied, 7, 3);  // nothing committed
+        }
+
+        {
+            toTableCopyCheckpoint other(file, signature + QString::fromLatin1("|other"));
+            QVector<toTableCopyPartition> parts;
+            check(!other.load(parts), "checkpoint of a different copy ignored");
+        }
+
+        {
+            toTableCopyCheckpoint checkpoint(file, signature);
+            QVector<toTableCopyPartition> parts;
+            check(checkpoint.load(parts) && parts.size() == 3, "checkpoint loaded");
+            check(parts.at(0).Rows == 28 && !parts.at(0).Finished, "committed rows of the interrupted range");
+            check(parts.at(1).Finished, "finished range");
+            check(parts.at(2).Rows == 0 && parts.at(2).Done == parts.at(2).Low, "range without a commit");
+            check(!parts.at(0).inDoubt() && !parts.at(2).inDoubt(), "no commit in doubt after a rollback");
+            for (int i = 0; i < parts.size(); i++)
+            {
+                if (!parts.at(i).Finished)
+                    copy(keys, i, parts[i], checkpoint, copied, 7, -1);
+            }
+        }
+
+        check(once(keys, copied), "every row copied exactly once");
+
+        toTableCopyCheckpoint checkpoint(file, signature);
+        QVector<toTableCopyPartition> parts;
+        qint64 rows = 0;
+        bool finished = checkpoint.load(parts);
+        Q_FOREACH(toTableCopyPartition const& p, parts)
+        {
+            rows += p.Rows;
+            finished = finished && p.Finished;
+        }
+        check(finished && rows == keys.size(), "checkpoint of the finished copy");
+    }
+
+    // crash between the commit of the destination and the checkpoint
+    {
+        QTemporaryDir dir;
+        QString file = dir.path() + QString::fromLatin1("/crash.ini");
+        QString signature = QString::fromLatin1("src|T|||dst|T|2|ID");
+
+        QList<qlonglong> keys;
+        for (qlonglong k = 1; k <= 100; k++)
+            keys << k;
+        QMap<qlonglong, int> copied;
+
+        {
+            toTableCopyCheckpoint checkpoint(file, signature);
+            QVector<toTableCopyPartition> parts = toTableCopyPartition::split(1, 100, 2);
+            checkpoint.reset(parts);
+            copy(keys, 0, parts[0], checkpoint, copied, 10, 25);  // two commits of 10
+            QVector<toTableCopyPartition> saved;
+            checkpoint.load(saved);
+            bool thrown = false;
+            try
+            {
+                copy(keys, 0, saved[0], checkpoint, copied, 10, -1, AfterCommit);
+            }
+            catch (Crashed const&)
+            {
+                thrown = true;
+            }
+            check(thrown && copied.size() == 30, "crash after the commit");
+            thrown = false;
+            try
+            {
+                copy(keys, 1, parts[1], checkpoint, copied, 10, -1, BeforeCommit);
+            }
+            catch (Crashed const&)
+            {
+                thrown = true;
+            }
+            check(thrown && copied.size() == 30, "crash before the commit");
+        }
+
+        {
+            toTableCopyCheckpoint checkpoint(file, signature);
+            QVector<toTableCopyPartition> parts;
+            check(checkpoint.load(parts) && parts.size() == 2, "checkpoint after the crashes loaded");
+            check(parts.at(0).inDoubt() && parts.at(0).Done == 20 && parts.at(0).Pending == 30,
+                  "committed rows in doubt");
+            check(parts.at(1).inDoubt() && parts.at(1).Done == 50 && parts.at(1).Pending == 60,
+                  "lost rows in doubt");
+            check(parts.at(0).pending(QString::fromLatin1("ID")) == QString::fromLatin1("ID > 20 AND ID <= 30"),
+                  "condition of the rows in doubt");
+            for (int i = 0; i < parts.size(); i++)
+            {
+                resolve(parts[i], copied);
+                checkpoint.save(i, parts.at(i));
+            }
+            check(!parts.at(0).inDoubt() && parts.at(0).Done == 30 && parts.at(0).Rows == 30, "commit found");
+            check(!parts.at(1).inDoubt() && parts.at(1).Done == 50 && parts.at(1).Rows == 0, "commit not found");
+            for (int i = 0; i < parts.size(); i++)
+                copy(keys, i, parts[i], checkpoint, copied, 10, -1);
+        }
+
+        check(once(keys, copied), "every row copied exactly once after the crashes");
+
+        toTableCopyCheckpoint checkpoint(file, signature);
+        QVector<toTableCopyPartition> parts;
+        bool finished = checkpoint.load(parts);
+        Q_FOREACH(toTableCopyPartition const& p, parts)
+            finished = finished && p.Finished && !p.inDoubt() && p.Rows == 50;
+        check(finished, "checkpoint of the copy finished after the crashes");
+    }
+
+    return checkResult();
+}
@@ -0,0 +1,221 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+
+/* Arrow IPC file written by toListViewFormatterArrow, no database needed.
+ *
+ * A small result is exported and the file is read back with a minimal flatbuffers reader:
+ * magic, schema (names and types of the fields) and the buffers of the record batch.
+ * Unsigned values above the Int64 range must give an unsigned Int column, unsigned and
+ * negative values in one column a Utf8 column.
+ */
+
+#include "core/tolistviewformatterarrow.h"
+#include "tests/tocheck.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QtEndian>
+#include <QStandardItemModel>
+
+#include <limits>
+#include <string.h>
+
+/** Just enough of flatbuffers to walk the Arrow metadata */
+class FbReader
+{
+    public:
+        FbReader(QByteArray const& buf) : Buf(buf) {}
+
+        template<typename T> T get(int pos) const
+        {
+            T ret;
+            memcpy(&ret, Buf.constData() + pos, sizeof(T));
+            return qFromLittleEndian<T>(ret);
+        }
+
+        int root(void) const
+        {
+            return get<quint32>(0);
+        }
+
+        /** Position of field @p id of the table at @p table, 0 when the field is absent */
+        int field(int table, int id) const
+        {
+            int vtable = table - get<qint32>(table);
+            if (4 + 2 * id >= get<quint16>(vtable))
+                return 0;
+            int offset = get<quint16>(vtable + 4 + 2 * id);
+            return offset ? table + offset : 0;
+        }
+
+        template<typename T> T scalar(int table, int id, T def = 0) const
+        {
+            int pos = field(table, id);
+            return pos ? get<T>(pos) : def;
+        }
+
+        /** Target of the table, string or vector field */
+        int ref(int table, int id) const
+        {
+            int pos = field(table, id);
+            return pos + get<quint32>(pos);
+        }
+
+        QString string(int table, int id) const
+        {
+            int pos = ref(table, id);
+            return QString::fromUtf8(Buf.constData() + pos + 4, get<quint32>(pos));
+        }
+
+        int count(int vector) const
+        {
+            return get<quint32>(vector);
+        }
+
+        /** Element @p i of a vector of tables */
+        int table(int vector, int i) const
+        {
+            int pos = vector + 4 + 4 * i;
+            return pos + get<quint32>(pos);
+        }
+    private:
+        QByteArray Buf;
+};
+
+enum { HeaderSchema = 1, HeaderRecordBatch = 3, TypeInt = 2, TypeUtf8 = 5 };
+
+/** Metadata of the IPC message at @p pos, moves @p pos to its body */
+static QByteArray message(QByteArray const& file, int &pos)
+{
+    FbReader r(file);
+    check(r.get<quint32>(pos) == 0xFFFFFFFF, "continuation marker");
+    int len = r.get<qint32>(pos + 4);
+    QByteArray meta = file.mid(pos + 8, len);
+    pos += 8 + len;
+    return meta;
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    const quint64 big = std::numeric_limits<quint64>::max() - 1;
+
+    QStandardItemModel model(3, 5);
+    model.setHorizontalHeaderLabels(QStringList() << "#" << "ID" << "BIG" << "MIXED" << "NAME");
+    QVariant values[3][5] =
+    {
+        { 1, qlonglong(-5), qulonglong(1), qulonglong(big), QString::fromLatin1("a") },
+        { 2, qlonglong(0), QVariant(), qlonglong(-1), QVariant() },
+        { 3, qlonglong(7), qulonglong(big), qlonglong(2), QString::fromLatin1("ccc") },
+    };
+    for (int row = 0; row < 3; row++)
+    {
+        for (int col = 0; col < 5; col++)
+        {
+            QStandardItem *item = new QStandardItem;
+            item->setData(values[row][col], Qt::DisplayRole);
+            item->setData(values[row][col], Qt::UserRole);
+            model.setItem(row, col, item);
+        }
+    }
+
+    toExportSettings settings(toExportSettings::RowsAll, toExportSettings::ColumnsAll, 0, false, true, QString(), QString());
+    toListViewFormatterArrow formatter;
+    QByteArray file = formatter.getFormattedData(settings, &model);
+
+    check(file.startsWith(QByteArray("ARROW1\0\0", 8)) && file.endsWith("ARROW1"), "file magic");
+
+    // schema
+    int pos = 8;
+    QByteArray meta = message(file, pos);
+    FbReader schemaMsg(meta);
+    check(schemaMsg.scalar<quint8>(schemaMsg.root(), 1) == HeaderSchema, "schema message");
+    int schema = schemaMsg.ref(schemaMsg.root(), 2);
+    int fields = schemaMsg.ref(schema, 1);
+    check(schemaMsg.count(fields) == 4, "row number column left out");
+
+    struct
+    {
+        const char *name;
+        quint8 type;
+        quint8 isSigned;
+    } expected[4] =
+    {
+        { "ID", TypeInt, 1 },
+        { "BIG", TypeInt, 0 },
+        { "MIXED", TypeUtf8, 0 },
+        { "NAME", TypeUtf8, 0 },
+    };
+    for (int i = 0; i < 4 && i < schemaMsg.count(fields); i++)
+    {
+        int field = schemaMsg.table(fields, i);
+        QByteArray what = QByteArray("field ") + expected[i].name;
+        check(schemaMsg.string(field, 0) == QString::fromLatin1(expected[i].name), (what + " name").constData());
+        check(schemaMsg.scalar<quint8>(field, 2) == expected[i].type, (what + " type").constData());
+        if (expected[i].type == TypeInt)
+        {
+            int type = schemaMsg.ref(field, 3);
+            check(schemaMsg.scalar<qint32>(type, 0) == 64, (what + " bit width").constData());
+            check(schemaMsg.scalar<quint8>(type, 1) == expected[i].isSigned, (what + " signedness").constData());
+        }
+    }
+
+    // record batch
+    QByteArray batchMeta = message(file, pos);
+    FbReader batchMsg(batchMeta);
+    check(batchMsg.scalar<quint8>(batchMsg.root(), 1) == HeaderRecordBatch, "record batch message");
+    int batch = batchMsg.ref(batchMsg.root(), 2);
+    check(batchMsg.scalar<qint64>(batch, 0) == 3, "record batch length");
+
+    // ID: validity, data; BIG: validity, data; MIXED: validity, offsets, data
+    int buffers = batchMsg.ref(batch, 2);
+    check(batchMsg.count(buffers) == 2 + 2 + 3 + 3, "buffer count");
+    int nodes = batchMsg.ref(batch, 1);
+    check(batchMsg.get<qint64>(nodes + 4 + 16 + 8) == 1, "NULL count of BIG");
+
+    FbReader body(file.mid(pos));
+    qint64 idData = batchMsg.get<qint64>(buffers + 4 + 16);
+    check(body.get<qint64>(idData) == -5 && body.get<qint64>(idData + 16) == 7, "signed values");
+
+    qint64 validity = batchMsg.get<qint64>(buffers + 4 + 2 * 16);
+    qint64 bigData = batchMsg.get<qint64>(buffers + 4 + 3 * 16);
+    check(body.get<quint8>(validity) == 5, "validity of BIG");
+    check(body.get<quint64>(bigData) == 1 && body.get<quint64>(bigData + 16) == big, "unsigned values");
+
+    qint64 mixedOffsets = batchMsg.get<qint64>(buffers + 4 + 5 * 16);
+    qint64 mixedData = batchMsg.get<qint64>(buffers + 4 + 6 * 16);
+    int end = body.get<qint32>(mixedOffsets + 12);
+    check(file.mid(pos + mixedData, end) == QByteArray::number(big) + "-12", "unsigned and negative values as text");
+
+    return checkResult();
+}
@@ -0,0 +1,127 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+
+/* Decoding of PostgreSQL binary numeric and timestamp values (toPQDecode), no database needed.
+ *
+ * The binary values are built by hand the way the server sends them, the text must be the one
+ * the server sends for the same value in a text result.
+ */
+
+#include "connection/topqdecode.h"
+#include "tests/tocheck.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QVector>
+#include <QtCore/QtEndian>
+
+#include <limits>
+
+/** Binary numeric from its header and base 10000 digits */
+static QByteArray numeric(qint16 weight, quint16 sign, qint16 dscale, QVector<qint16> const& digits)
+{
+    QByteArray ret(8 + 2 * digits.size(), '\0');
+    uchar *data = reinterpret_cast<uchar*>(ret.data());
+    qToBigEndian<qint16>(digits.size(), data);
+    qToBigEndian<qint16>(weight, data + 2);
+    qToBigEndian<quint16>(sign, data + 4);
+    qToBigEndian<qint16>(dscale, data + 6);
+    for (int i = 0; i < digits.size(); i++)
+        qToBigEndian<qint16>(digits.at(i), data + 8 + 2 * i);
+    return ret;
+}
+
+static bool numericIs(QByteArray const& value, const char *text)
+{
+    QString decoded = toPQDecode::numeric(reinterpret_cast<const uchar*>(value.constData()));
+    if (decoded == QString::fromLatin1(text))
+        return true;
+    printf("numeric: %s instead of %s\n", qPrintable(decoded), text);
+    return false;
+}
+
+static bool timestampIs(qint64 usec, bool tz, QTimeZone const& zone, const char *text)
+{
+    QString decoded = toPQDecode::timestamp(usec, tz, zone);
+    if (decoded == QString::fromLatin1(text))
+        return true;
+    printf("timestamp: %s instead of %s\n", qPrintable(decoded), text);
+    return false;
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    // numeric
+    {
+        const quint16 POS = 0x0000, NEG = 0x4000;
+        check(numericIs(numeric(1, POS, 3, QVector<qint16>() << 1 << 2345 << 6780), "12345.678"), "fraction");
+        check(numericIs(numeric(-1, NEG, 4, QVector<qint16>() << 12), "-0.0012"), "negative below one");
+        check(numericIs(numeric(0, POS, 2, QVector<qint16>()), "0.00"), "zero with scale");
+        check(numericIs(numeric(1, POS, 0, QVector<qint16>() << 1000), "10000000"), "trailing zero digits");
+        check(numericIs(numeric(-2, POS, 10, QVector<qint16>() << 5), "0.0000000500"), "leading zero digits of fraction");
+        check(numericIs(numeric(4, NEG, 0, QVector<qint16>() << 922 << 3372 << 368 << 5477 << 5758),
+                        "-9223372036854775758"), "more digits than a double holds");
+        check(numericIs(numeric(0, 0xC000, 0, QVector<qint16>()), "NaN"), "NaN");
+        check(numericIs(numeric(0, 0xD000, 0, QVector<qint16>()), "Infinity"), "infinity");
+        check(numericIs(numeric(0, 0xF000, 0, QVector<qint16>()), "-Infinity"), "minus infinity");
+    }
+
+    // timestamp and timestamp with time zone
+    {
+        const qint64 SEC = 1000000;
+        const qint64 JULY = qint64(182) * 86400 * SEC; // 2000-07-01 00:00 UTC
+        QTimeZone none;
+        check(timestampIs(0, false, none, "2000-01-01 00:00:00"), "epoch");
+        check(timestampIs(SEC + SEC / 2, false, none, "2000-01-01 00:00:01.5"), "fraction");
+        check(timestampIs(-1, false, none, "1999-12-31 23:59:59.999999"), "before the epoch");
+        check(timestampIs(std::numeric_limits<qint64>::max(), false, none, "infinity"), "infinity");
+        check(timestampIs(std::numeric_limits<qint64>::min(), true, none, "-infinity"), "minus infinity");
+
+        check(timestampIs(0, true, none, "2000-01-01 00:00:00+00"), "unknown session zone shown in UTC");
+        check(timestampIs(0, true, QTimeZone(5 * 3600 + 30 * 60), "2000-01-01 05:30:00+05:30"), "offset with minutes");
+        check(timestampIs(0, true, QTimeZone(-8 * 3600), "1999-12-31 16:00:00-08"), "negative offset");
+        check(timestampIs(0, false, QTimeZone(3600), "2000-01-01 00:00:00"), "no zone without time zone");
+
+        QTimeZone prague(QByteArray("Europe/Prague"));
+        if (prague.isValid())
+        {
+            check(timestampIs(0, true, prague, "2000-01-01 01:00:00+01"), "session zone in winter");
+            check(timestampIs(JULY, true, prague, "2000-07-01 02:00:00+02"), "session zone in summer");
+        }
+        else
+            printf("Time zone database not available, session zone checks skipped\n");
+    }
+
+    return checkResult();
+}
@@ -0,0 +1,338 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+
+/* Native ODBC queries (odbcQuery): block fetch, long columns, NULL and empty strings, array inserts.
+ * Needs an ODBC data source, the user must be able to create a table:
+ *
+ *   test17 dsn [user password [longtype]]
+ *
+ * dsn is a DSN or a complete connection string. longtype is the type of an unlimited text column
+ * (TEXT by default, VARCHAR(MAX) on SQL Server, CLOB ...), it must be read by SQLGetData.
+ * The database must not take empty strings for NULL (Oracle does).
+ */
+
+#include "connection/toodbcconnection.h"
+#include "core/toconfiguration.h"
+#include "core/toconnection.h"
+#include "core/toconnectionprovider.h"
+#include "core/toconnectionsubloan.h"
+#include "core/toconnectiontraits.h"
+#include "core/tologger.h"
+#include "core/toquery.h"
+#include "core/toqvalue.h"
+#include "connection/absfact.h"
+#include "tests/tocheck.h"
+
+#include <QApplication>
+#include <QtCore/QString>
+
+#define TEST_PROVIDER "ODBC test"
+#define TEST_FINDER "ODBC test finder"
+#define ROWS 600
+
+static void usage()
+{
+    printf("Usage:\n\n  test17 dsn [user password [longtype]]\n\n");
+    exit(2);
+}
+
+/* The native ODBC connection alone, without the QSql providers and their drivers */
+class testODBCConnectionImpl : public toODBCConnectionImpl
+{
+    public:
+        testODBCConnectionImpl(toConnection &conn) : toODBCConnectionImpl(conn) {}
+};
+
+class testODBCTraits : public toConnectionTraits
+{
+    public:
+        QString quote(const QString &name) const override
+        {
+            return name;
+        }
+        QString unQuote(const QString &name) const override
+        {
+            return name;
+        }
+        QString schemaSwitchSQL(QString const&) const override
+        {
+            return QString();
+        }
+        bool hasTableComments() const override
+        {
+            return false;
+        }
+        bool hasAsyncBreak() const override
+        {
+            return false;
+        }
+};
+
+class testODBCProvider : public toConnectionProvider
+{
+    public:
+        testODBCProvider(toConnectionProviderFinder::ConnectionProvirerParams const& p)
+            : toConnectionProvider(p)
+            , m_name(TEST_PROVIDER)
+        {}
+        bool initialize() override
+        {
+            return true;
+        }
+        QString const& name() const override
+        {
+            return m_name;
+        }
+        QString const& displayName() const override
+        {
+            return m_name;
+        }
+        QList<QString> hosts() const override
+        {
+            return QList<QString>();
+        }
+        QList<QString> databases(const QString&, const QString&, const QString&) const override
+        {
+            return QList<QString>();
+        }
+        QList<QString> options() const override
+        {
+            return QList<QString>();
+        }
+        QWidget *configurationTab(QWidget*) override
+        {
+            return NULL;
+        }
+        toConnection::connectionImpl* createConnectionImpl(toConnection &conn) override
+        {
+            return new testODBCConnectionImpl(conn);
+        }
+        toConnectionTraits* createConnectionTrait(void) override
+        {
+            static testODBCTraits *t = new testODBCTraits();
+            return t;
+        }
+    private:
+        QString m_name;
+};
+
+class testODBCFinder : public toConnectionProviderFinder
+{
+    public:
+        testODBCFinder(unsigned int i) : toConnectionProviderFinder(i) {}
+        QString name() const override
+        {
+            return QString::fromLatin1(TEST_FINDER);
+        }
+        QList<ConnectionProvirerParams> find() override
+        {
+            return QList<ConnectionProvirerParams>();
+        }
+        void load(ConnectionProvirerParams const&) override
+        {
+            ConnectionProvirerFactory::Instance().registerInFactory<testODBCProvider>(TEST_PROVIDER);
+        }
+};
+
+Util::RegisterInFactory<testODBCFinder, ConnectionProviderFinderFactory> regTestODBCFinder(TEST_FINDER);
+
+static QString nameOf(int i)
+{
+    switch (i % 3)
+    {
+        case 0:
+            return QString();
+        case 1:
+            return QString::fromLatin1("");
+        default:
+            return QString::fromLatin1("n%1").arg(i);
+    }
+}
+
+static QString bodyOf(int i)
+{
+    switch (i)
+    {
+        case 0:
+            return QString();
+        case 1:
+            return QString::fromLatin1("");
+        case 2:
+            // longer than the bound columns and than a chunk of SQLGetData
+            return QString(10000, QChar('x')) + QString::fromLatin1("end");
+        default:
+            return QString::fromLatin1("b%1").arg(i);
+    }
+}
+
+static bool same(toQValue const& v, QString const& expected)
+{
+    if (expected.isNull())
+        return v.isNull();
+    return !v.isNull() && (QString) v == expected;
+}
+
+static void execute(toConnectionSubLoan &conn, QString const& sql)
+{
+    toQuery q(conn, sql, toQueryParams());
+    while (!q.eof())
+        q.readValue();
+}
+
+int main(int argc, char **argv)
+{
+    toConfigurationNew::setQSettingsEnv();
+    QApplication app(argc, argv);
+
+    if (argc != 2 && argc != 4 && argc != 5)
+        usage();
+
+    try
+    {
+        qRegisterMetaType<toConnection::exception>("toConnection::exception");
+
+        QString database = QString::fromLocal8Bit(argv[1]);
+        QString user = argc > 2 ? QString::fromLocal8Bit(argv[2]) : QString();
+        QString password = argc > 3 ? QString::fromLocal8Bit(argv[3]) : QString();
+        QString longType = argc > 4 ? QString::fromLatin1(argv[4]) : QString::fromLatin1("TEXT");
+
+        toConnectionProviderFinder::ConnectionProvirerParams params;
+        params.insert("KEY", TEST_FINDER);
+        params.insert("PROVIDER", TEST_PROVIDER);
+        toConnectionProviderRegistrySing::Instance().load(params);
+
+        // TEST: no object cache and no keep alive
+        QSet<QString> options;
+        options << "TEST";
+        toConnection odbcCon(QString(TEST_PROVIDER), user, password, "", database, "", "", options);
+        toConnectionSubLoan conn(odbcCon);
+
+        try
+        {
+            execute(conn, "DROP TABLE TORA_TEST17");
+        }
+        catch (QString const&)
+        {
+        }
+        execute(conn, QString("CREATE TABLE TORA_TEST17 (ID INTEGER NOT NULL PRIMARY KEY, NAME VARCHAR(20), BODY %1)").arg(longType));
+        try
+        {
+            {
+                QList<toQueryParams> rows;
+                for (int i = 0; i < ROWS; i++)
+                    rows << (toQueryParams() << toQValue(i + 1) << toQValue(nameOf(i)) << toQValue(bodyOf(i)));
+                toQueryBatch insert(conn, "INSERT INTO TORA_TEST17 (ID, NAME, BODY) VALUES (:id<int>, :name<char[21]>, :body<char[10004]>)");
+                QString error;
+                int done = insert.execute(rows, error);
+                check(done == ROWS, "all rows inserted");
+                check(error.isEmpty(), "no insert error");
+                check(insert.affectedRows() == (unsigned long) ROWS, "affected rows");
+                if (!error.isEmpty())
+                    printf("%s\n", qPrintable(error));
+            }
+
+            // Bound columns only: blocks of up to 256 rows
+            {
+                toQuery select(conn, "SELECT ID, NAME FROM TORA_TEST17 ORDER BY ID", toQueryParams());
+                int rows = 0;
+                bool ids = true, names = true;
+                while (!select.eof())
+                {
+                    toQValue id = select.readValue();
+                    toQValue n = select.readValue();
+                    ids &= !id.isNull() && id.toInt() == rows + 1;
+                    names &= same(n, nameOf(rows));
+                    rows++;
+                }
+                check(rows == ROWS, "all rows read in blocks");
+                check(ids, "rows in order across the block boundaries (256, 512)");
+                check(names, "NULL, empty and other names of the bound column");
+                check(select.rowsProcessed() == (unsigned long) ROWS, "rows processed");
+            }
+
+            // A long column after the bound ones: rows one by one, the long column by SQLGetData
+            {
+                toQuery select(conn, "SELECT ID, NAME, BODY FROM TORA_TEST17 WHERE ID <= 10 ORDER BY ID", toQueryParams());
+                int rows = 0;
+                bool ids = true, names = true, bodies = true;
+                while (!select.eof())
+                {
+                    toQValue id = select.readValue();
+                    toQValue n = select.readValue();
+                    toQValue b = select.readValue();
+                    ids &= !id.isNull() && id.toInt() == rows + 1;
+                    names &= same(n, nameOf(rows));
+                    bodies &= same(b, bodyOf(rows));
+                    rows++;
+                }
+                check(rows == 10, "rows with a long column");
+                check(ids && names, "bound columns before the long one");
+                check(bodies, "NULL, empty and long values of the long column");
+            }
+
+            // A failing row (duplicate key) in the middle of a batch collecting errors
+            {
+                QList<toQueryParams> rows;
+                int ids[] = { 2001, 2002, 5, 2003, 2004 };
+                for (int i = 0; i < 5; i++)
+                    rows << (toQueryParams() << toQValue(ids[i]) << toQValue(QString("dup")) << toQValue());
+                toQueryBatch insert(conn, "INSERT INTO TORA_TEST17 (ID, NAME, BODY) VALUES (:id<int>, :name<char[21]>, :body<char[1]>)");
+                insert.setCollectErrors(true);
+                QString error;
+                int done = insert.execute(rows, error);
+                QList<queryImpl::BatchError> errors = insert.errors();
+                check(done == rows.size(), "all rows of the batch executed");
+                check(error.isEmpty(), "no batch error");
+                check(errors.size() == 1, "one row error");
+                if (errors.size() == 1)
+                    check(errors.at(0).Row == 2 && !errors.at(0).Message.isEmpty(), "error of the duplicate row");
+
+                toQuery count(conn, "SELECT COUNT(*) FROM TORA_TEST17 WHERE ID > 2000", toQueryParams());
+                check(!count.eof() && count.readValue().toInt() == 4, "the other rows of the batch inserted");
+            }
+        }
+        catch (...)
+        {
+            execute(conn, "DROP TABLE TORA_TEST17");
+            throw;
+        }
+        execute(conn, "DROP TABLE TORA_TEST17");
+    }
+    catch (const QString &str)
+    {
+        printf("Unhandled exception: %s\n", qPrintable(str));
+        return 1;
+    }
+
+    return checkResult();
+}
@@ -0,0 +1,483 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "tools/toaqmonitor.h"
+#include "tools/tolinechart.h"
+#include "core/utils.h"
+#include "core/totool.h"
+#include "core/toquery.h"
+#include "core/tosql.h"
+#include "core/toconnection.h"
+#include "core/toconnectionsub.h"
+#include "core/toconnectionsubloan.h"
+#include "core/toconnectiontraits.h"
+#include "core/tologger.h"
+
+#include <QAction>
+#include <QHeaderView>
+#include <QLabel>
+#include <QSpinBox>
+#include <QSplitter>
+#include <QTableWidget>
+#include <QToolBar>
+
+#include "icons/execute.xpm"
+#include "icons/refresh.xpm"
+#include "icons/stop.xpm"
+
+class toAQMonitorTool : public toTool
+{
+    protected:
+        virtual const char **pictureXPM(void)
+        {
+            return const_cast<const char**>(refresh_xpm);
+        }
+    public:
+        toAQMonitorTool()
+            : toTool(316, "Queue Monitor")
+        { }
+        virtual const char *menuItem()
+        {
+            return "Queue Monitor";
+        }
+        virtual toToolWidget *toolWindow(QWidget *parent, toConnection &connection)
+        {
+            return new toAQMonitor(parent, connection);
+        }
+        virtual bool canHandle(const toConnection &conn)
+        {
+            return conn.providerIs("Oracle");
+        }
+        virtual void closeWindow(toConnection &connection) {};
+};
+
+static toAQMonitorTool AQMonitorTool;
+
+static toSQL SQLQueues("toAQMonitor:Queues",
+                       "SELECT q.owner, q.name, q.queue_table,\n"
+                       "       DECODE(t.recipients, 'MULTIPLE', 1, 0),\n"
+                       "       NVL(v.ready, 0), NVL(v.waiting, 0), NVL(v.expired, 0),\n"
+                       "       NVL(p.enqueued, -1), NVL(p.dequeued, -1)\n"
+                       "  FROM sys.all_queues q\n"
+                       "  JOIN sys.all_queue_tables t ON t.owner = q.owner AND t.queue_table = q.queue_table\n"
+                       "  LEFT JOIN v$aq v ON v.qid = q.qid\n"
+                       "  LEFT JOIN (SELECT queue_id, SUM(enqueued_msgs) enqueued, SUM(dequeued_msgs) dequeued\n"
+                       "               FROM gv$persistent_queues\n"
+                       "              GROUP BY queue_id) p ON p.queue_id = q.qid\n"
+                       " WHERE q.queue_type = 'NORMAL_QUEUE'\n"
+                       " ORDER BY q.owner, q.name",
+                       "Depth and cumulative enqueue/dequeue counters of all queues, must have same columns",
+                       "1100",
+                       "Oracle");
+static toSQL SQLQueues9("toAQMonitor:Queues",
+                        "SELECT q.owner, q.name, q.queue_table,\n"
+                        "       DECODE(t.recipients, 'MULTIPLE', 1, 0),\n"
+                        "       NVL(v.ready, 0), NVL(v.waiting, 0), NVL(v.expired, 0),\n"
+                        "       -1, -1\n"
+                        "  FROM sys.all_queues q\n"
+                        "  JOIN sys.all_queue_tables t ON t.owner = q.owner AND t.queue_table = q.queue_table\n"
+                        "  LEFT JOIN v$aq v ON v.qid = q.qid\n"
+                        " WHERE q.queue_type = 'NORMAL_QUEUE'\n"
+                        " ORDER BY q.owner, q.name",
+                        "",
+                        "0900",
+                        "Oracle");
+
+// %1 owner, %2 AQ$ view of the queue table, %3 consumer column (or NULL for single consumer queues)
+static toSQL SQLBrowse("toAQMonitor:Browse",
+                       "SELECT * FROM (\n"
+                       "  SELECT RAWTOHEX(msg_id), corr_id, msg_state, %3,\n"
+                       "         TO_CHAR(enq_time, 'YYYY-MM-DD HH24:MI:SS'), msg_priority, retry_count\n"
+                       "    FROM %1.%2\n"
+                       "   WHERE queue = :q<char[129]>\n"
+                       "   ORDER BY enq_time, msg_priority)\n"
+                       " WHERE ROWNUM <= :m<int>",
+                       "Browse messages of a queue, must have same columns and binds",
+                       "0900",
+                       "Oracle");
+
+static toSQL SQLListen("toAQMonitor:Listen",
+                       "DECLARE\n"
+                       "  agents SYS.DBMS_AQ.AQ$_AGENT_LIST_T;\n"
+                       "  agent SYS.AQ$_AGENT;\n"
+                       "  queue VARCHAR2(300) := :q<char[300],in>;\n"
+                       "  multi NUMBER := :mc<int,in>;\n"
+                       "  ret NUMBER := 0;\n"
+                       "  listen_timeout EXCEPTION;\n"
+                       "  PRAGMA EXCEPTION_INIT(listen_timeout, -25254);\n"
+                       "BEGIN\n"
+                       "  IF multi = 1 THEN\n"
+                       "    FOR s IN (SELECT consumer_name FROM sys.all_queue_subscribers\n"
+                       "               WHERE owner || '.' || queue_name = queue) LOOP\n"
+                       "      agents(agents.COUNT + 1) := SYS.AQ$_AGENT(s.consumer_name, queue, NULL);\n"
+                       "    END LOOP;\n"
+                       "  ELSE\n"
+                       "    agents(1) := SYS.AQ$_AGENT(NULL, queue, NULL);\n"
+                       "  END IF;\n"
+                       "  IF agents.COUNT > 0 THEN\n"
+                       "    BEGIN\n"
+                       "      SYS.DBMS_AQ.LISTEN(agent_list => agents, wait => :w<int,in>, agent => agent);\n"
+                       "      ret := 1;\n"
+                       "    EXCEPTION\n"
+                       "      WHEN listen_timeout THEN\n"
+                       "        ret := 0;\n"
+                       "    END;\n"
+                       "  END IF;\n"
+                       "  :stat<int,out> := ret;\n"
+                       "END;",
+                       "Wait for a message in a queue, must have same binds",
+                       "0900",
+                       "Oracle");
+
+toAQOracleSource::toAQOracleSource(QSharedPointer<toConnectionSubLoan> conn)
+    : Connection(conn)
+{
+}
+
+QList<toAQQueueStat> toAQOracleSource::queues(void)
+{
+    QList<toAQQueueStat> retval;
+    toQuery query(*Connection, SQLQueues, toQueryParams());
+    while (!query.eof())
+    {
+        toAQQueueStat stat;
+        stat.Owner = query.readValue();
+        stat.Name = query.readValue();
+        stat.Table = query.readValue();
+        stat.MultiConsumer = query.readValue().toInt() == 1;
+        stat.Ready = query.readValue().toLong();
+        stat.Waiting = query.readValue().toLong();
+        stat.Expired = query.readValue().toLong();
+        stat.Enqueued = query.readValue().toLong();
+        stat.Dequeued = query.readValue().toLong();
+        retval << stat;
+    }
+    return retval;
+}
+
+QList<toAQMessage> toAQOracleSource::browse(toAQQueueStat const& queue, int max)
+{
+    // The AQ$ view gives the same non destructive view of the queue as a browse mode dequeue,
+    // without the need to know the payload type. Rows are array fetched.
+    toConnectionTraits const& traits = Connection->ParentConnection.getTraits();
+    QString sql = toSQL::string(SQLBrowse, Connection->ParentConnection)
+                  .arg(traits.quote(queue.Owner),
+                       traits.quote(QString::fromLatin1("AQ$") + queue.Table),
+                       queue.MultiConsumer ? QString::fromLatin1("consumer_name") : QString::fromLatin1("NULL"));
+
+    QList<toAQMessage> retval;
+    toQuery query(*Connection, sql, toQueryParams() << toQValue(queue.Name) << toQValue(max));
+    while (!query.eof())
+    {
+        toAQMessage msg;
+        msg.MsgId = query.readValue();
+        msg.CorrId = query.readValue();
+        msg.State = query.readValue();
+        msg.Consumer = query.readValue();
+        msg.EnqTime = query.readValue();
+        msg.Priority = query.readValue().toInt();
+        msg.Retries = query.readValue().toInt();
+        retval << msg;
+    }
+    return retval;
+}
+
+bool toAQOracleSource::listen(toAQQueueStat const& queue, int wait)
+{
+    toQuery query(*Connection, SQLListen, toQueryParams()
+                  << toQValue(queue.Owner + QString::fromLatin1(".") + queue.Name)
+                  << toQValue(queue.MultiConsumer ? 1 : 0)
+                  << toQValue(wait));
+    return query.readValue().toInt() == 1;
+}
+
+void toAQOracleSource::cancel(void)
+{
+    (*Connection)->cancel();
+}
+
+toAQMonitor::toAQMonitor(QWidget *parent, toConnection &connection)
+    : toToolWidget(AQMonitorTool, "aqmonitor.html", parent, connection, "toAQMonitor")
+    , Poller(NULL)
+{
+    QToolBar *toolbar = Utils::toAllocBar(this, tr("Queue Monitor"));
+    layout()->addWidget(toolbar);
+
+    toolbar->addAction(QIcon(QPixmap(refresh_xpm)),
+                       tr("Refresh now"),
+                       this,
+                       SLOT(slotRefresh()));
+    toolbar->addSeparator();
+    StartAct = toolbar->addAction(QIcon(QPixmap(execute_xpm)),
+                                  tr("Start monitoring"),
+                                  this,
+                                  SLOT(slotStart()));
+    StopAct = toolbar->addAction(QIcon(QPixmap(stop_xpm)),
+                                 tr("Stop monitoring"),
+                                 this,
+                                 SLOT(slotStop()));
+    toolbar->addSeparator();
+    toolbar->addWidget(new QLabel(tr("Refresh") + QString::fromLatin1(" "), toolbar));
+    Interval = new QSpinBox(toolbar);
+    Interval->setRange(1, 3600);
+    Interval->setValue(10);
+    Interval->setSuffix(tr(" s"));
+    Interval->setToolTip(tr("Sampling interval. An empty selected queue is sampled as soon as a message arrives."));
+    connect(Interval, SIGNAL(valueChanged(int)), this, SLOT(slotInterval(int)));
+    toolbar->addWidget(Interval);
+    toolbar->addWidget(new Utils::toSpacer());
+
+    QSplitter *splitter = new QSplitter(Qt::Vertical, this);
+
+    Queues = new QTableWidget(0, 7, splitter);
+    Queues->setHorizontalHeaderLabels(QStringList()
+                                      << tr("Queue") << tr("Queue table")
+                                      << tr("Ready") << tr("Waiting") << tr("Expired")
+                                      << tr("Enqueued/s") << tr("Dequeued/s"));
+    Queues->horizontalHeader()->setStretchLastSection(true);
+    Queues->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    Queues->setSelectionBehavior(QAbstractItemView::SelectRows);
+    Queues->setSelectionMode(QAbstractItemView::SingleSelection);
+    connect(Queues, SIGNAL(itemSelectionChanged()), this, SLOT(slotSelectQueue()));
+    splitter->addWidget(Queues);
+
+    QSplitter *charts = new QSplitter(Qt::Horizontal, splitter);
+    Depth = new toLineChart(charts);
+    Depth->setTitle(tr("Ready messages"));
+    Depth->setMinValue(0);
+    Depth->showLegend(true);
+    charts->addWidget(Depth);
+    Throughput = new toLineChart(charts);
+    Throughput->setTitle(tr("Throughput (all queues)"));
+    Throughput->setMinValue(0);
+    Throughput->setYPostfix(tr("/s"));
+    Throughput->showLegend(true);
+    std::list<QString> labels;
+    labels.push_back(tr("Enqueued"));
+    labels.push_back(tr("Dequeued"));
+    Throughput->setLabels(labels);
+    charts->addWidget(Throughput);
+    splitter->addWidget(charts);
+
+    Messages = new QTableWidget(0, 7, splitter);
+    Messages->setHorizontalHeaderLabels(QStringList()
+                                        << tr("Message ID") << tr("Correlation") << tr("State")
+                                        << tr("Consumer") << tr("Enqueued") << tr("Priority") << tr("Retries"));
+    Messages->horizontalHeader()->setStretchLastSection(true);
+    Messages->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    splitter->addWidget(Messages);
+    layout()->addWidget(splitter);
+
+    Status = new QLabel(this);
+    layout()->addWidget(Status);
+
+    slotStart();
+}
+
+toAQMonitor::~toAQMonitor()
+{
+    slotStop();
+}
+
+void toAQMonitor::slotStart(void)
+{
+    if (Poller)
+        return;
+    try
+    {
+        // The poller gets its own session, long waits in DBMS_AQ.LISTEN must not block other tools
+        Poller = new toAQPoller(new toAQOracleSource(QSharedPointer<toConnectionSubLoan>(new toConnectionSubLoan(connection()))),
+                                Interval->value(),
+                                100);
+        Poller->setQueue(Selected);
+        connect(Poller, SIGNAL(updated()), this, SLOT(slotUpdated()));
+        connect(Poller, SIGNAL(failed(QString const&)), this, SLOT(slotFailed(QString const&)));
+        Counters.clear();
+        LastSample = QDateTime();
+        Poller->start();
+        StartAct->setEnabled(false);
+        StopAct->setEnabled(true);
+    }
+    TOCATCH;
+}
+
+void toAQMonitor::slotStop(void)
+{
+    if (!Poller)
+        return;
+    Poller->stop();
+    Poller->wait();
+    delete Poller;
+    Poller = NULL;
+    StartAct->setEnabled(true);
+    StopAct->setEnabled(false);
+}
+
+void toAQMonitor::slotRefresh(void)
+{
+    if (Poller)
+        Poller->refresh();
+    else
+        slotStart();
+}
+
+void toAQMonitor::slotInterval(int interval)
+{
+    if (Poller)
+        Poller->setInterval(interval);
+}
+
+void toAQMonitor::slotSelectQueue(void)
+{
+    QList<QTableWidgetItem*> items = Queues->selectedItems();
+    Selected = items.isEmpty() ? QString() : Queues->item(items.first()->row(), 0)->text();
+    Throughput->clear();
+    Throughput->setTitle(Selected.isEmpty() ? tr("Throughput (all queues)") : tr("Throughput of %1").arg(Selected));
+    if (Selected.isEmpty())
+        Messages->setRowCount(0);
+    if (Poller)
+        Poller->setQueue(Selected);
+}
+
+void toAQMonitor::resetDepth(QList<toAQQueueStat> const& stats)
+{
+    DepthQueues.clear();
+    std::list<QString> labels;
+    Q_FOREACH(toAQQueueStat const& stat, stats)
+    {
+        QString name = stat.Owner + QString::fromLatin1(".") + stat.Name;
+        DepthQueues << name;
+        labels.push_back(name);
+    }
+    Depth->clear();
+    Depth->setLabels(labels);
+}
+
+static QTableWidgetItem *numberItem(double value, bool valid = true)
+{
+    QTableWidgetItem *item = new QTableWidgetItem(valid ? QString::number(value) : QString());
+    item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    return item;
+}
+
+void toAQMonitor::slotUpdated(void)
+{
+    if (!Poller)
+        return;
+    QList<toAQQueueStat> stats = Poller->stats();
+    QList<toAQMessage> messages = Poller->messages();
+    QDateTime sampled = Poller->sampled();
+    double elapsed = LastSample.isValid() ? LastSample.msecsTo(sampled) / 1000.0 : 0;
+    LastSample = sampled;
+
+    QStringList names;
+    Q_FOREACH(toAQQueueStat const& stat, stats)
+        names << stat.Owner + QString::fromLatin1(".") + stat.Name;
+    if (names != DepthQueues)
+        resetDepth(stats);
+
+    Queues->blockSignals(true);
+    Queues->setRowCount(stats.size());
+    std::list<double> depth;
+    double enqTotal = 0, deqTotal = 0;
+    bool rates = false;
+    QMap<QString, QPair<qint64, qint64> > counters;
+    for (int row = 0; row < stats.size(); row++)
+    {
+        toAQQueueStat const& stat = stats.at(row);
+        QString const& name = names.at(row);
+        depth.push_back(stat.Ready);
+
+        double enq = 0, deq = 0;
+        bool valid = elapsed > 0 && stat.Enqueued >= 0 && Counters.contains(name);
+        if (valid)
+        {
+            // counters restart with the instance, do not show negative rates
+            enq = qMax<qint64>(0, stat.Enqueued - Counters[name].first) / elapsed;
+            deq = qMax<qint64>(0, stat.Dequeued - Counters[name].second) / elapsed;
+            if (Selected.isEmpty() || Selected == name)
+            {
+                enqTotal += enq;
+                deqTotal += deq;
+                rates = true;
+            }
+        }
+        counters[name] = qMakePair(stat.Enqueued, stat.Dequeued);
+
+        Queues->setItem(row, 0, new QTableWidgetItem(name));
+        Queues->setItem(row, 1, new QTableWidgetItem(stat.Table));
+        Queues->setItem(row, 2, numberItem(stat.Ready));
+        Queues->setItem(row, 3, numberItem(stat.Waiting));
+        Queues->setItem(row, 4, numberItem(stat.Expired));
+        Queues->setItem(row, 5, numberItem(qRound(enq * 100) / 100.0, valid));
+        Queues->setItem(row, 6, numberItem(qRound(deq * 100) / 100.0, valid));
+        if (name == Selected)
+            Queues->selectRow(row);
+    }
+    Queues->blockSignals(false);
+    Counters = counters;
+
+    QString time = sampled.time().toString();
+    if (!depth.empty())
+        Depth->addValues(depth, time);
+    if (rates)
+    {
+        std::list<double> values;
+        values.push_back(enqTotal);
+        values.push_back(deqTotal);
+        Throughput->addValues(values, time);
+    }
+
+    Messages->setRowCount(messages.size());
+    for (int row = 0; row < messages.size(); row++)
+    {
+        toAQMessage const& msg = messages.at(row);
+        Messages->setItem(row, 0, new QTableWidgetItem(msg.MsgId));
+        Messages->setItem(row, 1, new QTableWidgetItem(msg.CorrId));
+        Messages->setItem(row, 2, new QTableWidgetItem(msg.State));
+        Messages->setItem(row, 3, new QTableWidgetItem(msg.Consumer));
+        Messages->setItem(row, 4, new QTableWidgetItem(msg.EnqTime));
+        Messages->setItem(row, 5, numberItem(msg.Priority));
+        Messages->setItem(row, 6, numberItem(msg.Retries));
+    }
+
+    Status->setText(tr("%1 queues, last sample at %2").arg(stats.size()).arg(time));
+}
+
+void toAQMonitor::slotFailed(QString const& error)
+{
+    Utils::toStatusMessage(error);
+    Status->setText(tr("Monitoring stopped: %1").arg(error));
+    slotStop();
+}
@@ -0,0 +1,97 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include "widgets/totoolwidget.h"
+#include "tools/toaqpoller.h"
+
+#include <QtCore/QMap>
+#include <QtCore/QSharedPointer>
+
+class QAction;
+class QLabel;
+class QSpinBox;
+class QTableWidget;
+class toLineChart;
+class toConnectionSubLoan;
+
+/** Oracle implementation reading V$AQ and the AQ$<queue table> views. Waits for new
+ *  messages with DBMS_AQ.LISTEN instead of repeated queries.
+ */
+class toAQOracleSource : public toAQSource
+{
+    public:
+        toAQOracleSource(QSharedPointer<toConnectionSubLoan> conn);
+
+        QList<toAQQueueStat> queues(void) override;
+        QList<toAQMessage> browse(toAQQueueStat const& queue, int max) override;
+        bool listen(toAQQueueStat const& queue, int wait) override;
+        void cancel(void) override;
+    private:
+        QSharedPointer<toConnectionSubLoan> Connection;
+};
+
+class toAQMonitor : public toToolWidget
+{
+        Q_OBJECT;
+    public:
+        toAQMonitor(QWidget *parent, toConnection &connection);
+        virtual ~toAQMonitor();
+        virtual void slotWindowActivated(toToolWidget*) {};
+    private slots:
+        void slotRefresh(void);
+        void slotStart(void);
+        void slotStop(void);
+        void slotUpdated(void);
+        void slotFailed(QString const& error);
+        void slotSelectQueue(void);
+        void slotInterval(int interval);
+    private:
+        /** Restart the depth chart when the set of queues changes */
+        void resetDepth(QList<toAQQueueStat> const& stats);
+
+        QAction *StartAct, *StopAct;
+        QSpinBox *Interval;
+        QTableWidget *Queues, *Messages;
+        toLineChart *Depth, *Throughput;
+        QLabel *Status;
+
+        toAQPoller *Poller;
+        QStringList DepthQueues;
+        QString Selected;
+        // previous cumulative counters per queue (enqueued, dequeued) and time of sample
+        QMap<QString, QPair<qint64, qint64> > Counters;
+        QDateTime LastSample;
+};
@@ -0,0 +1,190 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "tools/toaqpoller.h"
+#include "core/utils.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMutexLocker>
+
+toAQPoller::toAQPoller(toAQSource *source, int interval, int maxMessages)
+    : QThread(NULL)
+    , Source(source)
+    , Interval(interval)
+    , MaxMessages(maxMessages)
+    , Stopped(false)
+    , Refresh(false)
+    , Listening(false)
+    , Interrupted(false)
+{
+}
+
+toAQPoller::~toAQPoller()
+{
+    delete Source;
+}
+
+void toAQPoller::interrupt(void)
+{
+    Refresh = true;
+    Wake.wakeAll();
+    if (Listening)
+    {
+        Interrupted = true;
+        Source->cancel();
+    }
+}
+
+void toAQPoller::setQueue(QString const& queue)
+{
+    QMutexLocker lock(&Mutex);
+    if (Queue == queue)
+        return;
+    Queue = queue;
+    interrupt();
+}
+
+void toAQPoller::setInterval(int interval)
+{
+    QMutexLocker lock(&Mutex);
+    Interval = interval;
+}
+
+void toAQPoller::refresh(void)
+{
+    QMutexLocker lock(&Mutex);
+    interrupt();
+}
+
+void toAQPoller::stop(void)
+{
+    QMutexLocker lock(&Mutex);
+    Stopped = true;
+    interrupt();
+}
+
+QList<toAQQueueStat> toAQPoller::stats(void)
+{
+    QMutexLocker lock(&Mutex);
+    return Stats;
+}
+
+QList<toAQMessage> toAQPoller::messages(void)
+{
+    QMutexLocker lock(&Mutex);
+    return Messages;
+}
+
+QDateTime toAQPoller::sampled(void)
+{
+    QMutexLocker lock(&Mutex);
+    return Sampled;
+}
+
+void toAQPoller::run(void)
+{
+    Utils::toSetThreadName(*this);
+
+    QMutexLocker lock(&Mutex);
+    while (!Stopped)
+    {
+        QString queue = Queue;
+        int interval = Interval; // setInterval can change it while the lock is released
+        qint64 wait = interval * 1000;
+        Refresh = false;
+        lock.unlock();
+
+        try
+        {
+            QList<toAQQueueStat> stats = Source->queues();
+            QList<toAQMessage> messages;
+            toAQQueueStat const *current = NULL;
+            for (int i = 0; i < stats.size() && !current; i++)
+            {
+                if (stats.at(i).Owner + QString::fromLatin1(".") + stats.at(i).Name == queue)
+                    current = &stats.at(i);
+            }
+            if (current)
+                messages = Source->browse(*current, MaxMessages);
+
+            lock.relock();
+            Stats = stats;
+            Messages = messages;
+            Sampled = QDateTime::currentDateTime();
+            lock.unlock();
+            emit updated();
+
+            // Listen returns as soon as any message is ready, so it is only useful while
+            // the queue is empty. Otherwise fall back to the refresh interval.
+            if (current && current->Ready == 0)
+            {
+                lock.relock();
+                bool skip = Stopped || Refresh;
+                Listening = !skip;
+                lock.unlock();
+                if (!skip)
+                {
+                    QElapsedTimer timer;
+                    timer.start();
+                    bool arrived = Source->listen(*current, interval);
+                    lock.relock();
+                    Listening = false;
+                    Interrupted = false;
+                    lock.unlock();
+                    // take the next sample right away when a message arrived, otherwise
+                    // wait for what is left of the interval (listen may not have waited at all)
+                    wait = arrived ? 0 : wait - timer.elapsed();
+                }
+            }
+        }
+        catch (QString const& str)
+        {
+            lock.relock();
+            Listening = false;
+            if (Interrupted || Stopped)
+            {
+                // listen was cancelled by a change of queue, refresh or stop
+                Interrupted = false;
+                continue;
+            }
+            lock.unlock();
+            emit failed(str);
+            return;
+        }
+
+        lock.relock();
+        if (!Stopped && !Refresh && wait > 0)
+            Wake.wait(&Mutex, wait);
+    }
+}
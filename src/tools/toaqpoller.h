@@ -0,0 +1,126 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include <QtCore/QThread>
+#include <QtCore/QMutex>
+#include <QtCore/QWaitCondition>
+#include <QtCore/QDateTime>
+#include <QtCore/QList>
+#include <QtCore/QString>
+
+/** State of one queue as seen in a single sample */
+struct toAQQueueStat
+{
+    QString Owner, Name, Table;
+    bool MultiConsumer;
+    qint64 Ready, Waiting, Expired;
+    qint64 Enqueued, Dequeued;  // cumulative counters, -1 when not available
+};
+
+/** One message of a queue, as returned by a browse */
+struct toAQMessage
+{
+    QString MsgId, CorrId, State, Consumer, EnqTime;
+    int Priority, Retries;
+};
+
+/** Access to Advanced Queuing used by the monitor. The monitor only talks to the database
+ *  through this interface, so it can be driven by a fake implementation.
+ *  All the methods are called from the poller thread.
+ */
+class toAQSource
+{
+    public:
+        virtual ~toAQSource() {};
+
+        /** Current depth and counters of all visible queues */
+        virtual QList<toAQQueueStat> queues(void) = 0;
+
+        /** Browse (non destructively) at most @p max messages of the queue, oldest first */
+        virtual QList<toAQMessage> browse(toAQQueueStat const& queue, int max) = 0;
+
+        /** Block until a message is available in the queue or @p wait seconds pass.
+         * @return true when a message arrived, false on timeout
+         */
+        virtual bool listen(toAQQueueStat const& queue, int wait) = 0;
+
+        /** Interrupt a blocking @ref listen, called from other than the poller thread */
+        virtual void cancel(void) = 0;
+};
+
+/** Samples the queues in the background. Between samples it waits for a new message
+ *  in the selected queue (when the queue is empty) or for the refresh interval.
+ */
+class toAQPoller : public QThread
+{
+        Q_OBJECT;
+    public:
+        /** Takes ownership of @p source */
+        toAQPoller(toAQSource *source, int interval, int maxMessages);
+        virtual ~toAQPoller();
+
+        /** Queue to browse and listen on, owner.name. Empty string for none */
+        void setQueue(QString const& queue);
+        void setInterval(int interval);
+        /** Request the next sample now */
+        void refresh(void);
+        void stop(void);
+
+        /** Last sample taken, safe to call from any thread */
+        QList<toAQQueueStat> stats(void);
+        QList<toAQMessage> messages(void);
+        QDateTime sampled(void);
+    signals:
+        /** New sample is available */
+        void updated(void);
+        void failed(QString const& error);
+    protected:
+        void run(void) override;
+    private:
+        /** Wake up the poller, cancels a pending listen. Called with Mutex locked */
+        void interrupt(void);
+
+        toAQSource *Source;
+        QMutex Mutex;
+        QWaitCondition Wake;
+        QString Queue;
+        int Interval, MaxMessages;
+        bool Stopped, Refresh;
+        bool Listening, Interrupted;
+        QList<toAQQueueStat> Stats;
+        QList<toAQMessage> Messages;
+        QDateTime Sampled;
+};
@@ -0,0 +1,748 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "tools/toimport.h"
+#include "core/utils.h"
+#include "core/totool.h"
+#include "core/toquery.h"
+#include "core/toconnection.h"
+#include "core/toconnectionsub.h"
+#include "core/toconnectionsubloan.h"
+#include "core/toconnectiontraits.h"
+#include "core/tologger.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QScopedPointer>
+#include <QAction>
+#include <QCheckBox>
+#include <QComboBox>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QMessageBox>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QSplitter>
+#include <QTableWidget>
+#include <QToolBar>
+
+#include <exception>
+
+#include "icons/execute.xpm"
+#include "icons/fileopen.xpm"
+#include "icons/stop.xpm"
+
+class toImportTool : public toTool
+{
+    protected:
+        virtual const char **pictureXPM(void)
+        {
+            return const_cast<const char**>(fileopen_xpm);
+        }
+    public:
+        toImportTool()
+            : toTool(315, "Data Import")
+        { }
+        virtual const char *menuItem()
+        {
+            return "Data Import";
+        }
+        virtual toToolWidget *toolWindow(QWidget *parent, toConnection &connection)
+        {
+            return new toImport(parent, connection);
+        }
+        virtual void closeWindow(toConnection &connection) {};
+};
+
+static toImportTool ImportTool;
+
+toImportCsv::toImportCsv(QChar delimiter, QChar quote)
+    : Delimiter(delimiter)
+    , Quote(quote)
+    , InQuotes(false)
+{
+}
+
+bool toImportCsv::addLine(QString const& line)
+{
+    for (int i = 0; i < line.size(); i++)
+    {
+        QChar c = line.at(i);
+        if (InQuotes)
+        {
+            if (c != Quote)
+                Current += c;
+            else if (i + 1 < line.size() && line.at(i + 1) == Quote)
+                Current += line.at(++i); // doubled quote
+            else
+                InQuotes = false;
+        }
+        else if (c == Delimiter)
+        {
+            Fields << Current;
+            Current.clear();
+        }
+        else if (c == Quote && !Quote.isNull())
+            InQuotes = true;
+        else
+            Current += c;
+    }
+
+    if (InQuotes)
+    {
+        // quoted field continues on the next line
+        Current += QChar('\n');
+        return false;
+    }
+    Fields << Current;
+    Current.clear();
+    return true;
+}
+
+QStringList toImportCsv::record(void)
+{
+    QStringList retval(Fields);
+    Fields.clear();
+    return retval;
+}
+
+toImportParser::toImportParser(QString const& filename, QChar delimiter, QChar quote, int skipLines, int batchSize, toImportQueue &queue)
+    : QThread(NULL)
+    , Filename(filename)
+    , Delimiter(delimiter)
+    , Quote(quote)
+    , SkipLines(skipLines)
+    , BatchSize(batchSize)
+    , Queue(queue)
+{
+}
+
+void toImportParser::run(void)
+{
+    Utils::toSetThreadName(*this);
+
+    QFile file(Filename);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        emit failed(tr("Couldn't open %1 for reading").arg(Filename));
+        Queue.finish();
+        return;
+    }
+
+    toImportCsv csv(Delimiter, Quote);
+    toImportBatch batch;
+    qint64 bytes = 0;
+    int lineNo = 0, first = 0;
+    while (!file.atEnd())
+    {
+        QByteArray raw = file.readLine();
+        bytes += raw.size();
+        if (++lineNo <= SkipLines)
+            continue;
+
+        QString line = QString::fromUtf8(raw);
+        while (line.endsWith(QChar('\n')) || line.endsWith(QChar('\r')))
+            line.chop(1);
+        if (!csv.pending())
+        {
+            if (line.isEmpty())
+                continue;
+            first = lineNo;
+        }
+        if (!csv.addLine(line))
+            continue;
+
+        batch.Lines << first;
+        batch.Records << csv.record();
+        if (batch.Records.size() >= BatchSize)
+        {
+            batch.Bytes = bytes;
+            if (!Queue.push(batch))
+                return; // cancelled
+            batch = toImportBatch();
+        }
+    }
+
+    if (csv.pending())
+    {
+        // unterminated quoted field, pass the rest of the file as the last record
+        batch.Lines << first;
+        batch.Records << csv.record();
+    }
+    if (!batch.Records.isEmpty())
+    {
+        batch.Bytes = bytes;
+        Queue.push(batch);
+    }
+    Queue.finish();
+}
+
+toImportLoader::toImportLoader(QSharedPointer<toConnectionSubLoan> conn, QString const& sql, QList<int> const& mapping, bool commitBatch, toImportQueue &queue)
+    : QThread(NULL)
+    , Connection(conn)
+    , SQL(sql)
+    , Mapping(mapping)
+    , CommitBatch(commitBatch)
+    , Queue(queue)
+    , BulkBuffer(0)
+    , BulkBinary(false)
+{
+}
+
+void toImportLoader::setBulkLoad(QString const& table, QStringList const& columns, int bufferSize, bool binary)
+{
+    BulkTable = table;
+    BulkColumns = columns;
+    BulkBuffer = bufferSize;
+    BulkBinary = binary;
+}
+
+toQueryParams toImportLoader::values(QStringList const& record) const
+{
+    toQueryParams row;
+    Q_FOREACH(int col, Mapping)
+    {
+        // empty field is loaded as NULL
+        if (col < record.size() && !record.at(col).isEmpty())
+            row << toQValue(record.at(col));
+        else
+            row << toQValue();
+    }
+    return row;
+}
+
+void toImportLoader::bulkLoad(toBulkLoad &load)
+{
+    qint64 bytes = 0;
+    int loadedRows = 0;
+    toImportBatch batch;
+    while (Queue.pop(batch))
+    {
+        Q_FOREACH(QStringList const& record, batch.Records)
+            load.addRow(values(record));
+        loadedRows += batch.Records.size();
+        bytes = batch.Bytes;
+        emit progress(bytes, loadedRows, 0);
+    }
+
+    if (Queue.isCancelled())
+    {
+        load.abort(tr("Import cancelled"));
+        (*Connection)->rollback();
+        return;
+    }
+    loadedRows = load.finish();
+    (*Connection)->commit();
+    emit progress(bytes, loadedRows, 0);
+}
+
+void toImportLoader::run(void)
+{
+    Utils::toSetThreadName(*this);
+
+    int loadedRows = 0, rejectedRows = 0;
+    try
+    {
+        if (!BulkTable.isEmpty())
+        {
+            QScopedPointer<toBulkLoad> load((*Connection)->createBulkLoad(BulkTable, BulkColumns, BulkBuffer, BulkBinary));
+            if (load)
+            {
+                bulkLoad(*load);
+                return;
+            }
+            // not supported by the connection, use INSERT statements
+        }
+
+        toQueryBatch query(*Connection, SQL);
+        query.setCollectErrors(true);
+        query.init();
+
+        toImportBatch batch;
+        while (Queue.pop(batch))
+        {
+            QList<toQueryParams> rows;
+            Q_FOREACH(QStringList const& record, batch.Records)
+                rows << values(record);
+
+            // Rows failing on their own data are collected and reported, the rest of the batch is loaded.
+            // Other errors stop the execution on the failing row. Report it and continue with the next one.
+            int offset = 0;
+            while (offset < rows.size())
+            {
+                QString error;
+                int done = query.execute(offset ? rows.mid(offset) : rows, error);
+                QList<queryImpl::BatchError> errors = query.errors();
+                Q_FOREACH(queryImpl::BatchError const& err, errors)
+                {
+                    rejectedRows++;
+                    emit rejected(batch.Lines.at(offset + err.Row), err.Message, batch.Records.at(offset + err.Row));
+                }
+                loadedRows += done - errors.size();
+                offset += done;
+                if (offset < rows.size())
+                {
+                    rejectedRows++;
+                    emit rejected(batch.Lines.at(offset), error, batch.Records.at(offset));
+                    offset++;
+                }
+            }
+
+            if (CommitBatch)
+                (*Connection)->commit();
+            emit progress(batch.Bytes, loadedRows, rejectedRows);
+        }
+
+        if (Queue.isCancelled())
+            (*Connection)->rollback();
+        else
+            (*Connection)->commit();
+    }
+    catch (QString const& str)
+    {
+        fail(str);
+    }
+    catch (std::exception const& e)
+    {
+        // nothing may escape QThread::run
+        fail(QString::fromUtf8(e.what()));
+    }
+    catch (...)
+    {
+        fail(tr("Unknown error while loading the data"));
+    }
+}
+
+void toImportLoader::fail(QString const& error)
+{
+    Queue.cancel();
+    emit failed(error);
+    try
+    {
+        (*Connection)->rollback();
+    }
+    catch (...)
+    {
+        TLOG(1, toDecorator, __HERE__) << "	Ignored exception." << std::endl;
+    }
+}
+
+toImport::toImport(QWidget *parent, toConnection &connection)
+    : toToolWidget(ImportTool, "import.html", parent, connection, "toImport")
+    , Queue(NULL)
+    , Parser(NULL)
+    , Loader(NULL)
+    , FileSize(0)
+    , Loaded(0)
+    , Rejected(0)
+{
+    QToolBar *toolbar = Utils::toAllocBar(this, tr("Data Import"));
+    layout()->addWidget(toolbar);
+
+    StartAct = toolbar->addAction(QIcon(QPixmap(execute_xpm)),
+                                  tr("Start import"),
+                                  this,
+                                  SLOT(slotStart()));
+    StopAct = toolbar->addAction(QIcon(QPixmap(stop_xpm)),
+                                 tr("Stop import"),
+                                 this,
+                                 SLOT(slotStop()));
+    StopAct->setEnabled(false);
+    toolbar->addSeparator();
+    SaveAct = toolbar->addAction(tr("Save rejected rows"),
+                                 this,
+                                 SLOT(slotSaveRejected()));
+    SaveAct->setEnabled(false);
+    toolbar->addWidget(new Utils::toSpacer());
+
+    QWidget *settings = new QWidget(this);
+    QFormLayout *form = new QFormLayout(settings);
+
+    QHBoxLayout *fileBox = new QHBoxLayout;
+    File = new QLineEdit(settings);
+    fileBox->addWidget(File);
+    QPushButton *browse = new QPushButton(QIcon(QPixmap(fileopen_xpm)), QString(), settings);
+    connect(browse, SIGNAL(clicked()), this, SLOT(slotBrowse()));
+    fileBox->addWidget(browse);
+    form->addRow(tr("&File"), fileBox);
+
+    Delimiter = new QComboBox(settings);
+    Delimiter->setEditable(true);
+    Delimiter->addItems(QStringList() << QString::fromLatin1(",") << QString::fromLatin1(";") << tr("Tab") << QString::fromLatin1("|"));
+    form->addRow(tr("&Delimiter"), Delimiter);
+
+    Quote = new QLineEdit(QString::fromLatin1("\""), settings);
+    Quote->setMaxLength(1);
+    form->addRow(tr("&Quote character"), Quote);
+
+    Header = new QCheckBox(tr("First line contains column names"), settings);
+    Header->setChecked(true);
+    form->addRow(QString(), Header);
+
+    QHBoxLayout *tableBox = new QHBoxLayout;
+    Table = new QLineEdit(settings);
+    tableBox->addWidget(Table);
+    QPushButton *describe = new QPushButton(tr("&Map columns"), settings);
+    connect(describe, SIGNAL(clicked()), this, SLOT(slotDescribe()));
+    tableBox->addWidget(describe);
+    form->addRow(tr("&Target table"), tableBox);
+
+    BatchSize = new QSpinBox(settings);
+    BatchSize->setRange(1, 10000);
+    BatchSize->setValue(500);
+    BatchSize->setToolTip(tr("Number of rows sent to the database in a single round trip"));
+    form->addRow(tr("&Batch size"), BatchSize);
+
+    CommitBatch = new QCheckBox(tr("Commit after each batch"), settings);
+    form->addRow(QString(), CommitBatch);
+
+    Method = new QComboBox(settings);
+    Method->addItem(tr("INSERT statements"));
+    if (connection.providerIs("QPSQL"))
+    {
+        Method->addItem(tr("COPY, text format"));
+        Method->addItem(tr("COPY, binary format"));
+    }
+    Method->setToolTip(tr("COPY is loaded all or nothing, a row with bad data fails the whole import"));
+    Method->setEnabled(Method->count() > 1);
+    form->addRow(tr("&Load method"), Method);
+
+    CopyBuffer = new QSpinBox(settings);
+    CopyBuffer->setRange(64, 65536);
+    CopyBuffer->setValue(1024);
+    CopyBuffer->setSuffix(tr(" kB"));
+    CopyBuffer->setToolTip(tr("Amount of data collected before it is sent to the database by COPY"));
+    CopyBuffer->setEnabled(Method->isEnabled());
+    form->addRow(tr("COPY b&uffer"), CopyBuffer);
+
+    QSplitter *splitter = new QSplitter(Qt::Vertical, this);
+    splitter->addWidget(settings);
+
+    Mapping = new QTableWidget(0, 2, splitter);
+    Mapping->setHorizontalHeaderLabels(QStringList() << tr("Table column") << tr("File column"));
+    Mapping->horizontalHeader()->setStretchLastSection(true);
+    splitter->addWidget(Mapping);
+
+    Errors = new QTableWidget(0, 3, splitter);
+    Errors->setHorizontalHeaderLabels(QStringList() << tr("Line") << tr("Error") << tr("Record"));
+    Errors->horizontalHeader()->setStretchLastSection(true);
+    Errors->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    splitter->addWidget(Errors);
+    layout()->addWidget(splitter);
+
+    Progress = new QProgressBar(this);
+    Progress->setRange(0, 1000);
+    Progress->setValue(0);
+    layout()->addWidget(Progress);
+    Status = new QLabel(this);
+    layout()->addWidget(Status);
+}
+
+toImport::~toImport()
+{
+    if (Queue)
+    {
+        Queue->cancel();
+        Parser->wait();
+        Loader->wait();
+        slotFinished();
+    }
+}
+
+QChar toImport::delimiter(void) const
+{
+    QString text = Delimiter->currentText();
+    if (text == tr("Tab"))
+        return QChar('\t');
+    return text.isEmpty() ? QChar(',') : text.at(0);
+}
+
+QChar toImport::quote(void) const
+{
+    QString text = Quote->text();
+    return text.isEmpty() ? QChar() : text.at(0);
+}
+
+void toImport::slotBrowse(void)
+{
+    QString filename = Utils::toOpenFilename(File->text(), QString::fromLatin1("*.csv *.txt"), this);
+    if (!filename.isEmpty())
+        File->setText(filename);
+}
+
+QStringList toImport::fileColumns(void)
+{
+    QFile file(File->text());
+    if (!file.open(QIODevice::ReadOnly))
+        throw tr("Couldn't open %1 for reading").arg(File->text());
+
+    toImportCsv csv(delimiter(), quote());
+    QStringList record;
+    while (!file.atEnd())
+    {
+        QString line = QString::fromUtf8(file.readLine());
+        while (line.endsWith(QChar('\n')) || line.endsWith(QChar('\r')))
+            line.chop(1);
+        if (csv.addLine(line))
+        {
+            record = csv.record();
+            break;
+        }
+    }
+
+    if (Header->isChecked())
+        return record;
+
+    QStringList retval;
+    for (int i = 1; i <= record.size(); i++)
+        retval << tr("Column %1").arg(i);
+    return retval;
+}
+
+void toImport::slotDescribe(void)
+{
+    try
+    {
+        QString table = Table->text().trimmed();
+        if (table.isEmpty())
+            throw tr("No target table given");
+        QStringList fileCols = fileColumns();
+
+        toQColumnDescriptionList desc;
+        {
+            toConnectionSubLoan conn(connection());
+            toQuery query(conn, QString::fromLatin1("SELECT * FROM %1 WHERE 1=0").arg(table), toQueryParams());
+            desc = query.describe();
+        }
+
+        Mapping->setRowCount(0);
+        int row = 0;
+        for (toQColumnDescriptionList::iterator i = desc.begin(); i != desc.end(); i++, row++)
+        {
+            Mapping->insertRow(row);
+            QTableWidgetItem *item = new QTableWidgetItem((*i).Name);
+            item->setFlags(item->flags() & ~Qt::ItemIsEditable);
+            Mapping->setItem(row, 0, item);
+
+            QComboBox *combo = new QComboBox(Mapping);
+            combo->addItem(tr("(skip)"));
+            combo->addItems(fileCols);
+            // match by name when file has header, by position otherwise
+            int match = -1;
+            if (Header->isChecked())
+            {
+                for (int j = 0; j < fileCols.size() && match < 0; j++)
+                    if (fileCols.at(j).trimmed().compare((*i).Name, Qt::CaseInsensitive) == 0)
+                        match = j;
+            }
+            else if (row < fileCols.size())
+                match = row;
+            combo->setCurrentIndex(match + 1);
+            Mapping->setCellWidget(row, 1, combo);
+        }
+        Mapping->resizeColumnToContents(0);
+    }
+    TOCATCH;
+}
+
+QString toImport::insertStatement(QStringList const& columns, int batchSize) const
+{
+    toConnectionTraits const& traits = connection().getTraits();
+    // trotl needs the size of array bind variables declared in the statement
+    bool arrayBinds = connection().providerIs("Oracle");
+
+    QStringList cols, binds;
+    for (int i = 0; i < columns.size(); i++)
+    {
+        cols << traits.quote(columns.at(i));
+        if (arrayBinds)
+            binds << QString::fromLatin1(":c%1<char[4000],in[%2]>").arg(i + 1).arg(batchSize);
+        else
+            binds << QString::fromLatin1(":c%1").arg(i + 1);
+    }
+    return QString::fromLatin1("INSERT INTO %1 (%2) VALUES (%3)")
+           .arg(Table->text().trimmed())
+           .arg(cols.join(QString::fromLatin1(", ")))
+           .arg(binds.join(QString::fromLatin1(", ")));
+}
+
+void toImport::slotStart(void)
+{
+    if (Loader)
+        return;
+    try
+    {
+        QFileInfo info(File->text());
+        if (!info.isReadable())
+            throw tr("Couldn't open %1 for reading").arg(File->text());
+        if (Mapping->rowCount() == 0)
+            slotDescribe();
+
+        QStringList columns;
+        QList<int> mapping;
+        for (int row = 0; row < Mapping->rowCount(); row++)
+        {
+            QComboBox *combo = qobject_cast<QComboBox*>(Mapping->cellWidget(row, 1));
+            if (combo && combo->currentIndex() > 0)
+            {
+                columns << Mapping->item(row, 0)->text();
+                mapping << combo->currentIndex() - 1;
+            }
+        }
+        if (columns.isEmpty())
+            throw tr("No columns mapped to the target table");
+
+        int batchSize = BatchSize->value();
+        QString sql = insertStatement(columns, batchSize);
+
+        Errors->setRowCount(0);
+        RejectedRecords.clear();
+        SaveAct->setEnabled(false);
+        FileSize = qMax(info.size(), (qint64)1);
+        Loaded = Rejected = 0;
+        Progress->setValue(0);
+        Status->setText(tr("Loading..."));
+
+        Queue = new toImportQueue(4);
+        Parser = new toImportParser(File->text(), delimiter(), quote(), Header->isChecked() ? 1 : 0, batchSize, *Queue);
+        Loader = new toImportLoader(QSharedPointer<toConnectionSubLoan>(new toConnectionSubLoan(connection())),
+                                    sql,
+                                    mapping,
+                                    CommitBatch->isChecked(),
+                                    *Queue);
+        if (Method->currentIndex() > 0)
+        {
+            toConnectionTraits const& traits = connection().getTraits();
+            QStringList quoted;
+            Q_FOREACH(QString const& col, columns)
+                quoted << traits.quote(col);
+            Loader->setBulkLoad(Table->text().trimmed(), quoted, CopyBuffer->value() * 1024, Method->currentIndex() == 2);
+        }
+        connect(Parser, SIGNAL(failed(QString const&)), this, SLOT(slotFailed(QString const&)));
+        connect(Loader, SIGNAL(failed(QString const&)), this, SLOT(slotFailed(QString const&)));
+        connect(Loader, SIGNAL(progress(qint64, int, int)), this, SLOT(slotProgress(qint64, int, int)));
+        connect(Loader, SIGNAL(rejected(int, QString const&, QStringList const&)),
+                this, SLOT(slotRejected(int, QString const&, QStringList const&)));
+        connect(Loader, SIGNAL(finished()), this, SLOT(slotFinished()));
+
+        StartAct->setEnabled(false);
+        StopAct->setEnabled(true);
+        Parser->start();
+        Loader->start();
+    }
+    TOCATCH;
+}
+
+void toImport::slotStop(void)
+{
+    if (Queue)
+        Queue->cancel();
+}
+
+void toImport::slotProgress(qint64 bytes, int loaded, int rejected)
+{
+    Loaded = loaded;
+    Rejected = rejected;
+    Progress->setValue(bytes * 1000 / FileSize);
+    Status->setText(tr("%1 rows loaded, %2 rows rejected").arg(Loaded).arg(Rejected));
+}
+
+QString toImport::formatRecord(QStringList const& record) const
+{
+    QChar d = delimiter(), q = quote();
+    QStringList fields;
+    Q_FOREACH(QString field, record)
+    {
+        if (!q.isNull() && (field.contains(d) || field.contains(q) || field.contains(QChar('\n'))))
+        {
+            field.replace(q, QString(q) + q);
+            field = q + field + q;
+        }
+        fields << field;
+    }
+    return fields.join(d);
+}
+
+void toImport::slotRejected(int line, QString const& error, QStringList const& record)
+{
+    QString text = formatRecord(record);
+    RejectedRecords << text;
+
+    int row = Errors->rowCount();
+    Errors->insertRow(row);
+    Errors->setItem(row, 0, new QTableWidgetItem(QString::number(line)));
+    Errors->setItem(row, 1, new QTableWidgetItem(error.trimmed()));
+    Errors->setItem(row, 2, new QTableWidgetItem(text));
+}
+
+void toImport::slotSaveRejected(void)
+{
+    QString filename = Utils::toSaveFilename(QString(), QString::fromLatin1("*.csv"), this);
+    if (filename.isEmpty())
+        return;
+    Utils::toWriteFile(filename, RejectedRecords.join(QString::fromLatin1("\n")) + QString::fromLatin1("\n"));
+}
+
+void toImport::slotFailed(QString const& error)
+{
+    Utils::toStatusMessage(error);
+    Status->setText(error);
+}
+
+void toImport::slotFinished(void)
+{
+    if (!Loader)
+        return;
+
+    // loader has finished, parser is either done or waits in a cancelled queue
+    Queue->cancel();
+    Parser->wait();
+    Loader->wait();
+    delete Parser;
+    delete Loader;
+    delete Queue;
+    Parser = NULL;
+    Loader = NULL;
+    Queue = NULL;
+
+    StartAct->setEnabled(true);
+    StopAct->setEnabled(false);
+    SaveAct->setEnabled(!RejectedRecords.isEmpty());
+    Status->setText(tr("Import finished: %1 rows loaded, %2 rows rejected").arg(Loaded).arg(Rejected));
+    Utils::toStatusMessage(Status->text(), false, false);
+}
@@ -0,0 +1,192 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include "widgets/totoolwidget.h"
+#include "core/toqvalue.h"
+#include "core/toboundedqueue.h"
+
+#include <QtCore/QThread>
+#include <QtCore/QStringList>
+#include <QtCore/QSharedPointer>
+
+class QLineEdit;
+class QComboBox;
+class QCheckBox;
+class QSpinBox;
+class QTableWidget;
+class QProgressBar;
+class QLabel;
+class QAction;
+class toConnectionSubLoan;
+class toBulkLoad;
+
+/** Splits lines of a delimited text file into fields. Quoted fields can contain
+ *  delimiters, doubled quote characters and line breaks.
+ */
+class toImportCsv
+{
+    public:
+        toImportCsv(QChar delimiter, QChar quote);
+
+        /** Feed one physical line (without line end).
+         * @return true when a record is complete and can be taken by @ref record
+         */
+        bool addLine(QString const& line);
+
+        QStringList record(void);
+
+        /** True while inside of a quoted field spanning over multiple lines */
+        bool pending(void) const
+        {
+            return InQuotes;
+        }
+    private:
+        QChar Delimiter, Quote;
+        QStringList Fields;
+        QString Current;
+        bool InQuotes;
+};
+
+/** Chunk of parsed records passed from parser thread to the loader thread */
+struct toImportBatch
+{
+    QList<int> Lines;           // line number of the first line of each record
+    QList<QStringList> Records;
+    qint64 Bytes;               // file offset after the last record
+};
+
+/** Queue between parser and loader, memory usage does not depend on size of imported file */
+typedef toBoundedQueue<toImportBatch> toImportQueue;
+
+/** Reads the file and parses it into batches of records */
+class toImportParser : public QThread
+{
+        Q_OBJECT;
+    public:
+        toImportParser(QString const& filename, QChar delimiter, QChar quote, int skipLines, int batchSize, toImportQueue &queue);
+    signals:
+        void failed(QString const& error);
+    protected:
+        void run(void) override;
+    private:
+        QString Filename;
+        QChar Delimiter, Quote;
+        int SkipLines, BatchSize;
+        toImportQueue &Queue;
+};
+
+/** Loads batches of records into the target table using array binds (or bulk load, see @ref setBulkLoad) */
+class toImportLoader : public QThread
+{
+        Q_OBJECT;
+    public:
+        /**
+         * @param mapping index of the file column for every bind variable of @p sql
+         * @param commitBatch commit after each batch, otherwise only at the end of the import
+         */
+        toImportLoader(QSharedPointer<toConnectionSubLoan> conn, QString const& sql, QList<int> const& mapping, bool commitBatch, toImportQueue &queue);
+
+        /** Load using @ref toConnectionSub::createBulkLoad (COPY on PostgreSQL) instead of @p sql when the
+         *  connection supports it. The load is all or nothing, rows are not rejected one by one.
+         * @param columns quoted names of the loaded columns, in the order of the mapping
+         */
+        void setBulkLoad(QString const& table, QStringList const& columns, int bufferSize, bool binary);
+    signals:
+        void progress(qint64 bytes, int loaded, int rejected);
+        void rejected(int line, QString const& error, QStringList const& record);
+        void failed(QString const& error);
+    protected:
+        void run(void) override;
+    private:
+        /** Bind values of @p record according to the mapping */
+        toQueryParams values(QStringList const& record) const;
+        void bulkLoad(toBulkLoad &load);
+        /** Stop the load after an error, rolls back what was not committed yet */
+        void fail(QString const& error);
+
+        QSharedPointer<toConnectionSubLoan> Connection;
+        QString SQL;
+        QList<int> Mapping;
+        bool CommitBatch;
+        toImportQueue &Queue;
+        QString BulkTable;
+        QStringList BulkColumns;
+        int BulkBuffer;
+        bool BulkBinary;
+};
+
+class toImport : public toToolWidget
+{
+        Q_OBJECT;
+    public:
+        toImport(QWidget *parent, toConnection &connection);
+        virtual ~toImport();
+        virtual void slotWindowActivated(toToolWidget*) {};
+    private slots:
+        void slotBrowse(void);
+        void slotDescribe(void);
+        void slotStart(void);
+        void slotStop(void);
+        void slotProgress(qint64 bytes, int loaded, int rejected);
+        void slotRejected(int line, QString const& error, QStringList const& record);
+        void slotSaveRejected(void);
+        void slotFailed(QString const& error);
+        void slotFinished(void);
+    private:
+        QChar delimiter(void) const;
+        QChar quote(void) const;
+        /** Column names of the file, taken from the first line or numbered */
+        QStringList fileColumns(void);
+        QString insertStatement(QStringList const& columns, int batchSize) const;
+        /** Format a record as a line of the imported file */
+        QString formatRecord(QStringList const& record) const;
+
+        QLineEdit *File, *Table, *Quote;
+        QComboBox *Delimiter, *Method;
+        QCheckBox *Header, *CommitBatch;
+        QSpinBox *BatchSize, *CopyBuffer;
+        QTableWidget *Mapping, *Errors;
+        QProgressBar *Progress;
+        QLabel *Status;
+        QAction *StartAct, *StopAct, *SaveAct;
+
+        toImportQueue *Queue;
+        toImportParser *Parser;
+        toImportLoader *Loader;
+        qint64 FileSize;
+        int Loaded, Rejected;
+        QStringList RejectedRecords;
+};
@@ -39,6 +39,9 @@
 #include "core/utils.h"
 #include "core/toconfiguration.h"
 #include "core/toconnection.h"
+#include "core/toconnectionsub.h"
+#include "core/toconnectionsubloan.h"
+#include "core/toquery.h"
 #include "editor/tomodeleditor.h"
 #include "core/tomainwindow.h"
 #include "widgets/toresultlistformat.h"
@@ -50,6 +53,8 @@
 #include "core/todatabaseconfig.h"
 #include "core/tocontextmenu.h"
 
+#include <QtCore/QFile>
+#include <QtCore/QScopedPointer>
 #include <QtCore/QSize>
 #include <QtCore/QTimer>
 #include <QtCore/QtDebug>
@@ -109,6 +114,7 @@ void toResultTableView::setup(bool readable, bool numberColumn, bool editable)
 {
     Statistics      = NULL;
     ReadAll         = false;
+    FetchSize       = 0;
     Filter          = NULL;
     VisibleColumns  = 0;
     ReadableColumns = readable;
@@ -173,6 +179,7 @@ toResultTableView::~toResultTableView()
 void toResultTableView::query(const QString &sql, toQueryParams const& param)
 {
     setSqlAndParams(sql, param);
+    QuerySchema.clear();
 
     TLOG(7, toDecorator, __HERE__) << "Query from toResultTableView::query :" << sql << std::endl;
     try
@@ -198,6 +205,9 @@ void toResultTableView::query(const QString &sql, toQueryParams const& param)
                                                //, Statistics
                                               );
 
+        if (FetchSize)
+            query->setFetchSize(FetchSize);
+
         toResultModel *model = allocModel(query);
         setModel(model);
 
@@ -237,6 +247,7 @@ void toResultTableView::query(const QString &sql, toQueryParams const& param)
 void toResultTableView::querySub(QSharedPointer<toConnectionSubLoan> &con, const QString &sql, toQueryParams const& param)
 {
     setSqlAndParams(sql, param);
+    QuerySchema = con->Schema.isEmpty() ? (*con)->schema() : con->Schema;
 
     TLOG(7, toDecorator, __HERE__) << "Query from toResultTableView::querySub :" << sql << std::endl;
     try
@@ -263,6 +274,9 @@ void toResultTableView::querySub(QSharedPointer<toConnectionSubLoan> &con, const
                                                //, Statistics
                                               );
 
+        if (FetchSize)
+            query->setFetchSize(FetchSize);
+
         toResultModel *model = allocModel(query);
         setModel(model);
 
@@ -553,12 +567,16 @@ void toResultTableView::slotMenuCallback(QAction *action)
         editSave(false);
     else if (action == copyFormatAct)
     {
-        toResultListFormat exp(this, toResultListFormat::TypeCopy);
-        if (!exp.exec())
-            return;
-        QString t = exportAsText(exp.exportSettings());
-        QClipboard *clip = qApp->clipboard();
-        clip->setText(t);
+        try
+        {
+            toResultListFormat exp(this, toResultListFormat::TypeCopy);
+            if (!exp.exec())
+                return;
+            QString t = exportAsText(exp.exportSettings());
+            QClipboard *clip = qApp->clipboard();
+            clip->setText(t);
+        }
+        TOCATCH;
     }
 }
 
@@ -667,7 +685,7 @@ QModelIndex toResultTableView::selectedIndex(int col)
 }
 
 
-QString toResultTableView::exportAsText(toExportSettings settings)
+void toResultTableView::prepareExport(toExportSettings &settings)
 {
     if (settings.requireSelection())
         settings.selected = selectedIndexes();
@@ -696,6 +714,44 @@ QString toResultTableView::exportAsText(toExportSettings settings)
         this->setEnabled(true);
         progress.setValue(2);
     }
+}
+
+bool toResultTableView::exportDirect(toExportSettings const& settings, QString const& filename)
+{
+    // Binds can not be used in COPY
+    if (!settings.directCsv
+            || settings.type != toListViewFormatterIdentifier::CSV
+            || settings.rowsExport != toExportSettings::RowsAll
+            || settings.columnsExport != toExportSettings::ColumnsAll
+            || settings.rowsHeader
+            || settings.separator.size() != 1
+            || settings.delimiter.size() != 1
+            || sql().isEmpty()
+            || !params().empty())
+        return false;
+
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    QScopedPointer<toConnectionSubLoan> loan(QuerySchema.isEmpty()
+            ? new toConnectionSubLoan(connection())
+            : new toConnectionSubLoan(connection(), QuerySchema));
+    toConnectionSubLoan &conn = *loan;
+    toQuerySession session(conn, sql());
+    qint64 bytes = conn->exportCsv(sql(), settings.separator.at(0), settings.delimiter.at(0), settings.columnsHeader, file);
+    if (bytes < 0)
+    {
+        file.remove();
+        return false;
+    }
+    Utils::toStatusMessage(tr("Exported %1 bytes to %2").arg(bytes).arg(filename), false, false);
+    return true;
+}
+
+QString toResultTableView::exportAsText(toExportSettings settings)
+{
+    prepareExport(settings);
 
     std::unique_ptr<toListViewFormatter> pFormatter(toListViewFormatterFactory::Instance().CreateObject(settings.type));
     // TODO WTF? Owner and Table are now defined in the sub-class toResultTableViewEdit
@@ -704,6 +760,14 @@ QString toResultTableView::exportAsText(toExportSettings settings)
     return pFormatter->getFormattedString(settings, model());
 }
 
+QByteArray toResultTableView::exportAsData(toExportSettings settings)
+{
+    prepareExport(settings);
+
+    std::unique_ptr<toListViewFormatter> pFormatter(toListViewFormatterFactory::Instance().CreateObject(settings.type));
+    return pFormatter->getFormattedData(settings, model());
+}
+
 // ---------------------------------------- overrides toEditWidget
 
 bool toResultTableView::editSave(bool askfile)
@@ -720,6 +784,14 @@ bool toResultTableView::editSave(bool askfile)
         if (filename.isEmpty())
             return false;
 
+        if (exportDirect(settings, filename))
+            return true;
+        if (settings.directCsv)
+            Utils::toStatusMessage(tr("The database can not write this CSV, it is exported from the grid"), false, false);
+
+        std::unique_ptr<toListViewFormatter> pFormatter(toListViewFormatterFactory::Instance().CreateObject(settings.type));
+        if (pFormatter->isBinary())
+            return Utils::toWriteFileB(filename, exportAsData(settings));
         return Utils::toWriteFile(filename, exportAsText(settings));
     }
     TOCATCH;
@@ -736,20 +808,24 @@ void toResultTableView::editPrint()
 void toResultTableView::editCopy()
 {
     QClipboard *clip = qApp->clipboard();
-    QMimeData *md = new QMimeData();
     // if there's a selection, then export as text to clipboard
     QModelIndexList sel = selectedIndexes();
     if (sel.size() > 1)
     {
-        toExportSettings settings = toResultListFormat::plaintextCopySettings();
-        settings.selected = sel;
-        md->setText(exportAsText(settings));
-        md->setData("application/x-tora", QByteArray(Utils::ptr2str(this).c_str())); // store pointer to self in clipboard see tobindvar.cpp insertFromMimeData
+        try
+        {
+            toExportSettings settings = toResultListFormat::plaintextCopySettings();
+            settings.selected = sel;
+            std::unique_ptr<QMimeData> md(new QMimeData());
+            md->setText(exportAsText(settings));
+            md->setData("application/x-tora", QByteArray(Utils::ptr2str(this).c_str())); // store pointer to self in clipboard see tobindvar.cpp insertFromMimeData
 #ifdef Q_OS_WIN32
-        std::unique_ptr<toListViewFormatter> pFormatter(toListViewFormatterFactory::Instance().CreateObject(toListViewFormatterIdentifier::XLSX));
-        md->setData("XML Spreadsheet", pFormatter->getFormattedString(settings, model()).toUtf8());
+            std::unique_ptr<toListViewFormatter> pFormatter(toListViewFormatterFactory::Instance().CreateObject(toListViewFormatterIdentifier::XLSX));
+            md->setData("XML Spreadsheet", pFormatter->getFormattedString(settings, model()).toUtf8());
 #endif
-        clip->setMimeData(md, QClipboard::Clipboard);
+            clip->setMimeData(md.release(), QClipboard::Clipboard);
+        }
+        TOCATCH;
     }
     else
     {
@@ -159,6 +159,14 @@ class toResultTableView : public QTableView, public toResult, public toEditWidge
             ReadAll = b;
         }
 
+        /**
+         * Rows fetched in one round-trip by following queries, 0 uses database setting.
+         */
+        void setFetchSize(unsigned rows)
+        {
+            FetchSize = rows;
+        }
+
         /**
          * Convenience function to determine if the row indicated by index
          * is selected. Disregards column information.
@@ -177,6 +185,11 @@ class toResultTableView : public QTableView, public toResult, public toEditWidge
          * Export list as a string.
          */
         QString exportAsText(toExportSettings settings);
+
+        /**
+         * Export list as raw data, used by binary formats (see toListViewFormatter::isBinary).
+         */
+        QByteArray exportAsData(toExportSettings settings);
         // ----- overrides toEditWidget
         /**
          * Perform a save on this widget.
@@ -303,6 +316,17 @@ class toResultTableView : public QTableView, public toResult, public toEditWidge
         */
         void setup(bool readable, bool numberColumn, bool editable);
 
+        /*! \brief Fill in selection and fetch all the rows if the export requires them
+        */
+        void prepareExport(toExportSettings &settings);
+
+        /*! \brief Export all rows as CSV written by the database itself (COPY on PostgreSQL), when
+            requested by toExportSettings::directCsv. The query runs again on another session prepared
+            like the one of the grid (schema, init strings), values are in the text format of the database.
+            Returns false when not possible and the export has to be done from the model.
+        */
+        bool exportDirect(toExportSettings const& settings, QString const& filename);
+
         /**
          * overridden from parent.
          *
@@ -352,6 +376,9 @@ class toResultTableView : public QTableView, public toResult, public toEditWidge
         // if all records should be read
         bool ReadAll;
 
+        // rows per round-trip, 0 = database setting
+        unsigned FetchSize;
+
         // if column headers should be modified to be readable
         bool ReadableColumns;
 
@@ -377,6 +404,9 @@ class toResultTableView : public QTableView, public toResult, public toEditWidge
         // helps work around determining when query.eof has been reached.
         bool Finished;
 
+        // schema of the session running the query, empty for the default one
+        QString QuerySchema;
+
         /**
          * context menu items. may be null
          */
@@ -163,6 +163,13 @@ void toResultTableViewEdit::keyPressEvent(QKeyEvent * event)
         deleteRecord();
         return;
     }
+    if (event->matches(QKeySequence::Paste) && editModel())
+    {
+        QModelIndex ind = selectionModel() ? selectionModel()->currentIndex() : QModelIndex();
+        if (ind.isValid())
+            editModel()->pasteText(ind, QApplication::clipboard()->text());
+        return;
+    }
     toResultTableView::keyPressEvent(event);
 }
 
@@ -116,7 +116,7 @@ class toResultTableViewEdit : public toResultTableView
 
     protected:
         /**
-         * Reimplemented to handle delete key
+         * Reimplemented to handle delete and paste keys
          */
         virtual void keyPressEvent(QKeyEvent * event);
 
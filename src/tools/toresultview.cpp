@@ -1008,6 +1008,8 @@ bool toListView::editSave(bool)
             return false;
         std::unique_ptr<toListViewFormatter> pFormatter(
             toListViewFormatterFactory::Instance().CreateObject(settings.type));
+        if (pFormatter->isBinary())
+            return Utils::toWriteFileB(filename, exportAsData(settings));
         return Utils::toWriteFile(filename, exportAsText(settings));
     }
     TOCATCH
@@ -1078,6 +1080,18 @@ QString toListView::exportAsText(toExportSettings settings)
     return pFormatter->getFormattedString(settings, model());
 }
 
+QByteArray toListView::exportAsData(toExportSettings settings)
+{
+    if (settings.requireSelection())
+        settings.selected = selectedIndexes();
+
+    while (settings.rowsExport == toExportSettings::RowsAll && model()->canFetchMore(currentIndex()))
+        model()->fetchMore(currentIndex());
+
+    std::unique_ptr<toListViewFormatter> pFormatter(toListViewFormatterFactory::Instance().CreateObject(settings.type));
+    return pFormatter->getFormattedData(settings, model());
+}
+
 #ifdef TORA3_SESSION
 void toListView::exportData(std::map<QString, QString> &ret, const QString &prefix)
 {
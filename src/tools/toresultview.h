@@ -666,6 +666,9 @@ class toListView : public toTreeWidget, public toEditWidget
         /** Export list as a string.
          */
         virtual QString exportAsText(toExportSettings settings);
+        /** Export list as raw data (binary formats).
+         */
+        virtual QByteArray exportAsData(toExportSettings settings);
         /** Export list as file.
          */
         virtual bool editSave(bool ask);
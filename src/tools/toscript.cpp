@@ -219,6 +219,8 @@ toScript::toScript(QWidget *parent, toConnection &connection)
     ScriptUI->IncludeHeader->setChecked(s.value("IncludeHeader", true).toBool());
     ScriptUI->IncludeContent->setChecked(s.value("IncludeContent", false).toBool());
     ScriptUI->CommitDistance->setValue(s.value("CommitDistance", 0).toInt());
+    ScriptUI->InsertStyle->setCurrentIndex(s.value("InsertStyle", 0).toInt());
+    ScriptUI->InsertBatchRows->setValue(s.value("InsertBatchRows", 100).toInt());
     ScriptUI->Schema->setEditText(s.value("Schema", "Same").toString());
     // target
     ScriptUI->OutputTab->setChecked(s.value("OutputTab", true).toBool());
@@ -259,6 +261,8 @@ void toScript::closeEvent(QCloseEvent *event)
         s.setValue("IncludeHeader", ScriptUI->IncludeHeader->isChecked());
         s.setValue("IncludeContent", ScriptUI->IncludeContent->isChecked());
         s.setValue("CommitDistance", ScriptUI->CommitDistance->value());
+        s.setValue("InsertStyle", ScriptUI->InsertStyle->currentIndex());
+        s.setValue("InsertBatchRows", ScriptUI->InsertBatchRows->value());
         s.setValue("Schema", ScriptUI->Schema->currentText());
         // target
         s.setValue("OutputTab", ScriptUI->OutputTab->isChecked());
@@ -670,6 +674,8 @@ void toScript::changeMode(int mode)
 
     ScriptUI->IncludeContent->setEnabled(mode == MODE_EXTRACT);
     ScriptUI->CommitDistance->setEnabled(mode == MODE_EXTRACT);
+    ScriptUI->InsertStyle->setEnabled(mode == MODE_EXTRACT);
+    ScriptUI->InsertBatchRows->setEnabled(mode == MODE_EXTRACT);
 
     if (mode == MODE_EXTRACT)
     {
@@ -726,6 +732,8 @@ void toScript::setupExtract(toExtract &extr)
     extr.setContents (ScriptUI->IncludeContent->isEnabled() &&
                       ScriptUI->IncludeContent->isChecked() ,
                       ScriptUI->CommitDistance->value() );
+    extr.setInsertStyle(ScriptUI->InsertStyle->currentIndex(),
+                        ScriptUI->InsertBatchRows->value());
     extr.setGrants (ScriptUI->IncludeGrants->isEnabled() &&
                     ScriptUI->IncludeGrants->isChecked() );
     extr.setHeading (ScriptUI->IncludeHeader->isEnabled() &&
@@ -0,0 +1,827 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "tools/totablecopy.h"
+#include "core/utils.h"
+#include "core/totool.h"
+#include "core/toquery.h"
+#include "core/tosql.h"
+#include "core/toconnection.h"
+#include "core/toconnectionsub.h"
+#include "core/toconnectionsubloan.h"
+#include "core/toconnectiontraits.h"
+#include "core/toconnectionregistry.h"
+#include "core/toconnectionoptions.h"
+#include "core/tologger.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QScopedPointer>
+#include <QAction>
+#include <QCheckBox>
+#include <QComboBox>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QSplitter>
+#include <QTableWidget>
+#include <QToolBar>
+
+#include "icons/copy.xpm"
+#include "icons/execute.xpm"
+#include "icons/fileopen.xpm"
+#include "icons/stop.xpm"
+
+// Data sent by one COPY before it is committed is limited by the commit interval, not by this
+#define BULK_BUFFER_SIZE (1024 * 1024)
+
+class toTableCopyTool : public toTool
+{
+    protected:
+        virtual const char **pictureXPM(void)
+        {
+            return const_cast<const char**>(copy_xpm);
+        }
+    public:
+        toTableCopyTool()
+            : toTool(317, "Table Copy")
+        { }
+        virtual const char *menuItem()
+        {
+            return "Table Copy";
+        }
+        virtual toToolWidget *toolWindow(QWidget *parent, toConnection &connection)
+        {
+            return new toTableCopy(parent, connection);
+        }
+        virtual void closeWindow(toConnection &connection) {};
+};
+
+static toTableCopyTool TableCopyTool;
+
+// Counts the column when it alone is the primary key, a unique constraint or a unique index of the table
+static toSQL SQLUniqueKey("toTableCopy:UniqueKey",
+                          "SELECT COUNT(*)\n"
+                          "  FROM sys.all_tab_columns t\n"
+                          " WHERE t.owner = :own<char[129]>\n"
+                          "   AND t.table_name = :tab<char[129]>\n"
+                          "   AND t.column_name = :col<char[129]>\n"
+                          "   AND (EXISTS (SELECT 1\n"
+                          "                  FROM sys.all_constraints c, sys.all_cons_columns cc\n"
+                          "                 WHERE c.owner = t.owner\n"
+                          "                   AND c.table_name = t.table_name\n"
+                          "                   AND c.constraint_type IN ('P', 'U')\n"
+                          "                   AND c.status = 'ENABLED'\n"
+                          "                   AND cc.owner = c.owner\n"
+                          "                   AND cc.constraint_name = c.constraint_name\n"
+                          "                 GROUP BY c.constraint_name\n"
+                          "                HAVING COUNT(*) = 1 AND MAX(cc.column_name) = t.column_name)\n"
+                          "        OR EXISTS (SELECT 1\n"
+                          "                     FROM sys.all_indexes i, sys.all_ind_columns ic\n"
+                          "                    WHERE i.table_owner = t.owner\n"
+                          "                      AND i.table_name = t.table_name\n"
+                          "                      AND i.uniqueness = 'UNIQUE'\n"
+                          "                      AND ic.index_owner = i.owner\n"
+                          "                      AND ic.index_name = i.index_name\n"
+                          "                    GROUP BY i.owner, i.index_name\n"
+                          "                   HAVING COUNT(*) = 1 AND MAX(ic.column_name) = t.column_name))",
+                          "Non zero when the column alone is a unique key of the table, takes owner, table and column",
+                          "",
+                          "Oracle");
+
+static toSQL SQLUniqueKeyPG("toTableCopy:UniqueKey",
+                            "SELECT COUNT(*)\n"
+                            "  FROM pg_index i, pg_class c, pg_namespace n, pg_attribute a\n"
+                            " WHERE n.nspname = :f1\n"
+                            "   AND c.relname = :f2\n"
+                            "   AND c.relnamespace = n.oid\n"
+                            "   AND i.indrelid = c.oid\n"
+                            "   AND i.indisunique\n"
+                            "   AND i.indnatts = 1\n"
+                            "   AND i.indpred IS NULL\n"
+                            "   AND a.attrelid = c.oid\n"
+                            "   AND a.attnum = i.indkey[0]\n"
+                            "   AND a.attname = :f3",
+                            "",
+                            "",
+                            "QPSQL");
+
+static toSQL SQLUniqueKeyMySQL("toTableCopy:UniqueKey",
+                               "SELECT COUNT(*)\n"
+                               "  FROM information_schema.statistics s\n"
+                               " WHERE s.table_schema = :f1<char[129]>\n"
+                               "   AND s.table_name = :f2<char[129]>\n"
+                               "   AND s.column_name = :f3<char[129]>\n"
+                               "   AND s.non_unique = 0\n"
+                               "   AND NOT EXISTS (SELECT 1\n"
+                               "                     FROM information_schema.statistics s2\n"
+                               "                    WHERE s2.table_schema = s.table_schema\n"
+                               "                      AND s2.table_name = s.table_name\n"
+                               "                      AND s2.index_name = s.index_name\n"
+                               "                      AND s2.seq_in_index > 1)",
+                               "",
+                               "0500",
+                               "QMYSQL");
+
+toTableCopyReader::toTableCopyReader(QSharedPointer<toConnectionSubLoan> conn, QString const& sql, int keyColumn, int batchSize, toTableCopyQueue &queue)
+    : QThread(NULL)
+    , Connection(conn)
+    , SQL(sql)
+    , KeyColumn(keyColumn)
+    , BatchSize(batchSize)
+    , Queue(queue)
+{
+}
+
+void toTableCopyReader::run(void)
+{
+    Utils::toSetThreadName(*this);
+
+    try
+    {
+        toQuery query(*Connection, SQL, toQueryParams());
+        unsigned columns = query.columns();
+
+        toTableCopyBatch batch;
+        batch.LastKey = 0;
+        while (!query.eof())
+        {
+            toQueryParams row;
+            for (unsigned i = 0; i < columns; i++)
+                row << query.readValue();
+            if (KeyColumn >= 0 && !toTableCopyPartition::key(row.at(KeyColumn), batch.LastKey))
+                throw QString::fromLatin1("Key value \"%1\" is not an integer").arg((QString) row.at(KeyColumn));
+            batch.Rows << row;
+
+            if (batch.Rows.size() >= BatchSize)
+            {
+                if (!Queue.push(batch))
+                    return; // cancelled
+                batch.Rows.clear();
+            }
+        }
+        if (!batch.Rows.isEmpty() && !Queue.push(batch))
+            return;
+        Queue.finish();
+    }
+    catch (QString const& str)
+    {
+        Queue.cancel();
+        emit failed(str);
+    }
+}
+
+toTableCopyWriter::toTableCopyWriter(int index,
+                                     toTableCopyPartition const& partition,
+                                     QSharedPointer<toConnectionSubLoan> conn,
+                                     QString const& sql,
+                                     QString const& table,
+                                     QStringList const& columns,
+                                     int commitBatches,
+                                     toTableCopyQueue &queue,
+                                     toTableCopyCheckpoint *checkpoint)
+    : QThread(NULL)
+    , Index(index)
+    , Partition(partition)
+    , Connection(conn)
+    , SQL(sql)
+    , Table(table)
+    , Columns(columns)
+    , CommitBatches(commitBatches)
+    , Queue(queue)
+    , Checkpoint(checkpoint)
+{
+}
+
+void toTableCopyWriter::run(void)
+{
+    Utils::toSetThreadName(*this);
+
+    try
+    {
+        QScopedPointer<toBulkLoad> bulk;
+        QScopedPointer<toQueryBatch> insert;
+        bool useBulk = true;
+        int batches = 0;
+        toTableCopyCommitter committer(Index, Partition, Checkpoint);
+
+        toTableCopyBatch batch;
+        while (Queue.pop(batch))
+        {
+            if (useBulk && !bulk)
+            {
+                bulk.reset((*Connection)->createBulkLoad(Table, Columns, BULK_BUFFER_SIZE, true));
+                useBulk = !bulk.isNull();
+            }
+            if (bulk)
+            {
+                Q_FOREACH(toQueryParams const& row, batch.Rows)
+                    bulk->addRow(row);
+            }
+            else
+            {
+                if (!insert)
+                {
+                    insert.reset(new toQueryBatch(*Connection, SQL));
+                    insert->init();
+                }
+                QString error;
+                int done = insert->execute(batch.Rows, error);
+                if (done < batch.Rows.size())
+                    throw error;
+            }
+            committer.loaded(batch.Rows.size(), batch.LastKey);
+
+            if (++batches < CommitBatches)
+                continue;
+
+            if (bulk)
+            {
+                bulk->finish();
+                bulk.reset();
+            }
+            committer.commit([this]()
+            {
+                (*Connection)->commit();
+            }, false);
+            Partition = committer.partition();
+            emit progress(Index, Partition.Rows);
+            batches = 0;
+        }
+
+        if (Queue.isCancelled())
+        {
+            bulk.reset(); // aborts the load
+            (*Connection)->rollback();
+            return;
+        }
+
+        if (bulk)
+            bulk->finish();
+        committer.commit([this]()
+        {
+            (*Connection)->commit();
+        }, true);
+        Partition = committer.partition();
+        emit progress(Index, Partition.Rows);
+    }
+    catch (QString const& str)
+    {
+        Queue.cancel();
+        emit failed(str);
+        try
+        {
+            (*Connection)->rollback();
+        }
+        catch (...)
+        {
+            TLOG(1, toDecorator, __HERE__) << "	Ignored exception." << std::endl;
+        }
+    }
+}
+
+toTableCopy::toTableCopy(QWidget *parent, toConnection &connection)
+    : toToolWidget(TableCopyTool, "tablecopy.html", parent, connection, "toTableCopy")
+    , Checkpoint(NULL)
+    , Total(0)
+    , Running(0)
+{
+    QToolBar *toolbar = Utils::toAllocBar(this, tr("Table Copy"));
+    layout()->addWidget(toolbar);
+
+    StartAct = toolbar->addAction(QIcon(QPixmap(execute_xpm)),
+                                  tr("Start copy"),
+                                  this,
+                                  SLOT(slotStart()));
+    StopAct = toolbar->addAction(QIcon(QPixmap(stop_xpm)),
+                                 tr("Stop copy"),
+                                 this,
+                                 SLOT(slotStop()));
+    StopAct->setEnabled(false);
+    toolbar->addWidget(new Utils::toSpacer());
+
+    QWidget *settings = new QWidget(this);
+    QFormLayout *form = new QFormLayout(settings);
+
+    Source = new QLineEdit(settings);
+    form->addRow(tr("&Source table"), Source);
+
+    Filter = new QLineEdit(settings);
+    Filter->setToolTip(tr("Optional condition limiting the copied rows"));
+    form->addRow(tr("&Where"), Filter);
+
+    Destination = new QComboBox(settings);
+    Destination->setModel(&toConnectionRegistrySing::Instance());
+    form->addRow(tr("&Destination connection"), Destination);
+
+    Target = new QLineEdit(settings);
+    Target->setToolTip(tr("Same as the source table when empty"));
+    form->addRow(tr("&Target table"), Target);
+
+    Create = new QCheckBox(tr("Create the target table"), settings);
+    form->addRow(QString(), Create);
+
+    Key = new QLineEdit(settings);
+    Key->setToolTip(tr("Integer column used to split the table into ranges copied in parallel and to restart an interrupted copy"));
+    form->addRow(tr("&Key column"), Key);
+
+    Parallel = new QSpinBox(settings);
+    Parallel->setRange(1, 16);
+    Parallel->setValue(1);
+    Parallel->setToolTip(tr("Number of key ranges copied at the same time, each uses a connection on both sides"));
+    form->addRow(tr("&Parallel copies"), Parallel);
+
+    BatchSize = new QSpinBox(settings);
+    BatchSize->setRange(1, 10000);
+    BatchSize->setValue(500);
+    BatchSize->setToolTip(tr("Number of rows sent to the destination in a single round trip"));
+    form->addRow(tr("&Batch size"), BatchSize);
+
+    CommitBatches = new QSpinBox(settings);
+    CommitBatches->setRange(1, 10000);
+    CommitBatches->setValue(20);
+    CommitBatches->setToolTip(tr("Number of batches loaded between commits"));
+    form->addRow(tr("Co&mmit every"), CommitBatches);
+
+    Restartable = new QCheckBox(tr("Save progress to restart an interrupted copy (needs a key column)"), settings);
+    form->addRow(QString(), Restartable);
+
+    QHBoxLayout *fileBox = new QHBoxLayout;
+    CheckpointFile = new QLineEdit(QDir::homePath() + QString::fromLatin1("/tora-tablecopy.ini"), settings);
+    fileBox->addWidget(CheckpointFile);
+    QPushButton *browse = new QPushButton(QIcon(QPixmap(fileopen_xpm)), QString(), settings);
+    connect(browse, SIGNAL(clicked()), this, SLOT(slotBrowse()));
+    fileBox->addWidget(browse);
+    form->addRow(tr("&Checkpoint file"), fileBox);
+
+    QSplitter *splitter = new QSplitter(Qt::Vertical, this);
+    splitter->addWidget(settings);
+
+    Partitions = new QTableWidget(0, 3, splitter);
+    Partitions->setHorizontalHeaderLabels(QStringList() << tr("Key range") << tr("Rows") << tr("State"));
+    Partitions->horizontalHeader()->setStretchLastSection(true);
+    Partitions->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    splitter->addWidget(Partitions);
+    layout()->addWidget(splitter);
+
+    Progress = new QProgressBar(this);
+    Progress->setValue(0);
+    layout()->addWidget(Progress);
+    Status = new QLabel(this);
+    layout()->addWidget(Status);
+}
+
+toTableCopy::~toTableCopy()
+{
+    stopWorkers();
+}
+
+toConnection& toTableCopy::destination(void)
+{
+    QModelIndex i = Destination->model()->index(Destination->currentIndex(), 0);
+    QVariant data = Destination->model()->data(i, Qt::UserRole);
+    return toConnectionRegistrySing::Instance().connection(data.value<toConnectionOptions>());
+}
+
+void toTableCopy::slotBrowse(void)
+{
+    QString filename = Utils::toSaveFilename(CheckpointFile->text(), QString::fromLatin1("*.ini"), this);
+    if (!filename.isEmpty())
+        CheckpointFile->setText(filename);
+}
+
+QVector<toTableCopyPartition> toTableCopy::partitions(QString const& source, QString const& key, QString const& filter, int count)
+{
+    QVector<toTableCopyPartition> ret;
+    if (key.isEmpty())
+    {
+        ret << toTableCopyPartition::whole();
+        return ret;
+    }
+
+    QString sql = QString::fromLatin1("SELECT MIN(%1), MAX(%1) FROM %2").arg(key).arg(source);
+    if (!filter.isEmpty())
+        sql += QString::fromLatin1(" WHERE ") + filter;
+    toConnectionSubLoan conn(connection());
+    toQuery query(conn, sql, toQueryParams());
+    toQValue min = query.readValue();
+    toQValue max = query.readValue();
+    if (min.isNull() || max.isNull())
+    {
+        ret << toTableCopyPartition::whole(); // nothing to copy
+        return ret;
+    }
+
+    qlonglong low, high;
+    if (!toTableCopyPartition::key(min, low) || !toTableCopyPartition::key(max, high))
+        throw tr("Key column %1 of %2 has values that are not integers").arg(key).arg(source);
+    return toTableCopyPartition::split(low, high, count);
+}
+
+void toTableCopy::checkUniqueKey(QString const& source, QString const& key)
+{
+    toConnectionTraits const& traits = connection().getTraits();
+    QString owner = source.contains(QChar('.')) ? traits.unQuote(source.section(QChar('.'), 0, 0)) : connection().defaultSchema();
+    QString table = traits.unQuote(source.section(QChar('.'), -1));
+    QString column = traits.unQuote(key);
+
+    QString sql;
+    try
+    {
+        sql = toSQL::string(SQLUniqueKey, connection());
+    }
+    catch (QString const&)
+    {
+        throw tr("Restarting a copy is not supported for this database");
+    }
+    toConnectionSubLoan conn(connection());
+    toQuery query(conn, sql, toQueryParams() << owner << table << column);
+    if (query.readValue().toInt() == 0)
+        throw tr("Key column %1 is not the primary key or a unique key of %2, an interrupted copy could not be restarted "
+                 "without copying some rows twice").arg(key).arg(source);
+}
+
+toQColumnDescriptionList toTableCopy::createdColumns(toQColumnDescriptionList const& columns)
+{
+    toConnectionTraits const& from = connection().getTraits();
+    toConnectionTraits const& to = destination().getTraits();
+
+    toQColumnDescriptionList ret;
+    Q_FOREACH(toCache::ColumnDescription col, columns)
+    {
+        int size, scale;
+        toConnectionTraits::TypeClass type = from.typeClass(col.Datatype, size, scale);
+        col.Datatype = to.typeName(type, size, scale);
+        ret << col;
+    }
+    return ret;
+}
+
+toQColumnDescriptionList toTableCopy::targetColumns(QString const& table, toQColumnDescriptionList const& columns)
+{
+    toQColumnDescriptionList desc;
+    {
+        toConnectionSubLoan conn(destination());
+        toQuery query(conn, QString::fromLatin1("SELECT * FROM %1 WHERE 1=0").arg(table), toQueryParams());
+        desc = query.describe();
+    }
+
+    toQColumnDescriptionList ret;
+    Q_FOREACH(toCache::ColumnDescription const& col, columns)
+    {
+        int i = 0;
+        while (i < desc.size() && desc.at(i).Name.compare(col.Name, Qt::CaseInsensitive) != 0)
+            i++;
+        if (i == desc.size())
+            throw tr("Column %1 not found in %2").arg(col.Name).arg(table);
+        ret << desc.at(i);
+    }
+    return ret;
+}
+
+QString toTableCopy::createStatement(QString const& table, toQColumnDescriptionList const& columns)
+{
+    toConnectionTraits const& to = destination().getTraits();
+
+    QStringList cols;
+    Q_FOREACH(toCache::ColumnDescription const& col, createdColumns(columns))
+    {
+        QString def = to.quote(col.Name) + QChar(' ') + col.Datatype;
+        if (!col.Null)
+            def += QString::fromLatin1(" NOT NULL");
+        cols << def;
+    }
+    return QString::fromLatin1("CREATE TABLE %1 (%2)").arg(table).arg(cols.join(QString::fromLatin1(", ")));
+}
+
+QString toTableCopy::insertStatement(QString const& table, QStringList const& columns, toQColumnDescriptionList const& types, int batchSize)
+{
+    // trotl needs the type and size of array bind variables declared in the statement
+    bool arrayBinds = destination().providerIs("Oracle");
+    toConnectionTraits const& traits = destination().getTraits();
+
+    QStringList binds;
+    for (int i = 0; i < columns.size(); i++)
+    {
+        if (!arrayBinds)
+        {
+            binds << QString::fromLatin1(":c%1").arg(i + 1);
+            continue;
+        }
+
+        toCache::ColumnDescription const& col = types.at(i);
+        QString name = col.Datatype.trimmed().toUpper();
+        if (name.contains(QLatin1String("LOB")) || name.startsWith(QLatin1String("LONG"))
+                || name == QLatin1String("BFILE") || name.contains(QLatin1String("XMLTYPE")))
+            throw tr("Column %1 of %2 is %3, LOB and LONG columns can not be copied into Oracle")
+            .arg(col.Name).arg(table).arg(col.Datatype);
+
+        int size, scale;
+        QString type;
+        switch (traits.typeClass(col.Datatype, size, scale))
+        {
+            case toConnectionTraits::TYPE_INTEGER:
+                // bound as long, which can be 32 bits
+                type = size > 0 && size <= 9 ? QString::fromLatin1("long") : QString::fromLatin1("char[41]");
+                break;
+            case toConnectionTraits::TYPE_FLOAT:
+                type = QString::fromLatin1("double");
+                break;
+            case toConnectionTraits::TYPE_TEXT:
+                // the size can be in characters, up to 4 bytes each in UTF-8
+                type = QString::fromLatin1("char[%1]").arg(size > 0 ? qMin(size * 4, 4000) : 4000);
+                break;
+            case toConnectionTraits::TYPE_BINARY:
+                // RAW, as hexadecimal text
+                type = QString::fromLatin1("char[%1]").arg(size > 0 ? qMin(size * 2, 4000) : 4000);
+                break;
+            default:
+                // numbers, dates and timestamps converted from their text
+                type = QString::fromLatin1("char[100]");
+                break;
+        }
+        binds << QString::fromLatin1(":c%1<%2,in[%3]>").arg(i + 1).arg(type).arg(batchSize);
+    }
+    return QString::fromLatin1("INSERT INTO %1 (%2) VALUES (%3)")
+           .arg(table)
+           .arg(columns.join(QString::fromLatin1(", ")))
+           .arg(binds.join(QString::fromLatin1(", ")));
+}
+
+void toTableCopy::slotStart(void)
+{
+    if (!Workers.isEmpty())
+        return;
+    try
+    {
+        Utils::toBusy busy;
+
+        QString source = Source->text().trimmed();
+        QString target = Target->text().trimmed();
+        QString filter = Filter->text().trimmed();
+        QString key = Key->text().trimmed();
+        if (source.isEmpty())
+            throw tr("No source table given");
+        if (target.isEmpty())
+            target = source;
+        if (Restartable->isChecked() && key.isEmpty())
+            throw tr("A key column is needed to restart the copy");
+
+        toConnection &dest = destination();
+        toConnectionTraits const& srcTraits = connection().getTraits();
+        toConnectionTraits const& destTraits = dest.getTraits();
+
+        toQColumnDescriptionList desc;
+        {
+            toConnectionSubLoan conn(connection());
+            toQuery query(conn, QString::fromLatin1("SELECT * FROM %1 WHERE 1=0").arg(source), toQueryParams());
+            desc = query.describe();
+        }
+        if (desc.isEmpty())
+            throw tr("No columns found in %1").arg(source);
+
+        QStringList srcColumns, destColumns;
+        int keyColumn = -1;
+        Q_FOREACH(toCache::ColumnDescription const& col, desc)
+        {
+            if (!key.isEmpty() && col.Name.compare(srcTraits.unQuote(key), Qt::CaseInsensitive) == 0)
+                keyColumn = srcColumns.size();
+            srcColumns << srcTraits.quote(col.Name);
+            destColumns << destTraits.quote(col.Name);
+        }
+        if (!key.isEmpty())
+        {
+            if (keyColumn < 0)
+                throw tr("Key column %1 not found in %2").arg(key).arg(source);
+            // NUMBER without a scale is accepted, its values are checked when read
+            int size, scale;
+            toConnectionTraits::TypeClass type = srcTraits.typeClass(desc.at(keyColumn).Datatype, size, scale);
+            if (type != toConnectionTraits::TYPE_INTEGER && (type != toConnectionTraits::TYPE_DECIMAL || scale != 0))
+                throw tr("Key column %1 of %2 is %3, only integer columns can be used as the key")
+                .arg(key).arg(source).arg(desc.at(keyColumn).Datatype);
+            if (Restartable->isChecked())
+                checkUniqueKey(source, key);
+        }
+
+        // restart the copy from the checkpoint when it belongs to the same copy
+        QVector<toTableCopyPartition> parts;
+        bool resumed = false;
+        delete Checkpoint;
+        Checkpoint = NULL;
+        if (Restartable->isChecked())
+        {
+            QString signature = QStringList()
+                                << connection().description(false) << source << filter << key
+                                << dest.description(false) << target << QString::number(Parallel->value())
+                                << srcColumns.join(QString::fromLatin1(","));
+            Checkpoint = new toTableCopyCheckpoint(CheckpointFile->text(), signature.join(QString::fromLatin1("|")));
+            resumed = Checkpoint->load(parts);
+
+            // settle the commits the previous run stopped in, before their rows are read again
+            for (int i = 0; resumed && i < parts.size(); i++)
+            {
+                if (!parts.at(i).inDoubt())
+                    continue;
+                toConnectionSubLoan conn(dest);
+                toQuery query(conn,
+                              QString::fromLatin1("SELECT COUNT(*) FROM %1 WHERE %2")
+                              .arg(target)
+                              .arg(parts.at(i).pending(destColumns.at(keyColumn))),
+                              toQueryParams());
+                parts[i].resolve(query.readValue().toQVariant().toLongLong());
+                Checkpoint->save(i, parts.at(i));
+            }
+        }
+
+        // bind types come from the destination columns, checked before the table is created
+        bool create = !resumed && Create->isChecked();
+        toQColumnDescriptionList destDesc = create ? createdColumns(desc) : targetColumns(target, desc);
+        QString select = QString::fromLatin1("SELECT %1 FROM %2").arg(srcColumns.join(QString::fromLatin1(", "))).arg(source);
+        QString insert = insertStatement(target, destColumns, destDesc, BatchSize->value());
+
+        if (!resumed)
+        {
+            parts = partitions(source, key, filter, Parallel->value());
+            if (create)
+            {
+                toConnectionSubLoan conn(dest);
+                toQuery query(conn, createStatement(target, desc), toQueryParams());
+                conn->commit();
+            }
+            if (Checkpoint)
+                Checkpoint->reset(parts);
+        }
+
+        Partitions->setRowCount(0);
+        Copied.fill(0, parts.size());
+        Errors.clear();
+        Total = 0;
+        for (int i = 0; i < parts.size(); i++)
+        {
+            toTableCopyPartition const& part = parts.at(i);
+            Partitions->insertRow(i);
+            Partitions->setItem(i, 0, new QTableWidgetItem(part.Ranged ?
+                                QString::fromLatin1("%1 - %2").arg(part.Low + 1).arg(part.High) :
+                                tr("All rows")));
+            Partitions->setItem(i, 1, new QTableWidgetItem(QString::number(part.Rows)));
+            Copied[i] = part.Rows;
+            Total += part.Rows;
+            if (part.Finished)
+            {
+                Partitions->setItem(i, 2, new QTableWidgetItem(tr("Done")));
+                continue;
+            }
+            Partitions->setItem(i, 2, new QTableWidgetItem(resumed && part.Done > part.Low ? tr("Resumed") : tr("Copying")));
+
+            QStringList where;
+            if (!filter.isEmpty())
+                where << QString::fromLatin1("(%1)").arg(filter);
+            if (part.Ranged)
+                where << part.remaining(key);
+            QString sql = select;
+            if (!where.isEmpty())
+                sql += QString::fromLatin1(" WHERE ") + where.join(QString::fromLatin1(" AND "));
+            if (part.Ranged)
+                sql += QString::fromLatin1(" ORDER BY ") + key;
+
+            Worker worker;
+            worker.Queue = new toTableCopyQueue(4);
+            worker.Reader = new toTableCopyReader(QSharedPointer<toConnectionSubLoan>(new toConnectionSubLoan(connection())),
+                                                  sql,
+                                                  part.Ranged ? keyColumn : -1,
+                                                  BatchSize->value(),
+                                                  *worker.Queue);
+            worker.Writer = new toTableCopyWriter(i,
+                                                  part,
+                                                  QSharedPointer<toConnectionSubLoan>(new toConnectionSubLoan(dest)),
+                                                  insert,
+                                                  target,
+                                                  destColumns,
+                                                  CommitBatches->value(),
+                                                  *worker.Queue,
+                                                  Checkpoint);
+            connect(worker.Reader, SIGNAL(failed(QString const&)), this, SLOT(slotFailed(QString const&)));
+            connect(worker.Writer, SIGNAL(failed(QString const&)), this, SLOT(slotFailed(QString const&)));
+            connect(worker.Writer, SIGNAL(progress(int, qint64)), this, SLOT(slotProgress(int, qint64)));
+            connect(worker.Writer, SIGNAL(finished()), this, SLOT(slotFinished()));
+            Workers << worker;
+        }
+
+        if (Workers.isEmpty())
+        {
+            Status->setText(tr("Copy has already finished: %1 rows").arg(Total));
+            return;
+        }
+
+        Progress->setRange(0, parts.size());
+        Progress->setValue(parts.size() - Workers.size());
+        Status->setText(resumed ? tr("Resuming copy...") : tr("Copying..."));
+        StartAct->setEnabled(false);
+        StopAct->setEnabled(true);
+        Running = Workers.size();
+        Q_FOREACH(Worker const& worker, Workers)
+        {
+            worker.Reader->start();
+            worker.Writer->start();
+        }
+    }
+    TOCATCH;
+}
+
+void toTableCopy::slotStop(void)
+{
+    Q_FOREACH(Worker const& worker, Workers)
+        worker.Queue->cancel();
+}
+
+void toTableCopy::slotProgress(int index, qint64 rows)
+{
+    Total += rows - Copied.at(index);
+    Copied[index] = rows;
+    Partitions->item(index, 1)->setText(QString::number(rows));
+    Status->setText(tr("%1 rows copied").arg(Total));
+}
+
+void toTableCopy::slotFailed(QString const& error)
+{
+    Errors << error;
+    Utils::toStatusMessage(error);
+}
+
+void toTableCopy::slotFinished(void)
+{
+    toTableCopyWriter *writer = qobject_cast<toTableCopyWriter*>(sender());
+    if (writer)
+    {
+        bool finished = writer->partition().Finished;
+        Partitions->item(writer->index(), 2)->setText(finished ? tr("Done") : tr("Stopped"));
+        if (finished)
+            Progress->setValue(Progress->value() + 1);
+    }
+
+    if (--Running > 0)
+        return;
+
+    stopWorkers();
+    StartAct->setEnabled(true);
+    StopAct->setEnabled(false);
+    if (!Errors.isEmpty())
+        Status->setText(tr("Copy failed after %1 rows: %2").arg(Total).arg(Errors.first()));
+    else if (Progress->value() < Progress->maximum())
+        Status->setText(tr("Copy stopped after %1 rows").arg(Total));
+    else
+        Status->setText(tr("Copy finished: %1 rows").arg(Total));
+}
+
+void toTableCopy::stopWorkers(void)
+{
+    Q_FOREACH(Worker const& worker, Workers)
+        worker.Queue->cancel();
+    Q_FOREACH(Worker const& worker, Workers)
+    {
+        worker.Reader->wait();
+        worker.Writer->wait();
+        delete worker.Reader;
+        delete worker.Writer;
+        delete worker.Queue;
+    }
+    Workers.clear();
+    Running = 0;
+    delete Checkpoint;
+    Checkpoint = NULL;
+}
@@ -0,0 +1,187 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include "widgets/totoolwidget.h"
+#include "core/toqvalue.h"
+#include "core/toboundedqueue.h"
+#include "tools/totablecopypartition.h"
+
+#include <QtCore/QThread>
+#include <QtCore/QStringList>
+#include <QtCore/QSharedPointer>
+
+class QLineEdit;
+class QComboBox;
+class QCheckBox;
+class QSpinBox;
+class QTableWidget;
+class QProgressBar;
+class QLabel;
+class QAction;
+class toConnectionSubLoan;
+
+/** Rows passed from a reader to a writer */
+struct toTableCopyBatch
+{
+    QList<toQueryParams> Rows;
+    qlonglong LastKey;          // key of the last row when copying by key ranges
+};
+
+typedef toBoundedQueue<toTableCopyBatch> toTableCopyQueue;
+
+/** Fetches the rows of one partition from the source connection */
+class toTableCopyReader : public QThread
+{
+        Q_OBJECT;
+    public:
+        /** @param keyColumn index of the key among the selected columns, -1 when not copying by key */
+        toTableCopyReader(QSharedPointer<toConnectionSubLoan> conn, QString const& sql, int keyColumn, int batchSize, toTableCopyQueue &queue);
+    signals:
+        void failed(QString const& error);
+    protected:
+        void run(void) override;
+    private:
+        QSharedPointer<toConnectionSubLoan> Connection;
+        QString SQL;
+        int KeyColumn, BatchSize;
+        toTableCopyQueue &Queue;
+};
+
+/** Loads the rows of one partition into the destination, concurrently with its reader.
+ *  Uses the bulk load of the destination when it has one (see @ref toConnectionSub::createBulkLoad),
+ *  array bound INSERT statements otherwise.
+ */
+class toTableCopyWriter : public QThread
+{
+        Q_OBJECT;
+    public:
+        /**
+         * @param columns quoted column names of the destination table
+         * @param commitBatches number of batches loaded between commits (and checkpoints)
+         * @param checkpoint NULL when the copy is not restartable
+         */
+        toTableCopyWriter(int index,
+                          toTableCopyPartition const& partition,
+                          QSharedPointer<toConnectionSubLoan> conn,
+                          QString const& sql,
+                          QString const& table,
+                          QStringList const& columns,
+                          int commitBatches,
+                          toTableCopyQueue &queue,
+                          toTableCopyCheckpoint *checkpoint);
+
+        int index(void) const
+        {
+            return Index;
+        }
+
+        toTableCopyPartition const& partition(void) const
+        {
+            return Partition;
+        }
+    signals:
+        void progress(int index, qint64 rows);
+        void failed(QString const& error);
+    protected:
+        void run(void) override;
+    private:
+        int Index;
+        toTableCopyPartition Partition;
+        QSharedPointer<toConnectionSubLoan> Connection;
+        QString SQL, Table;
+        QStringList Columns;
+        int CommitBatches;
+        toTableCopyQueue &Queue;
+        toTableCopyCheckpoint *Checkpoint;
+};
+
+/** Copies data of a table into another connection (possibly of a different database) */
+class toTableCopy : public toToolWidget
+{
+        Q_OBJECT;
+    public:
+        toTableCopy(QWidget *parent, toConnection &connection);
+        virtual ~toTableCopy();
+        virtual void slotWindowActivated(toToolWidget*) {};
+    private slots:
+        void slotBrowse(void);
+        void slotStart(void);
+        void slotStop(void);
+        void slotProgress(int index, qint64 rows);
+        void slotFailed(QString const& error);
+        void slotFinished(void);
+    private:
+        /** One partition being copied */
+        struct Worker
+        {
+            toTableCopyQueue *Queue;
+            toTableCopyReader *Reader;
+            toTableCopyWriter *Writer;
+        };
+
+        toConnection& destination(void);
+        /** Split the source by key into @p count ranges (or one partition when there is no key) */
+        QVector<toTableCopyPartition> partitions(QString const& source, QString const& key, QString const& filter, int count);
+        /** Throw unless @p key alone is the primary key or a unique key of @p source.
+         *  An interrupted copy resumes after the last committed key, so that key must not repeat.
+         */
+        void checkUniqueKey(QString const& source, QString const& key);
+        /** Columns of a new destination table, types mapped using the traits of both connections */
+        toQColumnDescriptionList createdColumns(toQColumnDescriptionList const& columns);
+        /** Described columns of an existing destination table matching the source @p columns */
+        toQColumnDescriptionList targetColumns(QString const& table, toQColumnDescriptionList const& columns);
+        /** CREATE TABLE statement for the destination, see @ref createdColumns */
+        QString createStatement(QString const& table, toQColumnDescriptionList const& columns);
+        /** @param types described columns of the destination table, in the order of @p columns */
+        QString insertStatement(QString const& table, QStringList const& columns, toQColumnDescriptionList const& types, int batchSize);
+        void stopWorkers(void);
+
+        QComboBox *Destination;
+        QLineEdit *Source, *Filter, *Target, *Key, *CheckpointFile;
+        QCheckBox *Create, *Restartable;
+        QSpinBox *Parallel, *BatchSize, *CommitBatches;
+        QTableWidget *Partitions;
+        QProgressBar *Progress;
+        QLabel *Status;
+        QAction *StartAct, *StopAct;
+
+        QList<Worker> Workers;
+        toTableCopyCheckpoint *Checkpoint;
+        QVector<qint64> Copied;
+        qint64 Total;
+        int Running;
+        QStringList Errors;
+};
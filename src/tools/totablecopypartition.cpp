@@ -0,0 +1,201 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "tools/totablecopypartition.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QSettings>
+
+#include <limits>
+
+toTableCopyPartition toTableCopyPartition::whole(void)
+{
+    toTableCopyPartition ret;
+    ret.Ranged = false;
+    ret.Low = ret.High = ret.Done = ret.Pending = 0;
+    ret.Rows = 0;
+    ret.Finished = false;
+    return ret;
+}
+
+QVector<toTableCopyPartition> toTableCopyPartition::split(qlonglong min, qlonglong max, int count)
+{
+    // ranges are open at the low end
+    if (min == std::numeric_limits<qlonglong>::min())
+        throw QString::fromLatin1("Key value %1 is out of range").arg(min);
+
+    QVector<toTableCopyPartition> ret;
+    qlonglong low = min - 1;
+    // the whole span of qlonglong does not fit into qlonglong
+    quint64 span = quint64(max) - quint64(low);
+    quint64 parts = quint64(qMax(count, 1));
+    quint64 step = qMax(span / parts + (span % parts ? 1 : 0), (quint64)1);
+    for (qlonglong from = low; from < max;)
+    {
+        toTableCopyPartition p = whole();
+        p.Ranged = true;
+        p.Low = p.Done = p.Pending = from;
+        p.High = quint64(max) - quint64(from) <= step ? max : qlonglong(quint64(from) + step);
+        ret << p;
+        from = p.High;
+    }
+    return ret;
+}
+
+bool toTableCopyPartition::key(toQValue const& value, qlonglong &key)
+{
+    if (value.isNull())
+        return false;
+    // through the text, converting the variant would truncate fractions
+    bool ok;
+    key = value.toQVariant().toString().trimmed().toLongLong(&ok);
+    return ok;
+}
+
+QString toTableCopyPartition::remaining(QString const& key) const
+{
+    return QString::fromLatin1("%1 > %2 AND %1 <= %3").arg(key).arg(Done).arg(High);
+}
+
+QString toTableCopyPartition::pending(QString const& key) const
+{
+    return QString::fromLatin1("%1 > %2 AND %1 <= %3").arg(key).arg(Done).arg(Pending);
+}
+
+void toTableCopyPartition::resolve(qint64 rows)
+{
+    // the rows of one commit are either all there or none of them
+    if (rows > 0)
+    {
+        Done = Pending;
+        Rows += rows;
+    }
+    Pending = Done;
+}
+
+toTableCopyCheckpoint::toTableCopyCheckpoint(QString const& filename, QString const& signature)
+    : Filename(filename)
+    , Signature(signature)
+{
+}
+
+bool toTableCopyCheckpoint::load(QVector<toTableCopyPartition> &partitions)
+{
+    QMutexLocker lock(&Mutex);
+    if (!QFile::exists(Filename))
+        return false;
+    QSettings s(Filename, QSettings::IniFormat);
+    if (s.value(QString::fromLatin1("signature")).toString() != Signature)
+        return false;
+
+    int count = s.value(QString::fromLatin1("partitions")).toInt();
+    if (count <= 0)
+        return false;
+    partitions.resize(count);
+    for (int i = 0; i < count; i++)
+    {
+        s.beginGroup(QString::fromLatin1("partition%1").arg(i));
+        toTableCopyPartition &p = partitions[i];
+        p.Ranged = s.value(QString::fromLatin1("ranged")).toBool();
+        p.Low = s.value(QString::fromLatin1("low")).toLongLong();
+        p.High = s.value(QString::fromLatin1("high")).toLongLong();
+        p.Done = s.value(QString::fromLatin1("done")).toLongLong();
+        p.Pending = s.value(QString::fromLatin1("pending"), p.Done).toLongLong();
+        p.Rows = s.value(QString::fromLatin1("rows")).toLongLong();
+        p.Finished = s.value(QString::fromLatin1("finished")).toBool();
+        s.endGroup();
+    }
+    return true;
+}
+
+void toTableCopyCheckpoint::reset(QVector<toTableCopyPartition> const& partitions)
+{
+    {
+        QMutexLocker lock(&Mutex);
+        QSettings s(Filename, QSettings::IniFormat);
+        s.clear();
+        s.setValue(QString::fromLatin1("signature"), Signature);
+        s.setValue(QString::fromLatin1("partitions"), partitions.size());
+    }
+    for (int i = 0; i < partitions.size(); i++)
+        save(i, partitions.at(i));
+}
+
+void toTableCopyCheckpoint::save(int index, toTableCopyPartition const& partition)
+{
+    QMutexLocker lock(&Mutex);
+    QSettings s(Filename, QSettings::IniFormat);
+    s.beginGroup(QString::fromLatin1("partition%1").arg(index));
+    s.setValue(QString::fromLatin1("ranged"), partition.Ranged);
+    s.setValue(QString::fromLatin1("low"), partition.Low);
+    s.setValue(QString::fromLatin1("high"), partition.High);
+    s.setValue(QString::fromLatin1("done"), partition.Done);
+    s.setValue(QString::fromLatin1("pending"), partition.Pending);
+    s.setValue(QString::fromLatin1("rows"), partition.Rows);
+    s.setValue(QString::fromLatin1("finished"), partition.Finished);
+    s.endGroup();
+    s.sync();
+}
+
+toTableCopyCommitter::toTableCopyCommitter(int index, toTableCopyPartition const& partition, toTableCopyCheckpoint *checkpoint)
+    : Index(index)
+    , Partition(partition)
+    , Checkpoint(checkpoint)
+    , Rows(0)
+    , LastKey(partition.Done)
+{
+}
+
+void toTableCopyCommitter::loaded(int rows, qlonglong lastKey)
+{
+    Rows += rows;
+    LastKey = lastKey;
+}
+
+void toTableCopyCommitter::commit(std::function<void(void)> const& commit, bool finished)
+{
+    if (Checkpoint && Partition.Ranged && Rows > 0)
+    {
+        Partition.Pending = LastKey;
+        Checkpoint->save(Index, Partition);
+    }
+    commit();
+    Partition.Rows += Rows;
+    Partition.Done = Partition.Pending = LastKey;
+    Partition.Finished = finished;
+    Rows = 0;
+    if (Checkpoint)
+        Checkpoint->save(Index, Partition);
+}
@@ -0,0 +1,141 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include "core/toqvalue.h"
+
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include <functional>
+
+/** Part of the source table copied by one reader/writer pair.
+ *  When copying by key it is the range (Low, High] of the key, read in the order of the key,
+ *  so the rows up to the last committed key never have to be copied again. That only holds
+ *  when the key is unique, see @ref toTableCopy.
+ */
+struct toTableCopyPartition
+{
+    bool Ranged;
+    qlonglong Low, High;
+    qlonglong Done;             // last key committed in the destination
+    qlonglong Pending;          // last key of the rows being committed, see @ref toTableCopyCommitter
+    qint64 Rows;                // rows committed
+    bool Finished;
+
+    /** Single partition holding all the rows */
+    static toTableCopyPartition whole(void);
+
+    /** Split the keys from @p min to @p max into at most @p count ranges of about the same size */
+    static QVector<toTableCopyPartition> split(qlonglong min, qlonglong max, int count);
+
+    /** Integer value of a key column.
+     * @return false when @p value is NULL or not an integer
+     */
+    static bool key(toQValue const& value, qlonglong &key);
+
+    /** SQL condition selecting the rows of a ranged partition not committed yet */
+    QString remaining(QString const& key) const;
+
+    /** True when the copy stopped during a commit and it is not known whether the commit succeeded */
+    bool inDoubt(void) const
+    {
+        return Pending != Done;
+    }
+
+    /** SQL condition selecting the rows of the commit in doubt */
+    QString pending(QString const& key) const;
+
+    /** Settle the commit in doubt.
+     * @param rows number of rows of the @ref pending condition found in the destination
+     */
+    void resolve(qint64 rows);
+};
+
+/** Progress of the partitions saved in an ini file, so an interrupted copy can be restarted */
+class toTableCopyCheckpoint
+{
+    public:
+        /** @param signature identifies the copy (connections, tables, filter and partitioning) */
+        toTableCopyCheckpoint(QString const& filename, QString const& signature);
+
+        /** Read partitions saved by an earlier run of the same copy.
+         * @return false when there is no such run
+         */
+        bool load(QVector<toTableCopyPartition> &partitions);
+
+        /** Start a new checkpoint file for @p partitions */
+        void reset(QVector<toTableCopyPartition> const& partitions);
+
+        /** Save committed progress of partition @p index, called from the writer threads */
+        void save(int index, toTableCopyPartition const& partition);
+    private:
+        QMutex Mutex;
+        QString Filename, Signature;
+};
+
+/** Commit step of the copy of one partition.
+ *  The commit of the destination and the save of the checkpoint are not atomic, a crash between
+ *  the two would leave committed rows the checkpoint does not know of and the restart would insert
+ *  them again. So the last key of the rows being committed is saved as Pending before the commit;
+ *  a restart finding Pending beyond Done looks for those rows in the destination and settles the
+ *  partition with @ref toTableCopyPartition::resolve before copying it.
+ */
+class toTableCopyCommitter
+{
+    public:
+        /** @param checkpoint NULL when the copy is not restartable */
+        toTableCopyCommitter(int index, toTableCopyPartition const& partition, toTableCopyCheckpoint *checkpoint);
+
+        /** Rows up to @p lastKey were loaded into the destination, not committed yet */
+        void loaded(int rows, qlonglong lastKey);
+
+        /** Commit the loaded rows through @p commit and save the checkpoint.
+         * @param finished the partition has been copied entirely
+         */
+        void commit(std::function<void(void)> const& commit, bool finished);
+
+        toTableCopyPartition const& partition(void) const
+        {
+            return Partition;
+        }
+    private:
+        int Index;
+        toTableCopyPartition Partition;
+        toTableCopyCheckpoint *Checkpoint;
+        qint64 Rows;
+        qlonglong LastKey;
+};
@@ -133,6 +133,8 @@ namespace ToConfiguration
                 return QVariant((bool)true);
             case AutoLoad:
                 return QVariant(QString(""));
+            case WorksheetFetchSizeInt:
+                return QVariant((int)0);
             default:
                 Q_ASSERT_X( false, qPrintable(__QHERE__), qPrintable(QString("Context Worksheet un-registered enum value: %1").arg(option)));
                 return QVariant();
@@ -444,6 +446,7 @@ void toWorksheet::setup(bool autoLoad)
     ResultTab = new toTabWidget(EditSplitter);
 
     Current = Result = new toResultTableView(false, true, ResultTab, "ResultTab");
+    Result->setFetchSize(toConfigurationNewSingle::Instance().option(ToConfiguration::Worksheet::WorksheetFetchSizeInt).toUInt());
     ResultTab->addTab(Result, tr("&Result"));
     connect(Result, SIGNAL(done(void)), this, SLOT(slotQueryDone(void)));
     connect(Result,
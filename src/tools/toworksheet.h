@@ -96,6 +96,7 @@ namespace ToConfiguration
                 , ExecLogBool             // #define CONF_EXEC_LOG
                 , ToplevelDescribeBool    // #define CONF_TOPLEVEL_DESCRIBE
                 , AutoLoad                // #define CONF_AUTO_LOAD (Default file)
+                , WorksheetFetchSizeInt   // rows per round-trip, 0 = database setting
             };
             QVariant defaultValue(int option) const;
     };
@@ -35,6 +35,7 @@
 #include "widgets/toresultlistformat.h"
 #include "core/utils.h"
 #include "core/tolistviewformatter.h"
+#include "core/tolistviewformatteridentifier.h"
 #include "core/toconfiguration.h"
 #include "core/toglobalconfiguration.h"
 
@@ -42,18 +43,23 @@
 
 toResultListFormat::toResultListFormat(QWidget *parent, DialogType type, const char *name)
     : QDialog(parent)
+    , Type(type)
 {
     using namespace ToConfiguration;
 
     setupUi(this);
     setModal(true);
-    formatCombo->addItem(tr("Text"));
-    formatCombo->addItem(tr("Tab delimited"));
-    formatCombo->addItem(tr("CSV"));
-    formatCombo->addItem(tr("HTML"));
-    formatCombo->addItem(tr("SQL"));
+    formatCombo->addItem(tr("Text"), toListViewFormatterIdentifier::TEXT);
+    formatCombo->addItem(tr("Tab delimited"), toListViewFormatterIdentifier::TAB_DELIMITED);
+    formatCombo->addItem(tr("CSV"), toListViewFormatterIdentifier::CSV);
+    formatCombo->addItem(tr("HTML"), toListViewFormatterIdentifier::HTML);
+    formatCombo->addItem(tr("SQL"), toListViewFormatterIdentifier::SQL);
+    if (type == TypeExport)
+        formatCombo->addItem(tr("Arrow IPC"), toListViewFormatterIdentifier::ARROW);
 
     int num = toConfigurationNewSingle::Instance().option(Global::DefaultListFormatInt).toInt();
+    if (num >= formatCombo->count())
+        num = 0;
     formatCombo->setCurrentIndex(num);
     formatChanged(num);
 
@@ -64,6 +70,9 @@ toResultListFormat::toResultListFormat(QWidget *parent, DialogType type, const c
 
     delimiterEdit->setText(toConfigurationNewSingle::Instance().option(Exporter::CsvDelimiter).toString());
     separatorEdit->setText(toConfigurationNewSingle::Instance().option(Exporter::CsvSeparator).toString());
+    insertStyleCombo->setCurrentIndex(toConfigurationNewSingle::Instance().option(Exporter::SqlInsertStyle).toInt());
+    batchRowsSpin->setValue(toConfigurationNewSingle::Instance().option(Exporter::SqlBatchRows).toInt());
+    commitDistanceSpin->setValue(toConfigurationNewSingle::Instance().option(Exporter::SqlCommitDistance).toInt());
 
     selectedRowsRadio->setChecked(type == TypeCopy);
     selectedColumnsRadio->setChecked(type == TypeCopy);
@@ -85,13 +94,18 @@ toExportSettings toResultListFormat::exportSettings()
     else c = toExportSettings::ColumnsAll;
 
 
-    return toExportSettings(r,
-                            c,
-                            formatCombo->currentIndex(),
-                            includeRowHeaderCheck->isChecked(),
-                            includeColumnHeaderCheck->isChecked(),
-                            separatorEdit->text(),
-                            delimiterEdit->text());
+    toExportSettings ret(r,
+                         c,
+                         formatCombo->itemData(formatCombo->currentIndex()).toInt(),
+                         includeRowHeaderCheck->isChecked(),
+                         includeColumnHeaderCheck->isChecked(),
+                         separatorEdit->text(),
+                         delimiterEdit->text());
+    ret.insertStyle = insertStyleCombo->currentIndex();
+    ret.batchRows = batchRowsSpin->value();
+    ret.commitDistance = commitDistanceSpin->value();
+    ret.directCsv = directCsvCheck->isEnabled() && directCsvCheck->isChecked();
+    return ret;
 }
 
 toExportSettings toResultListFormat::plaintextCopySettings()
@@ -109,6 +123,10 @@ void toResultListFormat::formatChanged(int pos)
 {
     separatorEdit->setEnabled(pos == 2);
     delimiterEdit->setEnabled(pos == 2);
+    directCsvCheck->setEnabled(pos == 2 && Type == TypeExport);
+    insertStyleCombo->setEnabled(pos == 4);
+    batchRowsSpin->setEnabled(pos == 4);
+    commitDistanceSpin->setEnabled(pos == 4);
 }
 
 
@@ -117,6 +135,9 @@ void toResultListFormat::accept()
     toConfigurationNewSingle::Instance().setOption(ToConfiguration::Global::DefaultListFormatInt, formatCombo->currentIndex());
     toConfigurationNewSingle::Instance().setOption(ToConfiguration::Global::ClipboardCHeadersBool, includeColumnHeaderCheck->isChecked());
     toConfigurationNewSingle::Instance().setOption(ToConfiguration::Global::ClipboardRHeadersBool, includeRowHeaderCheck->isChecked());
+    toConfigurationNewSingle::Instance().setOption(ToConfiguration::Exporter::SqlInsertStyle, insertStyleCombo->currentIndex());
+    toConfigurationNewSingle::Instance().setOption(ToConfiguration::Exporter::SqlBatchRows, batchRowsSpin->value());
+    toConfigurationNewSingle::Instance().setOption(ToConfiguration::Exporter::SqlCommitDistance, commitDistanceSpin->value());
 
     QDialog::accept();
 }
@@ -75,6 +75,8 @@ class toResultListFormat : public QDialog, public Ui::toResultListFormatUI
 
     private slots:
         virtual void formatChanged(int pos);
+    private:
+        DialogType Type;
 };
 
 #endif
@@ -73,12 +73,13 @@ int toResultModelEdit::addRow(QModelIndex ind, bool duplicate)
     beginInsertRows(QModelIndex(), newRowPos, newRowPos);
 
     toQueryAbstr::Row row;
-    toRowDesc rowDesc;
-    rowDesc.key = CurrRowKey++;
-    rowDesc.status = ADDED;
 
     if (duplicate)
     {
+        toRowDesc rowDesc;
+        rowDesc.key = CurrRowKey++;
+        rowDesc.status = ADDED;
+
         // Create a duplicate of current row
         row = Rows[ind.row()];
         // Reset a 0'th column
@@ -87,21 +88,53 @@ int toResultModelEdit::addRow(QModelIndex ind, bool duplicate)
     else
     {
         // Create a new empty row
-        row.append(toQValue(rowDesc));
-
-        // null out the rest of the row
-        int cols = Headers.size();
-        for (int j = 1; j < cols; j++)
-            row.append(toQValue());
+        row = newRow();
     }
 
     Rows.insert(newRowPos, row);
     endInsertRows();
     recordAdd(row);
+    emit changed(changed());
     return newRowPos;
 } // addRow
 
 
+int toResultModelEdit::appendRows(int count)
+{
+    int first = Rows.size();
+    if (count <= 0)
+        return first;
+
+    beginInsertRows(QModelIndex(), first, first + count - 1);
+    Rows.reserve(first + count);
+    for (int i = 0; i < count; i++)
+    {
+        toQueryAbstr::Row row = newRow();
+        Rows.append(row);
+        recordAdd(row);
+    }
+    endInsertRows();
+    return first;
+}
+
+
+toQueryAbstr::Row toResultModelEdit::newRow()
+{
+    toQueryAbstr::Row row;
+    toRowDesc rowDesc;
+    rowDesc.key = CurrRowKey++;
+    rowDesc.status = ADDED;
+
+    row.append(toQValue(rowDesc));
+
+    // null out the rest of the row
+    int cols = Headers.size();
+    for (int j = 1; j < cols; j++)
+        row.append(toQValue());
+    return row;
+}
+
+
 void toResultModelEdit::deleteRow(QModelIndex index)
 {
     if (!index.isValid() || index.row() >= Rows.size())
@@ -205,9 +238,7 @@ bool toResultModelEdit::dropMimeData(const QMimeData *data,
                 return false;
         }
 
-        QModelIndex ind = index(row, column);
-        setData(ind, QVariant(data->text()));
-        return true;
+        return pasteText(index(row, column), data->text());
     }
     else if (data->hasFormat("application/vnd.tomodel.list"))
     {
@@ -221,37 +252,127 @@ bool toResultModelEdit::dropMimeData(const QMimeData *data,
         int columns;
         stream >> rows;
         stream >> columns;
+        if (rows <= 0)
+            return false;
 
-        // count of rows down we've gone so far
-        int counter = 0;
-        while (!stream.atEnd() && column <= columnCount())
+        // values are stored column by column
+        QList<QStringList> block;
+        for (int i = 0; i < rows; i++)
+            block << QStringList();
+        for (int counter = 0; !stream.atEnd(); counter++)
         {
             QString text;
             stream >> text;
+            block[counter % rows] << text;
+        }
 
-            QModelIndex ind = index(row, column);
-            setData(ind, QVariant(text));
+        return applyBlock(row, column, block);
+    }
 
-            row++;
-            counter++;
-            if (counter >= rows)
-            {
-                row -= counter;
-                counter = 0;
-                column++;
-            }
+    return false;
+}
+
+
+bool toResultModelEdit::pasteText(const QModelIndex &topLeft, const QString &text)
+{
+    if (!topLeft.isValid() || topLeft.column() == 0)
+        return false;
+
+    if (!text.contains(QChar('\t')) && !text.contains(QChar('\n')))
+        return setData(topLeft, QVariant(text));
+
+    return applyBlock(topLeft.row(), topLeft.column(), parseTable(text));
+}
 
-            if (!stream.atEnd() && row >= rowCount())
-                row = addRow();
 
-            if (column >= columnCount())
-                return true;    // drop data past end of columns
+QList<QStringList> toResultModelEdit::parseTable(const QString &text)
+{
+    // Tab separated lines as spreadsheets put them on the clipboard. Values containing
+    // a separator are enclosed in double quotes, quotes inside them are doubled.
+    QList<QStringList> retval;
+    QStringList line;
+    QString field;
+    bool quoted = false;
+    bool fieldStart = true;
+
+    const int len = text.size();
+    const QChar *data = text.constData();
+    for (int i = 0; i < len; i++)
+    {
+        QChar c = data[i];
+        if (quoted)
+        {
+            if (c != QChar('"'))
+                field += c;
+            else if (i + 1 < len && data[i + 1] == QChar('"'))
+                field += data[++i];
+            else
+                quoted = false;
+            continue;
         }
 
-        return true;
+        if (c == QChar('"') && fieldStart)
+        {
+            quoted = true;
+            fieldStart = false;
+        }
+        else if (c == QChar('\t'))
+        {
+            line << field;
+            field.clear();
+            fieldStart = true;
+        }
+        else if (c == QChar('\n') || c == QChar('\r'))
+        {
+            if (c == QChar('\r') && i + 1 < len && data[i + 1] == QChar('\n'))
+                i++;
+            line << field;
+            retval << line;
+            line.clear();
+            field.clear();
+            fieldStart = true;
+        }
+        else
+        {
+            field += c;
+            fieldStart = false;
+        }
+    }
+    if (!fieldStart || !line.isEmpty())
+    {
+        line << field;
+        retval << line;
     }
+    return retval;
+}
 
-    return false;
+
+bool toResultModelEdit::applyBlock(int row, int column, const QList<QStringList> &block)
+{
+    if (block.isEmpty() || row < 0 || column < 1 || column >= Headers.size())
+        return false;
+
+    // rows missing at the end are added in one go
+    int missing = row + block.size() - Rows.size();
+    if (missing > 0)
+        appendRows(missing);
+
+    int lastColumn = column;
+    for (int r = 0; r < block.size(); r++)
+    {
+        QStringList const& values = block.at(r);
+        // drop data past end of columns
+        for (int c = 0; c < values.size() && column + c < Headers.size(); c++)
+        {
+            if (updateCell(row + r, column + c, toQValue(values.at(c))))
+                lastColumn = qMax(lastColumn, column + c);
+        }
+    }
+
+    // one view update for the whole block
+    emit dataChanged(index(row, column), index(row + block.size() - 1, lastColumn));
+    emit changed(changed());
+    return true;
 }
 
 
@@ -267,38 +388,41 @@ bool toResultModelEdit::setData(const QModelIndex &index,
     if (role != Qt::EditRole)
         return false;
 
-    if (index.column() == 0)
+    if (!updateCell(index.row(), index.column(), toQValue::fromVariant(_value)))
+        return false;
+
+    // for the view
+    emit dataChanged(index, index);
+    emit changed(changed());
+
+    return true;
+}
+
+bool toResultModelEdit::updateCell(int rowIndex, int column, const toQValue &newValue)
+{
+    if (column == 0)
         return false;           // can't change number column
 
-    if (index.row() >= Rows.size() || index.column() >= Headers.size())
+    if (rowIndex < 0 || rowIndex >= Rows.size() || column >= Headers.size())
         return false;
 
-    toQueryAbstr::Row &row = Rows[index.row()];
-    toQValue newValue = toQValue::fromVariant(_value);
-    toRowDesc rowDesc = Rows.at(index.row())[0].getRowDesc();
-    if (rowDesc.status == EXISTED && !(row[index.column()] == newValue))
+    toQueryAbstr::Row &row = Rows[rowIndex];
+    if (column >= row.size())
+        return false;
+
+    toRowDesc rowDesc = row[0].getRowDesc();
+    if (rowDesc.status == EXISTED && !(row[column] == newValue))
     {
         // leave row that's added as in status added
         rowDesc.status = MODIFIED;
-        Rows[index.row()][0] = toQValue(rowDesc);
+        row[0] = toQValue(rowDesc);
     }
 
-    {
-        // If no prikey is used, data is recorded in change list
-        toQueryAbstr::Row oldRow = row;           // keep old version
-        row[index.column()] = newValue;
-        // for writing to the database
-        recordChange(index, newValue, oldRow);
-
-        if (!row[index.column()].updateNewValue(newValue))
-            return false;
-        qDebug() << "Value is changed from " << (QString)row[index.column()] << " to " << (QString)newValue << "At " << index;
-    }
-
-    // for the view
-    emit dataChanged(index, index);
+    // for writing to the database, recorded while the row still holds the old value
+    recordChange(column, newValue, row);
+    row[column] = newValue;
 
-    return true;
+    return row[column].updateNewValue(newValue);
 }
 
 Qt::ItemFlags toResultModelEdit::flags(const QModelIndex &index) const
@@ -340,44 +464,42 @@ QList<struct toResultModelEdit::ChangeSet>& toResultModelEdit::changes()
 
 void toResultModelEdit::revertChanges()
 {
-    bool c = changed();
+    clearChanges();
+}
+
+void toResultModelEdit::clearChanges()
+{
     Changes.clear();
+    AddedKeys.clear();
     emit changed(changed());
 }
 
-void toResultModelEdit::recordChange(const QModelIndex &index,
+void toResultModelEdit::recordChange(int column,
                                      const toQValue &newValue,
                                      const toQueryAbstr::Row &row)
 {
     // first, if it was an added row, find and update the ChangeSet so
     // they all get inserted as one.
-    toQValue rowDesc = row[0];
-    for (int changeIndex = 0; changeIndex < Changes.size(); changeIndex++)
+    QHash<int, int>::const_iterator added = AddedKeys.constFind(row[0].getRowDesc().key);
+    if (added != AddedKeys.constEnd())
     {
-        if (Changes[changeIndex].kind == Add && Changes[changeIndex].row[0].getRowDesc().key == rowDesc.getRowDesc().key)
-        {
-            Changes[changeIndex].row[index.column()] = newValue;
-            return;
-        }
+        Changes[added.value()].row[column] = newValue;
+        return;
     }
 
     // don't record if not changed
-    if (newValue == row[index.column()])
+    if (newValue == row[column])
         return;
 
 
     struct ChangeSet change;
 
-    change.columnName = headerData(index.column(),
-                                   Qt::Horizontal,
-                                   Qt::DisplayRole).toString();
     change.newValue = newValue;
-    change.row      = row;
-    change.column   = index.column();
+    change.row      = keyPart(row);
+    change.column   = column;
     change.kind     = Update;
 
     Changes.append(change);
-    emit changed(changed());
 }
 
 
@@ -386,10 +508,11 @@ void toResultModelEdit::recordAdd(const toQueryAbstr::Row &row)
     struct ChangeSet change;
 
     change.row      = row;
+    change.column   = 0;
     change.kind     = Add;
 
+    AddedKeys.insert(row[0].getRowDesc().key, Changes.size());
     Changes.append(change);
-    emit changed(changed());
 }
 
 void toResultModelEdit::recordDelete(const toQueryAbstr::Row &row)
@@ -398,17 +521,17 @@ void toResultModelEdit::recordDelete(const toQueryAbstr::Row &row)
     // statement for the row being deleted - remove it (as there is no point of
     // trying to insert a possibly bad row and throw exceptions then that row
     // must be deleted).
-    QMutableListIterator<struct ChangeSet> j(Changes);
-    struct ChangeSet cs;
-    bool insertFound = false;
-    while (j.hasNext() && !insertFound)
+    int key = row[0].getRowDesc().key;
+    bool insertFound = AddedKeys.contains(key);
+    if (insertFound)
     {
-        cs = j.next();
-        if ((cs.row[0].getRowDesc().key == row[0].getRowDesc().key) &&
-                (cs.kind == Add))
+        int changeIndex = AddedKeys.take(key);
+        Changes.removeAt(changeIndex);
+        // the changes recorded after the removed one moved up
+        for (QHash<int, int>::iterator i = AddedKeys.begin(); i != AddedKeys.end(); ++i)
         {
-            j.remove();
-            insertFound = true;
+            if (i.value() > changeIndex)
+                i.value()--;
         }
     }
 
@@ -416,10 +539,17 @@ void toResultModelEdit::recordDelete(const toQueryAbstr::Row &row)
     {
         struct ChangeSet change;
 
-        change.row      = row;
+        change.row      = keyPart(row);
+        change.column   = 0;
         change.kind     = Delete;
 
         Changes.append(change);
     }
     emit changed(changed());
 }
+
+toQueryAbstr::Row toResultModelEdit::keyPart(const toQueryAbstr::Row &row) const
+{
+    // row description followed by primary key columns
+    return row.mid(0, PriKeys.size() + 1);
+}
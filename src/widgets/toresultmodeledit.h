@@ -42,6 +42,8 @@
 #include <QtCore/QModelIndex>
 #include <QtCore/QList>
 #include <QtCore/QMap>
+#include <QtCore/QHash>
+#include <QtCore/QStringList>
 
 
 class toEventQuery;
@@ -59,15 +61,18 @@ class toResultModelEdit : public toResultModel
             Update
         };
 
+        /**
+         * Pending change of one row. To keep large edits cheap, Update and Delete
+         * keep the row description and primary key values only, Add keeps the whole new row.
+         */
         struct ChangeSet
         {
             ChangeKind         kind;         /* sql change mode */
-            QString            columnName;   /* column name */
             int                column;       /* the real column number
                                           * after adjusting for
-                                          * numbercolumn */
-            toQValue           newValue;     /* data after the change */
-            toQueryAbstr::Row       row;          /* data before the change */
+                                          * numbercolumn (Update only) */
+            toQValue           newValue;     /* data after the change (Update only) */
+            toQueryAbstr::Row       row;          /* row key, or the whole row for Add */
         };
 
         toResultModelEdit(toEventQuery *query,
@@ -95,6 +100,14 @@ class toResultModelEdit : public toResultModel
          */
         int addRow(QModelIndex ind = QModelIndex(), bool duplicate = false);
 
+        /**
+         * Append @p count empty rows at the end, with a single rows inserted
+         * notification. Does not emit changed.
+         *
+         * @return index of the first row added
+         */
+        int appendRows(int count);
+
         /**
          * Mark to delete a row internally. Emits rowDeleted on success.
          *
@@ -167,6 +180,19 @@ class toResultModelEdit : public toResultModel
          */
         virtual Qt::DropActions supportedDropActions() const;
 
+        /**
+         * Paste tab separated text (as copied from a spreadsheet) starting at
+         * @p topLeft. Rows are added as needed, values past the last column are
+         * dropped. The whole block is applied with a single view update.
+         */
+        bool pasteText(const QModelIndex &topLeft, const QString &text);
+
+        /**
+         * Split tab separated lines into values. Quoted values may contain
+         * tabs and newlines.
+         */
+        static QList<QStringList> parseTable(const QString &text);
+
         /**
          *  Get PriKeys
          */
@@ -179,16 +205,33 @@ class toResultModelEdit : public toResultModel
 
         void revertChanges();
 
+        /**
+         * Forget the recorded changes once they were saved to the database.
+         * Clears also the positions of added rows, which point into the list of changes.
+         */
+        void clearChanges();
+
     protected:
         /**
-         * Append change to Changes
+         * Set value of one cell and record the change. Emits no signals.
+         */
+        bool updateCell(int row, int column, const toQValue &newValue);
+
+        /**
+         * Apply @p block of values with its top left corner at @p row, @p column.
          */
-        void recordChange(const QModelIndex &,
+        bool applyBlock(int row, int column, const QList<QStringList> &block);
+
+        /**
+         * Append change to Changes, @p row still holds the old value.
+         * Does not emit changed.
+         */
+        void recordChange(int column,
                           const toQValue &,
                           const toQueryAbstr::Row &);
 
         /**
-         * Append a new row to Changes
+         * Append a new row to Changes. Does not emit changed.
          */
         void recordAdd(const toQueryAbstr::Row &);
 
@@ -204,8 +247,17 @@ class toResultModelEdit : public toResultModel
         void changed(bool edit);
 
     private:
+        // new empty row in status added
+        toQueryAbstr::Row newRow();
+
+        // row description and primary key values of a row
+        toQueryAbstr::Row keyPart(const toQueryAbstr::Row &row) const;
+
         const QList<QString> PriKeys;
 
+        // keys of added rows -> position of their Add in Changes
+        QHash<int, int> AddedKeys;
+
         // keep a history of changes to commit.
         // this is a fifo -- don't sort or insert. just append.
         QList<struct ChangeSet> Changes;